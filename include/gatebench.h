@@ -4,12 +4,19 @@
 #ifndef GATEBENCH_H
 #define GATEBENCH_H
 
+#include "gatebench_stats.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
 
-/* Global limits */
-#define GB_MAX_ENTRIES 64u
+/*
+ * Global limits. A gate action travels in one TCA_ACT_TAB nest whose nla_len
+ * is 16 bits; at 32 bytes per open entry plus 120 bytes of fixed attributes,
+ * 2028 entries is the largest request that fits with 512 bytes to spare.
+ * Replies add TCA_GATE_ENTRY_INDEX to every entry, so GETs, echoes and
+ * notifications outgrow the nest earlier, at roughly 1600 entries.
+ */
+#define GB_MAX_ENTRIES 2028u
 
 /* Core configuration structure */
 struct gb_config {
@@ -24,6 +31,8 @@ struct gb_config {
     /* System configuration */
     int cpu;        /* CPU to pin to (-1 for no pinning) */
     int timeout_ms; /* Netlink timeout in milliseconds */
+    int nl_backend; /* Netlink transport (enum gb_nl_backend) */
+    const char* loopback_service; /* Loopback model service time spec (NULL = none) */
 
     /* Mode flags */
     bool json;               /* Output JSON format */
@@ -33,8 +42,38 @@ struct gb_config {
     bool dump_proof;         /* Run dump proof harness */
     const char* pcap_path;   /* Output pcap path (nlmon capture) */
     const char* nlmon_iface; /* nlmon interface name */
+    bool dump_pipeline;      /* Dump proof parses on a second thread from a page ring */
     bool race_mode;          /* Run race mode workload */
     uint32_t race_seconds;   /* Race mode duration in seconds */
+    uint32_t batch;          /* Ops packed per batched sendmsg (0 = off) */
+    uint32_t window;         /* Ops kept in flight when pipelining (0 = off) */
+    uint32_t clients;        /* Event-loop clients, one socket each (0 = off) */
+    uint32_t listeners;      /* Max RTNLGRP_TC listeners in the fan-out sweep (0 = off) */
+    uint32_t netns;          /* Workers for the namespace scaling comparison (0 = off) */
+    uint32_t entry_sweep;    /* Largest schedule in the entry-count sweep (0 = off) */
+    uint32_t multi_actions;  /* Largest K in the actions-per-message sweep (0 = off) */
+    uint32_t teardown;       /* Largest population in the teardown benchmark (0 = off) */
+    uint32_t dump_pop;       /* Gate actions created and dumped by --dump-population (0 = off) */
+    uint32_t dump_delta;     /* TCA_ROOT_TIME_DELTA window of the filtered dumps, ms (0 = off) */
+    uint32_t act_stats;      /* Actions per variant in the stats flag benchmark (0 = off) */
+    uint32_t auto_index;     /* Actions per variant in the auto index benchmark (0 = off) */
+    uint32_t threads;        /* Largest thread count in the write scaling sweep (0 = off) */
+    uint32_t rw_writers;     /* Largest writer count in the reader/writer grid */
+    uint32_t rw_readers;     /* Largest reader count in the reader/writer grid (grid off when both 0) */
+    uint32_t rw_indices;     /* Gate actions shared by the grid's readers and writers */
+    uint32_t rw_ms;          /* Duration of each grid cell, ms */
+    uint32_t rate;           /* Open-loop offered replaces/sec (0 = off) */
+    int arrivals;            /* enum gb_arrivals */
+    uint64_t slo_ns;         /* Response latency bound of the capacity search (0 = off) */
+    uint32_t slo_pct;        /* Percentile held to slo_ns, permille (990 = p99) */
+    const char* mix;         /* Operation mix spec, "get=70,replace=25,..." (NULL = off) */
+    uint32_t hot_set;        /* Indices the mix draws from */
+    double zipf;             /* Zipf exponent of the mix's index popularity (0 = uniform) */
+    bool phases;             /* Break each op into build/send/wait/recv/parse/stats */
+    bool cycle;              /* Time create/EEXIST/replace/delete cycles, one distribution per op */
+    const char* trace_path;  /* Capture every request to this trace file (NULL = off) */
+    const char* replay_path; /* Replay this trace instead of running a workload */
+    int replay_pace;         /* enum gb_replay_pace */
 
     /* Gate shape parameters */
 
@@ -47,6 +86,24 @@ struct gb_config {
     uint64_t cycle_time_ext; /* Cycle time extension */
 };
 
+/* Per-op phase breakdown (phases mode); see struct gb_nl_phase_times */
+struct gb_phase_summary {
+    struct gb_latency_summary build; /* Rebuild the request message */
+    struct gb_latency_summary send;  /* sendto, including kernel processing */
+    struct gb_latency_summary wait;  /* sendto return -> poll wakeup */
+    struct gb_latency_summary recv;  /* poll wakeup -> recvfrom return */
+    struct gb_latency_summary parse; /* Match and parse the reply */
+    struct gb_latency_summary stats; /* Record the latency sample */
+};
+
+/* Per-op latency of a create/replace/delete cycle (cycle mode) */
+struct gb_cycle_summary {
+    struct gb_latency_summary create;  /* NLM_F_EXCL create of an absent index */
+    struct gb_latency_summary exists;  /* The same create again, rejected with -EEXIST */
+    struct gb_latency_summary replace; /* NLM_F_REPLACE of the existing action */
+    struct gb_latency_summary del;     /* RTM_DELACTION */
+};
+
 /* Gate shape structure */
 
 struct gate_shape {
@@ -67,6 +124,8 @@ struct gate_shape {
 struct gb_run_result {
     double secs;        /* Total time in seconds */
     double ops_per_sec; /* Operations per second */
+    uint64_t start_ns;  /* Timed loop start, CLOCK_MONOTONIC_RAW */
+    uint64_t end_ns;    /* Timed loop end, CLOCK_MONOTONIC_RAW */
 
     /* Latency percentiles in nanoseconds */
     uint64_t p50_ns;
@@ -85,6 +144,25 @@ struct gb_run_result {
     uint32_t replace_len;
     uint32_t del_len;
 
+    /* Batched submission (batch mode only) */
+    uint32_t batch_size;  /* Ops per batch; latency fields are per batch */
+    uint32_t batch_count; /* Timed batches sent */
+
+    /* Pipelined submission (window mode only); latency fields are issue->ack */
+    uint32_t window;         /* Requests kept in flight */
+    uint64_t ack_gap_p50_ns; /* Median interval between acks as read (per-op loop cost) */
+
+    /* Netlink-path heap allocations per op in the timed loop (gb_nl_alloc_count) */
+    double allocs_per_op;
+
+    /* Phase breakdown (phases mode only) */
+    bool has_phases;
+    struct gb_phase_summary phases;
+
+    /* Per-op breakdown (cycle mode only); latency fields above cover all four ops */
+    bool has_cycle;
+    struct gb_cycle_summary cycle;
+
     /* Raw latency samples (if sampling enabled) */
     uint64_t* samples;
     uint32_t sample_count;
@@ -0,0 +1,56 @@
+/* include/gatebench_act_stats.h
+ * Public API for the per-CPU / hardware stats flag cost benchmark.
+ */
+#ifndef GATEBENCH_ACT_STATS_H
+#define GATEBENCH_ACT_STATS_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GB_ACT_STATS_MAX 100000u
+#define GB_ACT_STATS_VARIANTS 6u
+
+/* One combination of TCA_ACT_FLAGS and TCA_ACT_HW_STATS */
+struct gb_act_stats_variant {
+    const char* name;
+    bool has_flags;
+    uint32_t flags; /* TCA_ACT_FLAGS value */
+    bool has_hw_stats;
+    uint32_t hw_stats; /* TCA_ACT_HW_STATS value */
+    int error;         /* The first create failed with this errno; no timings then */
+
+    uint64_t create_errors;
+    uint64_t replace_errors;
+    uint64_t delete_errors;
+    struct gb_latency_summary create;
+    struct gb_latency_summary replace;
+    struct gb_latency_summary del;
+
+    /*
+     * Approximate: system-wide /proc/meminfo growth over creating all
+     * actions, divided by their count; not sampled on the loopback backend
+     */
+    bool mem_valid;
+    double slab_bytes;   /* Slab */
+    double percpu_bytes; /* Percpu */
+};
+
+struct gb_act_stats_summary {
+    uint32_t actions; /* Created per variant */
+    uint32_t cpus;    /* Online CPUs; per-CPU stats scale with this */
+    uint32_t variants;
+    struct gb_act_stats_variant variant[GB_ACT_STATS_VARIANTS];
+};
+
+/*
+ * For each flag variant, create cfg->act_stats gate actions at index..
+ * one request at a time, replace each, then delete each, timing every
+ * request, and sample the system-wide /proc/meminfo Slab and Percpu around
+ * the creates (real kernel backends only).
+ */
+int gb_act_stats_run(const struct gb_config* cfg, struct gb_act_stats_summary* summary);
+void gb_act_stats_print_summary(const struct gb_act_stats_summary* summary, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_ACT_STATS_H */
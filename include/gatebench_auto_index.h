@@ -0,0 +1,51 @@
+/* include/gatebench_auto_index.h
+ * Public API for the kernel-allocated index create benchmark.
+ */
+#ifndef GATEBENCH_AUTO_INDEX_H
+#define GATEBENCH_AUTO_INDEX_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GB_AUTO_INDEX_MAX 100000u
+#define GB_AUTO_INDEX_VARIANTS 3u
+
+/* One way of creating the actions */
+struct gb_auto_index_variant {
+    const char* name;
+    bool auto_index; /* TCA_ACT_INDEX = 0, the kernel picks */
+    bool echo;       /* NLM_F_ECHO, the created action comes back */
+    int error;       /* The first create failed with this errno; no timings then */
+
+    uint64_t create_errors;
+    uint64_t delete_errors;
+    uint64_t missing_echoes;    /* Echo requested but no gate action came back */
+    uint64_t duplicate_indices; /* Echoed index already handed out in this variant */
+    uint64_t wrong_indices;     /* Explicit index echoed back as a different one */
+    uint64_t echo_bytes;        /* Summed RTM_NEWACTION echo lengths */
+    uint32_t first_index;       /* Lowest index created (echoed for auto) */
+    uint32_t last_index;        /* Highest index created */
+    struct gb_latency_summary create;
+    struct gb_latency_summary del;
+    double creates_per_sec; /* 1 / mean create latency */
+};
+
+struct gb_auto_index_summary {
+    uint32_t actions; /* Created per variant */
+    uint32_t variants;
+    struct gb_auto_index_variant variant[GB_AUTO_INDEX_VARIANTS];
+};
+
+/*
+ * Create cfg->auto_index gate actions one request at a time with explicit
+ * indices (index..), explicit indices plus NLM_F_ECHO, and index 0 plus
+ * NLM_F_ECHO, then delete them by the index used or echoed, timing every
+ * request. Auto-allocated indices land on the lowest free ones, so they may
+ * sit below cfg->index.
+ */
+int gb_auto_index_run(const struct gb_config* cfg, struct gb_auto_index_summary* summary);
+void gb_auto_index_print_summary(const struct gb_auto_index_summary* summary, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_AUTO_INDEX_H */
@@ -0,0 +1,37 @@
+/* include/gatebench_clients.h
+ * Public API for the multi-client event loop engine.
+ */
+#ifndef GATEBENCH_CLIENTS_H
+#define GATEBENCH_CLIENTS_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_CLIENTS_MAX 1024u
+
+struct gb_client_summary {
+    uint32_t index; /* Gate action index owned by this client */
+    uint64_t ops;
+    uint64_t errors;
+    int last_error;
+    struct gb_latency_summary latency; /* issue->ack per op */
+};
+
+struct gb_clients_summary {
+    uint32_t clients;
+    uint64_t total_ops;
+    uint64_t total_errors;
+    double secs;
+    double ops_per_sec;
+    uint64_t epoll_waits;              /* epoll_wait calls in the timed loop */
+    struct gb_latency_summary latency; /* All clients combined */
+    struct gb_client_summary* per_client;
+};
+
+/* Run cfg->clients controller clients from one thread; each does 2 * iters ops */
+int gb_clients_run(const struct gb_config* cfg, struct gb_clients_summary* summary);
+void gb_clients_print_summary(const struct gb_clients_summary* summary, const struct gb_config* cfg);
+void gb_clients_summary_free(struct gb_clients_summary* summary);
+
+#endif /* GATEBENCH_CLIENTS_H */
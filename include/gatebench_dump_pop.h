@@ -0,0 +1,78 @@
+/* include/gatebench_dump_pop.h
+ * Public API for the large-population dump benchmark.
+ */
+#ifndef GATEBENCH_DUMP_POP_H
+#define GATEBENCH_DUMP_POP_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GB_DUMP_POP_MAX 1000000u
+
+/* Dump request flavours, each timed against the same population */
+enum gb_dump_pop_kind {
+    GB_DUMP_POP_FULL = 0,    /* LARGE_DUMP_ON only */
+    GB_DUMP_POP_TERSE,       /* + TCA_ACT_FLAG_TERSE_DUMP: kind, index and stats, no options */
+    GB_DUMP_POP_DELTA,       /* + TCA_ROOT_TIME_DELTA: recently used actions only */
+    GB_DUMP_POP_TERSE_DELTA, /* Both */
+    GB_DUMP_POP_KINDS,
+};
+
+struct gb_dump_pop_variant {
+    const char* name;
+    uint32_t root_flags;    /* Extra TCA_ROOT_FLAGS */
+    uint32_t time_delta_ms; /* TCA_ROOT_TIME_DELTA (0 = none) */
+    uint32_t expected;      /* Actions the dump should return */
+    uint32_t dumps;         /* Timed dumps that completed */
+    uint64_t dump_errors;
+
+    /* Per dump, from the last timed dump */
+    uint32_t pages;      /* RTM_GETACTION messages */
+    uint64_t bytes;      /* Payload bytes */
+    uint64_t seen;       /* Gate actions walked */
+    uint64_t with_stats; /* ... of which carried TCA_ACT_STATS */
+    uint64_t entries;    /* Schedule entries decoded */
+
+    struct gb_latency_summary wall;       /* Request sent to last page parsed */
+    struct gb_latency_summary first_page; /* Request sent to first page received */
+
+    /* Totals over all timed dumps / summed wall time */
+    double bytes_per_sec;
+    double actions_per_sec;
+    double entries_per_sec;
+    double pages_per_sec;
+    double parse_share; /* Parse time / wall time */
+
+    /* Against the full dump (1.0 = same) */
+    double bytes_vs_full;
+    double wall_vs_full; /* p50 */
+};
+
+struct gb_dump_pop_summary {
+    uint32_t actions;         /* N requested */
+    uint32_t recent;          /* Actions refreshed before each time-delta dump (0 = no delta dumps) */
+    uint32_t populate_batch;  /* Actions per create message */
+    uint64_t populate_errors; /* Failed create batches */
+    double populate_secs;
+    uint32_t flush_count; /* TCA_FCNT of the closing flush (UINT32_MAX = missing) */
+    bool pipelined;       /* Pages were parsed while the next recv ran */
+
+    uint32_t variants; /* Filled entries of variant */
+    struct gb_dump_pop_variant variant[GB_DUMP_POP_KINDS];
+};
+
+/*
+ * Create cfg->dump_pop gate actions at index.. with 1..entries entries
+ * each, then dump them runs times (after one untimed dump) with
+ * LARGE_DUMP_ON, walking every action and entry, once in full and once
+ * terse. With cfg->dump_delta, the last tenth of the population is
+ * recreated before every dump filtered by TCA_ROOT_TIME_DELTA while the rest
+ * ages past the window, plain and terse. The table is flushed before and
+ * after, which removes every gate action in the namespace.
+ */
+int gb_dump_pop_run(const struct gb_config* cfg, struct gb_dump_pop_summary* summary);
+void gb_dump_pop_print_summary(const struct gb_dump_pop_summary* summary, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_DUMP_POP_H */
@@ -0,0 +1,39 @@
+/* include/gatebench_entry_sweep.h
+ * Public API for the schedule-size sweep.
+ */
+#ifndef GATEBENCH_ENTRY_SWEEP_H
+#define GATEBENCH_ENTRY_SWEEP_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+/* One schedule size of the sweep */
+struct gb_entry_sweep_step {
+    uint32_t entries;
+    uint32_t msg_len; /* Encoded RTM_NEWACTION bytes */
+    int error;        /* Create failed with this errno; no timings then */
+
+    uint64_t replace_errors;
+    struct gb_latency_summary replace; /* REPLACE request->ack */
+
+    uint64_t get_errors; /* Failed GETs or replies that did not carry every entry */
+    struct gb_latency_summary get; /* GET request->reply parsed */
+};
+
+struct gb_entry_sweep_summary {
+    uint32_t steps;
+    struct gb_entry_sweep_step* per_step;
+    uint32_t limit; /* Smallest size the kernel refused to create (0 = none) */
+};
+
+/*
+ * Create a gate with 1, 2, 4, ... cfg->entry_sweep entries and time iters
+ * REPLACEs and GETs at each size. The sweep stops at the first size the
+ * kernel refuses to create.
+ */
+int gb_entry_sweep_run(const struct gb_config* cfg, struct gb_entry_sweep_summary* summary);
+void gb_entry_sweep_print_summary(const struct gb_entry_sweep_summary* summary, const struct gb_config* cfg);
+void gb_entry_sweep_summary_free(struct gb_entry_sweep_summary* summary);
+
+#endif /* GATEBENCH_ENTRY_SWEEP_H */
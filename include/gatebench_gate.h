@@ -42,9 +42,17 @@ struct gate_shape;
 #define TCA_ACT_TAB 1
 #endif
 
+/* Kernel-internal in <net/act_api.h>; the uapi only has the two bits */
+#ifndef TCA_ACT_HW_STATS_ANY
+#define TCA_ACT_HW_STATS_ANY (TCA_ACT_HW_STATS_IMMEDIATE | TCA_ACT_HW_STATS_DELAYED)
+#endif
+
 /* Use priority slot 1 for action nesting */
 #define GATEBENCH_ACT_PRIO 1
 
+/* Most actions one TCA_ACT_TAB carries: slots 1..TCA_ACT_MAX_PRIO */
+#define GB_MULTI_ACTIONS_MAX ((uint32_t)TCA_ACT_MAX_PRIO)
+
 /* Gate entry */
 struct gate_entry {
     uint32_t index;    /* Entry index (from dump) */
@@ -65,6 +73,7 @@ struct gate_dump {
     int32_t priority;
     struct gate_entry* entries;
     uint32_t num_entries;
+    uint32_t entries_cap; /* Allocated slots in entries */
     struct tcf_t tm;
     bool has_tm;
     bool has_basic_stats;
@@ -75,10 +84,19 @@ struct gate_dump {
     uint32_t overlimits;
 };
 
+/* Exact worst-case encoded size of a gate RTM_NEWACTION with this many entries */
+size_t gate_msg_size(uint32_t entries);
+
+/* Same for a RTM_NEWACTION carrying several gate actions */
+size_t gate_msg_size_multi(uint32_t actions, uint32_t entries);
+
 /* Calculate message capacity needed for gate action */
 size_t gate_msg_capacity(uint32_t entries, uint32_t flags);
 
-/* Build RTM_NEWACTION message for gate */
+/*
+ * Build RTM_NEWACTION message for gate. Index 0 leaves the choice to the
+ * kernel, which takes the lowest free one; add NLM_F_ECHO to learn it.
+ */
 int build_gate_newaction(struct gb_nl_msg* msg,
                          uint32_t index,
                          const struct gate_shape* shape,
@@ -88,22 +106,144 @@ int build_gate_newaction(struct gb_nl_msg* msg,
                          uint32_t gate_flags,
                          int32_t priority);
 
+/*
+ * Generic action attributes next to TCA_ACT_OPTIONS. Each is only sent when
+ * its has_ flag is set; the kernel defaults are per-CPU stats and
+ * TCA_ACT_HW_STATS_ANY.
+ */
+struct gate_act_attrs {
+    bool has_flags;
+    uint32_t flags; /* TCA_ACT_FLAGS_* for TCA_ACT_FLAGS */
+    bool has_hw_stats;
+    uint32_t hw_stats; /* TCA_ACT_HW_STATS_* for TCA_ACT_HW_STATS (0 = disabled) */
+};
+
+int build_gate_newaction_attrs(struct gb_nl_msg* msg,
+                               uint32_t index,
+                               const struct gate_shape* shape,
+                               const struct gate_entry* entries,
+                               uint32_t num_entries,
+                               uint16_t nlmsg_flags,
+                               uint32_t gate_flags,
+                               int32_t priority,
+                               const struct gate_act_attrs* attrs);
+
+/*
+ * RTM_NEWACTION with count gate actions (indices[i] in priority slot i + 1),
+ * all sharing one schedule. Returns -EMSGSIZE when they do not fit the
+ * 16-bit TCA_ACT_TAB nest.
+ */
+int build_gate_newaction_multi(struct gb_nl_msg* msg,
+                               const uint32_t* indices,
+                               uint32_t count,
+                               const struct gate_shape* shape,
+                               const struct gate_entry* entries,
+                               uint32_t num_entries,
+                               uint16_t nlmsg_flags,
+                               uint32_t gate_flags,
+                               int32_t priority);
+
+/*
+ * RTM_NEWACTION encoded once, with the offsets of its fixed-size fields
+ * (action index, base_time, cycle_time, per-entry interval/ipv/maxoctets)
+ * recorded so later requests patch them in place instead of re-encoding.
+ * The entry count and each entry's gate state decide the attribute layout
+ * (an open gate carries an extra flag attribute), so changing either
+ * re-encodes the message; everything else is a few stores.
+ */
+struct gate_tmpl;
+
+int build_gate_newaction_tmpl(struct gate_tmpl** out,
+                              uint32_t max_entries,
+                              uint32_t index,
+                              const struct gate_shape* shape,
+                              const struct gate_entry* entries,
+                              uint32_t num_entries,
+                              uint16_t nlmsg_flags,
+                              uint32_t gate_flags,
+                              int32_t priority);
+struct gb_nl_msg* gate_tmpl_msg(const struct gate_tmpl* tmpl);
+void gate_tmpl_set_index(struct gate_tmpl* tmpl, uint32_t index);
+void gate_tmpl_set_base_time(struct gate_tmpl* tmpl, uint64_t base_time);
+void gate_tmpl_set_cycle_time(struct gate_tmpl* tmpl, uint64_t cycle_time);
+int gate_tmpl_set_entry(struct gate_tmpl* tmpl, uint32_t i, const struct gate_entry* entry);
+int gate_tmpl_set_entries(struct gate_tmpl* tmpl, const struct gate_entry* entries, uint32_t num_entries);
+void gate_tmpl_free(struct gate_tmpl* tmpl);
+
 /* Build RTM_DELACTION message */
 int build_gate_delaction(struct gb_nl_msg* msg, uint32_t index);
 
 /* Build RTM_GETACTION message */
 int build_gate_getaction(struct gb_nl_msg* msg, uint32_t index);
 int build_gate_getaction_ex(struct gb_nl_msg* msg, uint32_t index, uint16_t nlmsg_flags);
+
+/* RTM_GETACTION / RTM_DELACTION naming count actions, one priority slot each */
+int build_gate_getaction_multi(struct gb_nl_msg* msg, const uint32_t* indices, uint32_t count);
+int build_gate_delaction_multi(struct gb_nl_msg* msg, const uint32_t* indices, uint32_t count);
 int build_gate_flushaction(struct gb_nl_msg* msg);
 int build_gate_dumpaction(struct gb_nl_msg* msg);
 
+/*
+ * Dump with extra TCA_ROOT_FLAGS (e.g. TCA_ACT_FLAG_TERSE_DUMP) on top of
+ * LARGE_DUMP_ON and, when time_delta_ms is nonzero, TCA_ROOT_TIME_DELTA so
+ * only actions used within the last time_delta_ms are returned.
+ */
+int build_gate_dumpaction_ex(struct gb_nl_msg* msg, uint32_t root_flags, uint32_t time_delta_ms);
+
 /* Add a gate entry to message */
 int add_gate_entry(struct gb_nl_msg* msg, const struct gate_entry* entry);
 
+/*
+ * Zero-copy view of one gate action inside a received message. Scalars are
+ * decoded into action (whose entries stays NULL and num_entries counts the
+ * list); the entries themselves are decoded on demand from the receive
+ * buffer by gb_gate_view_entries(). Only valid during the visit callback.
+ */
+struct gate_view {
+    struct gate_dump action;
+    const struct nlattr* entry_list; /* TCA_GATE_ENTRY_LIST, NULL when absent */
+};
+
+/* Visitor callbacks; a negative return stops the walk and is passed back */
+typedef int (*gb_gate_visit_fn)(const struct gate_view* view, void* arg);
+typedef int (*gb_gate_entry_fn)(const struct gate_entry* entry, void* arg);
+
+/*
+ * Call fn for every gate action in one RTM_*ACTION message, walking the
+ * attributes in place without allocating. fn may be NULL to only count.
+ * Returns the number of gate actions seen or a negative errno.
+ */
+int gb_nl_gate_visit(const struct nlmsghdr* nlh, gb_gate_visit_fn fn, void* arg);
+
+/* Decode the view's entries one at a time onto the stack and pass each to fn */
+int gb_gate_view_entries(const struct gate_view* view, gb_gate_entry_fn fn, void* arg);
+
+/*
+ * Dump with req and hand every gate action to fn as pages arrive. With
+ * pipelined set, a receive thread pulls the next page into a small SPSC ring
+ * while this thread parses the previous one. stats also reports the time
+ * spent inside the parse (parse_ns) so it can be told apart from waiting on
+ * the kernel.
+ */
+int gb_nl_dump_visit(struct gb_nl_sock* sock,
+                     struct gb_nl_msg* req,
+                     gb_gate_visit_fn fn,
+                     void* arg,
+                     bool pipelined,
+                     struct gb_dump_stats* stats,
+                     int timeout_ms);
+
 /* Free gate dump structure */
 void gb_gate_dump_free(struct gate_dump* dump);
 
 /* Parse gate action from netlink message */
 int gb_nl_gate_parse(const struct nlmsghdr* nlh, struct gate_dump* dump);
 
+/*
+ * Like gb_nl_gate_parse(), but keeps the entries storage of an already
+ * initialized dump so repeated parses stop allocating once it is large enough.
+ * Release with gb_gate_dump_free().
+ */
+int gb_nl_gate_parse_into(const struct nlmsghdr* nlh, struct gate_dump* dump);
+
 #endif /* GATEBENCH_GATE_H */
@@ -0,0 +1,42 @@
+/* include/gatebench_listeners.h
+ * Public API for the RTNLGRP_TC notification fan-out mode.
+ */
+#ifndef GATEBENCH_LISTENERS_H
+#define GATEBENCH_LISTENERS_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_LISTENERS_MAX 256u
+
+/* One point of the listener sweep */
+struct gb_listeners_step {
+    uint32_t listeners;
+    uint64_t ops;
+    uint64_t errors; /* Failed ops other than the expected EEXIST on create */
+    double secs;
+    double ops_per_sec;
+    struct gb_latency_summary writer; /* Writer request->ack per op */
+
+    uint64_t expected; /* Notifying ops (successful ones) x listeners */
+    uint64_t received; /* Notifications matched to a writer op */
+    uint64_t early;    /* Read before the writer's ack returned (still in notify) */
+    uint64_t overruns; /* ENOBUFS seen by listeners */
+    struct gb_latency_summary notify; /* Writer send -> listener read, all listeners */
+};
+
+struct gb_listeners_summary {
+    uint32_t steps;
+    struct gb_listeners_step* per_step;
+};
+
+/*
+ * Sweep K = 0, 1, 2, 4, ... cfg->listeners sockets subscribed to RTNLGRP_TC
+ * while one writer runs the benchmark create/replace loop.
+ */
+int gb_listeners_run(const struct gb_config* cfg, struct gb_listeners_summary* summary);
+void gb_listeners_print_summary(const struct gb_listeners_summary* summary, const struct gb_config* cfg);
+void gb_listeners_summary_free(struct gb_listeners_summary* summary);
+
+#endif /* GATEBENCH_LISTENERS_H */
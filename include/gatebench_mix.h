@@ -0,0 +1,60 @@
+/* include/gatebench_mix.h
+ * Public API for the weighted operation-mix workload.
+ */
+#ifndef GATEBENCH_MIX_H
+#define GATEBENCH_MIX_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_MIX_HOT_SET_DEFAULT 64u
+#define GB_MIX_HOT_SET_MAX 65536u
+#define GB_MIX_ZIPF_MAX 10.0
+
+enum gb_mix_op {
+    GB_MIX_CREATE = 0, /* NLM_F_EXCL create of an absent index */
+    GB_MIX_REPLACE,    /* Full schedule, NLM_F_CREATE | NLM_F_REPLACE */
+    GB_MIX_UPDATE,     /* NLM_F_REPLACE of a present index carrying only a new base time */
+    GB_MIX_GET,        /* RTM_GETACTION, reply parsed */
+    GB_MIX_DUMP,       /* Dump of the whole table */
+    GB_MIX_DELETE,     /* RTM_DELACTION of a present index */
+    GB_MIX_OPS,
+};
+
+const char* gb_mix_op_name(enum gb_mix_op op);
+
+/* "get=70,replace=25,delete=5" into weights (unnamed ops 0); -EINVAL when malformed or all zero */
+int gb_mix_parse(const char* spec, uint32_t weights[GB_MIX_OPS]);
+
+struct gb_mix_op_summary {
+    uint32_t weight;
+    uint64_t ops;    /* Completed, in the latency */
+    uint64_t misses; /* ENOENT / EEXIST: the index was not in the state the op needs */
+    uint64_t errors; /* Any other failure */
+    double ops_per_sec;
+    struct gb_latency_summary latency;
+};
+
+struct gb_mix_summary {
+    uint32_t hot_set;
+    double zipf; /* Popularity exponent (0 = uniform) */
+    uint64_t total_ops;
+    double secs;
+    double ops_per_sec;
+    uint32_t present; /* Hot indices holding an action at the end */
+    struct gb_mix_op_summary op[GB_MIX_OPS];
+};
+
+/*
+ * Populate the hot set (cfg->hot_set actions at index..), then issue
+ * cfg->warmup untimed and cfg->iters timed ops on one socket, each drawn
+ * from the cfg->mix weights, on an index drawn uniformly or with Zipf
+ * popularity cfg->zipf (rank r at index + r). Creates move to the next
+ * absent index, and updates and deletes to the next present one, so the
+ * population keeps moving instead of saturating.
+ */
+int gb_mix_run(const struct gb_config* cfg, struct gb_mix_summary* summary);
+void gb_mix_print_summary(const struct gb_mix_summary* summary, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_MIX_H */
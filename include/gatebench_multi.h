@@ -0,0 +1,46 @@
+/* include/gatebench_multi.h
+ * Public API for the multi-action-per-message sweep.
+ */
+#ifndef GATEBENCH_MULTI_H
+#define GATEBENCH_MULTI_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+/* One batch size K of the sweep; latencies are per message of K actions */
+struct gb_multi_step {
+    uint32_t actions; /* K */
+    uint32_t msg_len; /* Encoded RTM_NEWACTION bytes */
+    int error;        /* Building or creating K actions failed with this errno; no timings then */
+
+    uint64_t create_errors;
+    uint64_t get_errors; /* Failed GETs or replies that did not carry all K actions */
+    uint64_t delete_errors;
+    struct gb_latency_summary create;
+    struct gb_latency_summary get;
+    struct gb_latency_summary del;
+
+    /* K / mean message latency */
+    double create_actions_per_sec;
+    double get_actions_per_sec;
+    double delete_actions_per_sec;
+};
+
+struct gb_multi_summary {
+    uint32_t steps;
+    struct gb_multi_step* per_step;
+    uint32_t limit; /* Smallest K that could not be created (0 = none) */
+};
+
+/*
+ * For K = 1, 2, 4, ... cfg->multi_actions, run warmup untimed and iters timed
+ * rounds of one RTM_NEWACTION, RTM_GETACTION and RTM_DELACTION, each carrying
+ * K gate actions at indices index..index+K-1. The sweep stops at the first K
+ * whose actions do not fit one message or that the kernel refuses to create.
+ */
+int gb_multi_run(const struct gb_config* cfg, struct gb_multi_summary* summary);
+void gb_multi_print_summary(const struct gb_multi_summary* summary, const struct gb_config* cfg);
+void gb_multi_summary_free(struct gb_multi_summary* summary);
+
+#endif /* GATEBENCH_MULTI_H */
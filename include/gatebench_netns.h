@@ -0,0 +1,54 @@
+/* include/gatebench_netns.h
+ * Public API for the multi-network-namespace scaling mode.
+ */
+#ifndef GATEBENCH_NETNS_H
+#define GATEBENCH_NETNS_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GB_NETNS_MAX 256u
+
+struct gb_netns_worker_summary {
+    uint32_t index; /* Gate action index owned by this worker */
+    uint64_t ops;
+    double secs;
+    double ops_per_sec;
+    struct gb_latency_summary latency;
+};
+
+/* All workers run at once in one namespace layout */
+struct gb_netns_layout_summary {
+    uint64_t total_ops;
+    double secs; /* First worker start to last worker finish */
+    double ops_per_sec;
+    struct gb_latency_summary latency; /* All workers combined */
+    struct gb_netns_worker_summary* per_worker;
+};
+
+struct gb_netns_summary {
+    uint32_t workers;
+    bool user_ns;                            /* Entered through a user namespace (unprivileged) */
+    struct gb_netns_layout_summary shared;   /* N workers in one namespace */
+    struct gb_netns_layout_summary isolated; /* One namespace per worker */
+    double scaling;                          /* isolated / shared aggregate ops/sec */
+};
+
+/*
+ * Move the process into a fresh network namespace, through a new user
+ * namespace when unshare(CLONE_NEWNET) is not permitted. Must be called while
+ * the process is single-threaded; *user_ns reports which path was taken.
+ */
+int gb_netns_enter(bool* user_ns);
+
+/*
+ * Run cfg->netns workers doing the benchmark create/replace loop (2 * iters
+ * ops each), first sharing the current namespace and then each in its own.
+ */
+int gb_netns_run(const struct gb_config* cfg, struct gb_netns_summary* summary);
+void gb_netns_print_summary(const struct gb_netns_summary* summary, const struct gb_config* cfg);
+void gb_netns_summary_free(struct gb_netns_summary* summary);
+
+#endif /* GATEBENCH_NETNS_H */
@@ -26,17 +26,173 @@ struct gb_dump_stats {
     bool saw_done;
     bool saw_error;
     int error_code;
+
+    /* gb_nl_dump_visit only */
+    uint64_t visited_actions; /* Gate actions handed to the visitor */
+    uint64_t parse_ns;        /* Time spent walking pages and in the visitor */
+    uint64_t wall_ns;         /* Request sent to last page parsed */
+    uint64_t first_page_ns;   /* Request sent to first page received */
+};
+
+/* Transport used to move netlink messages */
+enum gb_nl_backend {
+    GB_NL_BACKEND_SYSCALL = 0, /* sendto + poll + recvfrom */
+    GB_NL_BACKEND_URING,       /* io_uring: linked send/recv/timeout in one enter */
+    GB_NL_BACKEND_LOOPBACK,    /* AF_UNIX pair served by an in-process act_gate model */
+};
+
+/* Select the backend for sockets opened afterwards (call before spawning threads) */
+void gb_nl_set_backend(enum gb_nl_backend backend);
+enum gb_nl_backend gb_nl_get_backend(void);
+const char* gb_nl_backend_name(enum gb_nl_backend backend);
+int gb_nl_backend_parse(const char* name, enum gb_nl_backend* out);
+
+/* Service-time distribution of the loopback model, applied per request */
+enum gb_nl_service_dist {
+    GB_NL_SERVICE_NONE = 0,
+    GB_NL_SERVICE_FIXED,   /* a_ns every request */
+    GB_NL_SERVICE_UNIFORM, /* uniform in [a_ns, b_ns] */
+    GB_NL_SERVICE_EXP,     /* exponential with mean a_ns */
 };
 
+struct gb_nl_service {
+    enum gb_nl_service_dist dist;
+    uint64_t a_ns;
+    uint64_t b_ns;
+};
+
+/* Parse "none", "fixed:NS", "uniform:MIN:MAX" or "exp:MEAN" */
+int gb_nl_service_parse(const char* spec, struct gb_nl_service* out);
+
+/* Set the loopback model's service time (NULL for none); shared by all sockets */
+void gb_nl_loopback_set_service(const struct gb_nl_service* service);
+
 /* Initialize netlink socket */
 int gb_nl_open(struct gb_nl_sock** sock);
 
 /* Close and free netlink socket */
 void gb_nl_close(struct gb_nl_sock* sock);
 
+/* File descriptor of the underlying socket, for external pollers */
+int gb_nl_fd(const struct gb_nl_sock* sock);
+
+/* Netlink port id; notifications caused by this socket carry it in nlmsg_pid */
+uint32_t gb_nl_portid(const struct gb_nl_sock* sock);
+
+/*
+ * Join a multicast group (RTNLGRP_*). Loopback sockets only receive events
+ * for RTNLGRP_TC; the model drops a notification a full listener cannot take,
+ * where the kernel would report ENOBUFS on the listener's next receive.
+ */
+int gb_nl_join_group(struct gb_nl_sock* sock, unsigned int group);
+
+/*
+ * Receive one datagram into resp, e.g. notifications on a group member.
+ * Returns its length, -ETIMEDOUT, or -ENOBUFS after the socket overran.
+ */
+int gb_nl_recv(struct gb_nl_sock* sock, struct gb_nl_msg* resp, int timeout_ms);
+
+/*
+ * Toggle O_NONBLOCK. On a non-blocking socket, gb_nl_reap() with a zero
+ * timeout reads without polling and returns -EAGAIN when drained. Not
+ * supported by the io_uring backend (-EOPNOTSUPP).
+ */
+int gb_nl_set_nonblock(struct gb_nl_sock* sock, bool nonblock);
+
 /* Send and receive netlink message with error checking */
 int gb_nl_send_recv(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_nl_msg* resp, int timeout_ms);
 
+/*
+ * Phase boundaries of the last gb_nl_send_recv() (CLOCK_MONOTONIC_RAW).
+ * rtnetlink handles the request inside sendto, so start->sent is mostly
+ * kernel processing; sent->wake is wakeup latency and wake->recvd the copy
+ * out. With io_uring one enter covers all three: wake_ns equals sent_ns
+ * and the whole round trip lands in wake->recvd.
+ */
+struct gb_nl_phase_times {
+    uint64_t start_ns; /* Call entered */
+    uint64_t sent_ns;  /* sendto returned (io_uring: send queued) */
+    uint64_t wake_ns;  /* poll reported the reply readable */
+    uint64_t recvd_ns; /* recvfrom of the last datagram returned */
+    uint64_t done_ns;  /* Reply matched and parsed, call returning */
+};
+
+/* Record phase timestamps on every gb_nl_send_recv() (five clock reads per call) */
+void gb_nl_set_phase_timing(struct gb_nl_sock* sock, bool enable);
+
+/* Copy the phases of the last gb_nl_send_recv(); -ENODATA if timing is off */
+int gb_nl_last_phases(const struct gb_nl_sock* sock, struct gb_nl_phase_times* out);
+
+/* Maximum number of requests in one gb_nl_send_batch() */
+#define GB_NL_BATCH_MAX 1024u
+
+/* Per-request status value while its ack is still outstanding */
+#define GB_NL_BATCH_PENDING 1
+
+/*
+ * Send count requests (each must carry NLM_F_ACK) packed into as few
+ * sendmsg calls as the socket buffers allow and collect their acks by
+ * sequence number. The batch is split wherever one sendmsg would exceed the
+ * send buffer or its acks could overrun the receive buffer. errs[i] receives
+ * the netlink status of reqs[i] (0 or -errno, -ENOBUFS when the kernel
+ * dropped its ack); requests never acked keep GB_NL_BATCH_PENDING.
+ * Returns 0 once every chunk was acked, or a negative transport error.
+ */
+int gb_nl_send_batch(struct gb_nl_sock* sock,
+                     struct gb_nl_msg* const* reqs,
+                     uint32_t count,
+                     struct gb_nl_msg* resp,
+                     int* errs,
+                     int timeout_ms);
+
+/* Maximum number of requests kept in flight on one socket */
+#define GB_NL_WINDOW_MAX 4096u
+
+/* Completed pipelined request */
+struct gb_nl_completion {
+    uint64_t cookie;     /* Caller tag passed to gb_nl_submit() */
+    uint32_t seq;        /* Sequence number the request was sent with */
+    int err;             /* Netlink status (0 or -errno) */
+    uint64_t issue_ns;   /* CLOCK_MONOTONIC_RAW just before sendto */
+    uint64_t ack_ns;     /* CLOCK_MONOTONIC_RAW when the ack was received */
+    uint64_t latency_ns; /* ack_ns - issue_ns */
+};
+
+/*
+ * Enable pipelining on sock with up to window requests outstanding, growing
+ * the receive buffer to hold window acks (past rmem_max with CAP_NET_ADMIN).
+ * Fails with -EBUSY while requests are still in flight and with -ENOBUFS
+ * when the buffer cannot hold window acks.
+ */
+int gb_nl_async_init(struct gb_nl_sock* sock, uint32_t window);
+
+/*
+ * Send req (must carry NLM_F_ACK) without waiting for its ack. The buffer may
+ * be reused as soon as this returns. Returns -EAGAIN when the window is full.
+ */
+int gb_nl_submit(struct gb_nl_sock* sock, struct gb_nl_msg* req, uint64_t cookie);
+
+/*
+ * Receive one datagram and reap every ack it carries into out[], which must
+ * hold at least window entries. Returns the number of completions (0 when no
+ * request is in flight) or a negative transport error.
+ */
+int gb_nl_reap(struct gb_nl_sock* sock,
+               struct gb_nl_msg* resp,
+               struct gb_nl_completion* out,
+               uint32_t max,
+               int timeout_ms);
+
+/* Number of submitted requests not yet reaped */
+uint32_t gb_nl_inflight(const struct gb_nl_sock* sock);
+
+/*
+ * Heap allocations made so far by gatebench's netlink paths: message buffers,
+ * socket arena growth and parsed gate entry arrays. Process-wide and cheap to
+ * read; diff two snapshots to get allocations per operation.
+ */
+uint64_t gb_nl_alloc_count(void);
+
 /* Allocate netlink message buffer */
 struct gb_nl_msg* gb_nl_msg_alloc(size_t capacity);
 
@@ -59,6 +215,18 @@ int gb_nl_send_recv_flush(struct gb_nl_sock* sock,
                           int timeout_ms,
                           uint32_t* fcnt_out);
 
+/*
+ * Send an NLM_F_ECHO RTM_NEWACTION and read both the echoed action and the
+ * ack. *index_out is the index of the first gate action in the echo
+ * (UINT32_MAX when none came back); *echo_len_out, when given, its length.
+ */
+int gb_nl_send_recv_echo(struct gb_nl_sock* sock,
+                         struct gb_nl_msg* req,
+                         struct gb_nl_msg* resp,
+                         int timeout_ms,
+                         uint32_t* index_out,
+                         uint32_t* echo_len_out);
+
 /* Get error string from netlink error */
 const char* gb_nl_strerror(int err);
 
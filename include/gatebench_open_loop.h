@@ -0,0 +1,45 @@
+/* include/gatebench_open_loop.h
+ * Public API for the open-loop (rate-controlled) replace load.
+ */
+#ifndef GATEBENCH_OPEN_LOOP_H
+#define GATEBENCH_OPEN_LOOP_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_OPEN_LOOP_RATE_MAX 10000000u
+
+enum gb_arrivals {
+    GB_ARRIVALS_CONSTANT = 0, /* Every 1/rate seconds */
+    GB_ARRIVALS_POISSON,      /* Exponential gaps with mean 1/rate */
+};
+
+const char* gb_arrivals_name(enum gb_arrivals arrivals);
+int gb_arrivals_parse(const char* name, enum gb_arrivals* out);
+
+struct gb_open_loop_result {
+    int arrivals;         /* enum gb_arrivals */
+    double offered_rate;  /* Ops/sec scheduled */
+    double achieved_rate; /* Ops completed / first intended start to last ack */
+    double secs;
+    uint64_t ops;
+    uint64_t errors;     /* Failed replaces; not in the latencies */
+    uint64_t queued;     /* Intended start came before the previous op returned */
+    uint64_t max_lag_ns; /* Largest gap from intended start to send */
+
+    struct gb_latency_summary service;  /* Send to ack: what a closed loop reports */
+    struct gb_latency_summary response; /* Intended start to ack: corrected for coordinated omission */
+};
+
+/*
+ * Replace the gate action at cfg->index ops times on one socket, on a
+ * schedule of rate ops/sec with cfg->arrivals gaps, after cfg->warmup
+ * untimed replaces. An op due while the previous one is still out is sent
+ * as soon as it returns and its response time still counts from when it
+ * was due.
+ */
+int gb_open_loop_run(const struct gb_config* cfg, double rate, uint32_t ops, struct gb_open_loop_result* out);
+void gb_open_loop_print_result(const struct gb_open_loop_result* result, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_OPEN_LOOP_H */
@@ -14,6 +14,16 @@ struct gb_dump_summary {
     bool saw_done;
     bool saw_error;
     int error_code;
+
+    /* Client-side parse cost, kept apart from waiting on the kernel */
+    bool pipelined;              /* Pages were parsed while the next recv ran */
+    uint64_t actions;            /* Gate actions walked by the visitor */
+    uint64_t entries;            /* Schedule entries decoded */
+    uint64_t parse_ns;           /* Time spent parsing pages */
+    uint64_t wall_ns;            /* Request sent to last page parsed */
+    double parse_bytes_per_sec;  /* payload_bytes / parse_ns */
+    double parse_actions_per_sec;
+
     bool pcap_enabled;
     int pcap_error;
 };
@@ -0,0 +1,52 @@
+/* include/gatebench_rw.h
+ * Public API for the reader/writer contention grid.
+ */
+#ifndef GATEBENCH_RW_H
+#define GATEBENCH_RW_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_RW_MAX 256u
+#define GB_RW_INDICES_MAX 4096u
+#define GB_RW_MS_DEFAULT 1000u
+
+/* M writers and R readers running together for cfg->rw_ms */
+struct gb_rw_cell {
+    uint32_t writers; /* M */
+    uint32_t readers; /* R */
+    double secs;      /* Start to stop of the cell */
+
+    uint64_t reads; /* RTM_GETACTION round trips, parse included */
+    uint64_t writes;
+    uint64_t read_errors;
+    uint64_t write_errors;
+    double reads_per_sec;
+    double writes_per_sec;
+    struct gb_latency_summary read;  /* All readers combined; zero when R = 0 */
+    struct gb_latency_summary write; /* All writers combined; zero when M = 0 */
+};
+
+struct gb_rw_summary {
+    uint32_t writers; /* Largest M */
+    uint32_t readers; /* Largest R */
+    uint32_t indices; /* Shared gate actions */
+    uint32_t ms;      /* Per cell */
+    uint32_t cpus;    /* CPUs available for pinning */
+    uint32_t cells;
+    struct gb_rw_cell* per_cell; /* M-major: for each M, every R */
+};
+
+/*
+ * Create cfg->rw_indices gate actions at index.., then for every M in
+ * 0, 1, 2, 4, ... cfg->rw_writers and R in 0, 1, 2, 4, ... cfg->rw_readers
+ * (except both 0) run M threads replacing and R threads getting those
+ * actions round robin for cfg->rw_ms, each thread pinned with its own
+ * socket, timing every request.
+ */
+int gb_rw_run(const struct gb_config* cfg, struct gb_rw_summary* summary);
+void gb_rw_print_summary(const struct gb_rw_summary* summary, const struct gb_config* cfg);
+void gb_rw_summary_free(struct gb_rw_summary* summary);
+
+#endif /* GATEBENCH_RW_H */
@@ -0,0 +1,52 @@
+/* include/gatebench_slo.h
+ * Public API for the maximum sustainable rate search under a latency SLO.
+ */
+#ifndef GATEBENCH_SLO_H
+#define GATEBENCH_SLO_H
+
+#include "gatebench.h"
+#include "gatebench_open_loop.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GB_SLO_PROBES_MAX 64u
+#define GB_SLO_START_RATE 1000u
+#define GB_SLO_PCT_DEFAULT 990u /* Permille: p99 */
+#define GB_SLO_PROBE_SECS 10u   /* Wall-time budget of one probe */
+
+/* Percentile, in permille, as a summary field; only 500, 950, 990 and 999 exist */
+uint64_t gb_slo_pct_ns(const struct gb_latency_summary* lat, uint32_t pct_permille);
+
+/* One open-loop run at a fixed offered rate */
+struct gb_slo_probe {
+    double rate;
+    uint32_t ops;    /* Replaces issued: min(iters, rate x GB_SLO_PROBE_SECS), at least min_ops */
+    uint64_t pct_ns; /* Response latency at the SLO percentile */
+    bool pass;       /* pct_ns within the bound and no failed replaces */
+    struct gb_open_loop_result result;
+};
+
+struct gb_slo_summary {
+    uint64_t bound_ns;
+    uint32_t pct_permille;
+    uint32_t min_ops; /* Fewest replaces a probe keeps for the percentile */
+    double min_rate;  /* Slowest rate that gathers min_ops within GB_SLO_PROBE_SECS */
+    double knee_rate; /* Highest passing rate (0 = none passed) */
+    int knee;         /* Probe index of knee_rate (-1 = none) */
+    uint32_t probes;
+    struct gb_slo_probe probe[GB_SLO_PROBES_MAX]; /* In the order run */
+};
+
+/*
+ * Find the highest open-loop replace rate whose response latency at
+ * cfg->slo_pct stays within cfg->slo_ns: starting at cfg->rate (or
+ * GB_SLO_START_RATE), double until a probe fails (or halve until one
+ * passes, not below min_rate), then bisect to within 2%. Each probe is
+ * gb_open_loop_run() with cfg->iters replaces, cut to what the rate issues
+ * in GB_SLO_PROBE_SECS but never below the percentile's minimum sample
+ * (10 / (1 - pct) replaces, e.g. 1000 for p99).
+ */
+int gb_slo_run(const struct gb_config* cfg, struct gb_slo_summary* summary);
+void gb_slo_print_summary(const struct gb_slo_summary* summary, const struct gb_config* cfg);
+
+#endif /* GATEBENCH_SLO_H */
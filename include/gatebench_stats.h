@@ -54,6 +54,22 @@ int gb_stats_calculate(struct gb_stats* stats,
                        uint64_t* p99,
                        uint64_t* p999);
 
+/* Latency distribution snapshot; all fields are zero when there are no samples */
+struct gb_latency_summary {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    double mean_ns;
+    double stddev_ns;
+    uint64_t p50_ns;
+    uint64_t p95_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+};
+
+/* Fill out from stats (sorts stats). Empty stats yield a zeroed summary. */
+int gb_stats_summarize(struct gb_stats* stats, struct gb_latency_summary* out);
+
 /* Calculate median of an array of doubles. */
 int gb_stats_median_double(const double* values, size_t count, double* out);
 
@@ -0,0 +1,52 @@
+/* include/gatebench_teardown.h
+ * Public API for the bulk population and teardown benchmark.
+ */
+#ifndef GATEBENCH_TEARDOWN_H
+#define GATEBENCH_TEARDOWN_H
+
+#include "gatebench.h"
+#include <stdint.h>
+
+#define GB_TEARDOWN_MAX 1000000u
+
+/* One way of deleting the whole population */
+struct gb_teardown_method {
+    uint64_t msgs;   /* Requests sent */
+    uint64_t errors; /* Requests that failed */
+    double secs;     /* First request sent to last ack */
+    double actions_per_sec;
+    uint32_t left; /* Gate actions still dumped afterwards */
+};
+
+/* One population size */
+struct gb_teardown_step {
+    uint32_t actions; /* N */
+    int error;        /* Populating failed outright with this errno; no timings then */
+
+    uint64_t populate_errors; /* Failed create batches, summed over the three populations */
+    double populate_actions_per_sec;
+
+    struct gb_teardown_method single; /* One RTM_DELACTION per action */
+    struct gb_teardown_method batch;  /* GB_MULTI_ACTIONS_MAX indices per RTM_DELACTION */
+    struct gb_teardown_method flush;  /* One NLM_F_ROOT RTM_DELACTION */
+    uint32_t flush_count;             /* TCA_FCNT of the flush (UINT32_MAX = missing) */
+};
+
+struct gb_teardown_summary {
+    uint32_t steps;
+    uint32_t populate_batch; /* Actions per create message */
+    struct gb_teardown_step* per_step;
+};
+
+/*
+ * For N = 256, 1024, 4096, ... cfg->teardown (x4, ending at cfg->teardown),
+ * create N gate actions at index..index+N-1 and time deleting all of them
+ * one at a time, in multi-index batches and with a single flush,
+ * repopulating before each. The flush removes every gate action in the
+ * namespace, not just the ones created here.
+ */
+int gb_teardown_run(const struct gb_config* cfg, struct gb_teardown_summary* summary);
+void gb_teardown_print_summary(const struct gb_teardown_summary* summary, const struct gb_config* cfg);
+void gb_teardown_summary_free(struct gb_teardown_summary* summary);
+
+#endif /* GATEBENCH_TEARDOWN_H */
@@ -0,0 +1,50 @@
+/* include/gatebench_threads.h
+ * Public API for the multi-threaded write scaling sweep.
+ */
+#ifndef GATEBENCH_THREADS_H
+#define GATEBENCH_THREADS_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stdint.h>
+
+#define GB_THREADS_MAX 1024u
+
+struct gb_threads_worker {
+    uint32_t index; /* Gate action index owned by this thread */
+    int cpu;        /* CPU pinned to (-1 = not pinned) */
+    uint64_t ops;
+    double ops_per_sec;
+    struct gb_latency_summary latency;
+};
+
+/* All N threads run the benchmark loop at once */
+struct gb_threads_step {
+    uint32_t threads; /* N */
+    uint64_t total_ops;
+    double secs;        /* First timed loop start to last timed loop end */
+    double ops_per_sec; /* Aggregate */
+    double efficiency;  /* ops_per_sec / (N * single-thread ops_per_sec) */
+    struct gb_latency_summary latency; /* All threads combined */
+    struct gb_threads_worker* per_worker;
+};
+
+struct gb_threads_summary {
+    uint32_t steps;
+    uint32_t cpus; /* CPUs available for pinning */
+    struct gb_threads_step* per_step;
+};
+
+/*
+ * For N = 1, 2, 4, ... cfg->threads (x2, ending at cfg->threads), run N
+ * threads, each pinned to its own CPU with its own socket and index
+ * (index + thread), through one benchmark run of warmup and iters
+ * iterations, started together. -ERANGE when cfg->threads exceeds the CPUs
+ * this process may run on; workers run unpinned only when that count is
+ * unknown.
+ */
+int gb_threads_run(const struct gb_config* cfg, struct gb_threads_summary* summary);
+void gb_threads_print_summary(const struct gb_threads_summary* summary, const struct gb_config* cfg);
+void gb_threads_summary_free(struct gb_threads_summary* summary);
+
+#endif /* GATEBENCH_THREADS_H */
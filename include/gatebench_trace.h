@@ -0,0 +1,101 @@
+/* include/gatebench_trace.h
+ * Public API for netlink request capture and trace replay.
+ */
+#ifndef GATEBENCH_TRACE_H
+#define GATEBENCH_TRACE_H
+
+#include "gatebench.h"
+#include "gatebench_stats.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Trace file layout: one gb_trace_header followed by records. Each record is
+ * a gb_trace_record and len request bytes, padded to 8 bytes, so a mapped
+ * file can be walked in place.
+ */
+#define GB_TRACE_MAGIC "GBTRACE1"
+#define GB_TRACE_VERSION 1u
+
+/* err of a request whose ack or NLMSG_DONE was never received */
+#define GB_TRACE_ERR_PENDING INT32_MIN
+
+struct gb_trace_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t record_count; /* Written on close; 0 if the capture was cut short */
+    uint32_t threads;      /* Distinct capturing threads (tid 0..threads-1) */
+    uint32_t reserved;
+};
+
+struct gb_trace_record {
+    uint64_t ts_ns; /* CLOCK_MONOTONIC since the capture started */
+    uint32_t tid;   /* Capturing thread, numbered from 0 in first-send order */
+    uint32_t seq;   /* nlmsg_seq as sent */
+    int32_t err;    /* 0 or -errno from the ack, or GB_TRACE_ERR_PENDING */
+    uint32_t len;   /* Request bytes that follow */
+};
+
+/* Start capturing every request sent on sockets opened from now on */
+int gb_trace_open(const char* path);
+
+/* Flush pending records, finalize the header and stop capturing */
+int gb_trace_close(void);
+
+/* A read-only mapping of a trace file */
+struct gb_trace_file {
+    void* map;
+    size_t size;
+    const struct gb_trace_header* hdr;
+};
+
+int gb_trace_map(const char* path, struct gb_trace_file* out);
+void gb_trace_unmap(struct gb_trace_file* file);
+
+/* Walk records; both return NULL at the end or on a truncated record */
+const struct gb_trace_record* gb_trace_first(const struct gb_trace_file* file);
+const struct gb_trace_record* gb_trace_next(const struct gb_trace_file* file, const struct gb_trace_record* rec);
+
+/* Request bytes of a record (rec->len of them) */
+const void* gb_trace_payload(const struct gb_trace_record* rec);
+
+/* Replay pacing */
+enum gb_replay_pace {
+    GB_REPLAY_PACE_ORIGINAL = 0, /* Re-issue at the recorded offsets */
+    GB_REPLAY_PACE_MAX,          /* Back to back on every thread */
+};
+
+const char* gb_replay_pace_name(enum gb_replay_pace pace);
+int gb_replay_pace_parse(const char* name, enum gb_replay_pace* out);
+
+struct gb_replay_thread_summary {
+    uint32_t tid;
+    uint64_t ops;
+    uint64_t errors;     /* Replayed ops that failed */
+    uint64_t mismatches; /* Replayed errno differs from the recorded one */
+    uint64_t late_ns;    /* Largest lag behind the recorded schedule (original pace) */
+    struct gb_latency_summary latency;
+};
+
+struct gb_replay_summary {
+    uint32_t threads;
+    uint64_t records;
+    uint64_t total_ops;
+    uint64_t total_errors;
+    uint64_t total_mismatches;
+    double trace_secs; /* Span of the recorded timestamps */
+    double secs;
+    double ops_per_sec;
+    int pace; /* enum gb_replay_pace */
+    struct gb_latency_summary latency;
+    struct gb_replay_thread_summary* per_thread;
+};
+
+/* Re-issue cfg->replay_path with one socket and thread per recorded thread */
+int gb_replay_run(const struct gb_config* cfg, struct gb_replay_summary* summary);
+void gb_replay_print_summary(const struct gb_replay_summary* summary, const struct gb_config* cfg);
+void gb_replay_summary_free(struct gb_replay_summary* summary);
+
+#endif /* GATEBENCH_TRACE_H */
@@ -9,6 +9,12 @@
 /* CPU pinning */
 int gb_util_pin_cpu(int cpu);
 
+/* Up to max CPUs this process may run on, lowest first; returns how many (0 = unknown). */
+int gb_util_collect_cpus(int* cpus, int max);
+
+/* Number of CPUs this process may run on (0 = unknown). */
+int gb_util_count_cpus(void);
+
 /* High-resolution timing (returns 0 on success, -errno on failure). */
 int gb_util_ns_now(uint64_t* out_ns, int clockid);
 
@@ -21,6 +27,9 @@ int gb_util_get_cpu(int* out_cpu);
 /* Nanosecond sleep (returns 0 on success, -errno on failure). */
 int gb_util_sleep_ns(uint64_t ns);
 
+/* Value of one /proc/meminfo line in kB, e.g. key "Slab" (-ENOENT when absent). */
+int gb_util_meminfo_kb(const char* key, uint64_t* out_kb);
+
 /* String parsing utilities */
 int gb_util_parse_uint64(const char* str, uint64_t* val);
 int gb_util_parse_uint32(const char* str, uint32_t* val);
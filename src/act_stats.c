@@ -0,0 +1,303 @@
+/* src/act_stats.c
+ * Stats flag cost: what per-CPU stats and the hardware stats type add to
+ * creating, replacing and deleting a gate action, in time and memory.
+ */
+#include "../include/gatebench_act_stats.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+enum act_stats_op {
+    ACT_STATS_CREATE,
+    ACT_STATS_REPLACE,
+    ACT_STATS_DELETE,
+    ACT_STATS_OPS,
+};
+
+static const struct {
+    const char* name;
+    struct gate_act_attrs attrs;
+} act_stats_variants[GB_ACT_STATS_VARIANTS] = {
+    {"default", {false, 0, false, 0}},
+    {"no_percpu", {true, TCA_ACT_FLAGS_NO_PERCPU_STATS, false, 0}},
+    {"hw_immediate", {false, 0, true, TCA_ACT_HW_STATS_IMMEDIATE}},
+    {"hw_delayed", {false, 0, true, TCA_ACT_HW_STATS_DELAYED}},
+    {"hw_disabled", {false, 0, true, 0}},
+    {"no_percpu_hw_disabled", {true, TCA_ACT_FLAGS_NO_PERCPU_STATS, true, 0}},
+};
+
+struct act_stats_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    struct gb_nl_msg* msg;
+    struct gb_nl_msg* resp;
+};
+
+static int act_stats_build(struct act_stats_ctx* ctx, enum act_stats_op op, uint32_t index,
+                           const struct gate_act_attrs* attrs) {
+    const struct gb_config* cfg = ctx->cfg;
+
+    gb_nl_msg_reset(ctx->msg);
+    switch (op) {
+        case ACT_STATS_CREATE:
+            return build_gate_newaction_attrs(ctx->msg, index, &ctx->shape, ctx->entries, cfg->entries,
+                                              NLM_F_CREATE | NLM_F_EXCL, 0, -1, attrs);
+        case ACT_STATS_REPLACE:
+            return build_gate_newaction_attrs(ctx->msg, index, &ctx->shape, ctx->entries, cfg->entries,
+                                              NLM_F_CREATE | NLM_F_REPLACE, 0, -1, attrs);
+        default:
+            return build_gate_delaction(ctx->msg, index);
+    }
+}
+
+/* Send op for every action, timing each request */
+static int act_stats_pass(struct act_stats_ctx* ctx,
+                          enum act_stats_op op,
+                          const struct gate_act_attrs* attrs,
+                          struct gb_stats* lat,
+                          uint64_t* errors) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t t0, t1;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->act_stats; i++) {
+        ret = act_stats_build(ctx, op, cfg->index + i, attrs);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, cfg->timeout_ms);
+
+        if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+            return -EIO;
+
+        if (ret < 0) {
+            /* Nothing at all could be created: report it rather than timing errors */
+            if (op == ACT_STATS_CREATE && i == 0)
+                return ret;
+            (*errors)++;
+            continue;
+        }
+
+        ret = gb_stats_add(lat, t1 - t0);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+/*
+ * System-wide Slab and Percpu in kB; false when either line is missing or
+ * on the loopback backend, whose actions live in this process, not the kernel.
+ */
+static bool act_stats_mem(uint64_t* slab_kb, uint64_t* percpu_kb) {
+    if (gb_nl_get_backend() == GB_NL_BACKEND_LOOPBACK)
+        return false;
+    return gb_util_meminfo_kb("Slab", slab_kb) == 0 && gb_util_meminfo_kb("Percpu", percpu_kb) == 0;
+}
+
+/* Drop whatever is left at the benchmark's indices */
+static void act_stats_cleanup(struct act_stats_ctx* ctx) {
+    for (uint32_t i = 0; i < ctx->cfg->act_stats; i++) {
+        if (act_stats_build(ctx, ACT_STATS_DELETE, ctx->cfg->index + i, NULL) == 0)
+            (void)gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, ctx->cfg->timeout_ms);
+    }
+}
+
+static int act_stats_variant(struct act_stats_ctx* ctx, const struct gate_act_attrs* attrs,
+                             struct gb_act_stats_variant* v) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_stats lat[ACT_STATS_OPS];
+    uint64_t slab0, percpu0, slab1, percpu1;
+    bool mem;
+    int ret;
+
+    memset(lat, 0, sizeof(lat));
+    for (int op = 0; op < ACT_STATS_OPS; op++) {
+        ret = gb_stats_init(&lat[op], cfg->act_stats);
+        if (ret < 0)
+            goto out;
+    }
+
+    mem = act_stats_mem(&slab0, &percpu0);
+
+    ret = act_stats_pass(ctx, ACT_STATS_CREATE, attrs, &lat[ACT_STATS_CREATE], &v->create_errors);
+    if (ret < 0) {
+        /* The kernel refused the variant itself, e.g. an unsupported hw stats type */
+        if (lat[ACT_STATS_CREATE].count == 0 && v->create_errors == 0 && ret != -ENOMEM) {
+            v->error = -ret;
+            ret = 0;
+        }
+        goto out;
+    }
+
+    if (mem && act_stats_mem(&slab1, &percpu1)) {
+        v->mem_valid = true;
+        v->slab_bytes = ((double)slab1 - (double)slab0) * 1024.0 / (double)cfg->act_stats;
+        v->percpu_bytes = ((double)percpu1 - (double)percpu0) * 1024.0 / (double)cfg->act_stats;
+    }
+
+    ret = act_stats_pass(ctx, ACT_STATS_REPLACE, attrs, &lat[ACT_STATS_REPLACE], &v->replace_errors);
+    if (ret < 0)
+        goto out;
+
+    ret = act_stats_pass(ctx, ACT_STATS_DELETE, NULL, &lat[ACT_STATS_DELETE], &v->delete_errors);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_summarize(&lat[ACT_STATS_CREATE], &v->create);
+    if (ret == 0)
+        ret = gb_stats_summarize(&lat[ACT_STATS_REPLACE], &v->replace);
+    if (ret == 0)
+        ret = gb_stats_summarize(&lat[ACT_STATS_DELETE], &v->del);
+
+out:
+    for (int op = 0; op < ACT_STATS_OPS; op++)
+        gb_stats_free(&lat[op]);
+    if (ret < 0)
+        act_stats_cleanup(ctx);
+    return ret;
+}
+
+int gb_act_stats_run(const struct gb_config* cfg, struct gb_act_stats_summary* summary) {
+    struct act_stats_ctx ctx;
+    long cpus;
+    int ret;
+
+    if (!cfg || !summary)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    summary->actions = cfg->act_stats;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    summary->cpus = cpus > 0 ? (uint32_t)cpus : 0;
+
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = cfg->entries;
+
+    ctx.entries = calloc(cfg->entries > 0 ? cfg->entries : 1u, sizeof(*ctx.entries));
+    ctx.msg = gb_nl_msg_alloc(gate_msg_capacity(cfg->entries, 0));
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!ctx.entries || !ctx.msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(ctx.entries, cfg->entries, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    act_stats_cleanup(&ctx);
+
+    for (uint32_t k = 0; k < GB_ACT_STATS_VARIANTS; k++) {
+        const struct gate_act_attrs* attrs = &act_stats_variants[k].attrs;
+        struct gb_act_stats_variant* v = &summary->variant[k];
+
+        v->name = act_stats_variants[k].name;
+        v->has_flags = attrs->has_flags;
+        v->flags = attrs->flags;
+        v->has_hw_stats = attrs->has_hw_stats;
+        v->hw_stats = attrs->hw_stats;
+
+        if (!cfg->json)
+            printf("  %-22s ", v->name);
+        fflush(stdout);
+
+        ret = act_stats_variant(&ctx, attrs, v);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->variants = k + 1u;
+
+        if (!cfg->json) {
+            if (v->error != 0)
+                printf("refused: %s\n", strerror(v->error));
+            else
+                printf("done (create p50 %.1f us)\n", (double)v->create.p50_ns / 1e3);
+        }
+    }
+
+out:
+    gb_nl_close(ctx.sock);
+    gb_nl_msg_free(ctx.msg);
+    gb_nl_msg_free(ctx.resp);
+    free(ctx.entries);
+    return ret;
+}
+
+void gb_act_stats_print_summary(const struct gb_act_stats_summary* summary, const struct gb_config* cfg) {
+    const struct gb_act_stats_variant* base;
+
+    if (!summary || !cfg || summary->variants == 0)
+        return;
+
+    base = &summary->variant[0];
+    printf("Stats flags: %u gate actions per variant, %u CPUs; B/act is the system-wide meminfo delta over the "
+           "creates per action (approximate)\n",
+           summary->actions, summary->cpus);
+    printf("  %-22s %11s %11s %11s %11s %9s %11s %11s\n", "variant", "create p50", "create p99", "replace p50",
+           "delete p50", "vs dflt", "~slab B/act", "~pcpu B/act");
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_act_stats_variant* v = &summary->variant[k];
+
+        if (v->error != 0) {
+            printf("  %-22s refused: %s\n", v->name, strerror(v->error));
+            continue;
+        }
+
+        printf("  %-22s %9.1fus %9.1fus %9.1fus %9.1fus", v->name, (double)v->create.p50_ns / 1e3,
+               (double)v->create.p99_ns / 1e3, (double)v->replace.p50_ns / 1e3, (double)v->del.p50_ns / 1e3);
+        if (base->error == 0 && base->create.p50_ns > 0)
+            printf(" %8.1f%%", (double)v->create.p50_ns * 100.0 / (double)base->create.p50_ns);
+        else
+            printf(" %9s", "-");
+        if (v->mem_valid)
+            printf(" %11.0f %11.0f\n", v->slab_bytes, v->percpu_bytes);
+        else
+            printf(" %11s %11s\n", "-", "-");
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_act_stats_variant* v = &summary->variant[k];
+
+        if (v->error != 0)
+            continue;
+
+        printf("  %s: create %llu errors, replace %llu errors, delete %llu errors; delete p99 %.1f us\n", v->name,
+               (unsigned long long)v->create_errors, (unsigned long long)v->replace_errors,
+               (unsigned long long)v->delete_errors, (double)v->del.p99_ns / 1e3);
+    }
+}
@@ -0,0 +1,348 @@
+/* src/auto_index.c
+ * Kernel-allocated indices: what leaving TCA_ACT_INDEX at 0 and reading the
+ * chosen index back through NLM_F_ECHO costs next to pinning explicit ones.
+ */
+#include "../include/gatebench_auto_index.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const struct {
+    const char* name;
+    bool auto_index;
+    bool echo;
+} auto_index_variants[GB_AUTO_INDEX_VARIANTS] = {
+    {"explicit", false, false},
+    {"explicit_echo", false, true},
+    {"auto_echo", true, true},
+};
+
+struct auto_index_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    struct gb_nl_msg* msg;
+    struct gb_nl_msg* resp;
+    uint32_t* indices; /* Index each create ended up at (UINT32_MAX = unknown) */
+    uint32_t* sorted;
+};
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Time one create; *index is the index requested and comes back as the one used */
+static int auto_index_create(struct auto_index_ctx* ctx,
+                             const struct gb_auto_index_variant* v,
+                             uint32_t* index,
+                             uint64_t* ns,
+                             uint32_t* echo_len) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct nlmsghdr* nlh;
+    uint32_t echoed;
+    uint64_t t0, t1;
+    int ret;
+
+    gb_nl_msg_reset(ctx->msg);
+    ret = build_gate_newaction(ctx->msg, v->auto_index ? 0 : *index, &ctx->shape, ctx->entries, cfg->entries,
+                               NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+    if (ret < 0)
+        return ret;
+
+    if (v->echo) {
+        nlh = (struct nlmsghdr*)ctx->msg->buf;
+        nlh->nlmsg_flags |= NLM_F_ECHO;
+    }
+
+    ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+
+    if (v->echo)
+        ret = gb_nl_send_recv_echo(ctx->sock, ctx->msg, ctx->resp, cfg->timeout_ms, &echoed, echo_len);
+    else
+        ret = gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, cfg->timeout_ms);
+
+    if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+        return -EIO;
+    if (ret < 0)
+        return ret;
+
+    *ns = t1 - t0;
+    if (v->echo)
+        *index = echoed;
+    return 0;
+}
+
+/* Delete every known index, timing each request */
+static int auto_index_delete(struct auto_index_ctx* ctx, struct gb_stats* lat, uint64_t* errors) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t t0, t1;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->auto_index; i++) {
+        if (ctx->indices[i] == UINT32_MAX)
+            continue;
+
+        gb_nl_msg_reset(ctx->msg);
+        ret = build_gate_delaction(ctx->msg, ctx->indices[i]);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, cfg->timeout_ms);
+
+        if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+            return -EIO;
+
+        ctx->indices[i] = UINT32_MAX;
+        if (ret < 0) {
+            (*errors)++;
+            continue;
+        }
+
+        if (lat) {
+            ret = gb_stats_add(lat, t1 - t0);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+/* Count echoed indices handed out twice and note the range used */
+static void auto_index_check(struct auto_index_ctx* ctx, struct gb_auto_index_variant* v) {
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < ctx->cfg->auto_index; i++) {
+        if (ctx->indices[i] != UINT32_MAX)
+            ctx->sorted[n++] = ctx->indices[i];
+    }
+    if (n == 0)
+        return;
+
+    qsort(ctx->sorted, n, sizeof(*ctx->sorted), cmp_u32);
+    for (uint32_t i = 1; i < n; i++) {
+        if (ctx->sorted[i] == ctx->sorted[i - 1])
+            v->duplicate_indices++;
+    }
+    v->first_index = ctx->sorted[0];
+    v->last_index = ctx->sorted[n - 1];
+}
+
+static int auto_index_variant(struct auto_index_ctx* ctx, struct gb_auto_index_variant* v) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_stats create, del;
+    uint32_t echo_len;
+    uint64_t ns;
+    int ret;
+
+    memset(&create, 0, sizeof(create));
+    memset(&del, 0, sizeof(del));
+    ret = gb_stats_init(&create, cfg->auto_index);
+    if (ret == 0)
+        ret = gb_stats_init(&del, cfg->auto_index);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < cfg->auto_index; i++) {
+        uint32_t want = cfg->index + i;
+        uint32_t index = want;
+
+        echo_len = 0;
+        ret = auto_index_create(ctx, v, &index, &ns, &echo_len);
+        if (ret < 0) {
+            /* Nothing at all could be created: report it rather than timing errors */
+            if (i == 0 && ret != -ENOMEM) {
+                v->error = -ret;
+                ret = 0;
+                goto out;
+            }
+            if (ret == -ENOMEM)
+                goto out;
+            v->create_errors++;
+            continue;
+        }
+
+        if (v->echo && index == UINT32_MAX) {
+            /* Created, but the index is unknown; explicit ones can still be deleted */
+            v->missing_echoes++;
+            if (!v->auto_index)
+                index = want;
+        } else if (v->echo && !v->auto_index && index != want) {
+            v->wrong_indices++;
+            index = want;
+        }
+        ctx->indices[i] = index;
+        v->echo_bytes += echo_len;
+
+        ret = gb_stats_add(&create, ns);
+        if (ret < 0)
+            goto out;
+    }
+
+    auto_index_check(ctx, v);
+
+    ret = auto_index_delete(ctx, &del, &v->delete_errors);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_summarize(&create, &v->create);
+    if (ret == 0)
+        ret = gb_stats_summarize(&del, &v->del);
+    if (ret == 0 && v->create.mean_ns > 0.0)
+        v->creates_per_sec = 1e9 / v->create.mean_ns;
+
+out:
+    gb_stats_free(&create);
+    gb_stats_free(&del);
+    (void)auto_index_delete(ctx, NULL, &v->delete_errors);
+    return ret;
+}
+
+int gb_auto_index_run(const struct gb_config* cfg, struct gb_auto_index_summary* summary) {
+    struct auto_index_ctx ctx;
+    int ret;
+
+    if (!cfg || !summary)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    summary->actions = cfg->auto_index;
+
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = cfg->entries;
+
+    ctx.entries = calloc(cfg->entries > 0 ? cfg->entries : 1u, sizeof(*ctx.entries));
+    ctx.indices = malloc((size_t)cfg->auto_index * sizeof(*ctx.indices));
+    ctx.sorted = malloc((size_t)cfg->auto_index * sizeof(*ctx.sorted));
+    ctx.msg = gb_nl_msg_alloc(gate_msg_capacity(cfg->entries, 0));
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!ctx.entries || !ctx.indices || !ctx.sorted || !ctx.msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(ctx.entries, cfg->entries, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    /* Drop leftovers at the explicit indices */
+    for (uint32_t i = 0; i < cfg->auto_index; i++)
+        ctx.indices[i] = cfg->index + i;
+    (void)auto_index_delete(&ctx, NULL, &summary->variant[0].delete_errors);
+    summary->variant[0].delete_errors = 0;
+
+    for (uint32_t k = 0; k < GB_AUTO_INDEX_VARIANTS; k++) {
+        struct gb_auto_index_variant* v = &summary->variant[k];
+
+        v->name = auto_index_variants[k].name;
+        v->auto_index = auto_index_variants[k].auto_index;
+        v->echo = auto_index_variants[k].echo;
+
+        if (!cfg->json)
+            printf("  %-14s ", v->name);
+        fflush(stdout);
+
+        ret = auto_index_variant(&ctx, v);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->variants = k + 1u;
+
+        if (!cfg->json) {
+            if (v->error != 0)
+                printf("refused: %s\n", strerror(v->error));
+            else
+                printf("done (create p50 %.1f us)\n", (double)v->create.p50_ns / 1e3);
+        }
+    }
+
+out:
+    gb_nl_close(ctx.sock);
+    gb_nl_msg_free(ctx.msg);
+    gb_nl_msg_free(ctx.resp);
+    free(ctx.sorted);
+    free(ctx.indices);
+    free(ctx.entries);
+    return ret;
+}
+
+void gb_auto_index_print_summary(const struct gb_auto_index_summary* summary, const struct gb_config* cfg) {
+    const struct gb_auto_index_variant* base;
+
+    if (!summary || !cfg || summary->variants == 0)
+        return;
+
+    base = &summary->variant[0];
+    printf("Auto index: %u gate actions per variant\n", summary->actions);
+    printf("  %-14s %11s %11s %11s %9s %11s %9s  %s\n", "variant", "create p50", "create p99", "delete p50",
+           "vs expl", "creates/s", "echo B", "indices");
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_auto_index_variant* v = &summary->variant[k];
+        uint64_t echoed = v->create.count - v->missing_echoes;
+
+        if (v->error != 0) {
+            printf("  %-14s refused: %s\n", v->name, strerror(v->error));
+            continue;
+        }
+
+        printf("  %-14s %9.1fus %9.1fus %9.1fus", v->name, (double)v->create.p50_ns / 1e3,
+               (double)v->create.p99_ns / 1e3, (double)v->del.p50_ns / 1e3);
+        if (base->error == 0 && base->create.p50_ns > 0)
+            printf(" %8.1f%%", (double)v->create.p50_ns * 100.0 / (double)base->create.p50_ns);
+        else
+            printf(" %9s", "-");
+        printf(" %11.0f", v->creates_per_sec);
+        if (v->echo && echoed > 0)
+            printf(" %9.0f", (double)v->echo_bytes / (double)echoed);
+        else
+            printf(" %9s", "-");
+        printf("  %u..%u\n", v->first_index, v->last_index);
+    }
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_auto_index_variant* v = &summary->variant[k];
+
+        if (v->error != 0)
+            continue;
+        if (v->missing_echoes == 0 && v->duplicate_indices == 0 && v->wrong_indices == 0 && !cfg->verbose)
+            continue;
+
+        printf("  %s: %llu missing echoes, %llu duplicate indices, %llu wrong indices; "
+               "create %llu errors, delete %llu errors\n",
+               v->name, (unsigned long long)v->missing_echoes, (unsigned long long)v->duplicate_indices,
+               (unsigned long long)v->wrong_indices, (unsigned long long)v->create_errors,
+               (unsigned long long)v->delete_errors);
+    }
+}
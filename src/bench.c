@@ -68,25 +68,437 @@ static void stats_add_sample(struct gb_stats* stats, const struct gb_config* cfg
         gb_stats_add(stats, latency_ns);
 }
 
-static int benchmark_single_run(struct gb_nl_sock* sock, const struct gb_config* cfg, struct gb_run_result* result) {
+/* Message slots and per-op status for --batch, set up before the timed loop */
+struct bench_batch {
+    struct gb_nl_msg** msgs;
+    int* errs;
+    uint32_t n;
+};
+
+static void bench_batch_free(struct bench_batch* b) {
+    if (b->msgs) {
+        for (uint32_t i = 0; i < b->n; i++) {
+            if (b->msgs[i])
+                gb_nl_msg_free(b->msgs[i]);
+        }
+    }
+    free(b->msgs);
+    free(b->errs);
+    memset(b, 0, sizeof(*b));
+}
+
+/* Alternating create/replace copies; each slot needs its own buffer as the sequence number is written in place */
+static int bench_batch_init(struct bench_batch* b,
+                            uint32_t n,
+                            const struct gb_nl_msg* create_msg,
+                            const struct gb_nl_msg* replace_msg) {
+    memset(b, 0, sizeof(*b));
+    b->msgs = calloc(n, sizeof(*b->msgs));
+    b->errs = calloc(n, sizeof(*b->errs));
+    if (!b->msgs || !b->errs)
+        goto nomem;
+    b->n = n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const struct gb_nl_msg* src = (i % 2u) == 0u ? create_msg : replace_msg;
+
+        b->msgs[i] = gb_nl_msg_alloc(src->len);
+        if (!b->msgs[i])
+            goto nomem;
+        memcpy(b->msgs[i]->buf, src->buf, src->len);
+        b->msgs[i]->len = src->len;
+    }
+    return 0;
+
+nomem:
+    bench_batch_free(b);
+    return -ENOMEM;
+}
+
+/*
+ * Timed loop for --batch: the 2 * iters create/replace ops are packed into
+ * batches of slots->n messages, each sent with one sendmsg. Latency samples
+ * are per batch; per-op errors are attributed through slots->errs.
+ */
+static int benchmark_batched_iters(struct gb_nl_sock* sock,
+                                   const struct gb_config* cfg,
+                                   struct bench_batch* slots,
+                                   struct gb_nl_msg* resp,
+                                   struct gb_stats* stats,
+                                   struct gb_run_result* result) {
+    uint64_t total_ops = (uint64_t)cfg->iters * 2u;
+    uint64_t sent_ops = 0;
+    uint32_t batch_no = 0;
+    uint32_t n = slots->n;
+    int ret;
+
+    while (sent_ops < total_ops) {
+        uint32_t count = (total_ops - sent_ops) < n ? (uint32_t)(total_ops - sent_ops) : n;
+        uint64_t a, b;
+
+        ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+        ret = gb_nl_send_batch(sock, slots->msgs, count, resp, slots->errs, cfg->timeout_ms);
+        if (ret < 0)
+            return ret;
+        ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+
+        for (uint32_t i = 0; i < count; i++) {
+            bool is_create = (i % 2u) == 0u;
+            int err = slots->errs[i];
+
+            if (err == 0 || (is_create && err == -EEXIST))
+                continue;
+
+            if (!cfg->json)
+                fprintf(stderr, "Batch %u op %u (%s) failed: %s\n", batch_no, i, is_create ? "create" : "replace",
+                        gb_nl_strerror(err));
+            return err == GB_NL_BATCH_PENDING ? -ENOMSG : err;
+        }
+
+        stats_add_sample(stats, cfg, batch_no, b - a);
+        sent_ops += count;
+        batch_no++;
+    }
+
+    result->batch_size = n;
+    result->batch_count = batch_no;
+    return 0;
+}
+
+/* Completion array and ack gap samples for --window, set up before the timed loop */
+struct bench_window {
+    struct gb_nl_completion* comps;
+    struct gb_stats gaps;
+};
+
+static void bench_window_free(struct bench_window* w) {
+    free(w->comps);
+    gb_stats_free(&w->gaps);
+    memset(w, 0, sizeof(*w));
+}
+
+static int bench_window_init(struct bench_window* w, struct gb_nl_sock* sock, const struct gb_config* cfg) {
+    int ret;
+
+    memset(w, 0, sizeof(*w));
+    ret = gb_stats_init(&w->gaps, (size_t)cfg->iters * 2u);
+    if (ret < 0)
+        return ret;
+
+    w->comps = calloc(cfg->window, sizeof(*w->comps));
+    if (!w->comps) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_nl_async_init(sock, cfg->window);
+
+out:
+    if (ret < 0)
+        bench_window_free(w);
+    return ret;
+}
+
+/*
+ * Timed loop for --window: keeps up to cfg->window create/replace ops in
+ * flight on sock and reaps acks as they arrive. Latency samples are
+ * issue->ack per op. The ack gap is the interval between acks as this loop
+ * reads them; rtnetlink handles each request inside sendto, so it is the
+ * per-op cost of the submit/reap loop, not kernel service time.
+ */
+static int benchmark_windowed_iters(struct gb_nl_sock* sock,
+                                    const struct gb_config* cfg,
+                                    struct bench_window* w,
+                                    struct gb_nl_msg* create_msg,
+                                    struct gb_nl_msg* replace_msg,
+                                    struct gb_nl_msg* resp,
+                                    struct gb_stats* stats,
+                                    struct gb_run_result* result) {
+    struct gb_nl_completion* comps = w->comps;
+    struct gb_stats* gaps = &w->gaps;
+    uint64_t total_ops = (uint64_t)cfg->iters * 2u;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t last_ack_ns = 0;
+    int ret = 0;
+
+    while (completed < total_ops) {
+        int n;
+
+        while (submitted < total_ops && gb_nl_inflight(sock) < cfg->window) {
+            struct gb_nl_msg* msg = (submitted % 2u) == 0u ? create_msg : replace_msg;
+
+            ret = gb_nl_submit(sock, msg, submitted);
+            if (ret == -EAGAIN)
+                break;
+            if (ret < 0)
+                goto out;
+            submitted++;
+        }
+
+        n = gb_nl_reap(sock, resp, comps, cfg->window, cfg->timeout_ms);
+        if (n < 0) {
+            ret = n;
+            goto out;
+        }
+
+        for (int i = 0; i < n; i++) {
+            const struct gb_nl_completion* c = &comps[i];
+            bool is_create = (c->cookie % 2u) == 0u;
+
+            if (c->err != 0 && !(is_create && c->err == -EEXIST)) {
+                if (!cfg->json)
+                    fprintf(stderr, "Op %llu (%s) failed: %s\n", (unsigned long long)c->cookie,
+                            is_create ? "create" : "replace", gb_nl_strerror(c->err));
+                ret = c->err;
+                goto out;
+            }
+
+            stats_add_sample(stats, cfg, (uint32_t)(c->cookie / 2u), c->latency_ns);
+            completed++;
+        }
+
+        /* Acks reaped from one datagram share a timestamp; spread the gap over them */
+        if (n > 0) {
+            if (last_ack_ns != 0) {
+                uint64_t gap = (comps[0].ack_ns - last_ack_ns) / (uint64_t)n;
+
+                for (int i = 0; i < n; i++)
+                    gb_stats_add(gaps, gap);
+            }
+            last_ack_ns = comps[0].ack_ns;
+        }
+    }
+
+    result->window = cfg->window;
+    if (gaps->count > 0) {
+        ret = gb_stats_percentile(gaps, 0.50, &result->ack_gap_p50_ns);
+        if (ret < 0)
+            goto out;
+    }
+    ret = 0;
+
+out:
+    /* Drain so the socket can be reused synchronously after an error */
+    while (ret < 0 && gb_nl_inflight(sock) > 0) {
+        if (gb_nl_reap(sock, resp, comps, cfg->window, cfg->timeout_ms) < 0)
+            break;
+    }
+    return ret;
+}
+
+/* Phases recorded by benchmark_phased_iters, in struct gb_phase_summary order */
+enum bench_phase {
+    BENCH_PHASE_BUILD = 0,
+    BENCH_PHASE_SEND,
+    BENCH_PHASE_WAIT,
+    BENCH_PHASE_RECV,
+    BENCH_PHASE_PARSE,
+    BENCH_PHASE_STATS,
+    BENCH_PHASE_COUNT,
+};
+
+/*
+ * Timed loop for --phases: the plain create/replace loop, except every op
+ * rebuilds its request and is split into build/send/wait/recv/parse/stats
+ * using the socket's phase timestamps. The latency sample is the
+ * gb_nl_send_recv span (start -> done).
+ */
+static int benchmark_phased_iters(struct gb_nl_sock* sock,
+                                  const struct gb_config* cfg,
+                                  const struct gate_shape* shape,
+                                  const struct gate_entry* entries,
+                                  uint32_t entry_count,
+                                  struct gb_nl_msg* create_msg,
+                                  struct gb_nl_msg* replace_msg,
+                                  struct gb_nl_msg* resp,
+                                  struct gb_stats* stats,
+                                  struct gb_run_result* result) {
+    struct gb_stats phase[BENCH_PHASE_COUNT];
+    struct gb_latency_summary* out[BENCH_PHASE_COUNT] = {
+        &result->phases.build, &result->phases.send,  &result->phases.wait,
+        &result->phases.recv,  &result->phases.parse, &result->phases.stats,
+    };
+    uint64_t total_ops = (uint64_t)cfg->iters * 2u;
+    uint32_t inited = 0;
+    int ret = 0;
+
+    for (inited = 0; inited < BENCH_PHASE_COUNT; inited++) {
+        ret = gb_stats_init(&phase[inited], (size_t)total_ops);
+        if (ret < 0)
+            goto out;
+    }
+
+    gb_nl_set_phase_timing(sock, true);
+
+    for (uint64_t op = 0; op < total_ops; op++) {
+        bool is_create = (op % 2u) == 0u;
+        struct gb_nl_msg* msg = is_create ? create_msg : replace_msg;
+        uint16_t flags = is_create ? (uint16_t)(NLM_F_CREATE | NLM_F_EXCL) : (uint16_t)(NLM_F_CREATE | NLM_F_REPLACE);
+        struct gb_nl_phase_times t;
+        uint64_t b0, b1, s0, s1;
+
+        ret = gb_util_ns_now(&b0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            goto out;
+        ret = build_gate_newaction(msg, cfg->index, shape, entries, entry_count, flags, 0, -1);
+        if (ret < 0)
+            goto out;
+        ret = gb_util_ns_now(&b1, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_send_recv(sock, msg, resp, cfg->timeout_ms);
+        if (ret < 0 && !(is_create && ret == -EEXIST))
+            goto out;
+
+        ret = gb_nl_last_phases(sock, &t);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_util_ns_now(&s0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            goto out;
+        stats_add_sample(stats, cfg, (uint32_t)(op / 2u), t.done_ns - t.start_ns);
+        ret = gb_util_ns_now(&s1, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            goto out;
+
+        gb_stats_add(&phase[BENCH_PHASE_BUILD], b1 - b0);
+        gb_stats_add(&phase[BENCH_PHASE_SEND], t.sent_ns - t.start_ns);
+        gb_stats_add(&phase[BENCH_PHASE_WAIT], t.wake_ns - t.sent_ns);
+        gb_stats_add(&phase[BENCH_PHASE_RECV], t.recvd_ns - t.wake_ns);
+        gb_stats_add(&phase[BENCH_PHASE_PARSE], t.done_ns - t.recvd_ns);
+        gb_stats_add(&phase[BENCH_PHASE_STATS], s1 - s0);
+    }
+
+    for (uint32_t i = 0; i < BENCH_PHASE_COUNT; i++) {
+        ret = gb_stats_summarize(&phase[i], out[i]);
+        if (ret < 0)
+            goto out;
+    }
+
+    result->has_phases = true;
+    ret = 0;
+
+out:
+    gb_nl_set_phase_timing(sock, false);
+    for (uint32_t i = 0; i < inited; i++)
+        gb_stats_free(&phase[i]);
+    return ret;
+}
+
+/* Ops timed by benchmark_cycle_iters, in struct gb_cycle_summary order */
+enum bench_cycle_op {
+    BENCH_CYCLE_CREATE = 0,
+    BENCH_CYCLE_EXISTS,
+    BENCH_CYCLE_REPLACE,
+    BENCH_CYCLE_DELETE,
+    BENCH_CYCLE_COUNT,
+};
+
+/*
+ * Timed loop for --cycle: every iteration creates the action at an absent
+ * index, sends the same create again (which must fail with -EEXIST),
+ * replaces it and deletes it, so each op type gets its own distribution and
+ * "create" really measures create. Every sample also goes into stats.
+ */
+static int benchmark_cycle_iters(struct gb_nl_sock* sock,
+                                 const struct gb_config* cfg,
+                                 struct gb_nl_msg* create_msg,
+                                 struct gb_nl_msg* replace_msg,
+                                 struct gb_nl_msg* del_msg,
+                                 struct gb_nl_msg* resp,
+                                 struct gb_stats* stats,
+                                 struct gb_run_result* result) {
+    static const char* const names[BENCH_CYCLE_COUNT] = {"create", "exists", "replace", "delete"};
+    struct gb_nl_msg* msgs[BENCH_CYCLE_COUNT] = {create_msg, create_msg, replace_msg, del_msg};
+    int expect[BENCH_CYCLE_COUNT] = {0, -EEXIST, 0, 0};
+    struct gb_stats op_stats[BENCH_CYCLE_COUNT];
+    struct gb_latency_summary* out[BENCH_CYCLE_COUNT] = {
+        &result->cycle.create,
+        &result->cycle.exists,
+        &result->cycle.replace,
+        &result->cycle.del,
+    };
+    uint32_t inited = 0;
+    int ret = 0;
+
+    for (inited = 0; inited < BENCH_CYCLE_COUNT; inited++) {
+        ret = gb_stats_init(&op_stats[inited], cfg->iters);
+        if (ret < 0)
+            goto out;
+    }
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        for (uint32_t op = 0; op < BENCH_CYCLE_COUNT; op++) {
+            uint64_t a, b;
+
+            ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+            ret = gb_nl_send_recv(sock, msgs[op], resp, cfg->timeout_ms);
+            if (ret != expect[op]) {
+                if (!cfg->json)
+                    fprintf(stderr, "Cycle %u %s: got %s, expected %s\n", i, names[op], gb_nl_strerror(ret),
+                            gb_nl_strerror(expect[op]));
+                ret = ret < 0 ? ret : -EPROTO;
+                goto out;
+            }
+            ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+
+            stats_add_sample(stats, cfg, i, b - a);
+            gb_stats_add(&op_stats[op], b - a);
+        }
+    }
+
+    for (uint32_t op = 0; op < BENCH_CYCLE_COUNT; op++) {
+        ret = gb_stats_summarize(&op_stats[op], out[op]);
+        if (ret < 0)
+            goto out;
+    }
+
+    result->has_cycle = true;
+    ret = 0;
+
+out:
+    for (uint32_t op = 0; op < inited; op++)
+        gb_stats_free(&op_stats[op]);
+    return ret;
+}
+
+int gb_bench_single_run(struct gb_nl_sock* sock, const struct gb_config* cfg, struct gb_run_result* result) {
     struct gb_nl_msg* create_msg = NULL;
     struct gb_nl_msg* replace_msg = NULL;
     struct gb_nl_msg* del_msg = NULL;
     struct gb_nl_msg* resp = NULL;
+    struct bench_batch batch;
+    struct bench_window window;
     struct gate_shape shape;
     struct gate_entry* entries = NULL;
     uint32_t entry_count;
     struct gb_stats stats;
     size_t create_cap, replace_cap, del_cap;
     uint64_t start_ns, end_ns;
+    uint64_t allocs_start;
+    uint32_t ops_per_iter;
     int ret;
 
     if (!sock || !cfg || !result)
         return -EINVAL;
 
     memset(result, 0, sizeof(*result));
+    memset(&batch, 0, sizeof(batch));
+    memset(&window, 0, sizeof(window));
+    ops_per_iter = cfg->cycle ? BENCH_CYCLE_COUNT : 2u;
 
-    ret = gb_stats_init(&stats, cfg->iters * 2);
+    ret = gb_stats_init(&stats, (size_t)cfg->iters * ops_per_iter);
     if (ret < 0)
         return ret;
 
@@ -97,8 +509,6 @@ static int benchmark_single_run(struct gb_nl_sock* sock, const struct gb_config*
     }
 
     entry_count = cfg->entries;
-    if (entry_count > GB_MAX_ENTRIES)
-        entry_count = GB_MAX_ENTRIES;
 
     memset(&shape, 0, sizeof(shape));
     shape.clockid = cfg->clockid;
@@ -163,49 +573,89 @@ static int benchmark_single_run(struct gb_nl_sock* sock, const struct gb_config*
     if (ret < 0 && ret != -ENOENT)
         goto out;
 
-    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
-    if (ret < 0)
-        goto out;
-
-    for (uint32_t i = 0; i < cfg->iters; i++) {
-        uint64_t a, b;
-
-        ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+    if (cfg->batch > 0) {
+        ret = bench_batch_init(&batch, cfg->batch, create_msg, replace_msg);
         if (ret < 0)
             goto out;
-        ret = gb_nl_send_recv(sock, create_msg, resp, cfg->timeout_ms);
-        if (ret < 0 && ret != -EEXIST)
-            goto out;
-        ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+    }
+    else if (cfg->window > 0) {
+        ret = bench_window_init(&window, sock, cfg);
         if (ret < 0)
             goto out;
+    }
 
-        stats_add_sample(&stats, cfg, i, b - a);
+    allocs_start = gb_nl_alloc_count();
+    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
 
-        ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+    if (cfg->batch > 0) {
+        ret = benchmark_batched_iters(sock, cfg, &batch, resp, &stats, result);
         if (ret < 0)
             goto out;
-        ret = gb_nl_send_recv(sock, replace_msg, resp, cfg->timeout_ms);
+    }
+    else if (cfg->window > 0) {
+        ret = benchmark_windowed_iters(sock, cfg, &window, create_msg, replace_msg, resp, &stats, result);
         if (ret < 0)
             goto out;
-        ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+    }
+    else if (cfg->phases) {
+        ret = benchmark_phased_iters(sock, cfg, &shape, entries, entry_count, create_msg, replace_msg, resp, &stats,
+                                     result);
+        if (ret < 0)
+            goto out;
+    }
+    else if (cfg->cycle) {
+        ret = benchmark_cycle_iters(sock, cfg, create_msg, replace_msg, del_msg, resp, &stats, result);
         if (ret < 0)
             goto out;
-
-        stats_add_sample(&stats, cfg, i, b - a);
+    }
+    else {
+        for (uint32_t i = 0; i < cfg->iters; i++) {
+            uint64_t a, b;
+
+            ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+            ret = gb_nl_send_recv(sock, create_msg, resp, cfg->timeout_ms);
+            if (ret < 0 && ret != -EEXIST)
+                goto out;
+            ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+
+            stats_add_sample(&stats, cfg, i, b - a);
+
+            ret = gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+            ret = gb_nl_send_recv(sock, replace_msg, resp, cfg->timeout_ms);
+            if (ret < 0)
+                goto out;
+            ret = gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                goto out;
+
+            stats_add_sample(&stats, cfg, i, b - a);
+        }
     }
 
     ret = gb_util_ns_now(&end_ns, CLOCK_MONOTONIC_RAW);
     if (ret < 0)
         goto out;
+    if (cfg->iters > 0)
+        result->allocs_per_op =
+            (double)(gb_nl_alloc_count() - allocs_start) / ((double)cfg->iters * (double)ops_per_iter);
 
     ret = gb_nl_send_recv(sock, del_msg, resp, cfg->timeout_ms);
     if (ret < 0 && ret != -ENOENT)
         ret = 0;
 
+    result->start_ns = start_ns;
+    result->end_ns = end_ns;
     result->secs = (double)(end_ns - start_ns) / 1e9;
     if (result->secs > 0.0)
-        result->ops_per_sec = ((double)cfg->iters * 2.0) / result->secs;
+        result->ops_per_sec = ((double)cfg->iters * (double)ops_per_iter) / result->secs;
 
     ret = gb_stats_calculate(&stats, &result->min_ns, &result->max_ns, &result->mean_ns, &result->stddev_ns,
                              &result->p50_ns, &result->p95_ns, &result->p99_ns, &result->p999_ns);
@@ -224,6 +674,8 @@ static int benchmark_single_run(struct gb_nl_sock* sock, const struct gb_config*
     ret = 0;
 
 out:
+    bench_batch_free(&batch);
+    bench_window_free(&window);
     gb_stats_free(&stats);
     free(entries);
 
@@ -239,6 +691,40 @@ out:
     return ret;
 }
 
+static void print_cycle(const struct gb_cycle_summary* cy) {
+    const struct {
+        const char* name;
+        const struct gb_latency_summary* lat;
+    } rows[] = {
+        {"create", &cy->create},
+        {"exists", &cy->exists},
+        {"replace", &cy->replace},
+        {"delete", &cy->del},
+    };
+
+    printf("  %-8s %10s %10s %10s %10s\n", "op", "p50 ns", "p95 ns", "p99 ns", "max ns");
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++)
+        printf("  %-8s %10llu %10llu %10llu %10llu\n", rows[i].name, (unsigned long long)rows[i].lat->p50_ns,
+               (unsigned long long)rows[i].lat->p95_ns, (unsigned long long)rows[i].lat->p99_ns,
+               (unsigned long long)rows[i].lat->max_ns);
+}
+
+static void print_phases(const struct gb_phase_summary* ph) {
+    const struct {
+        const char* name;
+        const struct gb_latency_summary* lat;
+    } rows[] = {
+        {"build", &ph->build}, {"send", &ph->send},   {"wait", &ph->wait},
+        {"recv", &ph->recv},   {"parse", &ph->parse}, {"stats", &ph->stats},
+    };
+
+    printf("  %-6s %10s %10s %10s %10s\n", "phase", "p50 ns", "p95 ns", "p99 ns", "max ns");
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++)
+        printf("  %-6s %10llu %10llu %10llu %10llu\n", rows[i].name, (unsigned long long)rows[i].lat->p50_ns,
+               (unsigned long long)rows[i].lat->p95_ns, (unsigned long long)rows[i].lat->p99_ns,
+               (unsigned long long)rows[i].lat->max_ns);
+}
+
 int gb_bench_run(const struct gb_config* cfg, struct gb_summary* summary) {
     struct gb_nl_sock* sock = NULL;
     struct gb_run_result* runs = NULL;
@@ -271,15 +757,30 @@ int gb_bench_run(const struct gb_config* cfg, struct gb_summary* summary) {
             fflush(stdout);
         }
 
-        ret = benchmark_single_run(sock, cfg, &runs[i]);
+        ret = gb_bench_single_run(sock, cfg, &runs[i]);
         if (ret < 0) {
             if (!cfg->json)
                 printf("failed: %s\n", strerror(-ret));
             goto out;
         }
 
-        if (!cfg->json)
-            printf("done (%.1f ops/sec)\n", runs[i].ops_per_sec);
+        if (!cfg->json) {
+            if (runs[i].batch_size > 0)
+                printf("done (%.1f ops/sec, %u batches of %u, batch p50 %llu ns, %.2f allocs/op)\n",
+                       runs[i].ops_per_sec, runs[i].batch_count, runs[i].batch_size,
+                       (unsigned long long)runs[i].p50_ns, runs[i].allocs_per_op);
+            else if (runs[i].window > 0)
+                printf("done (%.1f ops/sec, window %u, issue->ack p50 %llu ns, ack gap p50 %llu ns, %.2f allocs/op)\n",
+                       runs[i].ops_per_sec, runs[i].window, (unsigned long long)runs[i].p50_ns,
+                       (unsigned long long)runs[i].ack_gap_p50_ns, runs[i].allocs_per_op);
+            else
+                printf("done (%.1f ops/sec, %.2f allocs/op)\n", runs[i].ops_per_sec, runs[i].allocs_per_op);
+
+            if (runs[i].has_phases)
+                print_phases(&runs[i].phases);
+            if (runs[i].has_cycle)
+                print_cycle(&runs[i].cycle);
+        }
     }
 
     summary->runs = runs;
@@ -4,9 +4,43 @@
 #ifndef GATEBENCH_BENCH_INTERNAL_H
 #define GATEBENCH_BENCH_INTERNAL_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "gatebench.h"
 #include "gatebench_gate.h"
 
 int gb_fill_entries(struct gate_entry* entries, uint32_t n, uint64_t interval_ns);
 
+/*
+ * One benchmark run on sock at cfg->index: warmup, then the timed loop
+ * selected by cfg (plain, batch, window, phases or cycle).
+ */
+int gb_bench_single_run(struct gb_nl_sock* sock, const struct gb_config* cfg, struct gb_run_result* result);
+
+/* Creates gate action populations at cfg->index.., several per RTM_NEWACTION (src/populate.c) */
+struct gb_populator {
+    const struct gb_config* cfg;
+    struct gate_shape shape;
+    struct gate_entry* entries; /* cfg->entries slots */
+    uint32_t batch;             /* Actions per create message */
+    struct gb_nl_msg* msg;
+};
+
+int gb_populator_init(struct gb_populator* p, const struct gb_config* cfg);
+
+/*
+ * Create n actions at cfg->index+off..cfg->index+off+n-1, p->batch per message. With
+ * vary_entries, message m carries 1 + m % cfg->entries entries instead of
+ * cfg->entries. Failed batches after the first are counted in *errors; a
+ * failing first batch is returned.
+ */
+int gb_populate(struct gb_populator* p,
+                struct gb_nl_sock* sock,
+                struct gb_nl_msg* resp,
+                uint32_t off,
+                uint32_t n,
+                bool vary_entries,
+                uint64_t* errors);
+void gb_populator_free(struct gb_populator* p);
+
 #endif /* GATEBENCH_BENCH_INTERNAL_H */
@@ -3,6 +3,23 @@
  */
 #include "../include/gatebench.h"
 #include "../include/gatebench_cli.h"
+#include "../include/gatebench_clients.h"
+#include "../include/gatebench_entry_sweep.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_listeners.h"
+#include "../include/gatebench_netns.h"
+#include "../include/gatebench_teardown.h"
+#include "../include/gatebench_dump_pop.h"
+#include "../include/gatebench_act_stats.h"
+#include "../include/gatebench_auto_index.h"
+#include "../include/gatebench_threads.h"
+#include "../include/gatebench_rw.h"
+#include "../include/gatebench_open_loop.h"
+#include "../include/gatebench_slo.h"
+#include "../include/gatebench_mix.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_trace.h"
+#include "../include/gatebench_util.h"
 
 #include <errno.h>
 #include <getopt.h>
@@ -16,7 +33,7 @@
 #define DEFAULT_ITERS 1000u
 #define DEFAULT_WARMUP 100u
 #define DEFAULT_RUNS 5u
-#define DEFAULT_ENTRIES GB_MAX_ENTRIES
+#define DEFAULT_ENTRIES 64u
 #define DEFAULT_INTERVAL_NS 1000000ull /* 1ms */
 #define DEFAULT_INDEX 1000u
 #define DEFAULT_CPU -1
@@ -36,28 +53,66 @@ static const char* usage_str =
     "  -i, --iters=NUM         Iterations per run (default: 1000)\n"
     "  -w, --warmup=NUM        Warmup iterations (default: 100)\n"
     "  -r, --runs=NUM          Number of runs (default: 5)\n"
-    "  -e, --entries=NUM       Number of gate entries (default: 64, max: 64)\n"
+    "  -e, --entries=NUM       Number of gate entries (default: 64, max: 2028)\n"
     "  -I, --interval-ns=NS    Gate interval in nanoseconds (default: 1000000)\n"
     "  -x, --index=NUM         Starting index for gate actions (default: 1000)\n"
+    "  --batch=N               Pack N create/replace ops per sendmsg (default: 0 = off, max: 1024)\n"
+    "  --window=W              Keep W create/replace ops in flight, reaping acks by seq (default: 0 = off, max: 4096)\n"
+    "  --phases                Split each op into build/send/wait/recv/parse/stats percentiles (default: off)\n"
+    "  --cycle                 Time create/EEXIST/replace/delete cycles, one distribution per op (default: off)\n"
     "\n"
     "System options:\n"
     "  -c, --cpu=NUM           CPU to pin to (-1 for no pinning, default: -1)\n"
     "  -t, --timeout-ms=MS     Netlink timeout in milliseconds (default: 1000)\n"
+    "  --backend=NAME          Netlink transport: syscall, io_uring or loopback (default: syscall)\n"
+    "  --loopback-service=SPEC Loopback model service time: none, fixed:NS, uniform:MIN:MAX or exp:MEAN\n"
     "\n"
     "Gate shape options:\n"
     "  --clockid=ID            Clock ID (default: CLOCK_TAI)\n"
     "  --base-time=NS          Base time for gate schedule (default: 0)\n"
     "  --cycle-time=NS         Cycle time for gate schedule (default: 0)\n"
     "  --cycle-time-ext=NS     Cycle time extension (default: 0)\n"
-    "\n"
+    "\n";
+
+/* Split in two: ISO C only guarantees string literals up to 4095 bytes */
+static const char* usage_modes_str =
     "Mode options:\n"
     "  -j, --json              Output JSON format (default: off)\n"
     "  --sample-every=N        Sample every N iterations (default: 0 = off)\n"
     "  --dump-proof            Run RTM_GETACTION dump proof harness (default: off)\n"
     "  --pcap=PATH             Write nlmon capture to PATH (default: off)\n"
     "  --nlmon-iface=NAME      nlmon interface for capture (default: nlmon0)\n"
+    "  --dump-pipeline         Dump proof receives the next page while parsing the last (default: off)\n"
     "  --race                  Run race workload mode (replace/dump/get/basetime/traffic/delete/invalid threads)\n"
     "  --seconds=NUM           Race mode duration in seconds (default: 60)\n"
+    "  --clients=N             Drive N clients (own socket and index each) from one epoll loop (max: 1024)\n"
+    "  --listeners=K           Sweep 0, 1, 2, 4, ... K RTNLGRP_TC listeners during create/replace (max: 256)\n"
+    "  --netns=N               Run N create/replace workers in one network namespace, then one namespace each\n"
+    "                          (enters a user namespace when unprivileged; max: 256)\n"
+    "  --entry-sweep=MAX       Time REPLACE and GET with 1, 2, 4, ... MAX gate entries (max: 2028)\n"
+    "  --multi-actions=K       Time create/get/delete of 1, 2, 4, ... K actions per message (max: 32)\n"
+    "  --teardown=N            Time deleting up to N gate actions singly, batched and by flush (max: 1000000)\n"
+    "  --dump-population=N     Create N gate actions with 1..entries entries and time dumping them all\n"
+    "                          (runs timed dumps, full and terse; honours --dump-pipeline; max: 1000000)\n"
+    "  --dump-delta=MS         With --dump-population, also time dumps filtered to actions used in the last MS\n"
+    "  --act-stats=N           Time create/replace/delete of N actions per stats flag variant (max: 100000)\n"
+    "  --auto-index=N          Time creating N actions at explicit vs kernel-allocated indices (max: 100000)\n"
+    "  --threads=N             Run the benchmark loop on 1, 2, 4, ... N pinned threads at once (max: CPU count)\n"
+    "  --rw-grid=M,R           Time GETs and replaces of shared actions for 0..M writers x 0..R readers (max: 256)\n"
+    "  --rw-indices=K          Gate actions shared by --rw-grid readers and writers (default: 1)\n"
+    "  --rw-ms=MS              Duration of each --rw-grid cell (default: 1000)\n"
+    "  --rate=OPS              Open loop: issue iters replaces at OPS/sec, latency from each op's due time\n"
+    "  --arrivals=KIND         Open-loop arrivals: constant or poisson (default: constant)\n"
+    "  --slo=NS                Search the highest open-loop rate whose response latency stays within NS\n"
+    "                          (starts at --rate or 1000 ops/sec, iters replaces per probe)\n"
+    "  --slo-pct=P             Percentile held to --slo: 50, 95, 99 or 99.9 (default: 99)\n"
+    "  --mix=SPEC              Run a weighted op mix, e.g. get=70,replace=25,delete=5\n"
+    "                          (ops: create, replace, update, get, dump, delete)\n"
+    "  --hot-set=N             Indices the --mix ops draw from (default: 64, max: 65536)\n"
+    "  --zipf=S                Zipf popularity exponent of the --mix indices (default: 0, uniform)\n"
+    "  --trace=PATH            Capture every request sent (any mode) to a replayable trace file\n"
+    "  --replay=PATH           Replay a trace, one thread per recorded thread, instead of a workload\n"
+    "  --replay-pace=PACE      Replay pacing: original (recorded timing) or max (default: original)\n"
     "  --verbose               Show configuration, environment, and selftest details\n"
     "\n"
     "Other options:\n"
@@ -84,6 +139,37 @@ static const struct option long_options[] = {
     {"race", no_argument, NULL, 264},
     {"seconds", required_argument, NULL, 265},
     {"verbose", no_argument, NULL, 266},
+    {"batch", required_argument, NULL, 267},
+    {"window", required_argument, NULL, 268},
+    {"backend", required_argument, NULL, 269},
+    {"clients", required_argument, NULL, 270},
+    {"phases", no_argument, NULL, 271},
+    {"loopback-service", required_argument, NULL, 272},
+    {"trace", required_argument, NULL, 273},
+    {"replay", required_argument, NULL, 274},
+    {"replay-pace", required_argument, NULL, 275},
+    {"listeners", required_argument, NULL, 276},
+    {"netns", required_argument, NULL, 277},
+    {"entry-sweep", required_argument, NULL, 278},
+    {"dump-pipeline", no_argument, NULL, 279},
+    {"multi-actions", required_argument, NULL, 280},
+    {"teardown", required_argument, NULL, 281},
+    {"dump-population", required_argument, NULL, 282},
+    {"dump-delta", required_argument, NULL, 283},
+    {"act-stats", required_argument, NULL, 284},
+    {"cycle", no_argument, NULL, 285},
+    {"auto-index", required_argument, NULL, 286},
+    {"threads", required_argument, NULL, 287},
+    {"rw-grid", required_argument, NULL, 288},
+    {"rw-indices", required_argument, NULL, 289},
+    {"rw-ms", required_argument, NULL, 290},
+    {"rate", required_argument, NULL, 291},
+    {"arrivals", required_argument, NULL, 292},
+    {"slo", required_argument, NULL, 293},
+    {"slo-pct", required_argument, NULL, 294},
+    {"mix", required_argument, NULL, 295},
+    {"hot-set", required_argument, NULL, 296},
+    {"zipf", required_argument, NULL, 297},
     {"json", no_argument, NULL, 'j'},
     {"help", no_argument, NULL, 'h'},
     {"version", no_argument, NULL, 'v'},
@@ -92,6 +178,7 @@ static const struct option long_options[] = {
 
 static void print_usage(void) {
     fputs(usage_str, stdout);
+    fputs(usage_modes_str, stdout);
 }
 
 static void print_version(void) {
@@ -116,6 +203,33 @@ static int parse_u32(const char* str, uint32_t* out, const char* name) {
     return 0;
 }
 
+/* "A,B" into two u32 values */
+static int parse_u32_pair(const char* str, uint32_t* a, uint32_t* b, const char* name) {
+    char* end = NULL;
+    unsigned long v, w;
+
+    if (!str || !a || !b)
+        return -EINVAL;
+
+    errno = 0;
+    v = strtoul(str, &end, 10);
+    if (errno != 0 || end == str || *end != ',' || v > UINT32_MAX)
+        goto invalid;
+
+    str = end + 1;
+    w = strtoul(str, &end, 10);
+    if (errno != 0 || end == str || *end != '\0' || w > UINT32_MAX)
+        goto invalid;
+
+    *a = (uint32_t)v;
+    *b = (uint32_t)w;
+    return 0;
+
+invalid:
+    fprintf(stderr, "Error: Invalid value for %s: %s (expected A,B)\n", name, str);
+    return -EINVAL;
+}
+
 static int parse_u64(const char* str, uint64_t* out, const char* name) {
     char* end = NULL;
     unsigned long long v;
@@ -170,12 +284,44 @@ void gb_config_init(struct gb_config* cfg) {
     cfg->dump_proof = false;
     cfg->pcap_path = NULL;
     cfg->nlmon_iface = DEFAULT_NLMON_IFACE;
+    cfg->dump_pipeline = false;
     cfg->clockid = DEFAULT_CLOCKID;
     cfg->base_time = DEFAULT_BASE_TIME;
     cfg->cycle_time = DEFAULT_CYCLE_TIME;
     cfg->cycle_time_ext = 0;
     cfg->race_mode = false;
     cfg->race_seconds = DEFAULT_RACE_SECONDS;
+    cfg->batch = 0;
+    cfg->window = 0;
+    cfg->nl_backend = GB_NL_BACKEND_SYSCALL;
+    cfg->loopback_service = NULL;
+    cfg->clients = 0;
+    cfg->listeners = 0;
+    cfg->netns = 0;
+    cfg->entry_sweep = 0;
+    cfg->multi_actions = 0;
+    cfg->teardown = 0;
+    cfg->dump_pop = 0;
+    cfg->dump_delta = 0;
+    cfg->act_stats = 0;
+    cfg->auto_index = 0;
+    cfg->threads = 0;
+    cfg->rw_writers = 0;
+    cfg->rw_readers = 0;
+    cfg->rw_indices = 1;
+    cfg->rw_ms = GB_RW_MS_DEFAULT;
+    cfg->rate = 0;
+    cfg->arrivals = GB_ARRIVALS_CONSTANT;
+    cfg->slo_ns = 0;
+    cfg->slo_pct = GB_SLO_PCT_DEFAULT;
+    cfg->mix = NULL;
+    cfg->hot_set = GB_MIX_HOT_SET_DEFAULT;
+    cfg->zipf = 0.0;
+    cfg->phases = false;
+    cfg->cycle = false;
+    cfg->trace_path = NULL;
+    cfg->replay_path = NULL;
+    cfg->replay_pace = GB_REPLAY_PACE_ORIGINAL;
 }
 
 void gb_config_print(const struct gb_config* cfg) {
@@ -190,6 +336,9 @@ void gb_config_print(const struct gb_config* cfg) {
     if (cfg->cpu >= 0)
         printf("  CPU:                %d\n", cfg->cpu);
     printf("  Netlink timeout:    %d ms\n", cfg->timeout_ms);
+    printf("  Netlink backend:    %s\n", gb_nl_backend_name((enum gb_nl_backend)cfg->nl_backend));
+    if (cfg->loopback_service)
+        printf("  Loopback service:   %s\n", cfg->loopback_service);
     printf("  JSON output:        %s\n", cfg->json ? "yes" : "no");
     printf("  Sampling:           %s\n", cfg->sample_mode ? "yes" : "no");
     if (cfg->sample_mode)
@@ -198,10 +347,75 @@ void gb_config_print(const struct gb_config* cfg) {
     if (cfg->dump_proof) {
         printf("  nlmon iface:        %s\n", cfg->nlmon_iface ? cfg->nlmon_iface : "(none)");
         printf("  pcap output:        %s\n", cfg->pcap_path ? cfg->pcap_path : "(disabled)");
+        printf("  Dump pipeline:      %s\n", cfg->dump_pipeline ? "yes" : "no");
     }
     printf("  Race mode:          %s\n", cfg->race_mode ? "yes" : "no");
     if (cfg->race_mode)
         printf("  Race duration:      %u seconds\n", cfg->race_seconds);
+    printf("  Batch mode:         %s\n", cfg->batch > 0 ? "yes" : "no");
+    if (cfg->batch > 0)
+        printf("  Ops per batch:      %u\n", cfg->batch);
+    printf("  Pipelined mode:     %s\n", cfg->window > 0 ? "yes" : "no");
+    if (cfg->window > 0)
+        printf("  In-flight window:   %u\n", cfg->window);
+    printf("  Phase breakdown:    %s\n", cfg->phases ? "yes" : "no");
+    printf("  Op cycle:           %s\n", cfg->cycle ? "yes" : "no");
+    printf("  Trace capture:      %s\n", cfg->trace_path ? cfg->trace_path : "(disabled)");
+    printf("  Replay:             %s\n", cfg->replay_path ? cfg->replay_path : "(disabled)");
+    if (cfg->replay_path)
+        printf("  Replay pace:        %s\n", gb_replay_pace_name((enum gb_replay_pace)cfg->replay_pace));
+    printf("  Clients mode:       %s\n", cfg->clients > 0 ? "yes" : "no");
+    if (cfg->clients > 0)
+        printf("  Clients:            %u\n", cfg->clients);
+    printf("  Listener sweep:     %s\n", cfg->listeners > 0 ? "yes" : "no");
+    if (cfg->listeners > 0)
+        printf("  Max listeners:      %u\n", cfg->listeners);
+    printf("  Namespace scaling:  %s\n", cfg->netns > 0 ? "yes" : "no");
+    if (cfg->netns > 0)
+        printf("  Namespace workers:  %u\n", cfg->netns);
+    printf("  Entry sweep:        %s\n", cfg->entry_sweep > 0 ? "yes" : "no");
+    if (cfg->entry_sweep > 0)
+        printf("  Max sweep entries:  %u\n", cfg->entry_sweep);
+    printf("  Multi-action sweep: %s\n", cfg->multi_actions > 0 ? "yes" : "no");
+    if (cfg->multi_actions > 0)
+        printf("  Max actions/msg:    %u\n", cfg->multi_actions);
+    printf("  Teardown:           %s\n", cfg->teardown > 0 ? "yes" : "no");
+    if (cfg->teardown > 0)
+        printf("  Max population:     %u\n", cfg->teardown);
+    printf("  Dump population:    %s\n", cfg->dump_pop > 0 ? "yes" : "no");
+    if (cfg->dump_pop > 0)
+        printf("  Dumped actions:     %u\n", cfg->dump_pop);
+    if (cfg->dump_delta > 0)
+        printf("  Dump time delta:    %u ms\n", cfg->dump_delta);
+    printf("  Stats flags:        %s\n", cfg->act_stats > 0 ? "yes" : "no");
+    if (cfg->act_stats > 0)
+        printf("  Actions/variant:    %u\n", cfg->act_stats);
+    printf("  Auto index:         %s\n", cfg->auto_index > 0 ? "yes" : "no");
+    if (cfg->auto_index > 0)
+        printf("  Actions/variant:    %u\n", cfg->auto_index);
+    printf("  Write scaling:      %s\n", cfg->threads > 0 ? "yes" : "no");
+    if (cfg->threads > 0)
+        printf("  Max threads:        %u\n", cfg->threads);
+    printf("  Reader/writer grid: %s\n", cfg->rw_writers + cfg->rw_readers > 0 ? "yes" : "no");
+    if (cfg->rw_writers + cfg->rw_readers > 0) {
+        printf("  Writers x readers:  %u x %u\n", cfg->rw_writers, cfg->rw_readers);
+        printf("  Shared actions:     %u\n", cfg->rw_indices);
+        printf("  Cell duration:      %u ms\n", cfg->rw_ms);
+    }
+    printf("  Open loop:          %s\n", cfg->rate > 0 ? "yes" : "no");
+    if (cfg->rate > 0) {
+        printf("  Offered rate:       %u ops/sec\n", cfg->rate);
+        printf("  Arrivals:           %s\n", gb_arrivals_name((enum gb_arrivals)cfg->arrivals));
+    }
+    printf("  SLO search:         %s\n", cfg->slo_ns > 0 ? "yes" : "no");
+    if (cfg->slo_ns > 0)
+        printf("  SLO:                p%.1f <= %llu ns\n", (double)cfg->slo_pct / 10.0,
+               (unsigned long long)cfg->slo_ns);
+    printf("  Op mix:             %s\n", cfg->mix ? cfg->mix : "no");
+    if (cfg->mix) {
+        printf("  Hot set:            %u\n", cfg->hot_set);
+        printf("  Zipf exponent:      %.2f\n", cfg->zipf);
+    }
     printf("  Clock ID:           %u\n", cfg->clockid);
     printf("  Base time:          %llu ns\n", (unsigned long long)cfg->base_time);
     printf("  Cycle time:         %llu ns\n", (unsigned long long)cfg->cycle_time);
@@ -209,9 +423,146 @@ void gb_config_print(const struct gb_config* cfg) {
     printf("\n");
 }
 
+/* Top-level modes, in the order main dispatches them; at most one may be selected */
+enum cli_mode {
+    CLI_MODE_REPLAY = 0,
+    CLI_MODE_RACE,
+    CLI_MODE_DUMP_PROOF,
+    CLI_MODE_CLIENTS,
+    CLI_MODE_LISTENERS,
+    CLI_MODE_NETNS,
+    CLI_MODE_ENTRY_SWEEP,
+    CLI_MODE_MULTI_ACTIONS,
+    CLI_MODE_TEARDOWN,
+    CLI_MODE_DUMP_POP,
+    CLI_MODE_ACT_STATS,
+    CLI_MODE_AUTO_INDEX,
+    CLI_MODE_THREADS,
+    CLI_MODE_RW,
+    CLI_MODE_SLO,
+    CLI_MODE_OPEN_LOOP,
+    CLI_MODE_MIX,
+    CLI_MODES, /* None: the plain benchmark */
+};
+
+static const char* const cli_mode_flags[CLI_MODES] = {
+    "--replay",
+    "--race",
+    "--dump-proof (or --pcap, --dump-pipeline)",
+    "--clients",
+    "--listeners",
+    "--netns",
+    "--entry-sweep",
+    "--multi-actions",
+    "--teardown",
+    "--dump-population",
+    "--act-stats",
+    "--auto-index",
+    "--threads",
+    "--rw-grid",
+    "--slo",
+    "--rate",
+    "--mix",
+};
+
+static void cli_modes_selected(const struct gb_config* cfg, bool on[CLI_MODES]) {
+    on[CLI_MODE_REPLAY] = cfg->replay_path != NULL;
+    on[CLI_MODE_RACE] = cfg->race_mode;
+    on[CLI_MODE_DUMP_PROOF] = cfg->dump_proof;
+    on[CLI_MODE_CLIENTS] = cfg->clients > 0;
+    on[CLI_MODE_LISTENERS] = cfg->listeners > 0;
+    on[CLI_MODE_NETNS] = cfg->netns > 0;
+    on[CLI_MODE_ENTRY_SWEEP] = cfg->entry_sweep > 0;
+    on[CLI_MODE_MULTI_ACTIONS] = cfg->multi_actions > 0;
+    on[CLI_MODE_TEARDOWN] = cfg->teardown > 0;
+    on[CLI_MODE_DUMP_POP] = cfg->dump_pop > 0;
+    on[CLI_MODE_ACT_STATS] = cfg->act_stats > 0;
+    on[CLI_MODE_AUTO_INDEX] = cfg->auto_index > 0;
+    on[CLI_MODE_THREADS] = cfg->threads > 0;
+    on[CLI_MODE_RW] = cfg->rw_writers + cfg->rw_readers > 0;
+    on[CLI_MODE_SLO] = cfg->slo_ns > 0;
+    /* --slo starts its search at --rate */
+    on[CLI_MODE_OPEN_LOOP] = cfg->rate > 0 && cfg->slo_ns == 0;
+    on[CLI_MODE_MIX] = cfg->mix != NULL;
+}
+
+/*
+ * Reject more than one top-level mode, and the plain-loop options --batch,
+ * --window, --phases and --cycle outside the plain benchmark (--threads
+ * runs that loop too, except --phases).
+ */
+static int check_modes(const struct gb_config* cfg) {
+    bool on[CLI_MODES];
+    enum cli_mode mode = CLI_MODES;
+    uint32_t selected = 0;
+
+    cli_modes_selected(cfg, on);
+    for (uint32_t k = 0; k < CLI_MODES; k++) {
+        if (!on[k])
+            continue;
+        if (selected++ == 0)
+            mode = (enum cli_mode)k;
+    }
+
+    if (selected > 1) {
+        const char* sep = "";
+
+        fprintf(stderr, "Error: only one mode may be selected, got");
+        for (uint32_t k = 0; k < CLI_MODES; k++) {
+            if (on[k]) {
+                fprintf(stderr, "%s %s", sep, cli_mode_flags[k]);
+                sep = ",";
+            }
+        }
+        fprintf(stderr, "\n       (modes: ");
+        for (uint32_t k = 0; k < CLI_MODES; k++)
+            fprintf(stderr, "%s%s", k > 0 ? ", " : "", cli_mode_flags[k]);
+        fprintf(stderr, ")\n");
+        return -EINVAL;
+    }
+
+    if (cfg->batch > 0 && cfg->window > 0) {
+        fprintf(stderr, "Error: --batch and --window are mutually exclusive\n");
+        return -EINVAL;
+    }
+
+    if (cfg->phases && (cfg->batch > 0 || cfg->window > 0)) {
+        fprintf(stderr, "Error: --phases times one op at a time and cannot be combined with --batch or --window\n");
+        return -EINVAL;
+    }
+
+    if (cfg->cycle && (cfg->batch > 0 || cfg->window > 0 || cfg->phases)) {
+        fprintf(stderr, "Error: --cycle changes the plain benchmark loop and cannot be combined with --batch, "
+                        "--window or --phases\n");
+        return -EINVAL;
+    }
+
+    if (mode != CLI_MODES && (cfg->batch > 0 || cfg->window > 0 || cfg->cycle || cfg->phases) &&
+        (mode != CLI_MODE_THREADS || cfg->phases)) {
+        fprintf(stderr, "Error: --batch, --window, --phases and --cycle change the plain benchmark loop and cannot be "
+                        "combined with %s\n",
+                cli_mode_flags[mode]);
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
 int gb_cli_parse(int argc, char* argv[], struct gb_config* cfg) {
     int opt;
+    int ret;
     int option_index = 0;
+    enum gb_nl_backend backend;
+    struct gb_nl_service service;
+    enum gb_replay_pace pace;
+    bool pace_set = false;
+    bool rw_set = false;
+    bool arrivals_set = false;
+    bool slo_pct_set = false;
+    bool mix_set = false;
+    uint32_t mix_weights[GB_MIX_OPS];
+    char* end = NULL;
+    enum gb_arrivals arrivals;
 
     gb_config_init(cfg);
 
@@ -300,6 +651,243 @@ int gb_cli_parse(int argc, char* argv[], struct gb_config* cfg) {
             case 266:
                 cfg->verbose = true;
                 break;
+            case 267:
+                if (parse_u32(optarg, &cfg->batch, "batch") < 0)
+                    return -EINVAL;
+                if (cfg->batch == 0 || cfg->batch > GB_NL_BATCH_MAX) {
+                    fprintf(stderr, "Error: batch must be between 1 and %u\n", GB_NL_BATCH_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 268:
+                if (parse_u32(optarg, &cfg->window, "window") < 0)
+                    return -EINVAL;
+                if (cfg->window == 0 || cfg->window > GB_NL_WINDOW_MAX) {
+                    fprintf(stderr, "Error: window must be between 1 and %u\n", GB_NL_WINDOW_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 269:
+                if (gb_nl_backend_parse(optarg, &backend) < 0) {
+                    fprintf(stderr, "Error: unknown backend '%s' (expected syscall, io_uring or loopback)\n", optarg);
+                    return -EINVAL;
+                }
+                cfg->nl_backend = (int)backend;
+                break;
+            case 270:
+                if (parse_u32(optarg, &cfg->clients, "clients") < 0)
+                    return -EINVAL;
+                if (cfg->clients == 0 || cfg->clients > GB_CLIENTS_MAX) {
+                    fprintf(stderr, "Error: clients must be between 1 and %u\n", GB_CLIENTS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 271:
+                cfg->phases = true;
+                break;
+            case 272:
+                if (gb_nl_service_parse(optarg, &service) < 0) {
+                    fprintf(stderr, "Error: invalid loopback service '%s' (expected none, fixed:NS, uniform:MIN:MAX "
+                                    "or exp:MEAN)\n", optarg);
+                    return -EINVAL;
+                }
+                cfg->loopback_service = optarg;
+                break;
+            case 273:
+                cfg->trace_path = optarg;
+                break;
+            case 274:
+                cfg->replay_path = optarg;
+                break;
+            case 275:
+                if (gb_replay_pace_parse(optarg, &pace) < 0) {
+                    fprintf(stderr, "Error: unknown replay pace '%s' (expected original or max)\n", optarg);
+                    return -EINVAL;
+                }
+                cfg->replay_pace = (int)pace;
+                pace_set = true;
+                break;
+            case 276:
+                if (parse_u32(optarg, &cfg->listeners, "listeners") < 0)
+                    return -EINVAL;
+                if (cfg->listeners == 0 || cfg->listeners > GB_LISTENERS_MAX) {
+                    fprintf(stderr, "Error: listeners must be between 1 and %u\n", GB_LISTENERS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 277:
+                if (parse_u32(optarg, &cfg->netns, "netns") < 0)
+                    return -EINVAL;
+                if (cfg->netns == 0 || cfg->netns > GB_NETNS_MAX) {
+                    fprintf(stderr, "Error: netns must be between 1 and %u\n", GB_NETNS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 278:
+                if (parse_u32(optarg, &cfg->entry_sweep, "entry-sweep") < 0)
+                    return -EINVAL;
+                if (cfg->entry_sweep == 0 || cfg->entry_sweep > GB_MAX_ENTRIES) {
+                    fprintf(stderr, "Error: entry-sweep must be between 1 and %u\n", GB_MAX_ENTRIES);
+                    return -EINVAL;
+                }
+                break;
+            case 279:
+                cfg->dump_pipeline = true;
+                break;
+            case 280:
+                if (parse_u32(optarg, &cfg->multi_actions, "multi-actions") < 0)
+                    return -EINVAL;
+                if (cfg->multi_actions == 0 || cfg->multi_actions > GB_MULTI_ACTIONS_MAX) {
+                    fprintf(stderr, "Error: multi-actions must be between 1 and %u\n", GB_MULTI_ACTIONS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 281:
+                if (parse_u32(optarg, &cfg->teardown, "teardown") < 0)
+                    return -EINVAL;
+                if (cfg->teardown == 0 || cfg->teardown > GB_TEARDOWN_MAX) {
+                    fprintf(stderr, "Error: teardown must be between 1 and %u\n", GB_TEARDOWN_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 282:
+                if (parse_u32(optarg, &cfg->dump_pop, "dump-population") < 0)
+                    return -EINVAL;
+                if (cfg->dump_pop == 0 || cfg->dump_pop > GB_DUMP_POP_MAX) {
+                    fprintf(stderr, "Error: dump-population must be between 1 and %u\n", GB_DUMP_POP_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 283:
+                if (parse_u32(optarg, &cfg->dump_delta, "dump-delta") < 0)
+                    return -EINVAL;
+                if (cfg->dump_delta == 0) {
+                    fprintf(stderr, "Error: dump-delta must be at least 1 ms\n");
+                    return -EINVAL;
+                }
+                break;
+            case 284:
+                if (parse_u32(optarg, &cfg->act_stats, "act-stats") < 0)
+                    return -EINVAL;
+                if (cfg->act_stats == 0 || cfg->act_stats > GB_ACT_STATS_MAX) {
+                    fprintf(stderr, "Error: act-stats must be between 1 and %u\n", GB_ACT_STATS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 285:
+                cfg->cycle = true;
+                break;
+            case 286:
+                if (parse_u32(optarg, &cfg->auto_index, "auto-index") < 0)
+                    return -EINVAL;
+                if (cfg->auto_index == 0 || cfg->auto_index > GB_AUTO_INDEX_MAX) {
+                    fprintf(stderr, "Error: auto-index must be between 1 and %u\n", GB_AUTO_INDEX_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 287:
+                if (parse_u32(optarg, &cfg->threads, "threads") < 0)
+                    return -EINVAL;
+                if (cfg->threads == 0 || cfg->threads > GB_THREADS_MAX) {
+                    fprintf(stderr, "Error: threads must be between 1 and %u\n", GB_THREADS_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 288:
+                if (parse_u32_pair(optarg, &cfg->rw_writers, &cfg->rw_readers, "rw-grid") < 0)
+                    return -EINVAL;
+                if (cfg->rw_writers > GB_RW_MAX || cfg->rw_readers > GB_RW_MAX ||
+                    cfg->rw_writers + cfg->rw_readers == 0) {
+                    fprintf(stderr, "Error: rw-grid writers and readers must be at most %u, not both 0\n", GB_RW_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 289:
+                if (parse_u32(optarg, &cfg->rw_indices, "rw-indices") < 0)
+                    return -EINVAL;
+                if (cfg->rw_indices == 0 || cfg->rw_indices > GB_RW_INDICES_MAX) {
+                    fprintf(stderr, "Error: rw-indices must be between 1 and %u\n", GB_RW_INDICES_MAX);
+                    return -EINVAL;
+                }
+                rw_set = true;
+                break;
+            case 290:
+                if (parse_u32(optarg, &cfg->rw_ms, "rw-ms") < 0)
+                    return -EINVAL;
+                if (cfg->rw_ms == 0) {
+                    fprintf(stderr, "Error: rw-ms must be at least 1 ms\n");
+                    return -EINVAL;
+                }
+                rw_set = true;
+                break;
+            case 291:
+                if (parse_u32(optarg, &cfg->rate, "rate") < 0)
+                    return -EINVAL;
+                if (cfg->rate == 0 || cfg->rate > GB_OPEN_LOOP_RATE_MAX) {
+                    fprintf(stderr, "Error: rate must be between 1 and %u ops/sec\n", GB_OPEN_LOOP_RATE_MAX);
+                    return -EINVAL;
+                }
+                break;
+            case 292:
+                if (gb_arrivals_parse(optarg, &arrivals) < 0) {
+                    fprintf(stderr, "Error: Invalid arrivals: %s (expected constant or poisson)\n", optarg);
+                    return -EINVAL;
+                }
+                cfg->arrivals = (int)arrivals;
+                arrivals_set = true;
+                break;
+            case 293:
+                if (parse_u64(optarg, &cfg->slo_ns, "slo") < 0)
+                    return -EINVAL;
+                if (cfg->slo_ns == 0) {
+                    fprintf(stderr, "Error: slo must be at least 1 ns\n");
+                    return -EINVAL;
+                }
+                break;
+            case 294:
+                if (strcmp(optarg, "50") == 0)
+                    cfg->slo_pct = 500;
+                else if (strcmp(optarg, "95") == 0)
+                    cfg->slo_pct = 950;
+                else if (strcmp(optarg, "99") == 0)
+                    cfg->slo_pct = 990;
+                else if (strcmp(optarg, "99.9") == 0)
+                    cfg->slo_pct = 999;
+                else {
+                    fprintf(stderr, "Error: Invalid slo-pct: %s (expected 50, 95, 99 or 99.9)\n", optarg);
+                    return -EINVAL;
+                }
+                slo_pct_set = true;
+                break;
+            case 295:
+                if (gb_mix_parse(optarg, mix_weights) < 0) {
+                    fprintf(stderr,
+                            "Error: Invalid mix: %s (expected op=weight,... with ops create, replace, update, get, "
+                            "dump, delete)\n",
+                            optarg);
+                    return -EINVAL;
+                }
+                cfg->mix = optarg;
+                break;
+            case 296:
+                if (parse_u32(optarg, &cfg->hot_set, "hot-set") < 0)
+                    return -EINVAL;
+                if (cfg->hot_set == 0 || cfg->hot_set > GB_MIX_HOT_SET_MAX) {
+                    fprintf(stderr, "Error: hot-set must be between 1 and %u\n", GB_MIX_HOT_SET_MAX);
+                    return -EINVAL;
+                }
+                mix_set = true;
+                break;
+            case 297:
+                errno = 0;
+                cfg->zipf = strtod(optarg, &end);
+                if (errno != 0 || end == optarg || *end != '\0' ||
+                    !(cfg->zipf >= 0.0 && cfg->zipf <= GB_MIX_ZIPF_MAX)) {
+                    fprintf(stderr, "Error: zipf must be between 0 and %.0f\n", GB_MIX_ZIPF_MAX);
+                    return -EINVAL;
+                }
+                mix_set = true;
+                break;
             case 'h':
                 print_usage();
                 exit(0);
@@ -314,6 +902,14 @@ int gb_cli_parse(int argc, char* argv[], struct gb_config* cfg) {
         }
     }
 
+    /*
+     * --pcap and --dump-pipeline run the dump proof (--dump-population pipelines
+     * its own dumps). Promote before the exclusion checks so they see the mode
+     * that will actually run.
+     */
+    if ((cfg->pcap_path || (cfg->dump_pipeline && cfg->dump_pop == 0)) && !cfg->dump_proof)
+        cfg->dump_proof = true;
+
     if (cfg->iters == 0) {
         fprintf(stderr, "Error: iterations must be positive\n");
         return -EINVAL;
@@ -325,8 +921,9 @@ int gb_cli_parse(int argc, char* argv[], struct gb_config* cfg) {
     }
 
     if (cfg->entries > GB_MAX_ENTRIES) {
-        fprintf(stderr, "Note: entries capped at %u (was %u)\n", GB_MAX_ENTRIES, cfg->entries);
-        cfg->entries = GB_MAX_ENTRIES;
+        fprintf(stderr, "Error: entries must be at most %u (one action must fit a 64 KiB netlink nest)\n",
+                GB_MAX_ENTRIES);
+        return -EINVAL;
     }
 
     if (cfg->interval_ns == 0) {
@@ -349,8 +946,69 @@ int gb_cli_parse(int argc, char* argv[], struct gb_config* cfg) {
         return -EINVAL;
     }
 
-    if (cfg->pcap_path && !cfg->dump_proof)
-        cfg->dump_proof = true;
+    ret = check_modes(cfg);
+    if (ret < 0)
+        return ret;
+
+    if (cfg->threads > 0) {
+        int cpu_count = gb_util_count_cpus();
+
+        if (cfg->cpu >= 0) {
+            fprintf(stderr, "Error: --threads pins its own workers and cannot be combined with --cpu\n");
+            return -EINVAL;
+        }
+        if (cpu_count > 0 && cfg->threads > (uint32_t)cpu_count) {
+            fprintf(stderr,
+                    "Error: threads must be at most %d, the CPUs this process may run on (one worker per CPU)\n",
+                    cpu_count);
+            return -EINVAL;
+        }
+    }
+
+    if (cfg->clients > 0 && cfg->nl_backend == GB_NL_BACKEND_URING) {
+        fprintf(stderr, "Error: --clients needs non-blocking sockets and does not support --backend=io_uring\n");
+        return -EINVAL;
+    }
+
+    if (arrivals_set && cfg->rate == 0 && cfg->slo_ns == 0) {
+        fprintf(stderr, "Error: --arrivals requires --rate or --slo\n");
+        return -EINVAL;
+    }
+
+    if (slo_pct_set && cfg->slo_ns == 0) {
+        fprintf(stderr, "Error: --slo-pct requires --slo\n");
+        return -EINVAL;
+    }
+
+    if (mix_set && !cfg->mix) {
+        fprintf(stderr, "Error: --hot-set and --zipf require --mix\n");
+        return -EINVAL;
+    }
+
+    if (rw_set && cfg->rw_writers + cfg->rw_readers == 0) {
+        fprintf(stderr, "Error: --rw-indices and --rw-ms require --rw-grid\n");
+        return -EINVAL;
+    }
+
+    if (cfg->dump_delta > 0 && cfg->dump_pop == 0) {
+        fprintf(stderr, "Error: --dump-delta requires --dump-population\n");
+        return -EINVAL;
+    }
+
+    if (cfg->loopback_service && cfg->nl_backend != GB_NL_BACKEND_LOOPBACK) {
+        fprintf(stderr, "Error: --loopback-service requires --backend=loopback\n");
+        return -EINVAL;
+    }
+
+    if (cfg->replay_path && cfg->trace_path) {
+        fprintf(stderr, "Error: --replay cannot be combined with --trace\n");
+        return -EINVAL;
+    }
+
+    if (pace_set && !cfg->replay_path) {
+        fprintf(stderr, "Error: --replay-pace requires --replay\n");
+        return -EINVAL;
+    }
 
     return 0;
 }
@@ -0,0 +1,385 @@
+/* src/clients.c
+ * Multi-client engine: many netlink sockets driven from one epoll loop.
+ */
+#include "../include/gatebench_clients.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CLIENTS_EPOLL_BATCH 256
+
+/* Per-client state machine: BUILD -> (submit) -> AWAIT -> BUILD ... -> DONE */
+enum client_state {
+    CLIENT_BUILD = 0,
+    CLIENT_AWAIT,
+    CLIENT_DONE,
+};
+
+struct client {
+    struct gb_nl_sock* sock;
+    struct gb_nl_msg* msg;
+    uint32_t index;
+    enum client_state state;
+    uint64_t ops_sent;
+    uint64_t ops_done;
+    uint64_t errors;
+    int last_error;
+    struct gb_stats lat;
+};
+
+struct clients_ctx {
+    const struct gb_config* cfg;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    uint32_t entry_count;
+    uint64_t ops_per_client;
+};
+
+/* Make sure one process can hold a socket per client plus stdio and epoll. */
+static void clients_raise_nofile(uint32_t clients) {
+    struct rlimit rl;
+    rlim_t want = (rlim_t)clients + 32u;
+
+    if (getrlimit(RLIMIT_NOFILE, &rl) < 0 || rl.rlim_cur >= want)
+        return;
+
+    rl.rlim_cur = want < rl.rlim_max ? want : rl.rlim_max;
+    (void)setrlimit(RLIMIT_NOFILE, &rl);
+}
+
+/* Even ops create (EEXIST after the first), odd ops replace, as in the benchmark loop. */
+static int client_build_submit(struct client* c, const struct clients_ctx* ctx) {
+    bool is_create = (c->ops_sent % 2u) == 0u;
+    uint16_t flags = is_create ? (uint16_t)(NLM_F_CREATE | NLM_F_EXCL) : (uint16_t)(NLM_F_CREATE | NLM_F_REPLACE);
+    int ret;
+
+    c->state = CLIENT_BUILD;
+    ret = build_gate_newaction(c->msg, c->index, &ctx->shape, ctx->entries, ctx->entry_count, flags, 0, -1);
+    if (ret < 0)
+        return ret;
+
+    ret = gb_nl_submit(c->sock, c->msg, c->ops_sent);
+    if (ret < 0)
+        return ret;
+
+    c->ops_sent++;
+    c->state = CLIENT_AWAIT;
+    return 0;
+}
+
+static void client_complete(struct client* c, const struct gb_nl_completion* comp) {
+    bool is_create = (comp->cookie % 2u) == 0u;
+
+    if (comp->err != 0 && !(is_create && comp->err == -EEXIST)) {
+        c->errors++;
+        c->last_error = comp->err;
+    }
+
+    gb_stats_add(&c->lat, comp->latency_ns);
+    c->ops_done++;
+}
+
+static void client_delete(struct client* c, struct gb_nl_msg* del_msg, struct gb_nl_msg* resp, int timeout_ms) {
+    if (build_gate_delaction(del_msg, c->index) == 0)
+        (void)gb_nl_send_recv(c->sock, del_msg, resp, timeout_ms);
+}
+
+int gb_clients_run(const struct gb_config* cfg, struct gb_clients_summary* summary) {
+    struct clients_ctx ctx;
+    struct client* clients = NULL;
+    struct gb_nl_msg* resp = NULL;
+    struct gb_nl_msg* del_msg = NULL;
+    struct gb_stats all;
+    struct epoll_event events[CLIENTS_EPOLL_BATCH];
+    uint32_t n;
+    uint32_t active;
+    uint64_t start_ns = 0, end_ns = 0;
+    size_t msg_cap;
+    int epfd = -1;
+    int ret;
+
+    if (!cfg || !summary || cfg->clients == 0 || cfg->clients > GB_CLIENTS_MAX)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    n = cfg->clients;
+
+    ret = gb_stats_init(&all, (size_t)n * cfg->iters * 2u);
+    if (ret < 0)
+        return ret;
+
+    ctx.cfg = cfg;
+    ctx.entry_count = cfg->entries;
+    ctx.ops_per_client = (uint64_t)cfg->iters * 2u;
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = ctx.entry_count;
+
+    if (ctx.entry_count > 0) {
+        ctx.entries = malloc((size_t)ctx.entry_count * sizeof(*ctx.entries));
+        if (!ctx.entries) {
+            ret = -ENOMEM;
+            goto out;
+        }
+        ret = gb_fill_entries(ctx.entries, ctx.entry_count, cfg->interval_ns);
+        if (ret < 0)
+            goto out;
+    }
+
+    clients = calloc(n, sizeof(*clients));
+    summary->per_client = calloc(n, sizeof(*summary->per_client));
+    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    del_msg = gb_nl_msg_alloc(1024);
+    if (!clients || !summary->per_client || !resp || !del_msg) {
+        ret = -ENOMEM;
+        goto out;
+    }
+    summary->clients = n;
+
+    clients_raise_nofile(n);
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        ret = -errno;
+        goto out;
+    }
+
+    msg_cap = gate_msg_capacity(ctx.entry_count, 0);
+    for (uint32_t i = 0; i < n; i++) {
+        struct client* c = &clients[i];
+        struct epoll_event ev;
+
+        c->index = cfg->index + i;
+
+        ret = gb_stats_init(&c->lat, (size_t)ctx.ops_per_client);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_open(&c->sock);
+        if (ret < 0)
+            goto out;
+
+        c->msg = gb_nl_msg_alloc(msg_cap);
+        if (!c->msg) {
+            ret = -ENOMEM;
+            goto out;
+        }
+
+        /* Start from a clean slot while the socket is still blocking */
+        client_delete(c, del_msg, resp, cfg->timeout_ms);
+
+        ret = gb_nl_set_nonblock(c->sock, true);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_async_init(c->sock, 1);
+        if (ret < 0)
+            goto out;
+
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = i;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, gb_nl_fd(c->sock), &ev) < 0) {
+            ret = -errno;
+            goto out;
+        }
+    }
+
+    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+
+    active = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (ctx.ops_per_client == 0) {
+            clients[i].state = CLIENT_DONE;
+            continue;
+        }
+        ret = client_build_submit(&clients[i], &ctx);
+        if (ret < 0)
+            goto out;
+        active++;
+    }
+
+    while (active > 0) {
+        int nev = epoll_wait(epfd, events, CLIENTS_EPOLL_BATCH, cfg->timeout_ms);
+
+        if (nev < 0) {
+            if (errno == EINTR)
+                continue;
+            ret = -errno;
+            goto out;
+        }
+        summary->epoll_waits++;
+        if (nev == 0) {
+            ret = -ETIMEDOUT;
+            goto out;
+        }
+
+        /* One completion per ready client per wakeup keeps service round-robin */
+        for (int e = 0; e < nev; e++) {
+            struct client* c = &clients[events[e].data.u32];
+            struct gb_nl_completion comp;
+            int got;
+
+            if (c->state != CLIENT_AWAIT)
+                continue;
+
+            got = gb_nl_reap(c->sock, resp, &comp, 1, 0);
+            if (got == -EAGAIN || got == 0)
+                continue;
+            if (got < 0) {
+                ret = got;
+                goto out;
+            }
+
+            client_complete(c, &comp);
+            if (c->ops_done < ctx.ops_per_client) {
+                ret = client_build_submit(c, &ctx);
+                if (ret < 0)
+                    goto out;
+                continue;
+            }
+
+            c->state = CLIENT_DONE;
+            (void)epoll_ctl(epfd, EPOLL_CTL_DEL, gb_nl_fd(c->sock), NULL);
+            active--;
+        }
+    }
+
+    ret = gb_util_ns_now(&end_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+
+    summary->secs = (double)(end_ns - start_ns) / 1e9;
+
+    for (uint32_t i = 0; i < n; i++) {
+        struct client* c = &clients[i];
+        struct gb_client_summary* cs = &summary->per_client[i];
+
+        cs->index = c->index;
+        cs->ops = c->ops_done;
+        cs->errors = c->errors;
+        cs->last_error = c->last_error;
+        summary->total_ops += c->ops_done;
+        summary->total_errors += c->errors;
+
+        for (size_t k = 0; k < c->lat.count; k++) {
+            ret = gb_stats_add(&all, c->lat.values[k]);
+            if (ret < 0)
+                goto out;
+        }
+
+        ret = gb_stats_summarize(&c->lat, &cs->latency);
+        if (ret < 0)
+            goto out;
+    }
+
+    if (summary->secs > 0.0)
+        summary->ops_per_sec = (double)summary->total_ops / summary->secs;
+
+    ret = gb_stats_summarize(&all, &summary->latency);
+
+out:
+    if (clients) {
+        for (uint32_t i = 0; i < n; i++) {
+            struct client* c = &clients[i];
+
+            if (c->sock) {
+                /* Drop any unreaped ack, then remove the client's action */
+                if (gb_nl_set_nonblock(c->sock, false) == 0 && resp && del_msg) {
+                    if (c->state == CLIENT_AWAIT) {
+                        struct gb_nl_completion comp;
+
+                        (void)gb_nl_reap(c->sock, resp, &comp, 1, cfg->timeout_ms);
+                    }
+                    client_delete(c, del_msg, resp, cfg->timeout_ms);
+                }
+                gb_nl_close(c->sock);
+            }
+            gb_nl_msg_free(c->msg);
+            gb_stats_free(&c->lat);
+        }
+        free(clients);
+    }
+    if (epfd >= 0)
+        close(epfd);
+    if (ret < 0)
+        gb_clients_summary_free(summary);
+    gb_nl_msg_free(resp);
+    gb_nl_msg_free(del_msg);
+    gb_stats_free(&all);
+    free(ctx.entries);
+    return ret;
+}
+
+void gb_clients_print_summary(const struct gb_clients_summary* summary, const struct gb_config* cfg) {
+    uint64_t* p99 = NULL;
+    uint64_t p99_min = 0, p99_med = 0, p99_max = 0;
+
+    if (!summary || !cfg)
+        return;
+
+    printf("Clients: %u clients, %llu ops in %.3f s (%.1f ops/sec), %llu errors, %llu epoll waits\n",
+           summary->clients, (unsigned long long)summary->total_ops, summary->secs, summary->ops_per_sec,
+           (unsigned long long)summary->total_errors, (unsigned long long)summary->epoll_waits);
+    printf("  Latency (all clients): p50 %llu ns, p95 %llu ns, p99 %llu ns, p999 %llu ns, max %llu ns\n",
+           (unsigned long long)summary->latency.p50_ns, (unsigned long long)summary->latency.p95_ns,
+           (unsigned long long)summary->latency.p99_ns, (unsigned long long)summary->latency.p999_ns,
+           (unsigned long long)summary->latency.max_ns);
+
+    if (summary->clients == 0 || !summary->per_client)
+        return;
+
+    p99 = malloc((size_t)summary->clients * sizeof(*p99));
+    if (p99) {
+        p99_min = UINT64_MAX;
+        for (uint32_t i = 0; i < summary->clients; i++) {
+            p99[i] = summary->per_client[i].latency.p99_ns;
+            if (p99[i] < p99_min)
+                p99_min = p99[i];
+            if (p99[i] > p99_max)
+                p99_max = p99[i];
+        }
+        (void)gb_stats_median_uint64(p99, summary->clients, &p99_med);
+        free(p99);
+        printf("  Per-client p99: min %llu ns, median %llu ns, max %llu ns\n", (unsigned long long)p99_min,
+               (unsigned long long)p99_med, (unsigned long long)p99_max);
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t i = 0; i < summary->clients; i++) {
+        const struct gb_client_summary* cs = &summary->per_client[i];
+
+        printf("  client %4u (index %u): %llu ops, %llu errors, p50 %llu ns, p99 %llu ns, max %llu ns\n", i, cs->index,
+               (unsigned long long)cs->ops, (unsigned long long)cs->errors, (unsigned long long)cs->latency.p50_ns,
+               (unsigned long long)cs->latency.p99_ns, (unsigned long long)cs->latency.max_ns);
+    }
+}
+
+void gb_clients_summary_free(struct gb_clients_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_client);
+    summary->per_client = NULL;
+    summary->clients = 0;
+}
@@ -0,0 +1,372 @@
+/* src/dump_pop.c
+ * Large-population dumps: pagination, throughput and time to first page
+ * when a single RTM_GETACTION dump walks tens of thousands of gate actions,
+ * and how much terse and time-delta filtered dumps save on top.
+ */
+#include "../include/gatebench_dump_pop.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <stdio.h>
+#include <string.h>
+
+/* One in this many actions is kept recent for the time-delta dumps */
+#define DUMP_POP_RECENT_DIV 10u
+
+struct dump_pop_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gb_populator pop;
+    struct gb_nl_msg* dump_msg;
+    struct gb_nl_msg* del_msg;
+    struct gb_nl_msg* resp;
+    int timeout_ms;
+    uint64_t stale_ns; /* When the non-recent actions were last created */
+};
+
+struct dump_pop_count {
+    uint64_t actions;
+    uint64_t with_stats;
+    uint64_t entries;
+};
+
+static int dump_pop_visit_entry(const struct gate_entry* entry, void* arg) {
+    struct dump_pop_count* count = arg;
+
+    (void)entry;
+    count->entries++;
+    return 0;
+}
+
+static int dump_pop_visit_action(const struct gate_view* view, void* arg) {
+    struct dump_pop_count* count = arg;
+
+    count->actions++;
+    if (view->action.has_basic_stats)
+        count->with_stats++;
+    return gb_gate_view_entries(view, dump_pop_visit_entry, count);
+}
+
+/* A flush of n actions can take far longer than one ordinary request */
+static int dump_pop_timeout(const struct gb_config* cfg, uint32_t n) {
+    uint64_t t = (uint64_t)cfg->timeout_ms * (1u + n / 10000u);
+
+    return t > INT32_MAX ? INT32_MAX : (int)t;
+}
+
+/* Delete and recreate the last recent actions so their lastuse is now */
+static int dump_pop_refresh(struct dump_pop_ctx* ctx, uint32_t recent) {
+    uint32_t idx[GB_MULTI_ACTIONS_MAX];
+    uint32_t off = ctx->cfg->dump_pop - recent;
+    uint64_t errors = 0;
+    uint32_t k;
+    int ret;
+
+    for (uint32_t done = 0; done < recent; done += k) {
+        k = recent - done < GB_MULTI_ACTIONS_MAX ? recent - done : GB_MULTI_ACTIONS_MAX;
+        for (uint32_t j = 0; j < k; j++)
+            idx[j] = ctx->cfg->index + off + done + j;
+
+        gb_nl_msg_reset(ctx->del_msg);
+        ret = build_gate_delaction_multi(ctx->del_msg, idx, k);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->sock, ctx->del_msg, ctx->resp, ctx->cfg->timeout_ms);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = gb_populate(&ctx->pop, ctx->sock, ctx->resp, off, recent, true, &errors);
+    if (ret < 0)
+        return ret;
+
+    return errors > 0 ? -EIO : 0;
+}
+
+/* One untimed then cfg->runs timed dumps of one variant */
+static int dump_pop_variant(struct dump_pop_ctx* ctx, uint32_t recent, struct gb_dump_pop_variant* v) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t wall_total = 0, parse_total = 0, bytes_total = 0, pages_total = 0;
+    uint64_t actions_total = 0, entries_total = 0;
+    struct gb_dump_stats stats;
+    struct dump_pop_count count;
+    struct gb_stats wall, first;
+    int ret;
+
+    gb_nl_msg_reset(ctx->dump_msg);
+    ret = build_gate_dumpaction_ex(ctx->dump_msg, v->root_flags, v->time_delta_ms);
+    if (ret < 0)
+        return ret;
+
+    if (v->time_delta_ms != 0) {
+        uint64_t now, window = (uint64_t)v->time_delta_ms * 1000000ull;
+
+        /* Everything but the recent actions has to fall outside the window first */
+        ret = gb_util_ns_now(&now, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+        if (now - ctx->stale_ns <= window) {
+            ret = gb_util_sleep_ns(window - (now - ctx->stale_ns) + 10000000ull);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    memset(&first, 0, sizeof(first));
+    ret = gb_stats_init(&wall, cfg->runs);
+    if (ret < 0)
+        return ret;
+    ret = gb_stats_init(&first, cfg->runs);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i <= cfg->runs; i++) {
+        if (v->time_delta_ms != 0) {
+            ret = dump_pop_refresh(ctx, recent);
+            if (ret < 0)
+                goto out;
+        }
+
+        memset(&count, 0, sizeof(count));
+        ret = gb_nl_dump_visit(ctx->sock, ctx->dump_msg, dump_pop_visit_action, &count, cfg->dump_pipeline, &stats,
+                               ctx->timeout_ms);
+        if (ret == 0 && stats.saw_error)
+            ret = stats.error_code;
+        if (ret < 0) {
+            if (i == 0)
+                goto out;
+            v->dump_errors++;
+            continue;
+        }
+        if (i == 0)
+            continue;
+
+        ret = gb_stats_add(&wall, stats.wall_ns);
+        if (ret == 0)
+            ret = gb_stats_add(&first, stats.first_page_ns);
+        if (ret < 0)
+            goto out;
+
+        v->dumps++;
+        v->pages = stats.reply_msgs;
+        v->bytes = stats.payload_bytes;
+        v->seen = count.actions;
+        v->with_stats = count.with_stats;
+        v->entries = count.entries;
+
+        wall_total += stats.wall_ns;
+        parse_total += stats.parse_ns;
+        bytes_total += stats.payload_bytes;
+        pages_total += stats.reply_msgs;
+        actions_total += count.actions;
+        entries_total += count.entries;
+    }
+
+    if (wall_total > 0) {
+        double secs = (double)wall_total / 1e9;
+
+        v->bytes_per_sec = (double)bytes_total / secs;
+        v->actions_per_sec = (double)actions_total / secs;
+        v->entries_per_sec = (double)entries_total / secs;
+        v->pages_per_sec = (double)pages_total / secs;
+        v->parse_share = (double)parse_total / (double)wall_total;
+    }
+
+    ret = gb_stats_summarize(&wall, &v->wall);
+    if (ret == 0)
+        ret = gb_stats_summarize(&first, &v->first_page);
+
+out:
+    gb_stats_free(&wall);
+    gb_stats_free(&first);
+    return ret;
+}
+
+int gb_dump_pop_run(const struct gb_config* cfg, struct gb_dump_pop_summary* summary) {
+    static const struct {
+        const char* name;
+        uint32_t root_flags;
+        bool delta;
+    } kinds[GB_DUMP_POP_KINDS] = {
+        [GB_DUMP_POP_FULL] = {"full", 0, false},
+        [GB_DUMP_POP_TERSE] = {"terse", TCA_ACT_FLAG_TERSE_DUMP, false},
+        [GB_DUMP_POP_DELTA] = {"delta", 0, true},
+        [GB_DUMP_POP_TERSE_DELTA] = {"terse_delta", TCA_ACT_FLAG_TERSE_DUMP, true},
+    };
+    struct dump_pop_ctx ctx;
+    struct gb_nl_msg* flush_msg = NULL;
+    const struct gb_dump_pop_variant* full;
+    struct nlmsghdr* nlh;
+    uint64_t t0;
+    int ret;
+
+    if (!cfg || !summary)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    ctx.timeout_ms = dump_pop_timeout(cfg, cfg->dump_pop);
+    summary->actions = cfg->dump_pop;
+    summary->pipelined = cfg->dump_pipeline;
+    summary->flush_count = UINT32_MAX;
+    if (cfg->dump_delta > 0) {
+        summary->recent = cfg->dump_pop / DUMP_POP_RECENT_DIV;
+        if (summary->recent == 0)
+            summary->recent = 1;
+    }
+
+    ctx.dump_msg = gb_nl_msg_alloc(1024);
+    ctx.del_msg = gb_nl_msg_alloc(4096);
+    flush_msg = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!ctx.dump_msg || !ctx.del_msg || !flush_msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_populator_init(&ctx.pop, cfg);
+    if (ret < 0)
+        goto out;
+    summary->populate_batch = ctx.pop.batch;
+
+    /* The kernel only unicasts the TCA_FCNT notification back when asked to echo */
+    ret = build_gate_flushaction(flush_msg);
+    if (ret < 0)
+        goto out;
+    nlh = (struct nlmsghdr*)flush_msg->buf;
+    nlh->nlmsg_flags |= NLM_F_ECHO;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    /* Start from an empty table so the dump only sees this population */
+    (void)gb_nl_send_recv_flush(ctx.sock, flush_msg, ctx.resp, ctx.timeout_ms, NULL);
+
+    if (!cfg->json)
+        printf("  Populating %u actions... ", cfg->dump_pop);
+    fflush(stdout);
+
+    ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+    ret = gb_populate(&ctx.pop, ctx.sock, ctx.resp, 0, cfg->dump_pop, true, &summary->populate_errors);
+    if (ret < 0) {
+        if (!cfg->json)
+            printf("failed: %s\n", strerror(-ret));
+        goto out_flush;
+    }
+    ret = gb_util_ns_now(&ctx.stale_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out_flush;
+    summary->populate_secs = (double)(ctx.stale_ns - t0) / 1e9;
+
+    if (!cfg->json)
+        printf("done (%.3f s)\n", summary->populate_secs);
+
+    for (uint32_t k = 0; k < GB_DUMP_POP_KINDS; k++) {
+        struct gb_dump_pop_variant* v = &summary->variant[summary->variants];
+
+        if (kinds[k].delta && cfg->dump_delta == 0)
+            continue;
+
+        v->name = kinds[k].name;
+        v->root_flags = kinds[k].root_flags;
+        v->time_delta_ms = kinds[k].delta ? cfg->dump_delta : 0;
+        v->expected = kinds[k].delta ? summary->recent : cfg->dump_pop;
+
+        if (!cfg->json)
+            printf("  %-11s dumps... ", v->name);
+        fflush(stdout);
+
+        ret = dump_pop_variant(&ctx, summary->recent, v);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out_flush;
+        }
+        summary->variants++;
+
+        if (!cfg->json)
+            printf("done (p50 %.3f ms)\n", (double)v->wall.p50_ns / 1e6);
+    }
+
+    full = &summary->variant[GB_DUMP_POP_FULL];
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        struct gb_dump_pop_variant* v = &summary->variant[k];
+
+        if (full->bytes > 0)
+            v->bytes_vs_full = (double)v->bytes / (double)full->bytes;
+        if (full->wall.p50_ns > 0)
+            v->wall_vs_full = (double)v->wall.p50_ns / (double)full->wall.p50_ns;
+    }
+
+out_flush:
+    if (gb_nl_send_recv_flush(ctx.sock, flush_msg, ctx.resp, ctx.timeout_ms, &summary->flush_count) < 0)
+        summary->flush_count = UINT32_MAX;
+
+out:
+    gb_nl_close(ctx.sock);
+    gb_populator_free(&ctx.pop);
+    gb_nl_msg_free(ctx.dump_msg);
+    gb_nl_msg_free(ctx.del_msg);
+    gb_nl_msg_free(flush_msg);
+    gb_nl_msg_free(ctx.resp);
+    return ret;
+}
+
+void gb_dump_pop_print_summary(const struct gb_dump_pop_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || summary->variants == 0)
+        return;
+
+    printf("Dump population: %u gate actions, 1..%u entries each (populated %u per message, %.3f s)\n",
+           summary->actions, cfg->entries, summary->populate_batch, summary->populate_secs);
+    if (summary->recent > 0)
+        printf("  Time-delta dumps: %u ms window, %u recent actions\n", cfg->dump_delta, summary->recent);
+    printf("  %-11s %8s %6s %11s %8s %7s %10s %10s %7s %10s %9s %6s\n", "variant", "actions", "pages", "bytes",
+           "B/action", "vs full", "first ms", "DONE ms", "vs full", "actions/s", "MB/s", "parse");
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_dump_pop_variant* v = &summary->variant[k];
+
+        printf("  %-11s %8llu %6u %11llu %8.0f %6.1f%% %10.3f %10.3f %6.1f%% %10.0f %9.1f %5.1f%%\n", v->name,
+               (unsigned long long)v->seen, v->pages, (unsigned long long)v->bytes,
+               v->seen > 0 ? (double)v->bytes / (double)v->seen : 0.0, v->bytes_vs_full * 100.0,
+               (double)v->first_page.p50_ns / 1e6, (double)v->wall.p50_ns / 1e6, v->wall_vs_full * 100.0,
+               v->actions_per_sec, v->bytes_per_sec / 1e6, v->parse_share * 100.0);
+    }
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_dump_pop_variant* v = &summary->variant[k];
+
+        if (v->seen != v->expected)
+            printf("  Warning: %s dump walked %llu actions, expected %u\n", v->name, (unsigned long long)v->seen,
+                   v->expected);
+    }
+    if (summary->populate_errors > 0)
+        printf("  Warning: %llu create batches failed\n", (unsigned long long)summary->populate_errors);
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t k = 0; k < summary->variants; k++) {
+        const struct gb_dump_pop_variant* v = &summary->variant[k];
+
+        printf("  %s: %u dumps%s, %llu errors, %llu entries, %llu with stats; first page p99 %.3f ms, DONE p99 "
+               "%.3f ms; %.0f entries/s, %.0f pages/s\n",
+               v->name, v->dumps, summary->pipelined ? " (pipelined)" : "", (unsigned long long)v->dump_errors,
+               (unsigned long long)v->entries, (unsigned long long)v->with_stats,
+               (double)v->first_page.p99_ns / 1e6, (double)v->wall.p99_ns / 1e6, v->entries_per_sec,
+               v->pages_per_sec);
+    }
+    if (summary->flush_count == UINT32_MAX)
+        printf("  Closing flush: no TCA_FCNT\n");
+    else
+        printf("  Closing flush: %u actions\n", summary->flush_count);
+}
@@ -0,0 +1,305 @@
+/* src/entry_sweep.c
+ * Schedule-size sweep: how REPLACE and GET latency grow with the number of
+ * gate entries, up to the largest schedule one netlink message can carry.
+ */
+#include "../include/gatebench_entry_sweep.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* A reply is one action nest (at most 64 KiB) plus headers */
+#define SWEEP_RESP_SIZE (128u * 1024u)
+
+struct sweep_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    struct gb_nl_msg* create_msg;
+    struct gb_nl_msg* replace_msg;
+    struct gb_nl_msg* get_msg;
+    struct gb_nl_msg* del_msg;
+    struct gb_nl_msg* resp;
+    struct gate_dump dump;
+};
+
+static int sweep_time_replace(struct sweep_ctx* ctx, struct gb_stats* lat, struct gb_entry_sweep_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t t0, t1;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->warmup; i++)
+        (void)gb_nl_send_recv(ctx->sock, ctx->replace_msg, ctx->resp, cfg->timeout_ms);
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->sock, ctx->replace_msg, ctx->resp, cfg->timeout_ms);
+
+        if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+            return -EIO;
+
+        if (ret < 0) {
+            step->replace_errors++;
+            continue;
+        }
+
+        ret = gb_stats_add(lat, t1 - t0);
+        if (ret < 0)
+            return ret;
+    }
+
+    return gb_stats_summarize(lat, &step->replace);
+}
+
+static int sweep_time_get(struct sweep_ctx* ctx, struct gb_stats* lat, struct gb_entry_sweep_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t t0, t1;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->sock, ctx->get_msg, ctx->resp, cfg->timeout_ms);
+        if (ret >= 0)
+            ret = gb_nl_gate_parse_into((struct nlmsghdr*)ctx->resp->buf, &ctx->dump);
+
+        if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+            return -EIO;
+
+        if (ret < 0 || ctx->dump.num_entries != step->entries) {
+            step->get_errors++;
+            continue;
+        }
+
+        ret = gb_stats_add(lat, t1 - t0);
+        if (ret < 0)
+            return ret;
+    }
+
+    return gb_stats_summarize(lat, &step->get);
+}
+
+static int sweep_step(struct sweep_ctx* ctx, uint32_t n, struct gb_entry_sweep_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_stats lat;
+    int ret;
+
+    memset(step, 0, sizeof(*step));
+    step->entries = n;
+
+    ret = gb_fill_entries(ctx->entries, n, cfg->interval_ns);
+    if (ret < 0)
+        return ret;
+
+    ctx->shape.entries = n;
+    gb_nl_msg_reset(ctx->create_msg);
+    ret = build_gate_newaction(ctx->create_msg, cfg->index, &ctx->shape, ctx->entries, n, NLM_F_CREATE | NLM_F_EXCL,
+                               0, -1);
+    if (ret < 0)
+        return ret;
+
+    gb_nl_msg_reset(ctx->replace_msg);
+    ret = build_gate_newaction(ctx->replace_msg, cfg->index, &ctx->shape, ctx->entries, n,
+                               NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    if (ret < 0)
+        return ret;
+    step->msg_len = (uint32_t)ctx->replace_msg->len;
+
+    ret = gb_nl_send_recv(ctx->sock, ctx->del_msg, ctx->resp, cfg->timeout_ms);
+    if (ret < 0 && ret != -ENOENT)
+        return ret;
+
+    ret = gb_nl_send_recv(ctx->sock, ctx->create_msg, ctx->resp, cfg->timeout_ms);
+    if (ret < 0) {
+        step->error = -ret;
+        return 0;
+    }
+
+    ret = gb_stats_init(&lat, cfg->iters);
+    if (ret < 0)
+        goto out;
+
+    ret = sweep_time_replace(ctx, &lat, step);
+    gb_stats_free(&lat);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_init(&lat, cfg->iters);
+    if (ret < 0)
+        goto out;
+
+    ret = sweep_time_get(ctx, &lat, step);
+    gb_stats_free(&lat);
+
+out:
+    (void)gb_nl_send_recv(ctx->sock, ctx->del_msg, ctx->resp, cfg->timeout_ms);
+    return ret;
+}
+
+static uint32_t sweep_points(uint32_t max, uint32_t* out) {
+    uint32_t n = 0;
+
+    for (uint32_t e = 1; e < max; e *= 2u)
+        out[n++] = e;
+    out[n++] = max;
+
+    return n;
+}
+
+int gb_entry_sweep_run(const struct gb_config* cfg, struct gb_entry_sweep_summary* summary) {
+    struct sweep_ctx ctx;
+    uint32_t sweep[34];
+    uint32_t steps;
+    uint32_t max;
+    size_t msg_cap;
+    int ret;
+
+    if (!cfg || !summary || cfg->entry_sweep == 0 || cfg->entry_sweep > GB_MAX_ENTRIES)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    max = cfg->entry_sweep;
+
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+
+    steps = sweep_points(max, sweep);
+    summary->per_step = calloc(steps, sizeof(*summary->per_step));
+    ctx.entries = calloc(max, sizeof(*ctx.entries));
+    msg_cap = gate_msg_capacity(max, 0);
+    ctx.create_msg = gb_nl_msg_alloc(msg_cap);
+    ctx.replace_msg = gb_nl_msg_alloc(msg_cap);
+    ctx.get_msg = gb_nl_msg_alloc(1024);
+    ctx.del_msg = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc(SWEEP_RESP_SIZE);
+    if (!summary->per_step || !ctx.entries || !ctx.create_msg || !ctx.replace_msg || !ctx.get_msg || !ctx.del_msg ||
+        !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = build_gate_getaction(ctx.get_msg, cfg->index);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_delaction(ctx.del_msg, cfg->index);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t s = 0; s < steps; s++) {
+        struct gb_entry_sweep_step* st = &summary->per_step[s];
+
+        if (!cfg->json)
+            printf("  %5u entries... ", sweep[s]);
+        fflush(stdout);
+
+        ret = sweep_step(&ctx, sweep[s], st);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->steps = s + 1u;
+
+        if (st->error != 0) {
+            summary->limit = sweep[s];
+            if (!cfg->json)
+                printf("create refused: %s\n", strerror(st->error));
+            break;
+        }
+
+        if (!cfg->json)
+            printf("done (replace p50 %llu ns)\n", (unsigned long long)st->replace.p50_ns);
+    }
+
+out:
+    gb_nl_close(ctx.sock);
+    gb_gate_dump_free(&ctx.dump);
+    gb_nl_msg_free(ctx.create_msg);
+    gb_nl_msg_free(ctx.replace_msg);
+    gb_nl_msg_free(ctx.get_msg);
+    gb_nl_msg_free(ctx.del_msg);
+    gb_nl_msg_free(ctx.resp);
+    free(ctx.entries);
+    if (ret < 0)
+        gb_entry_sweep_summary_free(summary);
+    return ret;
+}
+
+void gb_entry_sweep_print_summary(const struct gb_entry_sweep_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || summary->steps == 0)
+        return;
+
+    printf("Entry sweep: REPLACE and GET latency per schedule size\n");
+    printf("  %7s %9s %12s %12s %10s %12s %12s %10s\n", "entries", "msg bytes", "replace p50", "replace p99",
+           "ns/entry", "get p50", "get p99", "errors");
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_entry_sweep_step* st = &summary->per_step[s];
+
+        if (st->error != 0) {
+            printf("  %7u %9u create refused: %s\n", st->entries, st->msg_len, strerror(st->error));
+            continue;
+        }
+
+        printf("  %7u %9u %9llu ns %9llu ns %10.1f", st->entries, st->msg_len,
+               (unsigned long long)st->replace.p50_ns, (unsigned long long)st->replace.p99_ns,
+               (double)st->replace.p50_ns / (double)st->entries);
+        /* Every GET failing usually means the reply outgrew its 64 KiB nest */
+        if (st->get.count == 0)
+            printf(" %12s %12s", "-", "-");
+        else
+            printf(" %9llu ns %9llu ns", (unsigned long long)st->get.p50_ns, (unsigned long long)st->get.p99_ns);
+        printf(" %10llu\n", (unsigned long long)(st->replace_errors + st->get_errors));
+    }
+
+    if (summary->limit > 0)
+        printf("  Kernel limit: creating %u entries failed\n", summary->limit);
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_entry_sweep_step* st = &summary->per_step[s];
+
+        if (st->error != 0)
+            continue;
+
+        printf("  %u entries: replace %llu errors, p95 %llu ns, max %llu ns; get %llu errors, p95 %llu ns, "
+               "max %llu ns\n",
+               st->entries, (unsigned long long)st->replace_errors, (unsigned long long)st->replace.p95_ns,
+               (unsigned long long)st->replace.max_ns, (unsigned long long)st->get_errors,
+               (unsigned long long)st->get.p95_ns, (unsigned long long)st->get.max_ns);
+    }
+}
+
+void gb_entry_sweep_summary_free(struct gb_entry_sweep_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_step);
+    summary->per_step = NULL;
+    summary->steps = 0;
+}
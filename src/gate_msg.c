@@ -4,6 +4,7 @@
 #include "../include/gatebench.h"
 #include "../include/gatebench_gate.h"
 #include "../include/gatebench_nl.h"
+#include "nl_internal.h"
 
 #include <errno.h>
 #include <libmnl/libmnl.h>
@@ -79,59 +80,119 @@ static int parse_nested_attrs_limited(const struct nlattr* attr, const struct nl
     return mnl_attr_parse_nested(attr, mnl_attr_cb_copy, &ctx);
 }
 
-/* Approximate message size needed for a gate NEWACTION/REPLACE */
+static size_t gate_attr_size(size_t payload) {
+    return sizeof(struct nlattr) + ((payload + 3u) & ~(size_t)3u);
+}
+
+/*
+ * Worst-case TCA_ACT_TAB nest of a gate RTM_NEWACTION carrying this many
+ * actions: every optional attribute present and every entry open (which
+ * adds the GATE flag).
+ */
+static size_t gate_tab_size(uint32_t actions, uint32_t entries) {
+    size_t entry = gate_attr_size(0) + gate_attr_size(0) + 3u * gate_attr_size(sizeof(uint32_t));
+    size_t opts = gate_attr_size(0) + gate_attr_size(sizeof(struct tc_gate)) + gate_attr_size(sizeof(uint32_t)) +
+                  3u * gate_attr_size(sizeof(uint64_t)) + 2u * gate_attr_size(sizeof(uint32_t)) + gate_attr_size(0);
+    size_t action = gate_attr_size(0) + gate_attr_size(sizeof("gate")) + gate_attr_size(sizeof(uint32_t)) +
+                    2u * gate_attr_size(sizeof(struct nla_bitfield32)) + opts + (size_t)entries * entry;
+
+    return gate_attr_size(0) + (size_t)actions * action;
+}
+
+static size_t gate_hdr_size(void) {
+    return sizeof(struct nlmsghdr) + ((sizeof(struct tcamsg) + 3u) & ~(size_t)3u);
+}
+
+size_t gate_msg_size(uint32_t entries) {
+    return gate_msg_size_multi(1, entries);
+}
+
+size_t gate_msg_size_multi(uint32_t actions, uint32_t entries) {
+    return gate_hdr_size() + gate_tab_size(actions, entries);
+}
+
+/*
+ * Buffer size for a gate NEWACTION/REPLACE: the exact worst-case encoding,
+ * but never below one socket page so hand-built variants with extra or
+ * malformed attributes still fit.
+ */
 size_t gate_msg_capacity(uint32_t entries, uint32_t flags) {
-    size_t cap = 2048;
+    size_t cap = gate_msg_size(entries);
 
     (void)flags;
 
-    if (entries > 0) {
-        size_t add = (size_t)entries * 96;
-        if (add > 1024 * 1024)
-            add = 1024 * 1024;
-        cap += add;
-    }
-
     if (cap < (size_t)MNL_SOCKET_BUFFER_SIZE)
         cap = (size_t)MNL_SOCKET_BUFFER_SIZE;
 
-    cap = (cap + 4095) & ~4095u;
     return cap;
 }
 
-int build_gate_newaction(struct gb_nl_msg* msg,
-                         uint32_t index,
-                         const struct gate_shape* shape,
-                         const struct gate_entry* entries,
-                         uint32_t num_entries,
-                         uint16_t nlmsg_flags,
-                         uint32_t gate_flags,
-                         int32_t priority) {
-    struct nlmsghdr* nlh;
-    struct tcamsg* tca;
-    struct nlattr *nest_tab, *nest_prio, *nest_opts;
-
-    if (!msg || !msg->buf || !shape)
-        return -EINVAL;
+/* Patchable payload offsets of one encoded entry, from the start of the message */
+struct gate_tmpl_entry {
+    uint32_t interval_off;
+    uint32_t ipv_off;
+    uint32_t maxoctets_off;
+};
 
-    if (num_entries > 0 && !entries)
-        return -EINVAL;
+struct gate_tmpl {
+    struct gb_nl_msg* msg;
+    struct gate_shape shape;
+    uint32_t index;
+    uint16_t nlmsg_flags;
+    uint32_t gate_flags;
+    int32_t priority;
+
+    /* Copy of the encoded schedule; gate_state decides the entry layout */
+    struct gate_entry* entries;
+    uint32_t num_entries;
+    uint32_t max_entries;
+
+    uint32_t act_index_off;
+    uint32_t parms_index_off;
+    uint32_t base_time_off;
+    uint32_t cycle_time_off;
+    struct gate_tmpl_entry* entry_offs;
+};
 
-    nlh = mnl_nlmsg_put_header(msg->buf);
-    nlh->nlmsg_type = RTM_NEWACTION;
-    nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | nlmsg_flags;
-    nlh->nlmsg_seq = 0;
+/* Offset of the payload of the next attribute put at the message tail */
+static uint32_t next_payload_off(const struct nlmsghdr* nlh) {
+    const char* tail = mnl_nlmsg_get_payload_tail(nlh);
 
-    tca = mnl_nlmsg_put_extra_header(nlh, sizeof(*tca));
-    memset(tca, 0, sizeof(*tca));
-    tca->tca_family = AF_UNSPEC;
+    return (uint32_t)(tail - (const char*)nlh) + (uint32_t)sizeof(struct nlattr);
+}
 
-    nest_tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
-    nest_prio = mnl_attr_nest_start(nlh, GATEBENCH_ACT_PRIO);
+/* Put one gate action in priority slot prio of the open TCA_ACT_TAB */
+static void put_gate_action(struct nlmsghdr* nlh,
+                            uint16_t prio,
+                            uint32_t index,
+                            const struct gate_shape* shape,
+                            const struct gate_entry* entries,
+                            uint32_t num_entries,
+                            uint32_t gate_flags,
+                            int32_t priority,
+                            const struct gate_act_attrs* attrs,
+                            struct gate_tmpl* tmpl) {
+    struct nlattr *nest_prio, *nest_opts;
+
+    nest_prio = mnl_attr_nest_start(nlh, prio);
 
     add_attr_strz(nlh, TCA_ACT_KIND, "gate");
+    if (tmpl)
+        tmpl->act_index_off = next_payload_off(nlh);
     add_attr_u32(nlh, TCA_ACT_INDEX, index);
 
+    if (attrs && attrs->has_flags) {
+        struct nla_bitfield32 bf = {.value = attrs->flags, .selector = attrs->flags};
+
+        mnl_attr_put(nlh, TCA_ACT_FLAGS, sizeof(bf), &bf);
+    }
+
+    if (attrs && attrs->has_hw_stats) {
+        struct nla_bitfield32 bf = {.value = attrs->hw_stats, .selector = TCA_ACT_HW_STATS_ANY};
+
+        mnl_attr_put(nlh, TCA_ACT_HW_STATS, sizeof(bf), &bf);
+    }
+
     nest_opts = mnl_attr_nest_start(nlh, TCA_ACT_OPTIONS);
 
     {
@@ -141,11 +202,17 @@ int build_gate_newaction(struct gb_nl_msg* msg,
         gate_params.index = index;
         gate_params.action = TC_ACT_PIPE;
 
+        if (tmpl)
+            tmpl->parms_index_off = next_payload_off(nlh) + (uint32_t)offsetof(struct tc_gate, index);
         mnl_attr_put(nlh, TCA_GATE_PARMS, sizeof(gate_params), &gate_params);
     }
 
     add_attr_u32(nlh, TCA_GATE_CLOCKID, shape->clockid);
+    if (tmpl)
+        tmpl->base_time_off = next_payload_off(nlh);
     add_attr_u64(nlh, TCA_GATE_BASE_TIME, shape->base_time);
+    if (tmpl)
+        tmpl->cycle_time_off = next_payload_off(nlh);
     add_attr_u64(nlh, TCA_GATE_CYCLE_TIME, shape->cycle_time);
 
     if (shape->cycle_time_ext != 0)
@@ -166,8 +233,14 @@ int build_gate_newaction(struct gb_nl_msg* msg,
             if (entries[i].gate_state)
                 mnl_attr_put(nlh, TCA_GATE_ENTRY_GATE, 0, NULL);
 
+            if (tmpl)
+                tmpl->entry_offs[i].interval_off = next_payload_off(nlh);
             add_attr_u32(nlh, TCA_GATE_ENTRY_INTERVAL, entries[i].interval);
+            if (tmpl)
+                tmpl->entry_offs[i].ipv_off = next_payload_off(nlh);
             add_attr_s32(nlh, TCA_GATE_ENTRY_IPV, entries[i].ipv);
+            if (tmpl)
+                tmpl->entry_offs[i].maxoctets_off = next_payload_off(nlh);
             add_attr_s32(nlh, TCA_GATE_ENTRY_MAX_OCTETS, entries[i].maxoctets);
 
             mnl_attr_nest_end(nlh, entry_nest);
@@ -178,42 +251,314 @@ int build_gate_newaction(struct gb_nl_msg* msg,
 
     mnl_attr_nest_end(nlh, nest_opts);
     mnl_attr_nest_end(nlh, nest_prio);
-    mnl_attr_nest_end(nlh, nest_tab);
-
-    msg->len = nlh->nlmsg_len;
-    return 0;
 }
 
-int build_gate_delaction(struct gb_nl_msg* msg, uint32_t index) {
+/* Start a tc action request: header, tcamsg and the open TCA_ACT_TAB nest */
+static struct nlmsghdr* put_action_header(struct gb_nl_msg* msg,
+                                          uint16_t type,
+                                          uint16_t nlmsg_flags,
+                                          struct nlattr** nest_tab) {
     struct nlmsghdr* nlh;
     struct tcamsg* tca;
-    struct nlattr *nest_tab, *nest_prio;
-
-    if (!msg || !msg->buf)
-        return -EINVAL;
 
     nlh = mnl_nlmsg_put_header(msg->buf);
-    nlh->nlmsg_type = RTM_DELACTION;
-    nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_flags = NLM_F_REQUEST | nlmsg_flags;
     nlh->nlmsg_seq = 0;
 
     tca = mnl_nlmsg_put_extra_header(nlh, sizeof(*tca));
     memset(tca, 0, sizeof(*tca));
     tca->tca_family = AF_UNSPEC;
 
-    nest_tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
-    nest_prio = mnl_attr_nest_start(nlh, GATEBENCH_ACT_PRIO);
+    *nest_tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
+    return nlh;
+}
 
-    add_attr_strz(nlh, TCA_ACT_KIND, "gate");
-    add_attr_u32(nlh, TCA_ACT_INDEX, index);
+/* tmpl records patch offsets and is only used with a single action */
+static int encode_gate_newaction(struct gb_nl_msg* msg,
+                                 const uint32_t* indices,
+                                 uint32_t count,
+                                 const struct gate_shape* shape,
+                                 const struct gate_entry* entries,
+                                 uint32_t num_entries,
+                                 uint16_t nlmsg_flags,
+                                 uint32_t gate_flags,
+                                 int32_t priority,
+                                 const struct gate_act_attrs* attrs,
+                                 struct gate_tmpl* tmpl) {
+    struct nlmsghdr* nlh;
+    struct nlattr* nest_tab;
+
+    if (!msg || !msg->buf || !shape || !indices)
+        return -EINVAL;
+
+    if (num_entries > 0 && !entries)
+        return -EINVAL;
+
+    if (count == 0 || count > GB_MULTI_ACTIONS_MAX)
+        return -EINVAL;
+
+    /* All actions sit in one TCA_ACT_TAB nest with a 16-bit length */
+    if (gate_tab_size(count, num_entries) > UINT16_MAX)
+        return -EMSGSIZE;
+
+    if (msg->cap < gate_msg_size_multi(count, num_entries))
+        return -ENOSPC;
+
+    nlh = put_action_header(msg, RTM_NEWACTION, (uint16_t)(NLM_F_ACK | nlmsg_flags), &nest_tab);
+
+    /* The kernel walks priority slots from 1 and stops at the first gap */
+    for (uint32_t i = 0; i < count; i++)
+        put_gate_action(nlh, (uint16_t)(GATEBENCH_ACT_PRIO + i), indices[i], shape, entries, num_entries, gate_flags,
+                        priority, attrs, tmpl);
+
+    mnl_attr_nest_end(nlh, nest_tab);
+
+    msg->len = nlh->nlmsg_len;
+    return 0;
+}
+
+int build_gate_newaction(struct gb_nl_msg* msg,
+                         uint32_t index,
+                         const struct gate_shape* shape,
+                         const struct gate_entry* entries,
+                         uint32_t num_entries,
+                         uint16_t nlmsg_flags,
+                         uint32_t gate_flags,
+                         int32_t priority) {
+    return encode_gate_newaction(msg, &index, 1, shape, entries, num_entries, nlmsg_flags, gate_flags, priority,
+                                 NULL, NULL);
+}
+
+int build_gate_newaction_attrs(struct gb_nl_msg* msg,
+                               uint32_t index,
+                               const struct gate_shape* shape,
+                               const struct gate_entry* entries,
+                               uint32_t num_entries,
+                               uint16_t nlmsg_flags,
+                               uint32_t gate_flags,
+                               int32_t priority,
+                               const struct gate_act_attrs* attrs) {
+    return encode_gate_newaction(msg, &index, 1, shape, entries, num_entries, nlmsg_flags, gate_flags, priority,
+                                 attrs, NULL);
+}
+
+int build_gate_newaction_multi(struct gb_nl_msg* msg,
+                               const uint32_t* indices,
+                               uint32_t count,
+                               const struct gate_shape* shape,
+                               const struct gate_entry* entries,
+                               uint32_t num_entries,
+                               uint16_t nlmsg_flags,
+                               uint32_t gate_flags,
+                               int32_t priority) {
+    return encode_gate_newaction(msg, indices, count, shape, entries, num_entries, nlmsg_flags, gate_flags, priority,
+                                 NULL, NULL);
+}
+
+static void tmpl_put(struct gate_tmpl* tmpl, uint32_t off, const void* value, size_t len) {
+    memcpy((char*)tmpl->msg->buf + off, value, len);
+}
+
+static int tmpl_encode(struct gate_tmpl* tmpl) {
+    gb_nl_msg_reset(tmpl->msg);
+    return encode_gate_newaction(tmpl->msg, &tmpl->index, 1, &tmpl->shape, tmpl->entries, tmpl->num_entries,
+                                 tmpl->nlmsg_flags, tmpl->gate_flags, tmpl->priority, NULL, tmpl);
+}
+
+int build_gate_newaction_tmpl(struct gate_tmpl** out,
+                              uint32_t max_entries,
+                              uint32_t index,
+                              const struct gate_shape* shape,
+                              const struct gate_entry* entries,
+                              uint32_t num_entries,
+                              uint16_t nlmsg_flags,
+                              uint32_t gate_flags,
+                              int32_t priority) {
+    struct gate_tmpl* tmpl;
+    int ret;
+
+    if (!out || !shape)
+        return -EINVAL;
+
+    *out = NULL;
+
+    if (num_entries > max_entries)
+        return -E2BIG;
+
+    if (num_entries > 0 && !entries)
+        return -EINVAL;
+
+    tmpl = calloc(1, sizeof(*tmpl));
+    if (!tmpl)
+        return -ENOMEM;
+
+    if (max_entries > 0) {
+        tmpl->entries = calloc(max_entries, sizeof(*tmpl->entries));
+        tmpl->entry_offs = calloc(max_entries, sizeof(*tmpl->entry_offs));
+    }
+    tmpl->msg = gb_nl_msg_alloc(gate_msg_capacity(max_entries, 0));
+    if (!tmpl->msg || (max_entries > 0 && (!tmpl->entries || !tmpl->entry_offs))) {
+        ret = -ENOMEM;
+        goto err;
+    }
+
+    tmpl->shape = *shape;
+    tmpl->index = index;
+    tmpl->nlmsg_flags = nlmsg_flags;
+    tmpl->gate_flags = gate_flags;
+    tmpl->priority = priority;
+    tmpl->max_entries = max_entries;
+    tmpl->num_entries = num_entries;
+    if (num_entries > 0)
+        memcpy(tmpl->entries, entries, (size_t)num_entries * sizeof(*entries));
+
+    ret = tmpl_encode(tmpl);
+    if (ret < 0)
+        goto err;
+
+    *out = tmpl;
+    return 0;
+
+err:
+    gate_tmpl_free(tmpl);
+    return ret;
+}
+
+struct gb_nl_msg* gate_tmpl_msg(const struct gate_tmpl* tmpl) {
+    return tmpl ? tmpl->msg : NULL;
+}
+
+void gate_tmpl_set_index(struct gate_tmpl* tmpl, uint32_t index) {
+    if (!tmpl)
+        return;
+
+    tmpl->index = index;
+    tmpl_put(tmpl, tmpl->act_index_off, &index, sizeof(index));
+    tmpl_put(tmpl, tmpl->parms_index_off, &index, sizeof(index));
+}
+
+void gate_tmpl_set_base_time(struct gate_tmpl* tmpl, uint64_t base_time) {
+    if (!tmpl)
+        return;
+
+    tmpl->shape.base_time = base_time;
+    tmpl_put(tmpl, tmpl->base_time_off, &base_time, sizeof(base_time));
+}
+
+void gate_tmpl_set_cycle_time(struct gate_tmpl* tmpl, uint64_t cycle_time) {
+    if (!tmpl)
+        return;
+
+    tmpl->shape.cycle_time = cycle_time;
+    tmpl_put(tmpl, tmpl->cycle_time_off, &cycle_time, sizeof(cycle_time));
+}
+
+static void tmpl_patch_entry(struct gate_tmpl* tmpl, uint32_t i, const struct gate_entry* entry) {
+    const struct gate_tmpl_entry* offs = &tmpl->entry_offs[i];
+
+    tmpl->entries[i] = *entry;
+    tmpl_put(tmpl, offs->interval_off, &entry->interval, sizeof(entry->interval));
+    tmpl_put(tmpl, offs->ipv_off, &entry->ipv, sizeof(entry->ipv));
+    tmpl_put(tmpl, offs->maxoctets_off, &entry->maxoctets, sizeof(entry->maxoctets));
+}
+
+int gate_tmpl_set_entry(struct gate_tmpl* tmpl, uint32_t i, const struct gate_entry* entry) {
+    if (!tmpl || !entry)
+        return -EINVAL;
+
+    if (i >= tmpl->num_entries)
+        return -ERANGE;
+
+    if (entry->gate_state == tmpl->entries[i].gate_state) {
+        tmpl_patch_entry(tmpl, i, entry);
+        return 0;
+    }
+
+    tmpl->entries[i] = *entry;
+    return tmpl_encode(tmpl);
+}
+
+int gate_tmpl_set_entries(struct gate_tmpl* tmpl, const struct gate_entry* entries, uint32_t num_entries) {
+    bool same_shape;
+
+    if (!tmpl || (num_entries > 0 && !entries))
+        return -EINVAL;
+
+    if (num_entries > tmpl->max_entries)
+        return -E2BIG;
+
+    same_shape = num_entries == tmpl->num_entries;
+    for (uint32_t i = 0; same_shape && i < num_entries; i++)
+        same_shape = entries[i].gate_state == tmpl->entries[i].gate_state;
+
+    if (same_shape) {
+        for (uint32_t i = 0; i < num_entries; i++)
+            tmpl_patch_entry(tmpl, i, &entries[i]);
+        return 0;
+    }
+
+    tmpl->num_entries = num_entries;
+    if (num_entries > 0)
+        memcpy(tmpl->entries, entries, (size_t)num_entries * sizeof(*entries));
+    return tmpl_encode(tmpl);
+}
+
+void gate_tmpl_free(struct gate_tmpl* tmpl) {
+    if (!tmpl)
+        return;
+
+    if (tmpl->msg)
+        gb_nl_msg_free(tmpl->msg);
+    free(tmpl->entries);
+    free(tmpl->entry_offs);
+    free(tmpl);
+}
+
+/* GET/DEL request naming gate actions by index, one priority slot each */
+static int encode_gate_index_req(struct gb_nl_msg* msg,
+                                 uint16_t type,
+                                 uint16_t nlmsg_flags,
+                                 const uint32_t* indices,
+                                 uint32_t count) {
+    size_t slot = gate_attr_size(0) + gate_attr_size(sizeof("gate")) + gate_attr_size(sizeof(uint32_t));
+    struct nlmsghdr* nlh;
+    struct nlattr* nest_tab;
+
+    if (!msg || !msg->buf || !indices)
+        return -EINVAL;
+
+    if (count == 0 || count > GB_MULTI_ACTIONS_MAX)
+        return -EINVAL;
+
+    if (msg->cap < gate_hdr_size() + gate_attr_size(0) + (size_t)count * slot)
+        return -ENOSPC;
+
+    nlh = put_action_header(msg, type, nlmsg_flags, &nest_tab);
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct nlattr* nest_prio = mnl_attr_nest_start(nlh, (uint16_t)(GATEBENCH_ACT_PRIO + i));
+
+        add_attr_strz(nlh, TCA_ACT_KIND, "gate");
+        add_attr_u32(nlh, TCA_ACT_INDEX, indices[i]);
+
+        mnl_attr_nest_end(nlh, nest_prio);
+    }
 
-    mnl_attr_nest_end(nlh, nest_prio);
     mnl_attr_nest_end(nlh, nest_tab);
 
     msg->len = nlh->nlmsg_len;
     return 0;
 }
 
+int build_gate_delaction(struct gb_nl_msg* msg, uint32_t index) {
+    return encode_gate_index_req(msg, RTM_DELACTION, NLM_F_ACK, &index, 1);
+}
+
+int build_gate_delaction_multi(struct gb_nl_msg* msg, const uint32_t* indices, uint32_t count) {
+    return encode_gate_index_req(msg, RTM_DELACTION, NLM_F_ACK, indices, count);
+}
+
 int build_gate_flushaction(struct gb_nl_msg* msg) {
     struct nlmsghdr* nlh;
     struct tcamsg* tca;
@@ -250,33 +595,11 @@ int build_gate_flushaction(struct gb_nl_msg* msg) {
 }
 
 int build_gate_getaction_ex(struct gb_nl_msg* msg, uint32_t index, uint16_t nlmsg_flags) {
-    struct nlmsghdr* nlh;
-    struct tcamsg* tca;
-    struct nlattr *nest_tab, *nest_prio;
-
-    if (!msg || !msg->buf)
-        return -EINVAL;
-
-    nlh = mnl_nlmsg_put_header(msg->buf);
-    nlh->nlmsg_type = RTM_GETACTION;
-    nlh->nlmsg_flags = NLM_F_REQUEST | nlmsg_flags;
-    nlh->nlmsg_seq = 0;
-
-    tca = mnl_nlmsg_put_extra_header(nlh, sizeof(*tca));
-    memset(tca, 0, sizeof(*tca));
-    tca->tca_family = AF_UNSPEC;
-
-    nest_tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
-    nest_prio = mnl_attr_nest_start(nlh, GATEBENCH_ACT_PRIO);
-
-    add_attr_strz(nlh, TCA_ACT_KIND, "gate");
-    add_attr_u32(nlh, TCA_ACT_INDEX, index);
-
-    mnl_attr_nest_end(nlh, nest_prio);
-    mnl_attr_nest_end(nlh, nest_tab);
+    return encode_gate_index_req(msg, RTM_GETACTION, nlmsg_flags, &index, 1);
+}
 
-    msg->len = nlh->nlmsg_len;
-    return 0;
+int build_gate_getaction_multi(struct gb_nl_msg* msg, const uint32_t* indices, uint32_t count) {
+    return encode_gate_index_req(msg, RTM_GETACTION, 0, indices, count);
 }
 
 int build_gate_getaction(struct gb_nl_msg* msg, uint32_t index) {
@@ -284,6 +607,10 @@ int build_gate_getaction(struct gb_nl_msg* msg, uint32_t index) {
 }
 
 int build_gate_dumpaction(struct gb_nl_msg* msg) {
+    return build_gate_dumpaction_ex(msg, 0, 0);
+}
+
+int build_gate_dumpaction_ex(struct gb_nl_msg* msg, uint32_t root_flags, uint32_t time_delta_ms) {
     struct nlmsghdr* nlh;
     struct tcamsg* tca;
     struct nlattr *nest_tab, *nest_prio;
@@ -310,10 +637,13 @@ int build_gate_dumpaction(struct gb_nl_msg* msg) {
     add_attr_nest_raw_end(nlh, nest_tab);
 
     memset(&flags, 0, sizeof(flags));
-    flags.value = TCA_ACT_FLAG_LARGE_DUMP_ON;
-    flags.selector = TCA_ACT_FLAG_LARGE_DUMP_ON;
+    flags.value = TCA_ACT_FLAG_LARGE_DUMP_ON | root_flags;
+    flags.selector = TCA_ACT_FLAG_LARGE_DUMP_ON | root_flags;
     mnl_attr_put(nlh, TCA_ROOT_FLAGS, sizeof(flags), &flags);
 
+    if (time_delta_ms != 0)
+        mnl_attr_put_u32(nlh, TCA_ROOT_TIME_DELTA, time_delta_ms);
+
     msg->len = nlh->nlmsg_len;
     return 0;
 }
@@ -325,13 +655,32 @@ void gb_gate_dump_free(struct gate_dump* dump) {
     free(dump->entries);
     dump->entries = NULL;
     dump->num_entries = 0;
+    dump->entries_cap = 0;
+}
+
+/* Walk state shared by gb_nl_gate_visit() and gb_gate_view_entries() */
+struct gate_visit_ctx {
+    gb_gate_visit_fn action_fn;
+    gb_gate_entry_fn entry_fn;
+    void* arg;
+    struct gate_view view;
+    int visited;
+    int ret; /* Callback error that stopped the walk */
+};
+
+static int count_gate_entries_cb(const struct nlattr* attr, void* data) {
+    uint32_t* count = data;
+
+    if (mnl_attr_get_type(attr) == TCA_GATE_ONE_ENTRY)
+        (*count)++;
+
+    return MNL_CB_OK;
 }
 
-static int parse_gate_entries_cb(const struct nlattr* attr, void* data) {
-    struct gate_dump* dump = data;
+static int visit_gate_entry_cb(const struct nlattr* attr, void* data) {
+    struct gate_visit_ctx* ctx = data;
     const struct nlattr* tb[TCA_GATE_ENTRY_MAX + 1] = {NULL};
-    struct gate_entry* entry;
-    struct gate_entry* new_entries;
+    struct gate_entry entry;
 
     if (mnl_attr_get_type(attr) != TCA_GATE_ONE_ENTRY)
         return MNL_CB_OK;
@@ -339,38 +688,52 @@ static int parse_gate_entries_cb(const struct nlattr* attr, void* data) {
     if (parse_nested_attrs_limited(attr, tb, TCA_GATE_ENTRY_MAX) < 0)
         return MNL_CB_ERROR;
 
-    new_entries = realloc(dump->entries, sizeof(*new_entries) * (dump->num_entries + 1));
-    if (!new_entries)
-        return MNL_CB_ERROR;
-
-    dump->entries = new_entries;
-    entry = &dump->entries[dump->num_entries];
-    memset(entry, 0, sizeof(*entry));
+    memset(&entry, 0, sizeof(entry));
 
-    entry->gate_state = tb[TCA_GATE_ENTRY_GATE] != NULL;
+    entry.gate_state = tb[TCA_GATE_ENTRY_GATE] != NULL;
 
     if (tb[TCA_GATE_ENTRY_INDEX])
-        entry->index = mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INDEX]);
+        entry.index = mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INDEX]);
 
     if (tb[TCA_GATE_ENTRY_INTERVAL])
-        entry->interval = mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INTERVAL]);
+        entry.interval = mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INTERVAL]);
 
     if (tb[TCA_GATE_ENTRY_IPV])
-        entry->ipv = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_IPV]);
+        entry.ipv = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_IPV]);
     else
-        entry->ipv = -1;
+        entry.ipv = -1;
 
     if (tb[TCA_GATE_ENTRY_MAX_OCTETS])
-        entry->maxoctets = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_MAX_OCTETS]);
+        entry.maxoctets = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_MAX_OCTETS]);
     else
-        entry->maxoctets = -1;
+        entry.maxoctets = -1;
 
-    dump->num_entries++;
-    return MNL_CB_OK;
+    ctx->ret = ctx->entry_fn(&entry, ctx->arg);
+    return ctx->ret < 0 ? MNL_CB_ERROR : MNL_CB_OK;
 }
 
-static int parse_gate_options(const struct nlattr* attr, struct gate_dump* dump) {
+int gb_gate_view_entries(const struct gate_view* view, gb_gate_entry_fn fn, void* arg) {
+    struct gate_visit_ctx ctx;
+
+    if (!view || !fn)
+        return -EINVAL;
+
+    if (!view->entry_list)
+        return 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.entry_fn = fn;
+    ctx.arg = arg;
+
+    if (mnl_attr_parse_nested(view->entry_list, visit_gate_entry_cb, &ctx) < 0)
+        return ctx.ret < 0 ? ctx.ret : -EINVAL;
+
+    return 0;
+}
+
+static int parse_gate_options(const struct nlattr* attr, struct gate_view* view) {
     const struct nlattr* tb[TCA_GATE_MAX + 1] = {NULL};
+    struct gate_dump* dump = &view->action;
 
     if (parse_nested_attrs_limited(attr, tb, TCA_GATE_MAX) < 0)
         return -1;
@@ -398,8 +761,10 @@ static int parse_gate_options(const struct nlattr* attr, struct gate_dump* dump)
     if (tb[TCA_GATE_PRIORITY])
         dump->priority = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_PRIORITY]);
 
+    /* Entries stay in the buffer; only count them so copies can size once */
     if (tb[TCA_GATE_ENTRY_LIST]) {
-        if (mnl_attr_parse_nested(tb[TCA_GATE_ENTRY_LIST], parse_gate_entries_cb, dump) < 0)
+        view->entry_list = tb[TCA_GATE_ENTRY_LIST];
+        if (mnl_attr_parse_nested(view->entry_list, count_gate_entries_cb, &dump->num_entries) < 0)
             return -1;
     }
 
@@ -439,7 +804,8 @@ static int parse_action_stats(const struct nlattr* attr, struct gate_dump* dump)
 }
 
 static int parse_action_prio_cb(const struct nlattr* attr, void* data) {
-    struct gate_dump* dump = data;
+    struct gate_visit_ctx* ctx = data;
+    struct gate_view* view = &ctx->view;
     const struct nlattr* tb[TCA_ACT_MAX + 1] = {NULL};
 
     if (parse_nested_attrs_limited(attr, tb, TCA_ACT_MAX) < 0)
@@ -448,41 +814,110 @@ static int parse_action_prio_cb(const struct nlattr* attr, void* data) {
     if (!tb[TCA_ACT_KIND] || strcmp(mnl_attr_get_str(tb[TCA_ACT_KIND]), "gate") != 0)
         return MNL_CB_OK;
 
+    memset(view, 0, sizeof(*view));
+    view->action.priority = -1;
+
     if (tb[TCA_ACT_INDEX])
-        dump->index = mnl_attr_get_u32(tb[TCA_ACT_INDEX]);
+        view->action.index = mnl_attr_get_u32(tb[TCA_ACT_INDEX]);
 
     if (tb[TCA_ACT_OPTIONS]) {
-        if (parse_gate_options(tb[TCA_ACT_OPTIONS], dump) < 0)
+        if (parse_gate_options(tb[TCA_ACT_OPTIONS], view) < 0)
             return MNL_CB_ERROR;
     }
 
     if (tb[TCA_ACT_STATS]) {
-        if (parse_action_stats(tb[TCA_ACT_STATS], dump) < 0)
+        if (parse_action_stats(tb[TCA_ACT_STATS], &view->action) < 0)
+            return MNL_CB_ERROR;
+    }
+
+    ctx->visited++;
+    if (ctx->action_fn) {
+        ctx->ret = ctx->action_fn(view, ctx->arg);
+        if (ctx->ret < 0)
             return MNL_CB_ERROR;
     }
 
     return MNL_CB_OK;
 }
 
-int gb_nl_gate_parse(const struct nlmsghdr* nlh, struct gate_dump* dump) {
-    struct tcamsg* tca;
+int gb_nl_gate_visit(const struct nlmsghdr* nlh, gb_gate_visit_fn fn, void* arg) {
     const struct nlattr* tb[TCA_ROOT_MAX + 1] = {NULL};
+    struct gate_visit_ctx ctx;
+
+    if (!nlh)
+        return -EINVAL;
 
+    if (parse_attrs_limited(nlh, sizeof(struct tcamsg), tb, TCA_ROOT_MAX) < 0)
+        return -EINVAL;
+
+    if (!tb[TCA_ACT_TAB])
+        return 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.action_fn = fn;
+    ctx.arg = arg;
+
+    if (mnl_attr_parse_nested(tb[TCA_ACT_TAB], parse_action_prio_cb, &ctx) < 0)
+        return ctx.ret < 0 ? ctx.ret : -EINVAL;
+
+    return ctx.visited;
+}
+
+static int store_entry_cb(const struct gate_entry* entry, void* arg) {
+    struct gate_dump* dump = arg;
+
+    dump->entries[dump->num_entries++] = *entry;
+    return 0;
+}
+
+/* Copy one visited action into dump, reusing its entries storage */
+static int parse_into_cb(const struct gate_view* view, void* arg) {
+    struct gate_dump* dump = arg;
+    struct gate_entry* entries = dump->entries;
+    uint32_t entries_cap = dump->entries_cap;
+    uint32_t need = view->action.num_entries;
+
+    if (need > entries_cap) {
+        entries = realloc(entries, sizeof(*entries) * need);
+        if (!entries)
+            return -ENOMEM;
+
+        gb_nl_count_alloc();
+        entries_cap = need;
+    }
+
+    *dump = view->action;
+    dump->entries = entries;
+    dump->entries_cap = entries_cap;
+    dump->num_entries = 0;
+
+    return gb_gate_view_entries(view, store_entry_cb, dump);
+}
+
+int gb_nl_gate_parse(const struct nlmsghdr* nlh, struct gate_dump* dump) {
     if (!nlh || !dump)
         return -EINVAL;
 
     memset(dump, 0, sizeof(*dump));
-    dump->priority = -1;
+    return gb_nl_gate_parse_into(nlh, dump);
+}
 
-    tca = mnl_nlmsg_get_payload(nlh);
+int gb_nl_gate_parse_into(const struct nlmsghdr* nlh, struct gate_dump* dump) {
+    struct gate_entry* entries;
+    uint32_t entries_cap;
+    int ret;
 
-    if (parse_attrs_limited(nlh, sizeof(*tca), tb, TCA_ROOT_MAX) < 0)
-        return -1;
+    if (!nlh || !dump)
+        return -EINVAL;
 
-    if (tb[TCA_ACT_TAB]) {
-        if (mnl_attr_parse_nested(tb[TCA_ACT_TAB], parse_action_prio_cb, dump) < 0)
-            return -1;
-    }
+    entries = dump->entries;
+    entries_cap = dump->entries_cap;
 
-    return 0;
+    memset(dump, 0, sizeof(*dump));
+    dump->priority = -1;
+    dump->entries = entries;
+    dump->entries_cap = entries_cap;
+
+    ret = gb_nl_gate_visit(nlh, parse_into_cb, dump);
+    return ret < 0 ? ret : 0;
 }
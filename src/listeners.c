@@ -0,0 +1,488 @@
+/* src/listeners.c
+ * Notification fan-out: K sockets subscribed to RTNLGRP_TC read the events a
+ * writer's create/replace loop generates, measuring how late each listener
+ * hears about a change and what the fan-out costs the writer.
+ */
+#include "../include/gatebench_listeners.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <linux/rtnetlink.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* How often an idle listener checks for the end of a step */
+#define LISTENER_POLL_MS 10
+#define LISTENER_RESP_SIZE (64u * 1024u)
+
+/* One timed writer op; op i was sent with seq first_seq + i */
+struct writer_op {
+    uint32_t seq;
+    int err;
+    uint64_t send_ns; /* CLOCK_MONOTONIC_RAW before gb_nl_send_recv */
+    uint64_t ack_ns;  /* CLOCK_MONOTONIC_RAW when gb_nl_send_recv returned */
+};
+
+struct listener {
+    struct gb_nl_sock* sock;
+    struct gb_nl_msg* resp;
+    uint32_t writer_pid;
+    const atomic_bool* stop;
+
+    /* Writer notifications in arrival order */
+    uint32_t* seqs;
+    uint64_t* rx_ns;
+    size_t count;
+    size_t cap;
+
+    uint64_t overruns;
+    int ret;
+};
+
+struct listeners_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* writer;
+    struct gb_nl_msg* create_msg;
+    struct gb_nl_msg* replace_msg;
+    struct gb_nl_msg* del_msg;
+    struct gb_nl_msg* resp;
+    struct writer_op* ops;
+    uint64_t op_count;
+    atomic_bool stop;
+};
+
+static void* listener_main(void* arg) {
+    struct listener* l = arg;
+
+    for (;;) {
+        const struct nlmsghdr* nlh;
+        uint64_t now = 0;
+        int len;
+
+        len = gb_nl_recv(l->sock, l->resp, LISTENER_POLL_MS);
+        if (len == -ETIMEDOUT || len == -EINTR) {
+            /* Only stop once the queue is drained */
+            if (atomic_load(l->stop))
+                break;
+            continue;
+        }
+        if (len == -ENOBUFS) {
+            l->overruns++;
+            continue;
+        }
+        if (len < 0) {
+            l->ret = len;
+            break;
+        }
+
+        (void)gb_util_ns_now(&now, CLOCK_MONOTONIC_RAW);
+
+        for (nlh = l->resp->buf; mnl_nlmsg_ok(nlh, len); nlh = mnl_nlmsg_next(nlh, &len)) {
+            if (nlh->nlmsg_type != RTM_NEWACTION && nlh->nlmsg_type != RTM_DELACTION)
+                continue;
+            if (nlh->nlmsg_pid != l->writer_pid || l->count == l->cap)
+                continue;
+
+            l->seqs[l->count] = nlh->nlmsg_seq;
+            l->rx_ns[l->count] = now;
+            l->count++;
+        }
+    }
+
+    return NULL;
+}
+
+/* Writer side of one step: the create/replace loop of the benchmark */
+static int listeners_write(struct listeners_ctx* ctx, struct gb_stats* lat, struct gb_listeners_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t start_ns = 0, end_ns = 0;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->warmup; i++) {
+        ret = gb_nl_send_recv(ctx->writer, ctx->create_msg, ctx->resp, cfg->timeout_ms);
+        if (ret < 0 && ret != -EEXIST)
+            return ret;
+
+        ret = gb_nl_send_recv(ctx->writer, ctx->replace_msg, ctx->resp, cfg->timeout_ms);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = gb_nl_send_recv(ctx->writer, ctx->del_msg, ctx->resp, cfg->timeout_ms);
+    if (ret < 0 && ret != -ENOENT)
+        return ret;
+
+    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+
+    for (uint64_t i = 0; i < ctx->op_count; i++) {
+        struct gb_nl_msg* msg = (i % 2u) == 0u ? ctx->create_msg : ctx->replace_msg;
+        struct writer_op* op = &ctx->ops[i];
+
+        ret = gb_util_ns_now(&op->send_ns, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+        op->err = gb_nl_send_recv(ctx->writer, msg, ctx->resp, cfg->timeout_ms);
+        ret = gb_util_ns_now(&op->ack_ns, CLOCK_MONOTONIC_RAW);
+        if (ret < 0)
+            return ret;
+        op->seq = ((const struct nlmsghdr*)msg->buf)->nlmsg_seq;
+
+        if (op->err == -ETIMEDOUT)
+            return op->err;
+        if (op->err != 0 && !((i % 2u) == 0u && op->err == -EEXIST))
+            step->errors++;
+
+        ret = gb_stats_add(lat, op->ack_ns - op->send_ns);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = gb_util_ns_now(&end_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+
+    step->ops = ctx->op_count;
+    step->secs = (double)(end_ns - start_ns) / 1e9;
+    if (step->secs > 0.0)
+        step->ops_per_sec = (double)step->ops / step->secs;
+
+    /* Leave the slot empty for the next step; its notification is ignored */
+    ret = gb_nl_send_recv(ctx->writer, ctx->del_msg, ctx->resp, cfg->timeout_ms);
+    if (ret < 0 && ret != -ENOENT)
+        return ret;
+
+    return 0;
+}
+
+/* Match each listener's notifications to the writer ops that caused them */
+static int listeners_match(const struct listeners_ctx* ctx,
+                           const struct listener* ls,
+                           uint32_t k,
+                           struct gb_stats* notify,
+                           struct gb_listeners_step* step) {
+    uint64_t notifying = 0;
+    uint32_t first_seq;
+    int ret;
+
+    if (ctx->op_count == 0)
+        return 0;
+
+    for (uint64_t i = 0; i < ctx->op_count; i++) {
+        if (ctx->ops[i].err == 0)
+            notifying++;
+    }
+    step->expected = notifying * k;
+
+    first_seq = ctx->ops[0].seq;
+    for (uint32_t j = 0; j < k; j++) {
+        const struct listener* l = &ls[j];
+
+        step->overruns += l->overruns;
+
+        for (size_t n = 0; n < l->count; n++) {
+            uint64_t idx = (uint64_t)(uint32_t)(l->seqs[n] - first_seq);
+            const struct writer_op* op;
+
+            if (idx >= ctx->op_count)
+                continue;
+            op = &ctx->ops[idx];
+            if (op->seq != l->seqs[n] || op->err != 0)
+                continue;
+
+            /*
+             * rtnetlink multicasts before it acks, so most reads land before
+             * the ack returns: measure from the send, which every read follows.
+             */
+            step->received++;
+            if (l->rx_ns[n] < op->ack_ns)
+                step->early++;
+
+            ret = gb_stats_add(notify, l->rx_ns[n] > op->send_ns ? l->rx_ns[n] - op->send_ns : 0);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+static void listener_free(struct listener* l) {
+    gb_nl_close(l->sock);
+    gb_nl_msg_free(l->resp);
+    free(l->seqs);
+    free(l->rx_ns);
+    memset(l, 0, sizeof(*l));
+}
+
+static int listeners_step(struct listeners_ctx* ctx, uint32_t k, struct gb_listeners_step* step) {
+    struct listener* ls = NULL;
+    pthread_t* threads = NULL;
+    struct gb_stats lat, notify;
+    size_t slots = (size_t)ctx->op_count + (size_t)ctx->cfg->warmup * 2u + 4u;
+    uint32_t started = 0;
+    int ret, wret;
+
+    memset(step, 0, sizeof(*step));
+    step->listeners = k;
+
+    ret = gb_stats_init(&lat, ctx->op_count > 0 ? (size_t)ctx->op_count : 1u);
+    if (ret < 0)
+        return ret;
+    ret = gb_stats_init(&notify, k > 0 && ctx->op_count > 0 ? (size_t)ctx->op_count * k : 1u);
+    if (ret < 0) {
+        gb_stats_free(&lat);
+        return ret;
+    }
+
+    if (k > 0) {
+        ls = calloc(k, sizeof(*ls));
+        threads = calloc(k, sizeof(*threads));
+        if (!ls || !threads) {
+            ret = -ENOMEM;
+            goto out;
+        }
+    }
+
+    for (uint32_t j = 0; j < k; j++) {
+        struct listener* l = &ls[j];
+
+        l->writer_pid = gb_nl_portid(ctx->writer);
+        l->stop = &ctx->stop;
+        l->cap = slots;
+        l->seqs = malloc(slots * sizeof(*l->seqs));
+        l->rx_ns = malloc(slots * sizeof(*l->rx_ns));
+        l->resp = gb_nl_msg_alloc(LISTENER_RESP_SIZE);
+        if (!l->seqs || !l->rx_ns || !l->resp) {
+            ret = -ENOMEM;
+            goto out;
+        }
+
+        ret = gb_nl_open(&l->sock);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_join_group(l->sock, RTNLGRP_TC);
+        if (ret < 0)
+            goto out;
+    }
+
+    atomic_store(&ctx->stop, false);
+    for (uint32_t j = 0; j < k; j++) {
+        ret = -pthread_create(&threads[j], NULL, listener_main, &ls[j]);
+        if (ret < 0)
+            break;
+        started++;
+    }
+
+    wret = ret < 0 ? ret : listeners_write(ctx, &lat, step);
+
+    atomic_store(&ctx->stop, true);
+    for (uint32_t j = 0; j < started; j++)
+        pthread_join(threads[j], NULL);
+
+    ret = wret;
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t j = 0; j < k; j++) {
+        if (ls[j].ret < 0) {
+            ret = ls[j].ret;
+            goto out;
+        }
+    }
+
+    ret = listeners_match(ctx, ls, k, &notify, step);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_summarize(&lat, &step->writer);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_summarize(&notify, &step->notify);
+
+out:
+    if (ls) {
+        for (uint32_t j = 0; j < k; j++)
+            listener_free(&ls[j]);
+    }
+    free(ls);
+    free(threads);
+    gb_stats_free(&lat);
+    gb_stats_free(&notify);
+    return ret;
+}
+
+/* 0, 1, 2, 4, ... up to and including max */
+static uint32_t listeners_sweep(uint32_t max, uint32_t* out) {
+    uint32_t n = 0;
+
+    out[n++] = 0;
+    for (uint32_t k = 1; k < max; k *= 2u)
+        out[n++] = k;
+    if (max > 0)
+        out[n++] = max;
+
+    return n;
+}
+
+int gb_listeners_run(const struct gb_config* cfg, struct gb_listeners_summary* summary) {
+    struct listeners_ctx ctx;
+    struct gate_shape shape;
+    struct gate_entry* entries = NULL;
+    uint32_t sweep[34];
+    uint32_t steps;
+    uint32_t entry_count;
+    size_t msg_cap;
+    int ret;
+
+    if (!cfg || !summary || cfg->listeners == 0 || cfg->listeners > GB_LISTENERS_MAX)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    ctx.op_count = (uint64_t)cfg->iters * 2u;
+
+    entry_count = cfg->entries;
+
+    memset(&shape, 0, sizeof(shape));
+    shape.clockid = cfg->clockid;
+    shape.base_time = cfg->base_time;
+    shape.cycle_time = cfg->cycle_time;
+    shape.cycle_time_ext = cfg->cycle_time_ext;
+    shape.interval_ns = cfg->interval_ns;
+    shape.entries = entry_count;
+
+    if (entry_count > 0) {
+        entries = malloc((size_t)entry_count * sizeof(*entries));
+        if (!entries)
+            return -ENOMEM;
+        ret = gb_fill_entries(entries, entry_count, cfg->interval_ns);
+        if (ret < 0)
+            goto out;
+    }
+
+    steps = listeners_sweep(cfg->listeners, sweep);
+    summary->per_step = calloc(steps, sizeof(*summary->per_step));
+    ctx.ops = calloc(ctx.op_count > 0 ? (size_t)ctx.op_count : 1u, sizeof(*ctx.ops));
+    msg_cap = gate_msg_capacity(entry_count, 0);
+    ctx.create_msg = gb_nl_msg_alloc(msg_cap);
+    ctx.replace_msg = gb_nl_msg_alloc(msg_cap);
+    ctx.del_msg = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!summary->per_step || !ctx.ops || !ctx.create_msg || !ctx.replace_msg || !ctx.del_msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = build_gate_newaction(ctx.create_msg, cfg->index, &shape, entries, entry_count, NLM_F_CREATE | NLM_F_EXCL, 0,
+                               -1);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_newaction(ctx.replace_msg, cfg->index, &shape, entries, entry_count,
+                               NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_delaction(ctx.del_msg, cfg->index);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.writer);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t s = 0; s < steps; s++) {
+        if (!cfg->json)
+            printf("  %3u listeners... ", sweep[s]);
+        fflush(stdout);
+
+        ret = listeners_step(&ctx, sweep[s], &summary->per_step[s]);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->steps = s + 1u;
+
+        if (!cfg->json)
+            printf("done (%.1f ops/sec)\n", summary->per_step[s].ops_per_sec);
+    }
+
+out:
+    gb_nl_close(ctx.writer);
+    gb_nl_msg_free(ctx.create_msg);
+    gb_nl_msg_free(ctx.replace_msg);
+    gb_nl_msg_free(ctx.del_msg);
+    gb_nl_msg_free(ctx.resp);
+    free(ctx.ops);
+    free(entries);
+    if (ret < 0)
+        gb_listeners_summary_free(summary);
+    return ret;
+}
+
+void gb_listeners_print_summary(const struct gb_listeners_summary* summary, const struct gb_config* cfg) {
+    uint64_t base_p50 = 0;
+
+    if (!summary || !cfg || summary->steps == 0)
+        return;
+
+    base_p50 = summary->per_step[0].writer.p50_ns;
+
+    printf("Listeners: writer op latency and send->notification latency per listener count\n");
+    printf("  %9s %12s %12s %12s %8s %12s %12s %12s %9s %8s %9s\n", "listeners", "ops/sec", "writer p50", "writer p99",
+           "p50 x", "notify p50", "notify p99", "notify max", "missed", "early", "overruns");
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_listeners_step* st = &summary->per_step[s];
+        double growth = base_p50 > 0 ? (double)st->writer.p50_ns / (double)base_p50 : 0.0;
+
+        printf("  %9u %12.1f %9llu ns %9llu ns %7.2fx", st->listeners, st->ops_per_sec,
+               (unsigned long long)st->writer.p50_ns, (unsigned long long)st->writer.p99_ns, growth);
+        if (st->listeners == 0) {
+            printf(" %12s %12s %12s %9s %8s %9s\n", "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+        printf(" %9llu ns %9llu ns %9llu ns %9llu %8llu %9llu\n", (unsigned long long)st->notify.p50_ns,
+               (unsigned long long)st->notify.p99_ns, (unsigned long long)st->notify.max_ns,
+               (unsigned long long)(st->expected - st->received), (unsigned long long)st->early,
+               (unsigned long long)st->overruns);
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_listeners_step* st = &summary->per_step[s];
+
+        printf("  K=%u: %llu ops, %llu errors, %llu/%llu notifications, writer p95 %llu ns, p999 %llu ns, "
+               "notify p95 %llu ns, p999 %llu ns\n",
+               st->listeners, (unsigned long long)st->ops, (unsigned long long)st->errors,
+               (unsigned long long)st->received, (unsigned long long)st->expected,
+               (unsigned long long)st->writer.p95_ns, (unsigned long long)st->writer.p999_ns,
+               (unsigned long long)st->notify.p95_ns, (unsigned long long)st->notify.p999_ns);
+    }
+}
+
+void gb_listeners_summary_free(struct gb_listeners_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_step);
+    summary->per_step = NULL;
+    summary->steps = 0;
+}
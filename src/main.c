@@ -4,11 +4,27 @@
 
 #include "../include/gatebench.h"
 #include "../include/gatebench_cli.h"
+#include "../include/gatebench_clients.h"
+#include "../include/gatebench_entry_sweep.h"
+#include "../include/gatebench_multi.h"
+#include "../include/gatebench_teardown.h"
+#include "../include/gatebench_dump_pop.h"
+#include "../include/gatebench_act_stats.h"
+#include "../include/gatebench_auto_index.h"
+#include "../include/gatebench_threads.h"
+#include "../include/gatebench_rw.h"
+#include "../include/gatebench_open_loop.h"
+#include "../include/gatebench_slo.h"
+#include "../include/gatebench_mix.h"
+#include "../include/gatebench_listeners.h"
+#include "../include/gatebench_netns.h"
+#include "../include/gatebench_nl.h"
 #include "../include/gatebench_util.h"
 #include "../include/gatebench_bench.h"
 #include "../include/gatebench_selftest.h"
 #include "../include/gatebench_proof.h"
 #include "../include/gatebench_race.h"
+#include "../include/gatebench_trace.h"
 
 #include <errno.h>
 #include <inttypes.h>
@@ -172,12 +188,56 @@ static void json_print_config_obj(const struct gb_config* cfg) {
     printf("    \"nlmon_iface\": ");
     json_print_string_or_null(cfg->nlmon_iface);
     printf(",\n");
+    printf("    \"dump_pipeline\": %s,\n", cfg->dump_pipeline ? "true" : "false");
     printf("    \"clockid\": %" PRIu32 ",\n", cfg->clockid);
     printf("    \"base_time\": %" PRIu64 ",\n", cfg->base_time);
     printf("    \"cycle_time\": %" PRIu64 ",\n", cfg->cycle_time);
     printf("    \"cycle_time_ext\": %" PRIu64 ",\n", cfg->cycle_time_ext);
     printf("    \"race_mode\": %s,\n", cfg->race_mode ? "true" : "false");
-    printf("    \"race_seconds\": %" PRIu32 "\n", cfg->race_seconds);
+    printf("    \"race_seconds\": %" PRIu32 ",\n", cfg->race_seconds);
+    printf("    \"batch\": %" PRIu32 ",\n", cfg->batch);
+    printf("    \"window\": %" PRIu32 ",\n", cfg->window);
+    printf("    \"clients\": %" PRIu32 ",\n", cfg->clients);
+    printf("    \"listeners\": %" PRIu32 ",\n", cfg->listeners);
+    printf("    \"netns\": %" PRIu32 ",\n", cfg->netns);
+    printf("    \"entry_sweep\": %" PRIu32 ",\n", cfg->entry_sweep);
+    printf("    \"multi_actions\": %" PRIu32 ",\n", cfg->multi_actions);
+    printf("    \"teardown\": %" PRIu32 ",\n", cfg->teardown);
+    printf("    \"dump_population\": %" PRIu32 ",\n", cfg->dump_pop);
+    printf("    \"dump_delta\": %" PRIu32 ",\n", cfg->dump_delta);
+    printf("    \"act_stats\": %" PRIu32 ",\n", cfg->act_stats);
+    printf("    \"auto_index\": %" PRIu32 ",\n", cfg->auto_index);
+    printf("    \"threads\": %" PRIu32 ",\n", cfg->threads);
+    printf("    \"rw_writers\": %" PRIu32 ",\n", cfg->rw_writers);
+    printf("    \"rw_readers\": %" PRIu32 ",\n", cfg->rw_readers);
+    printf("    \"rw_indices\": %" PRIu32 ",\n", cfg->rw_indices);
+    printf("    \"rw_ms\": %" PRIu32 ",\n", cfg->rw_ms);
+    printf("    \"rate\": %" PRIu32 ",\n", cfg->rate);
+    printf("    \"arrivals\": \"%s\",\n", gb_arrivals_name((enum gb_arrivals)cfg->arrivals));
+    printf("    \"slo_ns\": %" PRIu64 ",\n", cfg->slo_ns);
+    printf("    \"slo_pct\": ");
+    json_print_double((double)cfg->slo_pct / 10.0);
+    printf(",\n");
+    printf("    \"mix\": ");
+    json_print_string_or_null(cfg->mix);
+    printf(",\n");
+    printf("    \"hot_set\": %" PRIu32 ",\n", cfg->hot_set);
+    printf("    \"zipf\": ");
+    json_print_double(cfg->zipf);
+    printf(",\n");
+    printf("    \"phases\": %s,\n", cfg->phases ? "true" : "false");
+    printf("    \"cycle\": %s,\n", cfg->cycle ? "true" : "false");
+    printf("    \"backend\": \"%s\",\n", gb_nl_backend_name((enum gb_nl_backend)cfg->nl_backend));
+    printf("    \"loopback_service\": ");
+    json_print_string_or_null(cfg->loopback_service);
+    printf(",\n");
+    printf("    \"trace\": ");
+    json_print_string_or_null(cfg->trace_path);
+    printf(",\n");
+    printf("    \"replay\": ");
+    json_print_string_or_null(cfg->replay_path);
+    printf(",\n");
+    printf("    \"replay_pace\": \"%s\"\n", gb_replay_pace_name((enum gb_replay_pace)cfg->replay_pace));
     printf("  }");
 }
 
@@ -206,6 +266,56 @@ static void json_print_selftests_obj(bool ran, int ret) {
     printf("  }");
 }
 
+static void json_print_latency_obj(const struct gb_latency_summary* lat) {
+    printf("{\"count\": %" PRIu64 ", \"min\": %" PRIu64 ", \"max\": %" PRIu64 ", \"mean\": ", lat->count, lat->min_ns,
+           lat->max_ns);
+    json_print_double(lat->mean_ns);
+    printf(", \"stddev\": ");
+    json_print_double(lat->stddev_ns);
+    printf(", \"p50\": %" PRIu64 ", \"p95\": %" PRIu64 ", \"p99\": %" PRIu64 ", \"p999\": %" PRIu64 "}", lat->p50_ns,
+           lat->p95_ns, lat->p99_ns, lat->p999_ns);
+}
+
+static void json_print_phases_obj(const struct gb_run_result* run) {
+    if (!run->has_phases) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("          \"build\": ");
+    json_print_latency_obj(&run->phases.build);
+    printf(",\n          \"send\": ");
+    json_print_latency_obj(&run->phases.send);
+    printf(",\n          \"wait\": ");
+    json_print_latency_obj(&run->phases.wait);
+    printf(",\n          \"recv\": ");
+    json_print_latency_obj(&run->phases.recv);
+    printf(",\n          \"parse\": ");
+    json_print_latency_obj(&run->phases.parse);
+    printf(",\n          \"stats\": ");
+    json_print_latency_obj(&run->phases.stats);
+    printf("\n        }");
+}
+
+static void json_print_cycle_obj(const struct gb_run_result* run) {
+    if (!run->has_cycle) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("          \"create\": ");
+    json_print_latency_obj(&run->cycle.create);
+    printf(",\n          \"exists\": ");
+    json_print_latency_obj(&run->cycle.exists);
+    printf(",\n          \"replace\": ");
+    json_print_latency_obj(&run->cycle.replace);
+    printf(",\n          \"delete\": ");
+    json_print_latency_obj(&run->cycle.del);
+    printf("\n        }");
+}
+
 static void json_print_benchmark_obj(const struct gb_summary* summary) {
     if (!summary || !summary->runs || summary->run_count == 0) {
         fputs("null", stdout);
@@ -267,6 +377,19 @@ static void json_print_benchmark_obj(const struct gb_summary* summary) {
         printf("          \"delete\": %" PRIu32 "\n", run->del_len);
         printf("        },\n");
 
+        printf("        \"batch_size\": %" PRIu32 ",\n", run->batch_size);
+        printf("        \"batch_count\": %" PRIu32 ",\n", run->batch_count);
+        printf("        \"window\": %" PRIu32 ",\n", run->window);
+        printf("        \"ack_gap_p50_ns\": %" PRIu64 ",\n", run->ack_gap_p50_ns);
+        printf("        \"allocs_per_op\": ");
+        json_print_double(run->allocs_per_op);
+        printf(",\n");
+        printf("        \"phases_ns\": ");
+        json_print_phases_obj(run);
+        printf(",\n");
+        printf("        \"cycle_ns\": ");
+        json_print_cycle_obj(run);
+        printf(",\n");
         printf("        \"sample_count\": %" PRIu32 "\n", run->sample_count);
         printf("      }%s\n", (i + 1u < summary->run_count) ? "," : "");
     }
@@ -286,6 +409,13 @@ static void json_print_dump_proof_obj(const struct gb_dump_summary* summary) {
     printf("    \"saw_done\": %s,\n", summary->saw_done ? "true" : "false");
     printf("    \"saw_error\": %s,\n", summary->saw_error ? "true" : "false");
     printf("    \"error_code\": %d,\n", summary->error_code);
+    printf("    \"pipelined\": %s,\n", summary->pipelined ? "true" : "false");
+    printf("    \"actions\": %" PRIu64 ",\n", summary->actions);
+    printf("    \"entries\": %" PRIu64 ",\n", summary->entries);
+    printf("    \"parse_ns\": %" PRIu64 ",\n", summary->parse_ns);
+    printf("    \"wall_ns\": %" PRIu64 ",\n", summary->wall_ns);
+    printf("    \"parse_bytes_per_sec\": %.0f,\n", summary->parse_bytes_per_sec);
+    printf("    \"parse_actions_per_sec\": %.0f,\n", summary->parse_actions_per_sec);
     printf("    \"pcap_enabled\": %s,\n", summary->pcap_enabled ? "true" : "false");
     printf("    \"pcap_error\": %d\n", summary->pcap_error);
     printf("  }");
@@ -333,6 +463,563 @@ static void json_print_race_obj(const struct gb_race_summary* summary) {
     printf("  }");
 }
 
+static void json_print_clients_obj(const struct gb_clients_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"clients\": %" PRIu32 ",\n", summary->clients);
+    printf("    \"total_ops\": %" PRIu64 ",\n", summary->total_ops);
+    printf("    \"total_errors\": %" PRIu64 ",\n", summary->total_errors);
+    printf("    \"secs\": ");
+    json_print_double(summary->secs);
+    printf(",\n");
+    printf("    \"ops_per_sec\": ");
+    json_print_double(summary->ops_per_sec);
+    printf(",\n");
+    printf("    \"epoll_waits\": %" PRIu64 ",\n", summary->epoll_waits);
+    printf("    \"latency_ns\": ");
+    json_print_latency_obj(&summary->latency);
+    printf(",\n");
+    printf("    \"per_client\": [\n");
+    for (uint32_t i = 0; i < summary->clients; i++) {
+        const struct gb_client_summary* cs = &summary->per_client[i];
+
+        printf("      {\"index\": %" PRIu32 ", \"ops\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"last_error\": %d, "
+               "\"latency_ns\": ",
+               cs->index, cs->ops, cs->errors, cs->last_error);
+        json_print_latency_obj(&cs->latency);
+        printf("}%s\n", (i + 1u < summary->clients) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_listeners_obj(const struct gb_listeners_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"steps\": [\n");
+    for (uint32_t i = 0; i < summary->steps; i++) {
+        const struct gb_listeners_step* st = &summary->per_step[i];
+
+        printf("      {\"listeners\": %" PRIu32 ", \"ops\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"secs\": ",
+               st->listeners, st->ops, st->errors);
+        json_print_double(st->secs);
+        printf(", \"ops_per_sec\": ");
+        json_print_double(st->ops_per_sec);
+        printf(",\n       \"writer_latency_ns\": ");
+        json_print_latency_obj(&st->writer);
+        printf(",\n       \"notifications_expected\": %" PRIu64 ", \"notifications_received\": %" PRIu64
+               ", \"early\": %" PRIu64 ", \"overruns\": %" PRIu64 ",\n       \"notify_latency_ns\": ",
+               st->expected, st->received, st->early, st->overruns);
+        json_print_latency_obj(&st->notify);
+        printf("}%s\n", (i + 1u < summary->steps) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_netns_layout_obj(const struct gb_netns_layout_summary* layout, uint32_t workers) {
+    printf("{\n");
+    printf("      \"total_ops\": %" PRIu64 ",\n", layout->total_ops);
+    printf("      \"secs\": ");
+    json_print_double(layout->secs);
+    printf(",\n");
+    printf("      \"ops_per_sec\": ");
+    json_print_double(layout->ops_per_sec);
+    printf(",\n");
+    printf("      \"latency_ns\": ");
+    json_print_latency_obj(&layout->latency);
+    printf(",\n");
+    printf("      \"per_worker\": [\n");
+    for (uint32_t i = 0; i < workers; i++) {
+        const struct gb_netns_worker_summary* ws = &layout->per_worker[i];
+
+        printf("        {\"index\": %" PRIu32 ", \"ops\": %" PRIu64 ", \"ops_per_sec\": ", ws->index, ws->ops);
+        json_print_double(ws->ops_per_sec);
+        printf(", \"latency_ns\": ");
+        json_print_latency_obj(&ws->latency);
+        printf("}%s\n", (i + 1u < workers) ? "," : "");
+    }
+    printf("      ]\n");
+    printf("    }");
+}
+
+static void json_print_netns_obj(const struct gb_netns_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"workers\": %" PRIu32 ",\n", summary->workers);
+    printf("    \"user_ns\": %s,\n", summary->user_ns ? "true" : "false");
+    printf("    \"scaling\": ");
+    json_print_double(summary->scaling);
+    printf(",\n");
+    printf("    \"shared\": ");
+    json_print_netns_layout_obj(&summary->shared, summary->workers);
+    printf(",\n");
+    printf("    \"isolated\": ");
+    json_print_netns_layout_obj(&summary->isolated, summary->workers);
+    printf("\n");
+    printf("  }");
+}
+
+static void json_print_entry_sweep_obj(const struct gb_entry_sweep_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"limit\": %" PRIu32 ",\n", summary->limit);
+    printf("    \"steps\": [\n");
+    for (uint32_t i = 0; i < summary->steps; i++) {
+        const struct gb_entry_sweep_step* st = &summary->per_step[i];
+
+        printf("      {\"entries\": %" PRIu32 ", \"msg_len\": %" PRIu32 ", \"error\": %d, \"replace_errors\": %" PRIu64
+               ",\n       \"replace_latency_ns\": ",
+               st->entries, st->msg_len, st->error, st->replace_errors);
+        json_print_latency_obj(&st->replace);
+        printf(",\n       \"get_errors\": %" PRIu64 ", \"get_latency_ns\": ", st->get_errors);
+        json_print_latency_obj(&st->get);
+        printf("}%s\n", (i + 1u < summary->steps) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_multi_obj(const struct gb_multi_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"limit\": %" PRIu32 ",\n", summary->limit);
+    printf("    \"steps\": [\n");
+    for (uint32_t i = 0; i < summary->steps; i++) {
+        const struct gb_multi_step* st = &summary->per_step[i];
+
+        printf("      {\"actions\": %" PRIu32 ", \"msg_len\": %" PRIu32 ", \"error\": %d,\n", st->actions,
+               st->msg_len, st->error);
+        printf("       \"create_errors\": %" PRIu64 ", \"create_actions_per_sec\": ", st->create_errors);
+        json_print_double(st->create_actions_per_sec);
+        printf(", \"create_latency_ns\": ");
+        json_print_latency_obj(&st->create);
+        printf(",\n       \"get_errors\": %" PRIu64 ", \"get_actions_per_sec\": ", st->get_errors);
+        json_print_double(st->get_actions_per_sec);
+        printf(", \"get_latency_ns\": ");
+        json_print_latency_obj(&st->get);
+        printf(",\n       \"delete_errors\": %" PRIu64 ", \"delete_actions_per_sec\": ", st->delete_errors);
+        json_print_double(st->delete_actions_per_sec);
+        printf(", \"delete_latency_ns\": ");
+        json_print_latency_obj(&st->del);
+        printf("}%s\n", (i + 1u < summary->steps) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_teardown_method(const char* name, const struct gb_teardown_method* m, bool last) {
+    printf("       \"%s\": {\"msgs\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"secs\": ", name, m->msgs, m->errors);
+    json_print_double(m->secs);
+    printf(", \"actions_per_sec\": ");
+    json_print_double(m->actions_per_sec);
+    printf(", \"left\": %" PRIu32 "}%s\n", m->left, last ? "" : ",");
+}
+
+static void json_print_teardown_obj(const struct gb_teardown_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"populate_batch\": %" PRIu32 ",\n", summary->populate_batch);
+    printf("    \"steps\": [\n");
+    for (uint32_t i = 0; i < summary->steps; i++) {
+        const struct gb_teardown_step* st = &summary->per_step[i];
+
+        printf("      {\"actions\": %" PRIu32 ", \"error\": %d, \"populate_errors\": %" PRIu64
+               ", \"populate_actions_per_sec\": ",
+               st->actions, st->error, st->populate_errors);
+        json_print_double(st->populate_actions_per_sec);
+        printf(", \"flush_count\": ");
+        if (st->flush_count == UINT32_MAX)
+            printf("null");
+        else
+            printf("%" PRIu32, st->flush_count);
+        printf(",\n");
+        json_print_teardown_method("single", &st->single, false);
+        json_print_teardown_method("batch", &st->batch, false);
+        json_print_teardown_method("flush", &st->flush, true);
+        printf("      }%s\n", (i + 1u < summary->steps) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_dump_pop_obj(const struct gb_dump_pop_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"actions\": %" PRIu32 ",\n", summary->actions);
+    printf("    \"recent\": %" PRIu32 ",\n", summary->recent);
+    printf("    \"populate_batch\": %" PRIu32 ",\n", summary->populate_batch);
+    printf("    \"populate_errors\": %" PRIu64 ",\n", summary->populate_errors);
+    printf("    \"populate_secs\": ");
+    json_print_double(summary->populate_secs);
+    printf(",\n");
+    printf("    \"flush_count\": ");
+    if (summary->flush_count == UINT32_MAX)
+        printf("null");
+    else
+        printf("%" PRIu32, summary->flush_count);
+    printf(",\n");
+    printf("    \"pipelined\": %s,\n", summary->pipelined ? "true" : "false");
+    printf("    \"variants\": [\n");
+    for (uint32_t i = 0; i < summary->variants; i++) {
+        const struct gb_dump_pop_variant* v = &summary->variant[i];
+
+        printf("      {\"name\": \"%s\", \"root_flags\": %" PRIu32 ", \"time_delta_ms\": %" PRIu32
+               ", \"expected\": %" PRIu32 ", \"dumps\": %" PRIu32 ", \"dump_errors\": %" PRIu64 ",\n",
+               v->name, v->root_flags, v->time_delta_ms, v->expected, v->dumps, v->dump_errors);
+        printf("       \"pages\": %" PRIu32 ", \"bytes\": %" PRIu64 ", \"seen\": %" PRIu64
+               ", \"with_stats\": %" PRIu64 ", \"entries\": %" PRIu64 ",\n",
+               v->pages, v->bytes, v->seen, v->with_stats, v->entries);
+        printf("       \"wall_ns\": ");
+        json_print_latency_obj(&v->wall);
+        printf(", \"first_page_ns\": ");
+        json_print_latency_obj(&v->first_page);
+        printf(",\n       \"bytes_per_sec\": ");
+        json_print_double(v->bytes_per_sec);
+        printf(", \"actions_per_sec\": ");
+        json_print_double(v->actions_per_sec);
+        printf(", \"entries_per_sec\": ");
+        json_print_double(v->entries_per_sec);
+        printf(", \"pages_per_sec\": ");
+        json_print_double(v->pages_per_sec);
+        printf(", \"parse_share\": ");
+        json_print_double(v->parse_share);
+        printf(", \"bytes_vs_full\": ");
+        json_print_double(v->bytes_vs_full);
+        printf(", \"wall_vs_full\": ");
+        json_print_double(v->wall_vs_full);
+        printf("}%s\n", (i + 1u < summary->variants) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_act_stats_obj(const struct gb_act_stats_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"actions\": %" PRIu32 ",\n", summary->actions);
+    printf("    \"cpus\": %" PRIu32 ",\n", summary->cpus);
+    printf("    \"variants\": [\n");
+    for (uint32_t i = 0; i < summary->variants; i++) {
+        const struct gb_act_stats_variant* v = &summary->variant[i];
+
+        printf("      {\"name\": \"%s\", \"flags\": ", v->name);
+        if (v->has_flags)
+            printf("%" PRIu32, v->flags);
+        else
+            printf("null");
+        printf(", \"hw_stats\": ");
+        if (v->has_hw_stats)
+            printf("%" PRIu32, v->hw_stats);
+        else
+            printf("null");
+        printf(", \"error\": %d,\n", v->error);
+        printf("       \"create_errors\": %" PRIu64 ", \"replace_errors\": %" PRIu64 ", \"delete_errors\": %" PRIu64
+               ",\n",
+               v->create_errors, v->replace_errors, v->delete_errors);
+        printf("       \"create_latency_ns\": ");
+        json_print_latency_obj(&v->create);
+        printf(",\n       \"replace_latency_ns\": ");
+        json_print_latency_obj(&v->replace);
+        printf(",\n       \"delete_latency_ns\": ");
+        json_print_latency_obj(&v->del);
+        printf(",\n       \"slab_bytes_per_action\": ");
+        if (v->mem_valid)
+            json_print_double(v->slab_bytes);
+        else
+            printf("null");
+        printf(", \"percpu_bytes_per_action\": ");
+        if (v->mem_valid)
+            json_print_double(v->percpu_bytes);
+        else
+            printf("null");
+        printf("}%s\n", (i + 1u < summary->variants) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_auto_index_obj(const struct gb_auto_index_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"actions\": %" PRIu32 ",\n", summary->actions);
+    printf("    \"variants\": [\n");
+    for (uint32_t i = 0; i < summary->variants; i++) {
+        const struct gb_auto_index_variant* v = &summary->variant[i];
+        uint64_t echoed = v->create.count - v->missing_echoes;
+
+        printf("      {\"name\": \"%s\", \"auto_index\": %s, \"echo\": %s, \"error\": %d,\n", v->name,
+               v->auto_index ? "true" : "false", v->echo ? "true" : "false", v->error);
+        printf("       \"create_errors\": %" PRIu64 ", \"delete_errors\": %" PRIu64 ", \"missing_echoes\": %" PRIu64
+               ", \"duplicate_indices\": %" PRIu64 ", \"wrong_indices\": %" PRIu64 ",\n",
+               v->create_errors, v->delete_errors, v->missing_echoes, v->duplicate_indices, v->wrong_indices);
+        printf("       \"first_index\": %" PRIu32 ", \"last_index\": %" PRIu32 ", \"echo_bytes_mean\": ",
+               v->first_index, v->last_index);
+        if (v->echo && echoed > 0)
+            json_print_double((double)v->echo_bytes / (double)echoed);
+        else
+            printf("null");
+        printf(", \"creates_per_sec\": ");
+        json_print_double(v->creates_per_sec);
+        printf(",\n       \"create_latency_ns\": ");
+        json_print_latency_obj(&v->create);
+        printf(",\n       \"delete_latency_ns\": ");
+        json_print_latency_obj(&v->del);
+        printf("}%s\n", (i + 1u < summary->variants) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_threads_obj(const struct gb_threads_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"cpus\": %" PRIu32 ",\n", summary->cpus);
+    printf("    \"steps\": [\n");
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_threads_step* st = &summary->per_step[s];
+
+        printf("      {\"threads\": %" PRIu32 ", \"total_ops\": %" PRIu64 ", \"secs\": ", st->threads, st->total_ops);
+        json_print_double(st->secs);
+        printf(", \"ops_per_sec\": ");
+        json_print_double(st->ops_per_sec);
+        printf(", \"efficiency\": ");
+        json_print_double(st->efficiency);
+        printf(",\n       \"latency_ns\": ");
+        json_print_latency_obj(&st->latency);
+        printf(",\n       \"workers\": [\n");
+        for (uint32_t i = 0; i < st->threads; i++) {
+            const struct gb_threads_worker* w = &st->per_worker[i];
+
+            printf("         {\"index\": %" PRIu32 ", \"cpu\": %d, \"ops\": %" PRIu64 ", \"ops_per_sec\": ", w->index,
+                   w->cpu, w->ops);
+            json_print_double(w->ops_per_sec);
+            printf(", \"latency_ns\": ");
+            json_print_latency_obj(&w->latency);
+            printf("}%s\n", (i + 1u < st->threads) ? "," : "");
+        }
+        printf("       ]}%s\n", (s + 1u < summary->steps) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_rw_obj(const struct gb_rw_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"writers\": %" PRIu32 ",\n", summary->writers);
+    printf("    \"readers\": %" PRIu32 ",\n", summary->readers);
+    printf("    \"indices\": %" PRIu32 ",\n", summary->indices);
+    printf("    \"ms\": %" PRIu32 ",\n", summary->ms);
+    printf("    \"cpus\": %" PRIu32 ",\n", summary->cpus);
+    printf("    \"cells\": [\n");
+    for (uint32_t i = 0; i < summary->cells; i++) {
+        const struct gb_rw_cell* c = &summary->per_cell[i];
+
+        printf("      {\"writers\": %" PRIu32 ", \"readers\": %" PRIu32 ", \"secs\": ", c->writers, c->readers);
+        json_print_double(c->secs);
+        printf(",\n       \"reads\": %" PRIu64 ", \"read_errors\": %" PRIu64 ", \"reads_per_sec\": ", c->reads,
+               c->read_errors);
+        json_print_double(c->reads_per_sec);
+        printf(", \"writes\": %" PRIu64 ", \"write_errors\": %" PRIu64 ", \"writes_per_sec\": ", c->writes,
+               c->write_errors);
+        json_print_double(c->writes_per_sec);
+        printf(",\n       \"read_latency_ns\": ");
+        json_print_latency_obj(&c->read);
+        printf(",\n       \"write_latency_ns\": ");
+        json_print_latency_obj(&c->write);
+        printf("}%s\n", (i + 1u < summary->cells) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_open_loop_obj(const struct gb_open_loop_result* result) {
+    if (!result) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"arrivals\": \"%s\",\n", gb_arrivals_name((enum gb_arrivals)result->arrivals));
+    printf("    \"offered_rate\": ");
+    json_print_double(result->offered_rate);
+    printf(",\n    \"achieved_rate\": ");
+    json_print_double(result->achieved_rate);
+    printf(",\n    \"secs\": ");
+    json_print_double(result->secs);
+    printf(",\n");
+    printf("    \"ops\": %" PRIu64 ",\n", result->ops);
+    printf("    \"errors\": %" PRIu64 ",\n", result->errors);
+    printf("    \"queued\": %" PRIu64 ",\n", result->queued);
+    printf("    \"max_lag_ns\": %" PRIu64 ",\n", result->max_lag_ns);
+    printf("    \"service_latency_ns\": ");
+    json_print_latency_obj(&result->service);
+    printf(",\n    \"response_latency_ns\": ");
+    json_print_latency_obj(&result->response);
+    printf("\n  }");
+}
+
+static void json_print_slo_obj(const struct gb_slo_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"bound_ns\": %" PRIu64 ",\n", summary->bound_ns);
+    printf("    \"probe_secs\": %u,\n", GB_SLO_PROBE_SECS);
+    printf("    \"min_ops\": %" PRIu32 ",\n", summary->min_ops);
+    printf("    \"min_rate\": ");
+    json_print_double(summary->min_rate);
+    printf(",\n");
+    printf("    \"pct\": ");
+    json_print_double((double)summary->pct_permille / 10.0);
+    printf(",\n    \"knee_rate\": ");
+    if (summary->knee >= 0)
+        json_print_double(summary->knee_rate);
+    else
+        printf("null");
+    printf(",\n    \"probes\": [\n");
+    for (uint32_t i = 0; i < summary->probes; i++) {
+        const struct gb_slo_probe* p = &summary->probe[i];
+        const struct gb_open_loop_result* r = &p->result;
+
+        printf("      {\"rate\": ");
+        json_print_double(p->rate);
+        printf(", \"probe_ops\": %" PRIu32, p->ops);
+        printf(", \"achieved_rate\": ");
+        json_print_double(r->achieved_rate);
+        printf(", \"pct_ns\": %" PRIu64 ", \"pass\": %s, \"ops\": %" PRIu64 ", \"errors\": %" PRIu64
+               ", \"queued\": %" PRIu64 ",\n",
+               p->pct_ns, p->pass ? "true" : "false", r->ops, r->errors, r->queued);
+        printf("       \"service_latency_ns\": ");
+        json_print_latency_obj(&r->service);
+        printf(",\n       \"response_latency_ns\": ");
+        json_print_latency_obj(&r->response);
+        printf("}%s\n", (i + 1u < summary->probes) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_mix_obj(const struct gb_mix_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"hot_set\": %" PRIu32 ",\n", summary->hot_set);
+    printf("    \"zipf\": ");
+    json_print_double(summary->zipf);
+    printf(",\n");
+    printf("    \"total_ops\": %" PRIu64 ",\n", summary->total_ops);
+    printf("    \"secs\": ");
+    json_print_double(summary->secs);
+    printf(",\n    \"ops_per_sec\": ");
+    json_print_double(summary->ops_per_sec);
+    printf(",\n");
+    printf("    \"present\": %" PRIu32 ",\n", summary->present);
+    printf("    \"ops\": [\n");
+    for (uint32_t k = 0; k < GB_MIX_OPS; k++) {
+        const struct gb_mix_op_summary* o = &summary->op[k];
+
+        printf("      {\"op\": \"%s\", \"weight\": %" PRIu32 ", \"ops\": %" PRIu64
+               ", \"misses\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"ops_per_sec\": ",
+               gb_mix_op_name((enum gb_mix_op)k), o->weight, o->ops, o->misses, o->errors);
+        json_print_double(o->ops_per_sec);
+        printf(",\n       \"latency_ns\": ");
+        json_print_latency_obj(&o->latency);
+        printf("}%s\n", (k != GB_MIX_OPS - 1u) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
+static void json_print_replay_obj(const struct gb_replay_summary* summary) {
+    if (!summary) {
+        fputs("null", stdout);
+        return;
+    }
+
+    printf("{\n");
+    printf("    \"threads\": %" PRIu32 ",\n", summary->threads);
+    printf("    \"records\": %" PRIu64 ",\n", summary->records);
+    printf("    \"pace\": \"%s\",\n", gb_replay_pace_name((enum gb_replay_pace)summary->pace));
+    printf("    \"total_ops\": %" PRIu64 ",\n", summary->total_ops);
+    printf("    \"total_errors\": %" PRIu64 ",\n", summary->total_errors);
+    printf("    \"errno_mismatches\": %" PRIu64 ",\n", summary->total_mismatches);
+    printf("    \"trace_secs\": ");
+    json_print_double(summary->trace_secs);
+    printf(",\n");
+    printf("    \"secs\": ");
+    json_print_double(summary->secs);
+    printf(",\n");
+    printf("    \"ops_per_sec\": ");
+    json_print_double(summary->ops_per_sec);
+    printf(",\n");
+    printf("    \"latency_ns\": ");
+    json_print_latency_obj(&summary->latency);
+    printf(",\n");
+    printf("    \"per_thread\": [\n");
+    for (uint32_t i = 0; i < summary->threads; i++) {
+        const struct gb_replay_thread_summary* ts = &summary->per_thread[i];
+
+        printf("      {\"tid\": %" PRIu32 ", \"ops\": %" PRIu64 ", \"errors\": %" PRIu64 ", \"errno_mismatches\": %" PRIu64
+               ", \"max_late_ns\": %" PRIu64 ", \"latency_ns\": ",
+               ts->tid, ts->ops, ts->errors, ts->mismatches, ts->late_ns);
+        json_print_latency_obj(&ts->latency);
+        printf("}%s\n", (i + 1u < summary->threads) ? "," : "");
+    }
+    printf("    ]\n");
+    printf("  }");
+}
+
 static void json_print_error_obj(const char* phase, int error_code) {
     int errnum;
 
@@ -354,14 +1041,34 @@ static void json_print_error_obj(const char* phase, int error_code) {
     printf("  }");
 }
 
+/* Result sections of the JSON report; sections of inactive modes stay NULL */
+struct json_sections {
+    const struct gb_summary* benchmark;
+    const struct gb_dump_summary* dump_proof;
+    const struct gb_race_summary* race;
+    const struct gb_clients_summary* clients;
+    const struct gb_listeners_summary* listeners;
+    const struct gb_netns_summary* netns;
+    const struct gb_entry_sweep_summary* entry_sweep;
+    const struct gb_multi_summary* multi_actions;
+    const struct gb_teardown_summary* teardown;
+    const struct gb_dump_pop_summary* dump_population;
+    const struct gb_act_stats_summary* act_stats;
+    const struct gb_auto_index_summary* auto_index;
+    const struct gb_threads_summary* threads;
+    const struct gb_rw_summary* rw;
+    const struct gb_open_loop_result* open_loop;
+    const struct gb_slo_summary* slo;
+    const struct gb_mix_summary* mix;
+    const struct gb_replay_summary* replay;
+};
+
 static void json_print_report(const struct gb_config* cfg,
                               const char* mode,
                               bool ok,
                               bool selftests_ran,
                               int selftests_result,
-                              const struct gb_summary* benchmark,
-                              const struct gb_dump_summary* dump_summary,
-                              const struct gb_race_summary* race_summary,
+                              const struct json_sections* sections,
                               const char* error_phase,
                               int error_code) {
     printf("{\n");
@@ -388,20 +1095,93 @@ static void json_print_report(const struct gb_config* cfg,
     printf(",\n");
 
     printf("  \"benchmark\": ");
-    json_print_benchmark_obj(benchmark);
+    json_print_benchmark_obj(sections->benchmark);
     printf(",\n");
 
     printf("  \"dump_proof\": ");
-    json_print_dump_proof_obj(dump_summary);
+    json_print_dump_proof_obj(sections->dump_proof);
     printf(",\n");
 
     printf("  \"race\": ");
-    json_print_race_obj(race_summary);
+    json_print_race_obj(sections->race);
+    printf(",\n");
+
+    printf("  \"clients\": ");
+    json_print_clients_obj(sections->clients);
+    printf(",\n");
+
+    printf("  \"listeners\": ");
+    json_print_listeners_obj(sections->listeners);
+    printf(",\n");
+
+    printf("  \"netns\": ");
+    json_print_netns_obj(sections->netns);
+    printf(",\n");
+
+    printf("  \"entry_sweep\": ");
+    json_print_entry_sweep_obj(sections->entry_sweep);
+    printf(",\n");
+
+    printf("  \"multi_actions\": ");
+    json_print_multi_obj(sections->multi_actions);
+    printf(",\n");
+
+    printf("  \"teardown\": ");
+    json_print_teardown_obj(sections->teardown);
+    printf(",\n");
+
+    printf("  \"dump_population\": ");
+    json_print_dump_pop_obj(sections->dump_population);
+    printf(",\n");
+
+    printf("  \"act_stats\": ");
+    json_print_act_stats_obj(sections->act_stats);
+    printf(",\n");
+
+    printf("  \"auto_index\": ");
+    json_print_auto_index_obj(sections->auto_index);
+    printf(",\n");
+
+    printf("  \"threads\": ");
+    json_print_threads_obj(sections->threads);
+    printf(",\n");
+
+    printf("  \"rw\": ");
+    json_print_rw_obj(sections->rw);
+    printf(",\n");
+
+    printf("  \"open_loop\": ");
+    json_print_open_loop_obj(sections->open_loop);
+    printf(",\n");
+
+    printf("  \"slo\": ");
+    json_print_slo_obj(sections->slo);
+    printf(",\n");
+
+    printf("  \"mix\": ");
+    json_print_mix_obj(sections->mix);
+    printf(",\n");
+
+    printf("  \"replay\": ");
+    json_print_replay_obj(sections->replay);
     printf("\n");
 
     printf("}\n");
 }
 
+/* Begin request capture when --trace was given; sockets opened afterwards are recorded */
+static int start_trace(const struct gb_config* cfg) {
+    int ret;
+
+    if (!cfg->trace_path)
+        return 0;
+
+    ret = gb_trace_open(cfg->trace_path);
+    if (ret < 0)
+        fprintf(stderr, "Failed to open trace %s: %s\n", cfg->trace_path, strerror(-ret));
+    return ret;
+}
+
 static bool argv_requests_json(int argc, char* argv[]) {
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0)
@@ -415,13 +1195,27 @@ int main(int argc, char* argv[]) {
     struct gb_summary summary;
     struct gb_dump_summary dump_summary;
     struct gb_race_summary race_summary;
-    const struct gb_summary* benchmark_out = NULL;
-    const struct gb_dump_summary* dump_out = NULL;
-    const struct gb_race_summary* race_out = NULL;
+    struct gb_clients_summary clients_summary;
+    struct gb_listeners_summary listeners_summary;
+    struct gb_netns_summary netns_summary;
+    struct gb_entry_sweep_summary entry_sweep_summary;
+    struct gb_multi_summary multi_summary;
+    struct gb_teardown_summary teardown_summary;
+    struct gb_dump_pop_summary dump_pop_summary;
+    struct gb_act_stats_summary act_stats_summary;
+    struct gb_auto_index_summary auto_index_summary;
+    struct gb_threads_summary threads_summary;
+    struct gb_rw_summary rw_summary;
+    struct gb_open_loop_result open_loop_result;
+    struct gb_slo_summary slo_summary;
+    struct gb_mix_summary mix_summary;
+    struct gb_replay_summary replay_summary;
+    struct json_sections sections;
     const char* mode = "benchmark";
     const char* error_phase = NULL;
     int error_code = 0;
     bool selftests_ran = false;
+    bool netns_user = false;
     bool json_requested;
     int selftests_result = 0;
     int ret;
@@ -432,19 +1226,75 @@ int main(int argc, char* argv[]) {
     memset(&summary, 0, sizeof(summary));
     memset(&dump_summary, 0, sizeof(dump_summary));
     memset(&race_summary, 0, sizeof(race_summary));
+    memset(&clients_summary, 0, sizeof(clients_summary));
+    memset(&listeners_summary, 0, sizeof(listeners_summary));
+    memset(&netns_summary, 0, sizeof(netns_summary));
+    memset(&entry_sweep_summary, 0, sizeof(entry_sweep_summary));
+    memset(&multi_summary, 0, sizeof(multi_summary));
+    memset(&teardown_summary, 0, sizeof(teardown_summary));
+    memset(&dump_pop_summary, 0, sizeof(dump_pop_summary));
+    memset(&act_stats_summary, 0, sizeof(act_stats_summary));
+    memset(&auto_index_summary, 0, sizeof(auto_index_summary));
+    memset(&threads_summary, 0, sizeof(threads_summary));
+    memset(&rw_summary, 0, sizeof(rw_summary));
+    memset(&open_loop_result, 0, sizeof(open_loop_result));
+    memset(&slo_summary, 0, sizeof(slo_summary));
+    memset(&mix_summary, 0, sizeof(mix_summary));
+    memset(&replay_summary, 0, sizeof(replay_summary));
+    memset(&sections, 0, sizeof(sections));
 
     ret = gb_cli_parse(argc, argv, &cfg);
     if (ret < 0) {
         if (json_requested) {
-            json_print_report(&cfg, mode, false, false, 0, NULL, NULL, NULL, "cli_parse", ret);
+            json_print_report(&cfg, mode, false, false, 0, &sections, "cli_parse", ret);
         }
         return EXIT_FAILURE;
     }
 
-    if (cfg.race_mode)
+    /* Every socket opened from here on (bench, selftests, race workers) uses it */
+    gb_nl_set_backend((enum gb_nl_backend)cfg.nl_backend);
+    if (cfg.loopback_service) {
+        struct gb_nl_service service;
+
+        /* Already validated by gb_cli_parse */
+        if (gb_nl_service_parse(cfg.loopback_service, &service) == 0)
+            gb_nl_loopback_set_service(&service);
+    }
+
+    if (cfg.replay_path)
+        mode = "replay";
+    else if (cfg.race_mode)
         mode = "race";
     else if (cfg.dump_proof)
         mode = "dump_proof";
+    else if (cfg.clients > 0)
+        mode = "clients";
+    else if (cfg.listeners > 0)
+        mode = "listeners";
+    else if (cfg.netns > 0)
+        mode = "netns";
+    else if (cfg.entry_sweep > 0)
+        mode = "entry_sweep";
+    else if (cfg.multi_actions > 0)
+        mode = "multi_actions";
+    else if (cfg.teardown > 0)
+        mode = "teardown";
+    else if (cfg.dump_pop > 0)
+        mode = "dump_population";
+    else if (cfg.act_stats > 0)
+        mode = "act_stats";
+    else if (cfg.auto_index > 0)
+        mode = "auto_index";
+    else if (cfg.threads > 0)
+        mode = "threads";
+    else if (cfg.rw_writers + cfg.rw_readers > 0)
+        mode = "rw";
+    else if (cfg.slo_ns > 0)
+        mode = "slo";
+    else if (cfg.rate > 0)
+        mode = "open_loop";
+    else if (cfg.mix)
+        mode = "mix";
 
     if (!cfg.json) {
         if (cfg.verbose) {
@@ -466,7 +1316,37 @@ int main(int argc, char* argv[]) {
             printf("Pinned to CPU %d\n\n", cfg.cpu);
     }
 
+    if (cfg.replay_path) {
+        if (!cfg.json)
+            printf("Replaying %s (pace %s)...\n", cfg.replay_path,
+                   gb_replay_pace_name((enum gb_replay_pace)cfg.replay_pace));
+
+        ret = gb_replay_run(&cfg, &replay_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Replay failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "replay";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.replay = &replay_summary;
+        if (!cfg.json) {
+            gb_replay_print_summary(&replay_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
     if (cfg.race_mode) {
+        ret = start_trace(&cfg);
+        if (ret < 0) {
+            error_phase = "trace";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
         if (!cfg.json)
             printf("Running race mode for %" PRIu32 " seconds...\n", cfg.race_seconds);
 
@@ -479,10 +1359,22 @@ int main(int argc, char* argv[]) {
         }
 
         if (cfg.json)
-            race_out = &race_summary;
+            sections.race = &race_summary;
         goto out;
     }
 
+    /* Enter the shared namespace while still single-threaded; selftests run there too */
+    if (cfg.netns > 0) {
+        ret = gb_netns_enter(&netns_user);
+        if (ret < 0) {
+            fprintf(stderr, "Failed to enter a network namespace: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "netns";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+    }
+
     if (!cfg.json) {
         if (cfg.verbose)
             printf("Running selftests...\n");
@@ -508,12 +1400,21 @@ int main(int argc, char* argv[]) {
             printf("Selftests: WARN (soft-failures)\n\n");
     }
 
+    /* Selftests are not part of the workload, so capture starts after them */
+    ret = start_trace(&cfg);
+    if (ret < 0) {
+        error_phase = "trace";
+        error_code = ret;
+        exit_code = EXIT_FAILURE;
+        goto out;
+    }
+
     if (cfg.dump_proof) {
         if (!cfg.json)
             printf("Running dump proof harness...\n");
 
         ret = gb_proof_run(&cfg, &dump_summary);
-        dump_out = &dump_summary;
+        sections.dump_proof = &dump_summary;
         if (ret < 0) {
             fprintf(stderr, "Dump proof failed: %s (%d)\n", strerror(-ret), ret);
             error_phase = "dump_proof";
@@ -529,6 +1430,305 @@ int main(int argc, char* argv[]) {
         goto out;
     }
 
+    if (cfg.clients > 0) {
+        if (!cfg.json)
+            printf("Running %" PRIu32 " event-loop clients...\n", cfg.clients);
+
+        ret = gb_clients_run(&cfg, &clients_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Clients run failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "clients";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.clients = &clients_summary;
+        if (!cfg.json) {
+            gb_clients_print_summary(&clients_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.listeners > 0) {
+        if (!cfg.json)
+            printf("Running listener fan-out sweep (up to %" PRIu32 " listeners)...\n", cfg.listeners);
+
+        ret = gb_listeners_run(&cfg, &listeners_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Listeners run failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "listeners";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.listeners = &listeners_summary;
+        if (!cfg.json) {
+            gb_listeners_print_summary(&listeners_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.netns > 0) {
+        if (!cfg.json)
+            printf("Running %" PRIu32 " workers across network namespaces%s...\n", cfg.netns,
+                   netns_user ? " (user namespace)" : "");
+
+        ret = gb_netns_run(&cfg, &netns_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Namespace run failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "netns";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        netns_summary.user_ns = netns_user;
+        sections.netns = &netns_summary;
+        if (!cfg.json) {
+            gb_netns_print_summary(&netns_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.entry_sweep > 0) {
+        if (!cfg.json)
+            printf("Running entry-count sweep (up to %" PRIu32 " entries)...\n", cfg.entry_sweep);
+
+        ret = gb_entry_sweep_run(&cfg, &entry_sweep_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Entry sweep failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "entry_sweep";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.entry_sweep = &entry_sweep_summary;
+        if (!cfg.json) {
+            gb_entry_sweep_print_summary(&entry_sweep_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.multi_actions > 0) {
+        if (!cfg.json)
+            printf("Running multi-action sweep (up to %" PRIu32 " actions per message)...\n", cfg.multi_actions);
+
+        ret = gb_multi_run(&cfg, &multi_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Multi-action sweep failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "multi_actions";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.multi_actions = &multi_summary;
+        if (!cfg.json) {
+            gb_multi_print_summary(&multi_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.teardown > 0) {
+        if (!cfg.json)
+            printf("Running teardown benchmark (up to %" PRIu32 " actions)...\n", cfg.teardown);
+
+        ret = gb_teardown_run(&cfg, &teardown_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Teardown benchmark failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "teardown";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.teardown = &teardown_summary;
+        if (!cfg.json) {
+            gb_teardown_print_summary(&teardown_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.dump_pop > 0) {
+        if (!cfg.json)
+            printf("Running dump population benchmark (%" PRIu32 " actions)...\n", cfg.dump_pop);
+
+        ret = gb_dump_pop_run(&cfg, &dump_pop_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Dump population benchmark failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "dump_population";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.dump_population = &dump_pop_summary;
+        if (!cfg.json) {
+            gb_dump_pop_print_summary(&dump_pop_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.act_stats > 0) {
+        if (!cfg.json)
+            printf("Running stats flag benchmark (%" PRIu32 " actions per variant)...\n", cfg.act_stats);
+
+        ret = gb_act_stats_run(&cfg, &act_stats_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Stats flag benchmark failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "act_stats";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.act_stats = &act_stats_summary;
+        if (!cfg.json) {
+            gb_act_stats_print_summary(&act_stats_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.auto_index > 0) {
+        if (!cfg.json)
+            printf("Running auto index benchmark (%" PRIu32 " actions per variant)...\n", cfg.auto_index);
+
+        ret = gb_auto_index_run(&cfg, &auto_index_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Auto index benchmark failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "auto_index";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.auto_index = &auto_index_summary;
+        if (!cfg.json) {
+            gb_auto_index_print_summary(&auto_index_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.threads > 0) {
+        if (!cfg.json)
+            printf("Running write scaling sweep (up to %" PRIu32 " threads)...\n", cfg.threads);
+
+        ret = gb_threads_run(&cfg, &threads_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Write scaling sweep failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "threads";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.threads = &threads_summary;
+        if (!cfg.json) {
+            gb_threads_print_summary(&threads_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.rw_writers + cfg.rw_readers > 0) {
+        if (!cfg.json)
+            printf("Running reader/writer grid (up to %" PRIu32 " writers x %" PRIu32 " readers)...\n",
+                   cfg.rw_writers, cfg.rw_readers);
+
+        ret = gb_rw_run(&cfg, &rw_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Reader/writer grid failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "rw";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.rw = &rw_summary;
+        if (!cfg.json) {
+            gb_rw_print_summary(&rw_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.slo_ns > 0) {
+        if (!cfg.json)
+            printf("Running capacity search (p%.1f <= %" PRIu64 " ns)...\n", (double)cfg.slo_pct / 10.0, cfg.slo_ns);
+
+        ret = gb_slo_run(&cfg, &slo_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Capacity search failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "slo";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.slo = &slo_summary;
+        if (!cfg.json) {
+            gb_slo_print_summary(&slo_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.rate > 0) {
+        if (!cfg.json)
+            printf("Running open-loop load (%" PRIu32 " replaces at %" PRIu32 " ops/sec, %s arrivals)...\n", cfg.iters,
+                   cfg.rate, gb_arrivals_name((enum gb_arrivals)cfg.arrivals));
+
+        ret = gb_open_loop_run(&cfg, (double)cfg.rate, cfg.iters, &open_loop_result);
+        if (ret < 0) {
+            fprintf(stderr, "Open-loop load failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "open_loop";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.open_loop = &open_loop_result;
+        if (!cfg.json) {
+            gb_open_loop_print_result(&open_loop_result, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
+    if (cfg.mix) {
+        if (!cfg.json)
+            printf("Running op mix (%s over %" PRIu32 " indices, %" PRIu32 " ops)...\n", cfg.mix, cfg.hot_set,
+                   cfg.iters);
+
+        ret = gb_mix_run(&cfg, &mix_summary);
+        if (ret < 0) {
+            fprintf(stderr, "Op mix failed: %s (%d)\n", strerror(-ret), ret);
+            error_phase = "mix";
+            error_code = ret;
+            exit_code = EXIT_FAILURE;
+            goto out;
+        }
+
+        sections.mix = &mix_summary;
+        if (!cfg.json) {
+            gb_mix_print_summary(&mix_summary, &cfg);
+            printf("\n");
+        }
+        goto out;
+    }
+
     if (!cfg.json)
         printf("Running benchmark...\n");
 
@@ -541,18 +1741,39 @@ int main(int argc, char* argv[]) {
         goto out;
     }
 
-    benchmark_out = &summary;
+    sections.benchmark = &summary;
 
     if (!cfg.json)
         printf("Benchmark completed successfully\n");
 
 out:
+    if (cfg.trace_path) {
+        ret = gb_trace_close();
+        if (ret < 0) {
+            fprintf(stderr, "Failed to finish trace %s: %s\n", cfg.trace_path, strerror(-ret));
+            if (exit_code == EXIT_SUCCESS) {
+                error_phase = "trace";
+                error_code = ret;
+                exit_code = EXIT_FAILURE;
+            }
+        }
+    }
+
     if (cfg.json) {
-        json_print_report(&cfg, mode, exit_code == EXIT_SUCCESS, selftests_ran, selftests_result, benchmark_out,
-                          dump_out, race_out, error_phase, error_code);
+        json_print_report(&cfg, mode, exit_code == EXIT_SUCCESS, selftests_ran, selftests_result, &sections,
+                          error_phase, error_code);
     }
 
     gb_summary_free(&summary);
+    gb_clients_summary_free(&clients_summary);
+    gb_listeners_summary_free(&listeners_summary);
+    gb_netns_summary_free(&netns_summary);
+    gb_entry_sweep_summary_free(&entry_sweep_summary);
+    gb_multi_summary_free(&multi_summary);
+    gb_teardown_summary_free(&teardown_summary);
+    gb_threads_summary_free(&threads_summary);
+    gb_rw_summary_free(&rw_summary);
+    gb_replay_summary_free(&replay_summary);
     return exit_code;
 }
 
@@ -0,0 +1,437 @@
+/* src/mix.c
+ * Weighted operation mix: creates, replaces, base-time updates, gets,
+ * dumps and deletes over a hot set of indices, in the proportions of a
+ * real control plane rather than the create/replace alternation.
+ */
+#include "../include/gatebench_mix.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MIX_SEED 0x6a09e667f3bcc909ull
+
+static const char* const mix_op_names[GB_MIX_OPS] = {
+    "create", "replace", "update", "get", "dump", "delete",
+};
+
+const char* gb_mix_op_name(enum gb_mix_op op) {
+    if ((unsigned)op >= GB_MIX_OPS)
+        return "unknown";
+    return mix_op_names[op];
+}
+
+int gb_mix_parse(const char* spec, uint32_t weights[GB_MIX_OPS]) {
+    const char* p = spec;
+    uint64_t total = 0;
+
+    if (!spec || !weights)
+        return -EINVAL;
+
+    memset(weights, 0, GB_MIX_OPS * sizeof(weights[0]));
+
+    while (*p != '\0') {
+        const char* eq = strchr(p, '=');
+        char* end = NULL;
+        unsigned long v;
+        int op = -1;
+
+        if (!eq)
+            return -EINVAL;
+
+        for (int k = 0; k < GB_MIX_OPS; k++) {
+            if (strlen(mix_op_names[k]) == (size_t)(eq - p) && strncmp(p, mix_op_names[k], (size_t)(eq - p)) == 0)
+                op = k;
+        }
+        if (op < 0)
+            return -EINVAL;
+
+        errno = 0;
+        v = strtoul(eq + 1, &end, 10);
+        if (errno != 0 || end == eq + 1 || (*end != ',' && *end != '\0') || v > 1000000ul)
+            return -EINVAL;
+
+        weights[op] = (uint32_t)v;
+        total += v;
+        p = *end == ',' ? end + 1 : end;
+    }
+
+    return total > 0 ? 0 : -EINVAL;
+}
+
+struct mix_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    uint32_t entry_count;
+    struct gb_nl_msg* msg;
+    struct gb_nl_msg* dump_msg;
+    struct gb_nl_msg* resp;
+    struct gate_dump dump;
+
+    uint32_t weights[GB_MIX_OPS];
+    uint64_t weight_total;
+    double* cdf; /* Zipf popularity by rank (NULL = uniform) */
+    bool* present;
+    uint32_t present_count;
+    uint64_t rng;
+    uint64_t updates; /* Base times handed out so far */
+};
+
+static uint64_t mix_rng(struct mix_ctx* ctx) {
+    uint64_t x = ctx->rng;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    ctx->rng = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+/* Uniform in [0, 1) */
+static double mix_uniform(struct mix_ctx* ctx) {
+    return (double)(mix_rng(ctx) >> 11) / 9007199254740992.0;
+}
+
+static enum gb_mix_op mix_pick_op(struct mix_ctx* ctx) {
+    uint64_t r = mix_rng(ctx) % ctx->weight_total;
+
+    for (int k = 0; k < GB_MIX_OPS; k++) {
+        if (r < ctx->weights[k])
+            return (enum gb_mix_op)k;
+        r -= ctx->weights[k];
+    }
+    return GB_MIX_GET;
+}
+
+/* Hot-set slot drawn by popularity */
+static uint32_t mix_pick_slot(struct mix_ctx* ctx) {
+    uint32_t n = ctx->cfg->hot_set;
+    uint32_t lo = 0, hi;
+    double u;
+
+    if (!ctx->cdf)
+        return (uint32_t)(mix_rng(ctx) % n);
+
+    /* First rank whose cumulative share exceeds u */
+    u = mix_uniform(ctx);
+    hi = n - 1u;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2u;
+
+        if (ctx->cdf[mid] > u)
+            hi = mid;
+        else
+            lo = mid + 1u;
+    }
+    return lo;
+}
+
+/* Next slot from slot (wrapping) whose presence is want; slot itself when none */
+static uint32_t mix_find(const struct mix_ctx* ctx, uint32_t slot, bool want) {
+    uint32_t n = ctx->cfg->hot_set;
+
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t s = (slot + k) % n;
+
+        if (ctx->present[s] == want)
+            return s;
+    }
+    return slot;
+}
+
+static int mix_build(struct mix_ctx* ctx, enum gb_mix_op op, uint32_t index) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gate_shape shape;
+
+    gb_nl_msg_reset(ctx->msg);
+    switch (op) {
+        case GB_MIX_CREATE:
+            return build_gate_newaction(ctx->msg, index, &ctx->shape, ctx->entries, ctx->entry_count,
+                                        NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+        case GB_MIX_REPLACE:
+            return build_gate_newaction(ctx->msg, index, &ctx->shape, ctx->entries, ctx->entry_count,
+                                        NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+        case GB_MIX_UPDATE:
+            /* No entry list: the kernel keeps the schedule and takes the new base time */
+            shape = ctx->shape;
+            shape.base_time = cfg->base_time + ++ctx->updates * cfg->interval_ns;
+            return build_gate_newaction(ctx->msg, index, &shape, NULL, 0, NLM_F_REPLACE, 0, -1);
+        case GB_MIX_DELETE:
+            return build_gate_delaction(ctx->msg, index);
+        default:
+            return 0;
+    }
+}
+
+/* Issue op on index; returns 0 or the request's -errno */
+static int mix_issue(struct mix_ctx* ctx, enum gb_mix_op op, uint32_t index) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_dump_stats stats;
+    int ret;
+
+    switch (op) {
+        case GB_MIX_GET:
+            return gb_nl_get_action(ctx->sock, index, &ctx->dump, cfg->timeout_ms);
+        case GB_MIX_DUMP:
+            ret = gb_nl_dump_action(ctx->sock, ctx->dump_msg, &stats, cfg->timeout_ms);
+            if (ret == 0 && stats.saw_error)
+                ret = stats.error_code;
+            return ret;
+        default:
+            return gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, cfg->timeout_ms);
+    }
+}
+
+/* One op of the mix; timed into lat when given */
+static int mix_step(struct mix_ctx* ctx, struct gb_stats* lat, struct gb_mix_op_summary* op_summary) {
+    enum gb_mix_op op = mix_pick_op(ctx);
+    uint32_t slot = mix_pick_slot(ctx);
+    uint32_t index;
+    uint64_t t0 = 0, t1 = 0;
+    int ret;
+
+    if (op == GB_MIX_CREATE)
+        slot = mix_find(ctx, slot, false);
+    else if (op == GB_MIX_DELETE || op == GB_MIX_UPDATE)
+        slot = mix_find(ctx, slot, true);
+    index = ctx->cfg->index + slot;
+
+    ret = mix_build(ctx, op, index);
+    if (ret < 0)
+        return ret;
+
+    (void)gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+    ret = mix_issue(ctx, op, index);
+    (void)gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW);
+
+    if (ret == 0) {
+        if (op == GB_MIX_CREATE || op == GB_MIX_REPLACE) {
+            ctx->present_count += ctx->present[slot] ? 0u : 1u;
+            ctx->present[slot] = true;
+        } else if (op == GB_MIX_DELETE) {
+            ctx->present_count -= ctx->present[slot] ? 1u : 0u;
+            ctx->present[slot] = false;
+        }
+    }
+
+    if (!lat)
+        return 0;
+
+    op_summary += op;
+    if (ret == -ENOENT || ret == -EEXIST) {
+        op_summary->misses++;
+        return 0;
+    }
+    if (ret < 0) {
+        op_summary->errors++;
+        return 0;
+    }
+
+    op_summary->ops++;
+    return gb_stats_add(&lat[op], t1 - t0);
+}
+
+/* Delete every hot index, present or not */
+static void mix_clear(struct mix_ctx* ctx) {
+    for (uint32_t i = 0; i < ctx->cfg->hot_set; i++) {
+        if (mix_build(ctx, GB_MIX_DELETE, ctx->cfg->index + i) == 0)
+            (void)gb_nl_send_recv(ctx->sock, ctx->msg, ctx->resp, ctx->cfg->timeout_ms);
+        ctx->present[i] = false;
+    }
+    ctx->present_count = 0;
+}
+
+static int mix_init_cdf(struct mix_ctx* ctx) {
+    uint32_t n = ctx->cfg->hot_set;
+    double sum = 0.0;
+
+    if (!(ctx->cfg->zipf > 0.0))
+        return 0;
+
+    ctx->cdf = malloc((size_t)n * sizeof(*ctx->cdf));
+    if (!ctx->cdf)
+        return -ENOMEM;
+
+    for (uint32_t r = 0; r < n; r++) {
+        sum += 1.0 / pow((double)r + 1.0, ctx->cfg->zipf);
+        ctx->cdf[r] = sum;
+    }
+    for (uint32_t r = 0; r < n; r++)
+        ctx->cdf[r] /= sum;
+    return 0;
+}
+
+int gb_mix_run(const struct gb_config* cfg, struct gb_mix_summary* summary) {
+    struct mix_ctx ctx;
+    struct gb_stats lat[GB_MIX_OPS];
+    struct gb_populator pop;
+    uint64_t populate_errors = 0;
+    uint64_t start_ns, end_ns;
+    int ret;
+
+    if (!cfg || !summary || !cfg->mix || cfg->hot_set == 0)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&pop, 0, sizeof(pop));
+    memset(lat, 0, sizeof(lat));
+    ctx.cfg = cfg;
+    ctx.rng = MIX_SEED ^ cfg->index;
+    summary->hot_set = cfg->hot_set;
+    summary->zipf = cfg->zipf;
+
+    ret = gb_mix_parse(cfg->mix, ctx.weights);
+    if (ret < 0)
+        return ret;
+    for (int k = 0; k < GB_MIX_OPS; k++) {
+        ctx.weight_total += ctx.weights[k];
+        summary->op[k].weight = ctx.weights[k];
+    }
+
+    for (int k = 0; k < GB_MIX_OPS; k++) {
+        ret = gb_stats_init(&lat[k], ctx.weights[k] > 0 ? cfg->iters : 1u);
+        if (ret < 0)
+            goto out;
+    }
+
+    ctx.entry_count = cfg->entries;
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = ctx.entry_count;
+
+    ctx.entries = calloc(ctx.entry_count > 0 ? ctx.entry_count : 1u, sizeof(*ctx.entries));
+    ctx.present = calloc(cfg->hot_set, sizeof(*ctx.present));
+    ctx.msg = gb_nl_msg_alloc(gate_msg_capacity(ctx.entry_count, 0));
+    ctx.dump_msg = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!ctx.entries || !ctx.present || !ctx.msg || !ctx.dump_msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(ctx.entries, ctx.entry_count, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    ret = mix_init_cdf(&ctx);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_dumpaction(ctx.dump_msg);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_populator_init(&pop, cfg);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    /* Start from a full hot set */
+    mix_clear(&ctx);
+    ret = gb_populate(&pop, ctx.sock, ctx.resp, 0, cfg->hot_set, false, &populate_errors);
+    if (ret < 0)
+        goto out_clear;
+    if (populate_errors > 0) {
+        ret = -EIO;
+        goto out_clear;
+    }
+    for (uint32_t i = 0; i < cfg->hot_set; i++)
+        ctx.present[i] = true;
+    ctx.present_count = cfg->hot_set;
+
+    for (uint32_t i = 0; i < cfg->warmup; i++) {
+        ret = mix_step(&ctx, NULL, NULL);
+        if (ret < 0)
+            goto out_clear;
+    }
+
+    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out_clear;
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        ret = mix_step(&ctx, lat, summary->op);
+        if (ret < 0)
+            goto out_clear;
+    }
+
+    ret = gb_util_ns_now(&end_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out_clear;
+
+    summary->secs = (double)(end_ns - start_ns) / 1e9;
+    summary->present = ctx.present_count;
+    for (int k = 0; k < GB_MIX_OPS; k++) {
+        struct gb_mix_op_summary* o = &summary->op[k];
+
+        summary->total_ops += o->ops + o->misses + o->errors;
+        if (summary->secs > 0.0)
+            o->ops_per_sec = (double)o->ops / summary->secs;
+
+        ret = gb_stats_summarize(&lat[k], &o->latency);
+        if (ret < 0)
+            goto out_clear;
+    }
+    if (summary->secs > 0.0)
+        summary->ops_per_sec = (double)summary->total_ops / summary->secs;
+
+out_clear:
+    mix_clear(&ctx);
+out:
+    gb_nl_close(ctx.sock);
+    gb_populator_free(&pop);
+    gb_gate_dump_free(&ctx.dump);
+    gb_nl_msg_free(ctx.msg);
+    gb_nl_msg_free(ctx.dump_msg);
+    gb_nl_msg_free(ctx.resp);
+    for (int k = 0; k < GB_MIX_OPS; k++)
+        gb_stats_free(&lat[k]);
+    free(ctx.present);
+    free(ctx.cdf);
+    free(ctx.entries);
+    return ret;
+}
+
+void gb_mix_print_summary(const struct gb_mix_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg)
+        return;
+
+    printf("Op mix: %u hot indices, %s popularity", summary->hot_set, summary->zipf > 0.0 ? "zipf" : "uniform");
+    if (summary->zipf > 0.0)
+        printf(" (s = %.2f)", summary->zipf);
+    printf(", %.1f ops/sec over %llu ops, %u indices present at the end\n", summary->ops_per_sec,
+           (unsigned long long)summary->total_ops, summary->present);
+    printf("  %-8s %6s %9s %9s %8s %12s %9s %9s %9s\n", "op", "weight", "ops", "misses", "errors", "ops/sec", "p50",
+           "p99", "p999");
+
+    for (int k = 0; k < GB_MIX_OPS; k++) {
+        const struct gb_mix_op_summary* o = &summary->op[k];
+
+        if (o->weight == 0)
+            continue;
+
+        printf("  %-8s %6u %9llu %9llu %8llu %12.1f %7.1fus %7.1fus %7.1fus\n", gb_mix_op_name((enum gb_mix_op)k),
+               o->weight, (unsigned long long)o->ops, (unsigned long long)o->misses, (unsigned long long)o->errors,
+               o->ops_per_sec, (double)o->latency.p50_ns / 1e3, (double)o->latency.p99_ns / 1e3,
+               (double)o->latency.p999_ns / 1e3);
+    }
+}
@@ -0,0 +1,341 @@
+/* src/multi.c
+ * Multi-action sweep: the amortized per-action cost of carrying K gate
+ * actions in one RTM_NEWACTION, RTM_GETACTION and RTM_DELACTION.
+ */
+#include "../include/gatebench_multi.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* A GET reply is one TCA_ACT_TAB nest (at most 64 KiB) plus headers */
+#define MULTI_RESP_SIZE (128u * 1024u)
+
+enum multi_op {
+    MULTI_OP_CREATE,
+    MULTI_OP_GET,
+    MULTI_OP_DELETE,
+    MULTI_OP_COUNT,
+};
+
+struct multi_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    uint32_t indices[GB_MULTI_ACTIONS_MAX];
+    struct gb_nl_msg* msgs[MULTI_OP_COUNT];
+    struct gb_nl_msg* single;
+    struct gb_nl_msg* resp;
+};
+
+/* Drop whatever is left at the sweep's indices, one action at a time */
+static void multi_cleanup(struct multi_ctx* ctx, uint32_t k) {
+    for (uint32_t i = 0; i < k; i++) {
+        gb_nl_msg_reset(ctx->single);
+        if (build_gate_delaction(ctx->single, ctx->indices[i]) == 0)
+            (void)gb_nl_send_recv(ctx->sock, ctx->single, ctx->resp, ctx->cfg->timeout_ms);
+    }
+}
+
+/* Send one op; a GET also has to come back with all k actions */
+static int multi_op(struct multi_ctx* ctx, enum multi_op op, uint32_t k) {
+    int ret;
+
+    ret = gb_nl_send_recv(ctx->sock, ctx->msgs[op], ctx->resp, ctx->cfg->timeout_ms);
+    if (ret < 0 || op != MULTI_OP_GET)
+        return ret;
+
+    ret = gb_nl_gate_visit((struct nlmsghdr*)ctx->resp->buf, NULL, NULL);
+    if (ret < 0)
+        return ret;
+
+    return (uint32_t)ret == k ? 0 : -EPROTO;
+}
+
+static int multi_time_step(struct multi_ctx* ctx, uint32_t k, struct gb_stats* lat, struct gb_multi_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint64_t* errors[MULTI_OP_COUNT] = {&step->create_errors, &step->get_errors, &step->delete_errors};
+    uint64_t t0, t1;
+    int ret;
+
+    for (uint32_t i = 0; i < cfg->warmup; i++) {
+        for (int op = 0; op < MULTI_OP_COUNT; op++)
+            (void)multi_op(ctx, (enum multi_op)op, k);
+    }
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        for (int op = 0; op < MULTI_OP_COUNT; op++) {
+            ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+            if (ret < 0)
+                return ret;
+
+            ret = multi_op(ctx, (enum multi_op)op, k);
+
+            if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+                return -EIO;
+
+            if (ret < 0) {
+                (*errors[op])++;
+                continue;
+            }
+
+            ret = gb_stats_add(&lat[op], t1 - t0);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+static double multi_rate(uint32_t k, const struct gb_latency_summary* lat) {
+    return lat->mean_ns > 0.0 ? (double)k * 1e9 / lat->mean_ns : 0.0;
+}
+
+static int multi_step(struct multi_ctx* ctx, uint32_t k, struct gb_multi_step* step) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_stats lat[MULTI_OP_COUNT];
+    int ret;
+
+    memset(step, 0, sizeof(*step));
+    memset(lat, 0, sizeof(lat));
+    step->actions = k;
+
+    gb_nl_msg_reset(ctx->msgs[MULTI_OP_CREATE]);
+    ret = build_gate_newaction_multi(ctx->msgs[MULTI_OP_CREATE], ctx->indices, k, &ctx->shape, ctx->entries,
+                                     cfg->entries, NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+    if (ret == -EMSGSIZE) {
+        step->error = EMSGSIZE;
+        return 0;
+    }
+    if (ret < 0)
+        return ret;
+    step->msg_len = (uint32_t)ctx->msgs[MULTI_OP_CREATE]->len;
+
+    gb_nl_msg_reset(ctx->msgs[MULTI_OP_GET]);
+    ret = build_gate_getaction_multi(ctx->msgs[MULTI_OP_GET], ctx->indices, k);
+    if (ret < 0)
+        return ret;
+
+    gb_nl_msg_reset(ctx->msgs[MULTI_OP_DELETE]);
+    ret = build_gate_delaction_multi(ctx->msgs[MULTI_OP_DELETE], ctx->indices, k);
+    if (ret < 0)
+        return ret;
+
+    multi_cleanup(ctx, k);
+
+    /* One untimed round up front so a refused K is reported, not counted as errors */
+    ret = gb_nl_send_recv(ctx->sock, ctx->msgs[MULTI_OP_CREATE], ctx->resp, cfg->timeout_ms);
+    if (ret < 0) {
+        step->error = -ret;
+        multi_cleanup(ctx, k);
+        return 0;
+    }
+    (void)gb_nl_send_recv(ctx->sock, ctx->msgs[MULTI_OP_DELETE], ctx->resp, cfg->timeout_ms);
+
+    for (int op = 0; op < MULTI_OP_COUNT; op++) {
+        ret = gb_stats_init(&lat[op], cfg->iters);
+        if (ret < 0)
+            goto out;
+    }
+
+    ret = multi_time_step(ctx, k, lat, step);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_stats_summarize(&lat[MULTI_OP_CREATE], &step->create);
+    if (ret == 0)
+        ret = gb_stats_summarize(&lat[MULTI_OP_GET], &step->get);
+    if (ret == 0)
+        ret = gb_stats_summarize(&lat[MULTI_OP_DELETE], &step->del);
+    if (ret < 0)
+        goto out;
+
+    step->create_actions_per_sec = multi_rate(k, &step->create);
+    step->get_actions_per_sec = multi_rate(k, &step->get);
+    step->delete_actions_per_sec = multi_rate(k, &step->del);
+
+out:
+    for (int op = 0; op < MULTI_OP_COUNT; op++)
+        gb_stats_free(&lat[op]);
+    multi_cleanup(ctx, k);
+    return ret;
+}
+
+static uint32_t multi_points(uint32_t max, uint32_t* out) {
+    uint32_t n = 0;
+
+    for (uint32_t k = 1; k < max; k *= 2u)
+        out[n++] = k;
+    out[n++] = max;
+
+    return n;
+}
+
+int gb_multi_run(const struct gb_config* cfg, struct gb_multi_summary* summary) {
+    struct multi_ctx ctx;
+    uint32_t sweep[8];
+    uint32_t steps;
+    size_t msg_cap;
+    int ret;
+
+    if (!cfg || !summary || cfg->multi_actions == 0 || cfg->multi_actions > GB_MULTI_ACTIONS_MAX)
+        return -EINVAL;
+
+    if (cfg->index > UINT32_MAX - cfg->multi_actions)
+        return -ERANGE;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = cfg->entries;
+
+    for (uint32_t i = 0; i < cfg->multi_actions; i++)
+        ctx.indices[i] = cfg->index + i;
+
+    steps = multi_points(cfg->multi_actions, sweep);
+    summary->per_step = calloc(steps, sizeof(*summary->per_step));
+    ctx.entries = calloc(cfg->entries > 0 ? cfg->entries : 1u, sizeof(*ctx.entries));
+
+    /* Sized for the largest K; build_gate_newaction_multi refuses what the nest cannot hold */
+    msg_cap = gate_msg_size_multi(cfg->multi_actions, cfg->entries);
+    ctx.msgs[MULTI_OP_CREATE] = gb_nl_msg_alloc(msg_cap);
+    ctx.msgs[MULTI_OP_GET] = gb_nl_msg_alloc(4096);
+    ctx.msgs[MULTI_OP_DELETE] = gb_nl_msg_alloc(4096);
+    ctx.single = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc(MULTI_RESP_SIZE);
+    if (!summary->per_step || !ctx.entries || !ctx.msgs[MULTI_OP_CREATE] || !ctx.msgs[MULTI_OP_GET] ||
+        !ctx.msgs[MULTI_OP_DELETE] || !ctx.single || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(ctx.entries, cfg->entries, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t s = 0; s < steps; s++) {
+        struct gb_multi_step* st = &summary->per_step[s];
+
+        if (!cfg->json)
+            printf("  K=%2u actions/msg... ", sweep[s]);
+        fflush(stdout);
+
+        ret = multi_step(&ctx, sweep[s], st);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->steps = s + 1u;
+
+        if (st->error != 0) {
+            summary->limit = sweep[s];
+            if (!cfg->json)
+                printf("refused: %s\n", strerror(st->error));
+            break;
+        }
+
+        if (!cfg->json)
+            printf("done (create %.0f actions/s)\n", st->create_actions_per_sec);
+    }
+
+out:
+    gb_nl_close(ctx.sock);
+    for (int op = 0; op < MULTI_OP_COUNT; op++)
+        gb_nl_msg_free(ctx.msgs[op]);
+    gb_nl_msg_free(ctx.single);
+    gb_nl_msg_free(ctx.resp);
+    free(ctx.entries);
+    if (ret < 0)
+        gb_multi_summary_free(summary);
+    return ret;
+}
+
+void gb_multi_print_summary(const struct gb_multi_summary* summary, const struct gb_config* cfg) {
+    const struct gb_multi_step* base;
+
+    if (!summary || !cfg || summary->steps == 0)
+        return;
+
+    base = &summary->per_step[0];
+
+    printf("Multi-action messages: per-action cost with K actions per message\n");
+    printf("  %3s %9s %12s %12s %12s %12s %12s %12s %8s\n", "K", "msg bytes", "create p50", "create/act",
+           "get/act", "delete/act", "create act/s", "delete act/s", "errors");
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_multi_step* st = &summary->per_step[s];
+        double k = (double)st->actions;
+
+        if (st->error != 0) {
+            printf("  %3u %9u refused: %s\n", st->actions, st->msg_len, strerror(st->error));
+            continue;
+        }
+
+        printf("  %3u %9u %9llu ns %9.0f ns %9.0f ns %9.0f ns %12.0f %12.0f %8llu\n", st->actions, st->msg_len,
+               (unsigned long long)st->create.p50_ns, (double)st->create.p50_ns / k, (double)st->get.p50_ns / k,
+               (double)st->del.p50_ns / k, st->create_actions_per_sec, st->delete_actions_per_sec,
+               (unsigned long long)(st->create_errors + st->get_errors + st->delete_errors));
+    }
+
+    if (summary->limit > 0)
+        printf("  Limit: %u actions per message refused\n", summary->limit);
+
+    /* Speedup of the largest K that ran over one action per message */
+    for (uint32_t s = summary->steps; s-- > 1;) {
+        const struct gb_multi_step* st = &summary->per_step[s];
+
+        if (st->error != 0 || base->error != 0 || base->create_actions_per_sec <= 0.0)
+            continue;
+
+        printf("  K=%u vs K=1: create %.2fx, get %.2fx, delete %.2fx actions/s\n", st->actions,
+               st->create_actions_per_sec / base->create_actions_per_sec,
+               base->get_actions_per_sec > 0.0 ? st->get_actions_per_sec / base->get_actions_per_sec : 0.0,
+               base->delete_actions_per_sec > 0.0 ? st->delete_actions_per_sec / base->delete_actions_per_sec : 0.0);
+        break;
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_multi_step* st = &summary->per_step[s];
+
+        if (st->error != 0)
+            continue;
+
+        printf("  K=%u: create %llu errors, p99 %llu ns; get %llu errors, p99 %llu ns, %.0f act/s; delete %llu "
+               "errors, p99 %llu ns\n",
+               st->actions, (unsigned long long)st->create_errors, (unsigned long long)st->create.p99_ns,
+               (unsigned long long)st->get_errors, (unsigned long long)st->get.p99_ns, st->get_actions_per_sec,
+               (unsigned long long)st->delete_errors, (unsigned long long)st->del.p99_ns);
+    }
+}
+
+void gb_multi_summary_free(struct gb_multi_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_step);
+    summary->per_step = NULL;
+    summary->steps = 0;
+}
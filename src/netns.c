@@ -0,0 +1,466 @@
+/* src/netns.c
+ * Namespace scaling: N workers run the benchmark loop, first all in one
+ * network namespace and then each in its own, to show whether gate
+ * control-plane ops scale per namespace or serialize on global locks.
+ */
+#include "../include/gatebench_netns.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libmnl/libmnl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+struct netns_ctx {
+    const struct gb_config* cfg;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    uint32_t entry_count;
+
+    /* Start gate: the timed loops begin together once every worker is set up */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t ready;
+    bool go;
+};
+
+struct netns_worker {
+    struct netns_ctx* ctx;
+    uint32_t index;
+    bool isolate;
+
+    struct gb_stats lat;
+    uint64_t ops;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int ret;
+};
+
+/* Report this worker set up (or failed) and wait for the common start */
+static void netns_ready_wait(struct netns_ctx* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    ctx->ready++;
+    pthread_cond_broadcast(&ctx->cond);
+    while (!ctx->go)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static int write_file(const char* path, const char* data) {
+    size_t len = strlen(data);
+    ssize_t n;
+    int fd;
+    int ret = 0;
+
+    fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -errno;
+
+    n = write(fd, data, len);
+    if (n < 0)
+        ret = -errno;
+    else if ((size_t)n != len)
+        ret = -EIO;
+
+    close(fd);
+    return ret;
+}
+
+int gb_netns_enter(bool* user_ns) {
+    char map[64];
+    uid_t uid = geteuid();
+    gid_t gid = getegid();
+    int ret;
+
+    if (!user_ns)
+        return -EINVAL;
+
+    *user_ns = false;
+    if (unshare(CLONE_NEWNET) == 0)
+        return 0;
+    if (errno != EPERM)
+        return -errno;
+
+    /* Unprivileged: become root of a new user namespace that owns the netns */
+    if (unshare(CLONE_NEWUSER | CLONE_NEWNET) < 0)
+        return -errno;
+
+    ret = write_file("/proc/self/setgroups", "deny");
+    if (ret < 0 && ret != -ENOENT)
+        return ret;
+
+    snprintf(map, sizeof(map), "0 %u 1\n", (unsigned)uid);
+    ret = write_file("/proc/self/uid_map", map);
+    if (ret < 0)
+        return ret;
+
+    snprintf(map, sizeof(map), "0 %u 1\n", (unsigned)gid);
+    ret = write_file("/proc/self/gid_map", map);
+    if (ret < 0)
+        return ret;
+
+    *user_ns = true;
+    return 0;
+}
+
+/* The create/replace loop of the benchmark on the worker's own socket and index */
+static int netns_worker_loop(struct netns_worker* w, struct gb_nl_sock* sock) {
+    const struct netns_ctx* ctx = w->ctx;
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_nl_msg* create_msg = NULL;
+    struct gb_nl_msg* replace_msg = NULL;
+    struct gb_nl_msg* del_msg = NULL;
+    struct gb_nl_msg* resp = NULL;
+    size_t msg_cap = gate_msg_capacity(ctx->entry_count, 0);
+    bool waited = false;
+    int ret;
+
+    create_msg = gb_nl_msg_alloc(msg_cap);
+    replace_msg = gb_nl_msg_alloc(msg_cap);
+    del_msg = gb_nl_msg_alloc(1024);
+    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!create_msg || !replace_msg || !del_msg || !resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = build_gate_newaction(create_msg, w->index, &ctx->shape, ctx->entries, ctx->entry_count,
+                               NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_newaction(replace_msg, w->index, &ctx->shape, ctx->entries, ctx->entry_count,
+                               NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_delaction(del_msg, w->index);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < cfg->warmup; i++) {
+        ret = gb_nl_send_recv(sock, create_msg, resp, cfg->timeout_ms);
+        if (ret < 0 && ret != -EEXIST)
+            goto out;
+
+        ret = gb_nl_send_recv(sock, replace_msg, resp, cfg->timeout_ms);
+        if (ret < 0)
+            goto out;
+    }
+
+    ret = gb_nl_send_recv(sock, del_msg, resp, cfg->timeout_ms);
+    if (ret < 0 && ret != -ENOENT)
+        goto out;
+
+    netns_ready_wait(w->ctx);
+    waited = true;
+
+    ret = gb_util_ns_now(&w->start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < cfg->iters; i++) {
+        uint64_t a = 0, b = 0;
+
+        (void)gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+        ret = gb_nl_send_recv(sock, create_msg, resp, cfg->timeout_ms);
+        if (ret < 0 && ret != -EEXIST)
+            goto out;
+        (void)gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+
+        ret = gb_stats_add(&w->lat, b - a);
+        if (ret < 0)
+            goto out;
+
+        (void)gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+        ret = gb_nl_send_recv(sock, replace_msg, resp, cfg->timeout_ms);
+        if (ret < 0)
+            goto out;
+        (void)gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+
+        ret = gb_stats_add(&w->lat, b - a);
+        if (ret < 0)
+            goto out;
+
+        w->ops += 2u;
+    }
+
+    ret = gb_util_ns_now(&w->end_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+
+    (void)gb_nl_send_recv(sock, del_msg, resp, cfg->timeout_ms);
+
+out:
+    /* A worker that failed during setup still releases the others */
+    if (!waited)
+        netns_ready_wait(w->ctx);
+    gb_nl_msg_free(create_msg);
+    gb_nl_msg_free(replace_msg);
+    gb_nl_msg_free(del_msg);
+    gb_nl_msg_free(resp);
+    return ret;
+}
+
+static void* netns_worker_main(void* arg) {
+    struct netns_worker* w = arg;
+    struct gb_nl_sock* sock = NULL;
+
+    /* unshare(CLONE_NEWNET) moves only the calling thread */
+    if (w->isolate && unshare(CLONE_NEWNET) < 0) {
+        w->ret = -errno;
+        netns_ready_wait(w->ctx);
+        return NULL;
+    }
+
+    w->ret = gb_nl_open(&sock);
+    if (w->ret < 0) {
+        netns_ready_wait(w->ctx);
+        return NULL;
+    }
+
+    w->ret = netns_worker_loop(w, sock);
+    gb_nl_close(sock);
+    return NULL;
+}
+
+static int netns_layout(struct netns_ctx* ctx, bool isolate, struct gb_netns_layout_summary* out) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint32_t n = cfg->netns;
+    struct netns_worker* workers = NULL;
+    pthread_t* threads = NULL;
+    struct gb_stats all;
+    uint64_t first_start = UINT64_MAX, last_end = 0;
+    uint32_t started = 0;
+    int ret;
+
+    memset(out, 0, sizeof(*out));
+
+    ret = gb_stats_init(&all, (size_t)n * cfg->iters * 2u);
+    if (ret < 0)
+        return ret;
+
+    workers = calloc(n, sizeof(*workers));
+    threads = calloc(n, sizeof(*threads));
+    out->per_worker = calloc(n, sizeof(*out->per_worker));
+    if (!workers || !threads || !out->per_worker) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        workers[i].ctx = ctx;
+        workers[i].index = cfg->index + i;
+        workers[i].isolate = isolate;
+
+        ret = gb_stats_init(&workers[i].lat, (size_t)cfg->iters * 2u);
+        if (ret < 0)
+            goto out;
+    }
+
+    ctx->ready = 0;
+    ctx->go = false;
+
+    for (uint32_t i = 0; i < n; i++) {
+        ret = -pthread_create(&threads[i], NULL, netns_worker_main, &workers[i]);
+        if (ret < 0)
+            break;
+        started++;
+    }
+
+    /* Release whoever started, even after a failed pthread_create */
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->ready < started)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    ctx->go = true;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (uint32_t i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < n; i++) {
+        struct netns_worker* w = &workers[i];
+        struct gb_netns_worker_summary* ws = &out->per_worker[i];
+
+        if (w->ret < 0) {
+            ret = w->ret;
+            goto out;
+        }
+
+        ws->index = w->index;
+        ws->ops = w->ops;
+        ws->secs = (double)(w->end_ns - w->start_ns) / 1e9;
+        if (ws->secs > 0.0)
+            ws->ops_per_sec = (double)ws->ops / ws->secs;
+
+        out->total_ops += w->ops;
+        if (w->start_ns < first_start)
+            first_start = w->start_ns;
+        if (w->end_ns > last_end)
+            last_end = w->end_ns;
+
+        for (size_t k = 0; k < w->lat.count; k++) {
+            ret = gb_stats_add(&all, w->lat.values[k]);
+            if (ret < 0)
+                goto out;
+        }
+
+        ret = gb_stats_summarize(&w->lat, &ws->latency);
+        if (ret < 0)
+            goto out;
+    }
+
+    if (last_end > first_start)
+        out->secs = (double)(last_end - first_start) / 1e9;
+    if (out->secs > 0.0)
+        out->ops_per_sec = (double)out->total_ops / out->secs;
+
+    ret = gb_stats_summarize(&all, &out->latency);
+
+out:
+    if (workers) {
+        for (uint32_t i = 0; i < n; i++)
+            gb_stats_free(&workers[i].lat);
+    }
+    if (ret < 0) {
+        free(out->per_worker);
+        out->per_worker = NULL;
+    }
+    free(workers);
+    free(threads);
+    gb_stats_free(&all);
+    return ret;
+}
+
+int gb_netns_run(const struct gb_config* cfg, struct gb_netns_summary* summary) {
+    struct netns_ctx ctx;
+    int ret;
+
+    if (!cfg || !summary || cfg->netns == 0 || cfg->netns > GB_NETNS_MAX)
+        return -EINVAL;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
+    ctx.entry_count = cfg->entries;
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = ctx.entry_count;
+
+    if (ctx.entry_count > 0) {
+        ctx.entries = malloc((size_t)ctx.entry_count * sizeof(*ctx.entries));
+        if (!ctx.entries) {
+            ret = -ENOMEM;
+            goto out;
+        }
+        ret = gb_fill_entries(ctx.entries, ctx.entry_count, cfg->interval_ns);
+        if (ret < 0)
+            goto out;
+    }
+
+    summary->workers = cfg->netns;
+
+    if (!cfg->json)
+        printf("  %u workers, one namespace... ", cfg->netns);
+    fflush(stdout);
+    ret = netns_layout(&ctx, false, &summary->shared);
+    if (ret < 0) {
+        if (!cfg->json)
+            printf("failed: %s\n", strerror(-ret));
+        goto out;
+    }
+    if (!cfg->json)
+        printf("done (%.1f ops/sec)\n", summary->shared.ops_per_sec);
+
+    if (!cfg->json)
+        printf("  %u workers, namespace each... ", cfg->netns);
+    fflush(stdout);
+    ret = netns_layout(&ctx, true, &summary->isolated);
+    if (ret < 0) {
+        if (!cfg->json)
+            printf("failed: %s\n", strerror(-ret));
+        goto out;
+    }
+    if (!cfg->json)
+        printf("done (%.1f ops/sec)\n", summary->isolated.ops_per_sec);
+
+    if (summary->shared.ops_per_sec > 0.0)
+        summary->scaling = summary->isolated.ops_per_sec / summary->shared.ops_per_sec;
+
+out:
+    if (ret < 0)
+        gb_netns_summary_free(summary);
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    free(ctx.entries);
+    return ret;
+}
+
+static void netns_print_layout(const char* name, const struct gb_netns_layout_summary* layout, uint32_t workers) {
+    double min_ops = 0.0, max_ops = 0.0;
+
+    for (uint32_t i = 0; i < workers; i++) {
+        double ops = layout->per_worker[i].ops_per_sec;
+
+        if (i == 0 || ops < min_ops)
+            min_ops = ops;
+        if (i == 0 || ops > max_ops)
+            max_ops = ops;
+    }
+
+    printf("  %-15s %12.1f ops/sec aggregate, per worker %.1f..%.1f ops/sec, p50 %llu ns, p99 %llu ns, max %llu ns\n",
+           name, layout->ops_per_sec, min_ops, max_ops, (unsigned long long)layout->latency.p50_ns,
+           (unsigned long long)layout->latency.p99_ns, (unsigned long long)layout->latency.max_ns);
+}
+
+void gb_netns_print_summary(const struct gb_netns_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || !summary->shared.per_worker || !summary->isolated.per_worker)
+        return;
+
+    printf("Namespaces: %u workers%s\n", summary->workers, summary->user_ns ? " (inside a user namespace)" : "");
+    netns_print_layout("one namespace", &summary->shared, summary->workers);
+    netns_print_layout("namespace each", &summary->isolated, summary->workers);
+    printf("  Scaling: %.2fx aggregate throughput with a namespace per worker (about 1.00x: serialized on a global "
+           "lock)\n",
+           summary->scaling);
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t i = 0; i < summary->workers; i++) {
+        const struct gb_netns_worker_summary* s = &summary->shared.per_worker[i];
+        const struct gb_netns_worker_summary* o = &summary->isolated.per_worker[i];
+
+        printf("  worker %3u (index %u): shared %.1f ops/sec p99 %llu ns, own netns %.1f ops/sec p99 %llu ns\n", i,
+               s->index, s->ops_per_sec, (unsigned long long)s->latency.p99_ns, o->ops_per_sec,
+               (unsigned long long)o->latency.p99_ns);
+    }
+}
+
+void gb_netns_summary_free(struct gb_netns_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->shared.per_worker);
+    free(summary->isolated.per_worker);
+    summary->shared.per_worker = NULL;
+    summary->isolated.per_worker = NULL;
+    summary->workers = 0;
+}
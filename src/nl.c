@@ -3,6 +3,8 @@
  */
 #include "../include/gatebench_nl.h"
 #include "../include/gatebench_gate.h"
+#include "../include/gatebench_util.h"
+#include "nl_internal.h"
 #include <libmnl/libmnl.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
@@ -11,18 +13,152 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <time.h>
+
+/* In-flight slot of a pipelined request */
+struct gb_nl_inflight {
+    uint64_t cookie;
+    uint64_t issue_ns;
+    uint32_t seq;
+    bool busy;
+};
+
+/* Transport used by sockets opened from now on */
+static enum gb_nl_backend nl_backend = GB_NL_BACKEND_SYSCALL;
+
+/* Heap allocations made on netlink/message paths (gb_nl_alloc_count) */
+static atomic_uint_fast64_t nl_alloc_count;
+
+/*
+ * Per-socket arena sizes. The kernel caps a dump datagram at roughly 32 KiB
+ * once it has seen a large enough receive buffer, so 64 KiB rarely grows.
+ */
+#define GB_NL_ARENA_RX_SIZE (64u * 1024u)
+#define GB_NL_ARENA_TX_SIZE 4096u
+
+/* Pages in flight between the receive and parse threads of a pipelined dump */
+#define GB_NL_DUMP_RING 4u
+
+/*
+ * Batched sends: the socket buffers asked for on first use (the kernel caps
+ * them at wmem_max/rmem_max) and the slack netlink keeps below sk_sndbuf
+ * for one sendmsg.
+ */
+#define GB_NL_BATCH_SOCKBUF (1024u * 1024u)
+#define GB_NL_BATCH_SNDBUF_SLACK 32u
+
+/* Receive buffer charge of one queued ack (skb truesize, rounded up) */
+#define GB_NL_ACK_COST 1024u
+
+/* Capture bookkeeping for one request awaiting its ack; slot = seq % GB_NL_TRACE_SLOTS */
+#define GB_NL_TRACE_SLOTS GB_NL_WINDOW_MAX
+
+struct nl_trace_slot {
+    uint32_t seq;
+    bool busy;
+    int64_t off; /* Record offset in the trace file */
+};
 
 /* Netlink socket structure */
 struct gb_nl_sock {
     struct mnl_socket* nl;
+    int fd; /* Netlink socket, or the client end of the loopback pair */
     uint32_t pid;
     uint32_t seq;
+
+    /* io_uring transport (GB_NL_BACKEND_URING), NULL for plain syscalls */
+    struct gb_nl_uring* uring;
+
+    /* In-process act_gate model (GB_NL_BACKEND_LOOPBACK), NULL otherwise */
+    struct gb_nl_loopback* loopback;
+
+    /* O_NONBLOCK set: a zero timeout receive skips poll and may return -EAGAIN */
+    bool nonblock;
+
+    /* Pipelining state (gb_nl_async_init); slot = seq % window */
+    struct gb_nl_inflight* inflight;
+    uint32_t window;
+    uint32_t inflight_count;
+
+    /* Reusable, prefaulted buffers for get/dump so the hot path never allocates */
+    struct gb_nl_msg rx;
+    struct gb_nl_msg tx;
+
+    /* Page slots of a pipelined dump (gb_nl_dump_visit), grown on first use */
+    struct gb_nl_msg dump_ring[GB_NL_DUMP_RING];
+
+    /* gb_nl_send_batch iovecs and per-sendmsg limits (sized on first use) */
+    struct iovec batch_iov[GB_NL_BATCH_MAX];
+    size_t batch_bytes;  /* Largest sendmsg the socket accepts (0 = not sized yet) */
+    uint32_t batch_acks; /* Acks the receive buffer holds without overrun */
+
+    /* Per-phase timestamps of the last gb_nl_send_recv (gb_nl_set_phase_timing) */
+    bool phase_timing;
+    struct gb_nl_phase_times phases;
+
+    /* Requests awaiting their ack, set when a capture was running at open */
+    struct nl_trace_slot* trace;
 };
 
+static bool nl_is_open(const struct gb_nl_sock* sock) {
+    return sock->nl || sock->loopback;
+}
+
+/* Timestamp a phase boundary; a no-op unless phase timing is enabled */
+static void nl_stamp(const struct gb_nl_sock* sock, uint64_t* at) {
+    if (sock->phase_timing)
+        (void)gb_util_ns_now(at, CLOCK_MONOTONIC_RAW);
+}
+
+void gb_nl_count_alloc(void) {
+    atomic_fetch_add_explicit(&nl_alloc_count, 1, memory_order_relaxed);
+}
+
+uint64_t gb_nl_alloc_count(void) {
+    return (uint64_t)atomic_load_explicit(&nl_alloc_count, memory_order_relaxed);
+}
+
+/* Make sure m->buf holds at least need bytes; new pages are touched up front. */
+static int arena_reserve(struct gb_nl_msg* m, size_t need) {
+    size_t cap;
+    void* buf;
+
+    if (need <= m->cap)
+        return 0;
+
+    cap = m->cap ? m->cap : GB_NL_ARENA_TX_SIZE;
+    while (cap < need) {
+        if (cap > SIZE_MAX / 2)
+            return -ENOMEM;
+        cap *= 2;
+    }
+
+    buf = realloc(m->buf, cap);
+    if (!buf)
+        return -ENOMEM;
+
+    gb_nl_count_alloc();
+    memset((char*)buf + m->cap, 0, cap - m->cap);
+    m->buf = buf;
+    m->cap = cap;
+    return 0;
+}
+
+/* Capture this socket's requests if a trace is being written; best effort */
+static void nl_trace_attach(struct gb_nl_sock* s) {
+    if (gb_trace_capturing())
+        s->trace = calloc(GB_NL_TRACE_SLOTS, sizeof(*s->trace));
+}
+
 int gb_nl_open(struct gb_nl_sock** sock) {
     struct gb_nl_sock* s;
     struct mnl_socket* nl;
@@ -40,6 +176,29 @@ int gb_nl_open(struct gb_nl_sock** sock) {
 
     memset(s, 0, sizeof(*s));
 
+    if (nl_backend == GB_NL_BACKEND_LOOPBACK) {
+        int ret = gb_nl_loopback_open(&s->fd, &s->pid, &s->loopback);
+
+        if (ret < 0) {
+            free(s);
+            return ret;
+        }
+
+        if (arena_reserve(&s->rx, GB_NL_ARENA_RX_SIZE) < 0 || arena_reserve(&s->tx, GB_NL_ARENA_TX_SIZE) < 0) {
+            close(s->fd);
+            gb_nl_loopback_close(s->loopback);
+            free(s->rx.buf);
+            free(s->tx.buf);
+            free(s);
+            return -ENOMEM;
+        }
+
+        s->seq = 1;
+        nl_trace_attach(s);
+        *sock = s;
+        return 0;
+    }
+
     /* Open netlink socket for routing (NETLINK_ROUTE) */
     nl = mnl_socket_open(NETLINK_ROUTE);
     if (!nl) {
@@ -59,9 +218,31 @@ int gb_nl_open(struct gb_nl_sock** sock) {
         return -errno;
     }
 
+    if (nl_backend == GB_NL_BACKEND_URING) {
+        int ret = gb_nl_uring_open(fd, &s->uring);
+
+        if (ret < 0) {
+            mnl_socket_close(nl);
+            free(s);
+            return ret;
+        }
+    }
+
+    if (arena_reserve(&s->rx, GB_NL_ARENA_RX_SIZE) < 0 || arena_reserve(&s->tx, GB_NL_ARENA_TX_SIZE) < 0) {
+        if (s->uring)
+            gb_nl_uring_close(s->uring);
+        free(s->rx.buf);
+        free(s->tx.buf);
+        mnl_socket_close(nl);
+        free(s);
+        return -ENOMEM;
+    }
+
     s->nl = nl;
+    s->fd = fd;
     s->pid = mnl_socket_get_portid(nl);
     s->seq = 1;
+    nl_trace_attach(s);
 
     *sock = s;
     return 0;
@@ -72,14 +253,79 @@ void gb_nl_close(struct gb_nl_sock* sock) {
         return;
     }
 
+    if (sock->uring) {
+        gb_nl_uring_close(sock->uring);
+        sock->uring = NULL;
+    }
+
     if (sock->nl) {
         mnl_socket_close(sock->nl);
         sock->nl = NULL;
     }
 
+    if (sock->loopback) {
+        close(sock->fd);
+        gb_nl_loopback_close(sock->loopback);
+        sock->loopback = NULL;
+    }
+
+    free(sock->inflight);
+    free(sock->trace);
+    free(sock->rx.buf);
+    free(sock->tx.buf);
+    for (uint32_t i = 0; i < GB_NL_DUMP_RING; i++)
+        free(sock->dump_ring[i].buf);
     free(sock);
 }
 
+int gb_nl_fd(const struct gb_nl_sock* sock) {
+    if (!sock || !nl_is_open(sock))
+        return -EINVAL;
+
+    return sock->fd;
+}
+
+uint32_t gb_nl_portid(const struct gb_nl_sock* sock) {
+    return sock ? sock->pid : 0;
+}
+
+int gb_nl_join_group(struct gb_nl_sock* sock, unsigned int group) {
+    if (!sock || !nl_is_open(sock) || group == 0)
+        return -EINVAL;
+
+    if (sock->loopback)
+        return gb_nl_loopback_join(sock->loopback, group);
+
+    if (setsockopt(sock->fd, SOL_NETLINK, NETLINK_ADD_MEMBERSHIP, &group, sizeof(group)) < 0)
+        return -errno;
+
+    return 0;
+}
+
+int gb_nl_set_nonblock(struct gb_nl_sock* sock, bool nonblock) {
+    int fd;
+    int flags;
+
+    if (!sock || !nl_is_open(sock))
+        return -EINVAL;
+
+    /* Readiness is driven by the caller's poller; io_uring has its own wait */
+    if (sock->uring)
+        return -EOPNOTSUPP;
+
+    fd = sock->fd;
+    flags = fcntl(fd, F_GETFL);
+    if (flags < 0)
+        return -errno;
+
+    flags = nonblock ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    if (fcntl(fd, F_SETFL, flags) < 0)
+        return -errno;
+
+    sock->nonblock = nonblock;
+    return 0;
+}
+
 struct gb_nl_msg* gb_nl_msg_alloc(size_t capacity) {
     struct gb_nl_msg* msg;
 
@@ -94,6 +340,8 @@ struct gb_nl_msg* gb_nl_msg_alloc(size_t capacity) {
         return NULL;
     }
 
+    gb_nl_count_alloc();
+
     msg->cap = capacity;
     msg->len = 0;
 
@@ -184,37 +432,203 @@ static int parse_delaction_fcnt(const struct nlmsghdr* nlh, uint32_t* fcnt_out)
     return -ENOENT;
 }
 
-static int recv_response(struct gb_nl_sock* sock, struct gb_nl_msg* resp, uint32_t expected_seq, int timeout_ms) {
+/* Capture each request in an outgoing datagram, remembering its record by seq */
+static void nl_trace_send(struct gb_nl_sock* sock, const void* buf, size_t len) {
+    const struct nlmsghdr* nlh = buf;
+    int remaining = len > INT_MAX ? INT_MAX : (int)len;
+
+    while (mnl_nlmsg_ok(nlh, remaining)) {
+        int64_t off = gb_trace_record_request(nlh, nlh->nlmsg_len, nlh->nlmsg_seq);
+        struct nl_trace_slot* slot = &sock->trace[nlh->nlmsg_seq % GB_NL_TRACE_SLOTS];
+
+        if (off >= 0) {
+            slot->seq = nlh->nlmsg_seq;
+            slot->off = off;
+            slot->busy = true;
+        }
+        nlh = mnl_nlmsg_next(nlh, &remaining);
+    }
+}
+
+/* Complete captured requests answered in this datagram: ack, NLMSG_DONE or a single reply */
+static void nl_trace_recv(struct gb_nl_sock* sock, const void* buf, size_t len) {
+    const struct nlmsghdr* nlh = buf;
+    int remaining = len > INT_MAX ? INT_MAX : (int)len;
+
+    while (mnl_nlmsg_ok(nlh, remaining)) {
+        struct nl_trace_slot* slot = &sock->trace[nlh->nlmsg_seq % GB_NL_TRACE_SLOTS];
+
+        if (slot->busy && slot->seq == nlh->nlmsg_seq) {
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                gb_trace_record_result(slot->off, parse_error(nlh));
+                slot->busy = false;
+            }
+            else if (nlh->nlmsg_type == NLMSG_DONE || !(nlh->nlmsg_flags & NLM_F_MULTI)) {
+                gb_trace_record_result(slot->off, 0);
+                slot->busy = false;
+            }
+        }
+        nlh = mnl_nlmsg_next(nlh, &remaining);
+    }
+}
+
+/*
+ * Transport helpers. Every send and receive in this file goes through these so
+ * the backend can be swapped. With io_uring a send is only queued and goes out
+ * linked to the next nl_recv() in one io_uring_enter; its failure is reported
+ * there, or by nl_flush().
+ */
+static int nl_send(struct gb_nl_sock* sock, const void* buf, size_t len) {
+    ssize_t ret;
+
+    if (sock->trace)
+        nl_trace_send(sock, buf, len);
+
+    if (sock->uring) {
+        ret = gb_nl_uring_send(sock->uring, buf, len);
+        nl_stamp(sock, &sock->phases.sent_ns);
+        return (int)ret;
+    }
+
+    ret = send(sock->fd, buf, len, 0);
+    nl_stamp(sock, &sock->phases.sent_ns);
+    if (ret < 0)
+        return -errno;
+
+    if ((size_t)ret != len)
+        return -EIO;
+
+    return 0;
+}
+
+static int nl_sendmsg(struct gb_nl_sock* sock, const struct msghdr* mh, size_t total) {
+    ssize_t ret;
+
+    if (sock->trace) {
+        for (size_t i = 0; i < mh->msg_iovlen; i++)
+            nl_trace_send(sock, mh->msg_iov[i].iov_base, mh->msg_iov[i].iov_len);
+    }
+
+    if (sock->uring)
+        return gb_nl_uring_sendmsg(sock->uring, mh, total);
+
+    ret = sendmsg(sock->fd, mh, 0);
+    if (ret < 0)
+        return -errno;
+
+    if ((size_t)ret != total)
+        return -EIO;
+
+    return 0;
+}
+
+static int nl_flush(struct gb_nl_sock* sock) {
+    if (sock->uring)
+        return gb_nl_uring_flush(sock->uring);
+
+    return 0;
+}
+
+/* Receive one datagram into resp; returns its length or a negative errno. */
+static ssize_t nl_recv(struct gb_nl_sock* sock, struct gb_nl_msg* resp, int timeout_ms) {
+    struct pollfd pfd;
+    ssize_t ret;
+
+    if (sock->uring) {
+        ret = gb_nl_uring_recv(sock->uring, resp->buf, resp->cap, 0, timeout_ms);
+        /* One enter covers send, wait and receive; attribute it all to recv */
+        sock->phases.wake_ns = sock->phases.sent_ns;
+        nl_stamp(sock, &sock->phases.recvd_ns);
+    }
+    else {
+        if (!sock->nonblock || timeout_ms != 0) {
+            pfd.fd = sock->fd;
+            pfd.events = POLLIN;
+
+            ret = poll(&pfd, 1, timeout_ms);
+            if (ret < 0)
+                return -errno;
+            if (ret == 0)
+                return -ETIMEDOUT;
+        }
+        nl_stamp(sock, &sock->phases.wake_ns);
+
+        ret = recv(sock->fd, resp->buf, resp->cap, MSG_TRUNC);
+        nl_stamp(sock, &sock->phases.recvd_ns);
+        if (ret < 0)
+            return -errno;
+        if ((size_t)ret > resp->cap)
+            return -ENOSPC;
+    }
+
+    if (ret >= 0) {
+        resp->len = (size_t)ret;
+        if (sock->trace)
+            nl_trace_recv(sock, resp->buf, resp->len);
+    }
+    return ret;
+}
+
+/*
+ * Receive one datagram into an arena (the socket rx arena or a dump ring
+ * slot). The pending datagram is sized with MSG_PEEK | MSG_TRUNC first and the
+ * arena grown to fit, so a large dump page is never truncated and nothing is
+ * allocated in the common case.
+ */
+static ssize_t nl_recv_arena(struct gb_nl_sock* sock, struct gb_nl_msg* arena, int timeout_ms) {
     struct pollfd pfd;
+    ssize_t ret;
+    int err;
+
+    if (sock->uring) {
+        ret = gb_nl_uring_recv(sock->uring, NULL, 0, MSG_PEEK, timeout_ms);
+        if (ret < 0)
+            return ret;
+    }
+    else {
+        if (!sock->nonblock || timeout_ms != 0) {
+            pfd.fd = sock->fd;
+            pfd.events = POLLIN;
+
+            ret = poll(&pfd, 1, timeout_ms);
+            if (ret < 0)
+                return -errno;
+            if (ret == 0)
+                return -ETIMEDOUT;
+        }
+
+        ret = recv(sock->fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+        if (ret < 0)
+            return -errno;
+    }
+
+    err = arena_reserve(arena, (size_t)ret);
+    if (err < 0)
+        return err;
+
+    /* The datagram is already queued, so the real read does not block */
+    return nl_recv(sock, arena, timeout_ms);
+}
+
+static int recv_response(struct gb_nl_sock* sock, struct gb_nl_msg* resp, uint32_t expected_seq, int timeout_ms) {
     ssize_t ret;
     int len;
     struct nlmsghdr* nlh;
     int done = 0;
 
-    if (!sock || !sock->nl || !resp) {
+    if (!sock || !nl_is_open(sock) || !resp) {
         return -EINVAL;
     }
 
-    pfd.fd = mnl_socket_get_fd(sock->nl);
-    pfd.events = POLLIN;
-
     while (!done) {
-        /* Wait for data with timeout */
-        ret = poll(&pfd, 1, timeout_ms);
-        if (ret < 0) {
-            return -errno;
-        }
-        if (ret == 0) {
-            return -ETIMEDOUT;
-        }
-
-        /* Receive data */
-        ret = mnl_socket_recvfrom(sock->nl, resp->buf, resp->cap);
-        if (ret < 0) {
-            return -errno;
-        }
+        /* Replies into the socket arena are sized first, so large GETs fit */
+        if (resp == &sock->rx)
+            ret = nl_recv_arena(sock, &sock->rx, timeout_ms);
+        else
+            ret = nl_recv(sock, resp, timeout_ms);
+        if (ret < 0)
+            return (int)ret;
 
-        resp->len = (size_t)ret;
         len = (int)ret;
 
         /* Parse netlink message */
@@ -240,33 +654,19 @@ static int recv_response(struct gb_nl_sock* sock, struct gb_nl_msg* resp, uint32
 }
 
 static int recv_ack(struct gb_nl_sock* sock, struct gb_nl_msg* resp, uint32_t expected_seq, int timeout_ms) {
-    struct pollfd pfd;
     ssize_t ret;
     int len;
     struct nlmsghdr* nlh;
 
-    if (!sock || !sock->nl || !resp) {
+    if (!sock || !nl_is_open(sock) || !resp) {
         return -EINVAL;
     }
 
-    pfd.fd = mnl_socket_get_fd(sock->nl);
-    pfd.events = POLLIN;
-
     for (;;) {
-        ret = poll(&pfd, 1, timeout_ms);
-        if (ret < 0) {
-            return -errno;
-        }
-        if (ret == 0) {
-            return -ETIMEDOUT;
-        }
-
-        ret = mnl_socket_recvfrom(sock->nl, resp->buf, resp->cap);
-        if (ret < 0) {
-            return -errno;
-        }
+        ret = nl_recv(sock, resp, timeout_ms);
+        if (ret < 0)
+            return (int)ret;
 
-        resp->len = (size_t)ret;
         len = (int)ret;
         nlh = (struct nlmsghdr*)resp->buf;
         while (mnl_nlmsg_ok(nlh, len)) {
@@ -280,12 +680,24 @@ static int recv_ack(struct gb_nl_sock* sock, struct gb_nl_msg* resp, uint32_t ex
     }
 }
 
+int gb_nl_recv(struct gb_nl_sock* sock, struct gb_nl_msg* resp, int timeout_ms) {
+    ssize_t ret;
+
+    if (!sock || !nl_is_open(sock) || !resp)
+        return -EINVAL;
+
+    ret = nl_recv(sock, resp, timeout_ms);
+    if (ret > INT_MAX)
+        return -EOVERFLOW;
+    return (int)ret;
+}
+
 int gb_nl_send_recv(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_nl_msg* resp, int timeout_ms) {
     ssize_t ret;
     struct nlmsghdr* nlh;
     uint32_t seq;
 
-    if (!sock || !sock->nl || !req || !resp) {
+    if (!sock || !nl_is_open(sock) || !req || !resp) {
         return -EINVAL;
     }
 
@@ -293,100 +705,409 @@ int gb_nl_send_recv(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_nl
         return -EINVAL;
     }
 
+    nl_stamp(sock, &sock->phases.start_ns);
+
     /* Get and set sequence number */
     seq = gb_nl_next_seq(sock);
     nlh = (struct nlmsghdr*)req->buf;
     nlh->nlmsg_seq = seq;
 
     /* Send request */
-    ret = mnl_socket_sendto(sock->nl, req->buf, req->len);
-    if (ret < 0) {
-        return -errno;
-    }
-
-    if ((size_t)ret != req->len) {
-        return -EIO;
-    }
+    ret = nl_send(sock, req->buf, req->len);
+    if (ret < 0)
+        return (int)ret;
 
     /* Receive response */
-    return recv_response(sock, resp, seq, timeout_ms);
+    ret = recv_response(sock, resp, seq, timeout_ms);
+    nl_stamp(sock, &sock->phases.done_ns);
+    return (int)ret;
 }
 
-int gb_nl_send_recv_ack(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_nl_msg* resp, int timeout_ms) {
-    ssize_t ret;
-    struct nlmsghdr* nlh;
-    uint32_t seq;
+void gb_nl_set_phase_timing(struct gb_nl_sock* sock, bool enable) {
+    if (!sock)
+        return;
 
-    if (!sock || !sock->nl || !req || !resp) {
-        return -EINVAL;
-    }
+    sock->phase_timing = enable;
+    memset(&sock->phases, 0, sizeof(sock->phases));
+}
 
-    if (req->len > req->cap) {
+int gb_nl_last_phases(const struct gb_nl_sock* sock, struct gb_nl_phase_times* out) {
+    if (!sock || !out)
         return -EINVAL;
-    }
 
-    seq = gb_nl_next_seq(sock);
-    nlh = (struct nlmsghdr*)req->buf;
-    nlh->nlmsg_seq = seq;
+    if (!sock->phase_timing)
+        return -ENODATA;
 
-    ret = mnl_socket_sendto(sock->nl, req->buf, req->len);
-    if (ret < 0) {
-        return -errno;
-    }
+    *out = sock->phases;
+    return 0;
+}
 
-    if ((size_t)ret != req->len) {
-        return -EIO;
-    }
+/* Size the socket for batching: raise both buffers as far as the caps allow, then read back what was granted */
+static int nl_batch_prepare(struct gb_nl_sock* sock) {
+    int want = (int)GB_NL_BATCH_SOCKBUF;
+    int sndbuf = 0, rcvbuf = 0;
+    socklen_t optlen;
 
-    return recv_ack(sock, resp, seq, timeout_ms);
+    if (sock->batch_bytes > 0)
+        return 0;
+
+    (void)setsockopt(sock->fd, SOL_SOCKET, SO_SNDBUF, &want, sizeof(want));
+    (void)setsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, &want, sizeof(want));
+
+    optlen = sizeof(sndbuf);
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &optlen) < 0)
+        return -errno;
+    optlen = sizeof(rcvbuf);
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, &optlen) < 0)
+        return -errno;
+
+    sock->batch_bytes = sndbuf > (int)GB_NL_BATCH_SNDBUF_SLACK ? (size_t)sndbuf - GB_NL_BATCH_SNDBUF_SLACK : 1;
+    sock->batch_acks = rcvbuf > 0 ? (uint32_t)rcvbuf / GB_NL_ACK_COST : 0;
+    if (sock->batch_acks == 0)
+        sock->batch_acks = 1;
+    return 0;
 }
 
-int gb_nl_send_recv_flush(struct gb_nl_sock* sock,
-                          struct gb_nl_msg* req,
+/* Send reqs[start..end) in one sendmsg and collect their acks into errs */
+static int nl_batch_chunk(struct gb_nl_sock* sock,
+                          struct gb_nl_msg* const* reqs,
+                          uint32_t start,
+                          uint32_t end,
+                          uint32_t first_seq,
                           struct gb_nl_msg* resp,
-                          int timeout_ms,
-                          uint32_t* fcnt_out) {
-    struct pollfd pfd;
+                          int* errs,
+                          int timeout_ms) {
+    struct sockaddr_nl addr;
+    struct msghdr mh;
+    struct nlmsghdr* nlh;
+    uint32_t pending = end - start;
+    bool overrun = false;
+    size_t total = 0;
     ssize_t ret;
     int len;
-    struct nlmsghdr* nlh;
-    uint32_t seq;
-
-    if (!sock || !sock->nl || !req || !resp)
-        return -EINVAL;
 
-    if (req->len > req->cap)
-        return -EINVAL;
+    for (uint32_t i = start; i < end; i++) {
+        sock->batch_iov[i - start].iov_base = reqs[i]->buf;
+        sock->batch_iov[i - start].iov_len = reqs[i]->len;
+        total += reqs[i]->len;
+    }
 
-    if (fcnt_out)
-        *fcnt_out = UINT32_MAX;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
 
-    seq = gb_nl_next_seq(sock);
-    nlh = (struct nlmsghdr*)req->buf;
-    nlh->nlmsg_seq = seq;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_name = &addr;
+    mh.msg_namelen = sizeof(addr);
+    mh.msg_iov = sock->batch_iov;
+    mh.msg_iovlen = end - start;
 
-    ret = mnl_socket_sendto(sock->nl, req->buf, req->len);
+    ret = nl_sendmsg(sock, &mh, total);
     if (ret < 0)
-        return -errno;
-
-    if ((size_t)ret != req->len)
-        return -EIO;
-
-    pfd.fd = mnl_socket_get_fd(sock->nl);
-    pfd.events = POLLIN;
+        return (int)ret;
 
-    for (;;) {
-        ret = poll(&pfd, 1, timeout_ms);
+    while (pending > 0) {
+        /* After an overrun, take what is still queued without waiting */
+        ret = nl_recv(sock, resp, overrun ? 0 : timeout_ms);
+        if (ret == -ENOBUFS) {
+            overrun = true;
+            continue;
+        }
+        if (ret < 0 && overrun && (ret == -ETIMEDOUT || ret == -EAGAIN)) {
+            /* The kernel dropped these acks with the receive buffer full */
+            for (uint32_t i = start; i < end; i++) {
+                if (errs[i] == GB_NL_BATCH_PENDING)
+                    errs[i] = -ENOBUFS;
+            }
+            return 0;
+        }
         if (ret < 0)
-            return -errno;
-        if (ret == 0)
-            return -ETIMEDOUT;
+            return (int)ret;
+
+        len = (int)ret;
+        nlh = (struct nlmsghdr*)resp->buf;
+        while (mnl_nlmsg_ok(nlh, len)) {
+            uint32_t slot = nlh->nlmsg_seq - first_seq;
+
+            if (nlh->nlmsg_type == NLMSG_ERROR && slot >= start && slot < end && errs[slot] == GB_NL_BATCH_PENDING) {
+                errs[slot] = parse_error(nlh);
+                pending--;
+            }
+            nlh = mnl_nlmsg_next(nlh, &len);
+        }
+    }
+
+    return 0;
+}
+
+int gb_nl_send_batch(struct gb_nl_sock* sock,
+                     struct gb_nl_msg* const* reqs,
+                     uint32_t count,
+                     struct gb_nl_msg* resp,
+                     int* errs,
+                     int timeout_ms) {
+    struct nlmsghdr* nlh;
+    uint32_t first_seq;
+    uint32_t start, end;
+    size_t total;
+    int ret;
 
-        ret = mnl_socket_recvfrom(sock->nl, resp->buf, resp->cap);
+    if (!sock || !nl_is_open(sock) || !reqs || !resp || !errs || count == 0)
+        return -EINVAL;
+
+    if (count > GB_NL_BATCH_MAX)
+        return -E2BIG;
+
+    ret = nl_batch_prepare(sock);
+    if (ret < 0)
+        return ret;
+
+    first_seq = sock->seq;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!reqs[i] || reqs[i]->len > reqs[i]->cap || reqs[i]->len < NLMSG_HDRLEN)
+            return -EINVAL;
+
+        nlh = (struct nlmsghdr*)reqs[i]->buf;
+        /* Completion is tracked through acks, so every request must ask for one */
+        if (!(nlh->nlmsg_flags & NLM_F_ACK))
+            return -EINVAL;
+
+        nlh->nlmsg_seq = gb_nl_next_seq(sock);
+        errs[i] = GB_NL_BATCH_PENDING;
+    }
+
+    /*
+     * Split the batch where it would outgrow one sendmsg or queue more acks
+     * than the receive buffer holds; each chunk is acked before the next.
+     */
+    for (start = 0; start < count; start = end) {
+        total = reqs[start]->len;
+        end = start + 1u;
+        while (end < count && end - start < sock->batch_acks && total + reqs[end]->len <= sock->batch_bytes) {
+            total += reqs[end]->len;
+            end++;
+        }
+
+        ret = nl_batch_chunk(sock, reqs, start, end, first_seq, resp, errs, timeout_ms);
         if (ret < 0)
-            return -errno;
+            return ret;
+    }
+
+    return 0;
+}
+
+/*
+ * Grow the receive buffer to hold bytes of queued replies: SO_RCVBUFFORCE
+ * passes rmem_max with CAP_NET_ADMIN, SO_RCVBUF goes up to it. Never
+ * shrinks; *granted receives the size in effect afterwards.
+ */
+static int nl_grow_rcvbuf(struct gb_nl_sock* sock, int bytes, int* granted) {
+    socklen_t optlen = sizeof(*granted);
+
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, granted, &optlen) < 0)
+        return -errno;
+    if (*granted >= bytes)
+        return 0;
+
+    if (setsockopt(sock->fd, SOL_SOCKET, SO_RCVBUFFORCE, &bytes, sizeof(bytes)) < 0)
+        (void)setsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+
+    optlen = sizeof(*granted);
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, granted, &optlen) < 0)
+        return -errno;
+    return 0;
+}
+
+int gb_nl_async_init(struct gb_nl_sock* sock, uint32_t window) {
+    struct gb_nl_inflight* slots;
+    int rcvbuf = 0;
+    int ret;
+
+    if (!sock || window == 0 || window > GB_NL_WINDOW_MAX)
+        return -EINVAL;
+
+    if (sock->inflight_count > 0)
+        return -EBUSY;
+
+    /*
+     * Up to window acks queue while requests are being submitted; rtnetlink
+     * drops the ones that do not fit. The loopback pair blocks instead.
+     */
+    ret = nl_grow_rcvbuf(sock, (int)(window * GB_NL_ACK_COST), &rcvbuf);
+    if (ret < 0)
+        return ret;
+    if (sock->nl && (uint32_t)rcvbuf / GB_NL_ACK_COST < window)
+        return -ENOBUFS;
+
+    slots = calloc(window, sizeof(*slots));
+    if (!slots)
+        return -ENOMEM;
+
+    free(sock->inflight);
+    sock->inflight = slots;
+    sock->window = window;
+    return 0;
+}
+
+int gb_nl_submit(struct gb_nl_sock* sock, struct gb_nl_msg* req, uint64_t cookie) {
+    struct gb_nl_inflight* slot;
+    struct nlmsghdr* nlh;
+    uint64_t now;
+    ssize_t ret;
+    int err;
+
+    if (!sock || !nl_is_open(sock) || !sock->inflight || !req)
+        return -EINVAL;
+
+    if (req->len > req->cap || req->len < NLMSG_HDRLEN)
+        return -EINVAL;
+
+    nlh = (struct nlmsghdr*)req->buf;
+    if (!(nlh->nlmsg_flags & NLM_F_ACK))
+        return -EINVAL;
+
+    /*
+     * rtnl acks in order, so the slot for the next seq is free whenever the
+     * window has room. A stale slot only appears if acks were lost.
+     */
+    slot = &sock->inflight[sock->seq % sock->window];
+    if (sock->inflight_count >= sock->window || slot->busy)
+        return -EAGAIN;
+
+    nlh->nlmsg_seq = gb_nl_next_seq(sock);
+
+    err = gb_util_ns_now(&now, CLOCK_MONOTONIC_RAW);
+    if (err < 0)
+        return err;
+
+    /* The request must be on the wire when submit returns, even if the backend queues sends */
+    ret = nl_send(sock, req->buf, req->len);
+    if (ret == 0)
+        ret = nl_flush(sock);
+    if (ret < 0)
+        return (int)ret;
+
+    slot->cookie = cookie;
+    slot->issue_ns = now;
+    slot->seq = nlh->nlmsg_seq;
+    slot->busy = true;
+    sock->inflight_count++;
+    return 0;
+}
+
+int gb_nl_reap(struct gb_nl_sock* sock,
+               struct gb_nl_msg* resp,
+               struct gb_nl_completion* out,
+               uint32_t max,
+               int timeout_ms) {
+    struct nlmsghdr* nlh;
+    uint32_t done = 0;
+    uint64_t now;
+    ssize_t ret;
+    int len;
+    int err;
+
+    if (!sock || !nl_is_open(sock) || !sock->inflight || !resp || !out || max < sock->window)
+        return -EINVAL;
+
+    if (sock->inflight_count == 0)
+        return 0;
+
+    while (done == 0) {
+        ret = nl_recv(sock, resp, timeout_ms);
+        if (ret < 0)
+            return (int)ret;
+
+        err = gb_util_ns_now(&now, CLOCK_MONOTONIC_RAW);
+        if (err < 0)
+            return err;
+
+        len = (int)ret;
+        nlh = (struct nlmsghdr*)resp->buf;
+        while (mnl_nlmsg_ok(nlh, len)) {
+            struct gb_nl_inflight* slot = &sock->inflight[nlh->nlmsg_seq % sock->window];
+
+            if (nlh->nlmsg_type == NLMSG_ERROR && slot->busy && slot->seq == nlh->nlmsg_seq) {
+                struct gb_nl_completion* c = &out[done++];
+
+                c->cookie = slot->cookie;
+                c->seq = slot->seq;
+                c->err = parse_error(nlh);
+                c->issue_ns = slot->issue_ns;
+                c->ack_ns = now;
+                c->latency_ns = now - slot->issue_ns;
+                slot->busy = false;
+                sock->inflight_count--;
+            }
+            nlh = mnl_nlmsg_next(nlh, &len);
+        }
+    }
+
+    return (int)done;
+}
+
+uint32_t gb_nl_inflight(const struct gb_nl_sock* sock) {
+    if (!sock)
+        return 0;
+
+    return sock->inflight_count;
+}
+
+int gb_nl_send_recv_ack(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_nl_msg* resp, int timeout_ms) {
+    ssize_t ret;
+    struct nlmsghdr* nlh;
+    uint32_t seq;
+
+    if (!sock || !nl_is_open(sock) || !req || !resp) {
+        return -EINVAL;
+    }
+
+    if (req->len > req->cap) {
+        return -EINVAL;
+    }
+
+    seq = gb_nl_next_seq(sock);
+    nlh = (struct nlmsghdr*)req->buf;
+    nlh->nlmsg_seq = seq;
+
+    ret = nl_send(sock, req->buf, req->len);
+    if (ret < 0)
+        return (int)ret;
+
+    return recv_ack(sock, resp, seq, timeout_ms);
+}
+
+int gb_nl_send_recv_flush(struct gb_nl_sock* sock,
+                          struct gb_nl_msg* req,
+                          struct gb_nl_msg* resp,
+                          int timeout_ms,
+                          uint32_t* fcnt_out) {
+    ssize_t ret;
+    int len;
+    struct nlmsghdr* nlh;
+    uint32_t seq;
+
+    if (!sock || !nl_is_open(sock) || !req || !resp)
+        return -EINVAL;
+
+    if (req->len > req->cap)
+        return -EINVAL;
+
+    if (fcnt_out)
+        *fcnt_out = UINT32_MAX;
+
+    seq = gb_nl_next_seq(sock);
+    nlh = (struct nlmsghdr*)req->buf;
+    nlh->nlmsg_seq = seq;
+
+    ret = nl_send(sock, req->buf, req->len);
+    if (ret < 0)
+        return (int)ret;
+
+    for (;;) {
+        ret = nl_recv(sock, resp, timeout_ms);
+        if (ret < 0)
+            return (int)ret;
 
-        resp->len = (size_t)ret;
         len = (int)ret;
         nlh = (struct nlmsghdr*)resp->buf;
         while (mnl_nlmsg_ok(nlh, len)) {
@@ -409,137 +1130,430 @@ int gb_nl_send_recv_flush(struct gb_nl_sock* sock,
     }
 }
 
+static int echo_index_cb(const struct gate_view* view, void* arg) {
+    uint32_t* index = arg;
+
+    if (*index == UINT32_MAX)
+        *index = view->action.index;
+    return 0;
+}
+
+int gb_nl_send_recv_echo(struct gb_nl_sock* sock,
+                         struct gb_nl_msg* req,
+                         struct gb_nl_msg* resp,
+                         int timeout_ms,
+                         uint32_t* index_out,
+                         uint32_t* echo_len_out) {
+    ssize_t ret;
+    int len;
+    struct nlmsghdr* nlh;
+    uint32_t seq;
+
+    if (!sock || !nl_is_open(sock) || !req || !resp || !index_out)
+        return -EINVAL;
+
+    if (req->len > req->cap)
+        return -EINVAL;
+
+    *index_out = UINT32_MAX;
+    if (echo_len_out)
+        *echo_len_out = 0;
+
+    seq = gb_nl_next_seq(sock);
+    nlh = (struct nlmsghdr*)req->buf;
+    nlh->nlmsg_seq = seq;
+
+    ret = nl_send(sock, req->buf, req->len);
+    if (ret < 0)
+        return (int)ret;
+
+    /* The echo is unicast before the ack, possibly in its own datagram */
+    for (;;) {
+        ret = nl_recv(sock, resp, timeout_ms);
+        if (ret < 0)
+            return (int)ret;
+
+        len = (int)ret;
+        nlh = (struct nlmsghdr*)resp->buf;
+        while (mnl_nlmsg_ok(nlh, len)) {
+            if (nlh->nlmsg_seq != seq) {
+                nlh = mnl_nlmsg_next(nlh, &len);
+                continue;
+            }
+
+            if (nlh->nlmsg_type == RTM_NEWACTION) {
+                (void)gb_nl_gate_visit(nlh, echo_index_cb, index_out);
+                if (echo_len_out)
+                    *echo_len_out = nlh->nlmsg_len;
+            }
+
+            if (nlh->nlmsg_type == NLMSG_ERROR)
+                return parse_error(nlh);
+
+            nlh = mnl_nlmsg_next(nlh, &len);
+        }
+    }
+}
+
 int gb_nl_get_action(struct gb_nl_sock* sock, uint32_t index, struct gate_dump* dump, int timeout_ms) {
-    struct gb_nl_msg* req = NULL;
-    struct gb_nl_msg* resp = NULL;
     int ret;
 
-    req = gb_nl_msg_alloc(1024);
-    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!sock || !nl_is_open(sock) || !dump)
+        return -EINVAL;
 
-    if (!req || !resp) {
-        ret = -ENOMEM;
-        goto out;
-    }
+    ret = build_gate_getaction(&sock->tx, index);
+    if (ret < 0)
+        return ret;
 
-    ret = build_gate_getaction(req, index);
-    if (ret < 0) {
-        goto out;
-    }
+    ret = gb_nl_send_recv(sock, &sock->tx, &sock->rx, timeout_ms);
+    if (ret < 0)
+        return ret;
 
-    ret = gb_nl_send_recv(sock, req, resp, timeout_ms);
-    if (ret < 0) {
-        goto out;
-    }
+    return gb_nl_gate_parse((struct nlmsghdr*)sock->rx.buf, dump);
+}
 
-    ret = gb_nl_gate_parse((struct nlmsghdr*)resp->buf, dump);
+/* Destination of the gate actions found while walking dump pages */
+struct dump_visit {
+    gb_gate_visit_fn fn;
+    void* arg;
+    bool parse;        /* Walk actions at all; plain dumps only count */
+    uint64_t start_ns; /* Request send time, for first_page_ns (0 = not timed) */
+};
 
-out:
-    if (req)
-        gb_nl_msg_free(req);
-    if (resp)
-        gb_nl_msg_free(resp);
-    return ret;
+/*
+ * Account one received dump page and hand its actions to the visitor.
+ * Returns 1 once the dump has ended (DONE or an error recorded in stats),
+ * 0 when more pages follow, or a negative errno from the visitor.
+ */
+static int dump_walk_page(const void* buf,
+                          size_t buf_len,
+                          uint32_t seq,
+                          const struct dump_visit* visit,
+                          struct gb_dump_stats* stats) {
+    const struct nlmsghdr* nlh = buf;
+    int len = (int)buf_len;
+    int ret;
+
+    while (mnl_nlmsg_ok(nlh, len)) {
+        if (nlh->nlmsg_seq != seq) {
+            nlh = mnl_nlmsg_next(nlh, &len);
+            continue;
+        }
+
+        if (nlh->nlmsg_type == NLMSG_ERROR) {
+            int err = parse_error(nlh);
+            if (err != 0) {
+                stats->saw_error = true;
+                stats->error_code = err;
+                return 1;
+            }
+            nlh = mnl_nlmsg_next(nlh, &len);
+            continue;
+        }
+
+        if (nlh->nlmsg_type == NLMSG_DONE) {
+            stats->saw_done = true;
+            return 1;
+        }
+
+        if (nlh->nlmsg_type == RTM_GETACTION) {
+            const struct nlattr* tb[TCA_ROOT_MAX + 1] = {NULL};
+
+            if (mnl_attr_parse(nlh, sizeof(struct tcamsg), nl_attr_cb_copy, tb) == 0 && tb[TCA_ROOT_COUNT]) {
+                stats->action_count += mnl_attr_get_u32(tb[TCA_ROOT_COUNT]);
+            }
+
+            if (visit->parse) {
+                ret = gb_nl_gate_visit(nlh, visit->fn, visit->arg);
+                if (ret < 0)
+                    return ret;
+                stats->visited_actions += (uint64_t)ret;
+            }
+        }
+
+        stats->reply_msgs++;
+        if (nlh->nlmsg_len >= NLMSG_HDRLEN)
+            stats->payload_bytes += (uint64_t)(nlh->nlmsg_len - NLMSG_HDRLEN);
+
+        nlh = mnl_nlmsg_next(nlh, &len);
+    }
+
+    return 0;
 }
 
-int gb_nl_dump_action(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_dump_stats* stats, int timeout_ms) {
-    struct gb_nl_msg* resp = NULL;
+/* Send req with a fresh sequence number */
+static int dump_send(struct gb_nl_sock* sock, struct gb_nl_msg* req, uint32_t* seq_out) {
     struct nlmsghdr* nlh;
-    struct pollfd pfd;
-    uint32_t seq;
     ssize_t ret;
-    int len;
 
-    if (!sock || !sock->nl || !req || !stats)
+    if (req->len > req->cap)
         return -EINVAL;
 
-    memset(stats, 0, sizeof(*stats));
+    *seq_out = gb_nl_next_seq(sock);
+    nlh = (struct nlmsghdr*)req->buf;
+    nlh->nlmsg_seq = *seq_out;
 
-    if (req->len > req->cap)
-        return -EINVAL;
+    ret = nl_send(sock, req->buf, req->len);
+    return ret < 0 ? (int)ret : 0;
+}
 
-    resp = gb_nl_msg_alloc(1024u * 1024u);
-    if (!resp)
-        return -ENOMEM;
+/* Receive pages into the rx arena and walk each one before the next recv */
+static int dump_serial(struct gb_nl_sock* sock,
+                       uint32_t seq,
+                       const struct dump_visit* visit,
+                       struct gb_dump_stats* stats,
+                       int timeout_ms) {
+    uint64_t t0 = 0, t1 = 0;
+    ssize_t len;
+    int ret;
 
-    seq = gb_nl_next_seq(sock);
-    nlh = (struct nlmsghdr*)req->buf;
-    nlh->nlmsg_seq = seq;
+    for (;;) {
+        len = nl_recv_arena(sock, &sock->rx, timeout_ms);
+        if (len < 0)
+            return (int)len;
 
-    ret = mnl_socket_sendto(sock->nl, req->buf, req->len);
-    if (ret < 0) {
-        gb_nl_msg_free(resp);
-        return -errno;
+        if (visit->parse)
+            (void)gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        if (visit->start_ns != 0 && stats->first_page_ns == 0)
+            stats->first_page_ns = t0 - visit->start_ns;
+
+        ret = dump_walk_page(sock->rx.buf, (size_t)len, seq, visit, stats);
+
+        if (visit->parse) {
+            (void)gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW);
+            stats->parse_ns += t1 - t0;
+        }
+
+        if (ret != 0)
+            return ret < 0 ? ret : 0;
     }
+}
 
-    if ((size_t)ret != req->len) {
-        gb_nl_msg_free(resp);
-        return -EIO;
+/*
+ * Single-producer/single-consumer page ring. The receive thread owns head and
+ * fills slot head % GB_NL_DUMP_RING; the parsing thread owns tail. A slot is
+ * handed over by the release store of the index that covers it.
+ */
+struct dump_ring {
+    struct gb_nl_sock* sock;
+    uint32_t seq;
+    int timeout_ms;
+    uint64_t start_ns; /* Request send time */
+    uint64_t first_ns; /* First page received, written before head is first published */
+
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_bool done;  /* Receiver has published its last page (or failed) */
+    atomic_bool stop;  /* Parser gave up; receiver should exit */
+    int recv_err;      /* Receive error, read once done is seen */
+};
+
+/* True when buf holds the end of dump seq (DONE or a nonzero error) */
+static bool dump_page_is_last(const void* buf, size_t buf_len, uint32_t seq) {
+    const struct nlmsghdr* nlh = buf;
+    int len = (int)buf_len;
+
+    while (mnl_nlmsg_ok(nlh, len)) {
+        if (nlh->nlmsg_seq == seq) {
+            if (nlh->nlmsg_type == NLMSG_DONE)
+                return true;
+            if (nlh->nlmsg_type == NLMSG_ERROR && parse_error(nlh) != 0)
+                return true;
+        }
+        nlh = mnl_nlmsg_next(nlh, &len);
     }
 
-    pfd.fd = mnl_socket_get_fd(sock->nl);
-    pfd.events = POLLIN;
+    return false;
+}
+
+static void* dump_ring_recv_main(void* arg) {
+    struct dump_ring* ring = arg;
+    struct gb_nl_sock* sock = ring->sock;
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    struct gb_nl_msg* slot;
+    ssize_t len;
 
     for (;;) {
-        ret = poll(&pfd, 1, timeout_ms);
-        if (ret < 0) {
-            gb_nl_msg_free(resp);
-            return -errno;
-        }
-        if (ret == 0) {
-            gb_nl_msg_free(resp);
-            return -ETIMEDOUT;
+        while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) == GB_NL_DUMP_RING) {
+            if (atomic_load_explicit(&ring->stop, memory_order_relaxed))
+                goto out;
+            sched_yield();
         }
 
-        ret = mnl_socket_recvfrom(sock->nl, resp->buf, resp->cap);
-        if (ret < 0) {
-            gb_nl_msg_free(resp);
-            return -errno;
+        slot = &sock->dump_ring[head % GB_NL_DUMP_RING];
+        len = nl_recv_arena(sock, slot, ring->timeout_ms);
+        if (len < 0) {
+            ring->recv_err = (int)len;
+            goto out;
         }
 
-        resp->len = (size_t)ret;
-        len = (int)ret;
-        nlh = (struct nlmsghdr*)resp->buf;
+        if (head == 0 && ring->start_ns != 0 && gb_util_ns_now(&ring->first_ns, CLOCK_MONOTONIC_RAW) == 0)
+            ring->first_ns -= ring->start_ns;
 
-        while (mnl_nlmsg_ok(nlh, len)) {
-            if (nlh->nlmsg_seq != seq) {
-                nlh = mnl_nlmsg_next(nlh, &len);
-                continue;
-            }
+        head++;
+        atomic_store_explicit(&ring->head, head, memory_order_release);
 
-            if (nlh->nlmsg_type == NLMSG_ERROR) {
-                int err = parse_error(nlh);
-                if (err != 0) {
-                    stats->saw_error = true;
-                    stats->error_code = err;
-                    gb_nl_msg_free(resp);
-                    return 0;
-                }
-                nlh = mnl_nlmsg_next(nlh, &len);
-                continue;
-            }
+        if (dump_page_is_last(slot->buf, slot->len, ring->seq))
+            goto out;
+    }
 
-            if (nlh->nlmsg_type == NLMSG_DONE) {
-                stats->saw_done = true;
-                gb_nl_msg_free(resp);
-                return 0;
-            }
+out:
+    atomic_store_explicit(&ring->done, true, memory_order_release);
+    return NULL;
+}
 
-            if (nlh->nlmsg_type == RTM_GETACTION) {
-                const struct nlattr* tb[TCA_ROOT_MAX + 1] = {NULL};
+/* Parse pages here while a receive thread keeps the next ones coming */
+static int dump_pipelined(struct gb_nl_sock* sock,
+                          uint32_t seq,
+                          const struct dump_visit* visit,
+                          struct gb_dump_stats* stats,
+                          int timeout_ms) {
+    struct dump_ring ring;
+    pthread_t thread;
+    unsigned int tail = 0;
+    uint64_t t0, t1;
+    int ret;
 
-                if (mnl_attr_parse(nlh, sizeof(struct tcamsg), nl_attr_cb_copy, tb) == 0 && tb[TCA_ROOT_COUNT]) {
-                    stats->action_count += mnl_attr_get_u32(tb[TCA_ROOT_COUNT]);
-                }
+    memset(&ring, 0, sizeof(ring));
+    ring.sock = sock;
+    ring.seq = seq;
+    ring.timeout_ms = timeout_ms;
+    ring.start_ns = visit->start_ns;
+    atomic_init(&ring.head, 0u);
+    atomic_init(&ring.tail, 0u);
+    atomic_init(&ring.done, false);
+    atomic_init(&ring.stop, false);
+
+    ret = -pthread_create(&thread, NULL, dump_ring_recv_main, &ring);
+    if (ret < 0)
+        return ret;
+
+    for (;;) {
+        const struct gb_nl_msg* slot;
+
+        while (atomic_load_explicit(&ring.head, memory_order_acquire) == tail) {
+            /* head is published before done, so re-check it once done is seen */
+            if (atomic_load_explicit(&ring.done, memory_order_acquire) &&
+                atomic_load_explicit(&ring.head, memory_order_acquire) == tail) {
+                ret = ring.recv_err < 0 ? ring.recv_err : -EPROTO;
+                goto out;
             }
+            sched_yield();
+        }
 
-            stats->reply_msgs++;
-            if (nlh->nlmsg_len >= NLMSG_HDRLEN)
-                stats->payload_bytes += (uint64_t)(nlh->nlmsg_len - NLMSG_HDRLEN);
+        slot = &sock->dump_ring[tail % GB_NL_DUMP_RING];
 
-            nlh = mnl_nlmsg_next(nlh, &len);
+        (void)gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        ret = dump_walk_page(slot->buf, slot->len, seq, visit, stats);
+        (void)gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW);
+        stats->parse_ns += t1 - t0;
+
+        tail++;
+        atomic_store_explicit(&ring.tail, tail, memory_order_release);
+
+        if (ret != 0) {
+            if (ret > 0)
+                ret = 0;
+            goto out;
         }
     }
+
+out:
+    atomic_store_explicit(&ring.stop, true, memory_order_relaxed);
+    (void)pthread_join(thread, NULL);
+    stats->first_page_ns = ring.first_ns;
+    return ret;
+}
+
+int gb_nl_dump_action(struct gb_nl_sock* sock, struct gb_nl_msg* req, struct gb_dump_stats* stats, int timeout_ms) {
+    const struct dump_visit visit = {NULL, NULL, false, 0};
+    uint32_t seq;
+    int ret;
+
+    if (!sock || !nl_is_open(sock) || !req || !stats)
+        return -EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+
+    ret = dump_send(sock, req, &seq);
+    if (ret < 0)
+        return ret;
+
+    return dump_serial(sock, seq, &visit, stats, timeout_ms);
+}
+
+int gb_nl_dump_visit(struct gb_nl_sock* sock,
+                     struct gb_nl_msg* req,
+                     gb_gate_visit_fn fn,
+                     void* arg,
+                     bool pipelined,
+                     struct gb_dump_stats* stats,
+                     int timeout_ms) {
+    struct dump_visit visit = {fn, arg, true, 0};
+    uint64_t start, end;
+    uint32_t seq;
+    int ret;
+
+    if (!sock || !nl_is_open(sock) || !req || !stats)
+        return -EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+
+    ret = gb_util_ns_now(&start, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+    visit.start_ns = start;
+
+    ret = dump_send(sock, req, &seq);
+    if (ret < 0)
+        return ret;
+
+    if (pipelined)
+        ret = dump_pipelined(sock, seq, &visit, stats, timeout_ms);
+    else
+        ret = dump_serial(sock, seq, &visit, stats, timeout_ms);
+
+    if (gb_util_ns_now(&end, CLOCK_MONOTONIC_RAW) == 0)
+        stats->wall_ns = end - start;
+
+    return ret;
+}
+
+void gb_nl_set_backend(enum gb_nl_backend backend) {
+    nl_backend = backend;
+}
+
+enum gb_nl_backend gb_nl_get_backend(void) {
+    return nl_backend;
+}
+
+const char* gb_nl_backend_name(enum gb_nl_backend backend) {
+    switch (backend) {
+        case GB_NL_BACKEND_SYSCALL:
+            return "syscall";
+        case GB_NL_BACKEND_URING:
+            return "io_uring";
+        case GB_NL_BACKEND_LOOPBACK:
+            return "loopback";
+        default:
+            return "unknown";
+    }
+}
+
+int gb_nl_backend_parse(const char* name, enum gb_nl_backend* out) {
+    if (!name || !out)
+        return -EINVAL;
+
+    if (strcmp(name, "syscall") == 0)
+        *out = GB_NL_BACKEND_SYSCALL;
+    else if (strcmp(name, "io_uring") == 0 || strcmp(name, "uring") == 0)
+        *out = GB_NL_BACKEND_URING;
+    else if (strcmp(name, "loopback") == 0)
+        *out = GB_NL_BACKEND_LOOPBACK;
+    else
+        return -EINVAL;
+
+    return 0;
 }
 
 const char* gb_nl_strerror(int err) {
@@ -0,0 +1,69 @@
+/* src/nl_internal.h
+ * Internal declarations for the netlink transport backends.
+ */
+#ifndef GATEBENCH_NL_INTERNAL_H
+#define GATEBENCH_NL_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+/* io_uring transport bound to one netlink socket (src/nl_uring.c) */
+struct gb_nl_uring;
+
+int gb_nl_uring_open(int fd, struct gb_nl_uring** out);
+void gb_nl_uring_close(struct gb_nl_uring* ur);
+
+/*
+ * Queue a send of buf without entering the kernel. The bytes are copied into
+ * the registered tx buffer, so buf may be reused immediately. The send is
+ * linked ahead of the next receive and submitted with it; a send failure is
+ * reported by that receive (or by gb_nl_uring_flush).
+ */
+int gb_nl_uring_send(struct gb_nl_uring* ur, const void* buf, size_t len);
+
+/* Submit a sendmsg (together with any queued sends) and wait for it. */
+int gb_nl_uring_sendmsg(struct gb_nl_uring* ur, const struct msghdr* mh, size_t total);
+
+/* Submit queued sends and wait for their completions. */
+int gb_nl_uring_flush(struct gb_nl_uring* ur);
+
+/*
+ * Submit queued sends plus one receive guarded by a linked timeout, all in a
+ * single io_uring_enter. Returns the full datagram length (MSG_TRUNC semantics)
+ * or a negative errno. With MSG_PEEK in flags, buf may be NULL to size a read.
+ */
+ssize_t gb_nl_uring_recv(struct gb_nl_uring* ur, void* buf, size_t cap, int flags, int timeout_ms);
+
+/* In-process act_gate model behind an AF_UNIX pair (src/nl_loopback.c) */
+struct gb_nl_loopback;
+
+/*
+ * Create a SOCK_SEQPACKET pair and start a responder thread on the far end.
+ * *fd_out is the client end (owned by the caller) and *portid_out the fake
+ * port id stamped into replies. Sockets opened from different network
+ * namespaces see separate action tables, as with tc_action_net.
+ */
+int gb_nl_loopback_open(int* fd_out, uint32_t* portid_out, struct gb_nl_loopback** out);
+
+/* Subscribe to a multicast group; only RTNLGRP_TC carries events. */
+int gb_nl_loopback_join(struct gb_nl_loopback* lb, unsigned int group);
+
+/* Join the responder; the client end must already be closed. */
+void gb_nl_loopback_close(struct gb_nl_loopback* lb);
+
+/* Request capture (src/trace.c) */
+bool gb_trace_capturing(void);
+
+/* Append one request; returns the record offset to complete, or -errno */
+int64_t gb_trace_record_request(const void* buf, size_t len, uint32_t seq);
+
+/* Store the ack errno of the record at off */
+void gb_trace_record_result(int64_t off, int err);
+
+/* Account one heap allocation made on a netlink/message path (see gb_nl_alloc_count) */
+void gb_nl_count_alloc(void);
+
+#endif /* GATEBENCH_NL_INTERNAL_H */
@@ -0,0 +1,1417 @@
+/* src/nl_loopback.c
+ * Loopback netlink backend: an AF_UNIX SOCK_SEQPACKET pair whose far end is
+ * served in-process by a model of act_gate, so the client side of gatebench
+ * can run without CAP_NET_ADMIN or the act_gate module.
+ */
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_util.h"
+#include "nl_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <linux/gen_stats.h>
+#include <linux/netlink.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef NLM_F_CAPPED
+#define NLM_F_CAPPED 0x100
+#endif
+
+#ifndef NLM_F_ACK_TLVS
+#define NLM_F_ACK_TLVS 0x200
+#endif
+
+#ifndef NLMSGERR_ATTR_MSG
+#define NLMSGERR_ATTR_MSG 1
+#endif
+
+/* Dump page budget, matching the kernel's steady-state dump skb */
+#define LB_PAGE_SIZE (32u * 1024u - 512u)
+#define LB_BUF_SIZE (64u * 1024u)
+
+/* tcf_t ages are reported in clock_t ticks */
+#define LB_USER_HZ 100u
+
+/* Spin for the tail of a service time; sleep through anything longer */
+#define LB_SPIN_NS 200000ull
+
+/* One modelled gate action */
+struct lb_action {
+    uint32_t index;
+    int32_t control;
+    uint32_t clockid;
+    uint64_t base_time;
+    uint64_t cycle_time;
+    uint64_t cycle_time_ext;
+    uint32_t flags;
+    int32_t priority;
+    struct gate_entry* entries;
+    uint32_t num_entries;
+    uint64_t install_ns;
+    uint64_t lastuse_ns;
+};
+
+/* The gate actions of one network namespace (tc_action_net) */
+struct lb_table {
+    uint64_t netns; /* Inode of the namespace the sockets were opened in */
+    struct lb_action** actions; /* Sorted by index */
+    size_t count;
+    size_t cap;
+    struct lb_table* next;
+};
+
+/*
+ * act_gate state shared by every loopback socket in the process. The lock
+ * plays the role of rtnl_lock: requests from all sockets, in every
+ * namespace, are serialized and the service time is spent while holding it.
+ */
+static struct {
+    pthread_mutex_t lock;
+    struct lb_table* tables;
+    struct gb_nl_service service;
+    uint64_t rng;
+    struct gb_nl_loopback** listeners; /* Sockets joined to RTNLGRP_TC */
+    size_t listener_count;
+    size_t listener_cap;
+} lb_model = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .rng = 0x9e3779b97f4a7c15ull,
+};
+
+static atomic_uint lb_next_portid = 1;
+
+/* Model side of one client socket */
+struct gb_nl_loopback {
+    int fd;
+    uint32_t portid;
+    pthread_t thread;
+    bool tc_listener;
+    struct lb_table* table;
+
+    uint8_t* rx;
+    size_t rx_cap;
+    uint8_t* tx; /* Scratch for the reply being built */
+    size_t tx_cap;
+
+    /* Replies not yet accepted by the socket: [uint32 len][datagram]... */
+    uint8_t* out;
+    size_t out_head;
+    size_t out_len;
+    size_t out_cap;
+};
+
+/* A validated NEWACTION waiting to be committed */
+struct lb_staged {
+    struct lb_action* action;
+    bool replaces;
+};
+
+static int lb_reserve(uint8_t** buf, size_t* cap, size_t need) {
+    size_t new_cap;
+    uint8_t* p;
+
+    if (need <= *cap)
+        return 0;
+
+    new_cap = *cap ? *cap : LB_BUF_SIZE;
+    while (new_cap < need)
+        new_cap *= 2;
+
+    p = realloc(*buf, new_cap);
+    if (!p)
+        return -ENOMEM;
+
+    *buf = p;
+    *cap = new_cap;
+    return 0;
+}
+
+static void lb_action_free(struct lb_action* a) {
+    if (!a)
+        return;
+
+    free(a->entries);
+    free(a);
+}
+
+static uint64_t lb_now_ns(void) {
+    uint64_t now = 0;
+
+    (void)gb_util_ns_now(&now, CLOCK_MONOTONIC);
+    return now;
+}
+
+/* Binary search; returns the slot index and sets *found when the index exists */
+static size_t lb_find_pos(const struct lb_table* t, uint32_t index, bool* found) {
+    size_t lo = 0;
+    size_t hi = t->count;
+
+    *found = false;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2u;
+        uint32_t cur = t->actions[mid]->index;
+
+        if (cur == index) {
+            *found = true;
+            return mid;
+        }
+        if (cur < index)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static struct lb_action* lb_find(const struct lb_table* t, uint32_t index) {
+    bool found;
+    size_t pos = lb_find_pos(t, index, &found);
+
+    return found ? t->actions[pos] : NULL;
+}
+
+/*
+ * Lowest free index >= 1, as idr_alloc_u32 hands out for a zero index. The
+ * kernel reserves each index as it goes, so indices staged earlier in the
+ * same request count as taken.
+ */
+static uint32_t lb_alloc_index(const struct lb_table* t, const struct lb_staged* staged, size_t staged_count) {
+    uint32_t want = 1;
+    size_t i = 0;
+    bool bumped;
+
+    do {
+        bumped = false;
+        for (; i < t->count && t->actions[i]->index <= want; i++) {
+            if (t->actions[i]->index == want)
+                want++;
+        }
+        for (size_t s = 0; s < staged_count; s++) {
+            if (staged[s].action->index == want) {
+                want++;
+                bumped = true;
+                break;
+            }
+        }
+    } while (bumped);
+
+    return want;
+}
+
+static int lb_insert(struct lb_table* t, struct lb_action* a) {
+    bool found;
+    size_t pos;
+
+    pos = lb_find_pos(t, a->index, &found);
+    if (found) {
+        lb_action_free(t->actions[pos]);
+        t->actions[pos] = a;
+        return 0;
+    }
+
+    if (t->count == t->cap) {
+        size_t cap = t->cap ? t->cap * 2u : 64u;
+        struct lb_action** p = realloc(t->actions, cap * sizeof(*p));
+
+        if (!p)
+            return -ENOMEM;
+        t->actions = p;
+        t->cap = cap;
+    }
+
+    memmove(&t->actions[pos + 1u], &t->actions[pos], (t->count - pos) * sizeof(*t->actions));
+    t->actions[pos] = a;
+    t->count++;
+    return 0;
+}
+
+static void lb_remove(struct lb_table* t, uint32_t index) {
+    bool found;
+    size_t pos = lb_find_pos(t, index, &found);
+
+    if (!found)
+        return;
+
+    lb_action_free(t->actions[pos]);
+    memmove(&t->actions[pos], &t->actions[pos + 1u],
+            (t->count - pos - 1u) * sizeof(*t->actions));
+    t->count--;
+}
+
+/* xorshift64*, uniform in [0, 1) */
+static double lb_rand_unit(void) {
+    uint64_t x = lb_model.rng;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    lb_model.rng = x;
+    return (double)((x * 0x2545f4914f6cdd1dull) >> 11) / 9007199254740992.0;
+}
+
+static uint64_t lb_service_ns(void) {
+    const struct gb_nl_service* svc = &lb_model.service;
+
+    switch (svc->dist) {
+        case GB_NL_SERVICE_FIXED:
+            return svc->a_ns;
+        case GB_NL_SERVICE_UNIFORM:
+            return svc->a_ns + (uint64_t)(lb_rand_unit() * (double)(svc->b_ns - svc->a_ns));
+        case GB_NL_SERVICE_EXP:
+            return (uint64_t)(-log(1.0 - lb_rand_unit()) * (double)svc->a_ns);
+        case GB_NL_SERVICE_NONE:
+        default:
+            return 0;
+    }
+}
+
+/* Burn the configured service time for one request (model lock held) */
+static void lb_service_wait(void) {
+    uint64_t ns = lb_service_ns();
+    uint64_t start, now;
+
+    if (ns == 0)
+        return;
+
+    start = lb_now_ns();
+    if (ns > LB_SPIN_NS) {
+        uint64_t sleep_ns = ns - LB_SPIN_NS;
+        struct timespec ts = {
+            .tv_sec = (time_t)(sleep_ns / 1000000000ull),
+            .tv_nsec = (long)(sleep_ns % 1000000000ull),
+        };
+
+        (void)nanosleep(&ts, NULL);
+    }
+
+    do {
+        now = lb_now_ns();
+    } while (now - start < ns);
+}
+
+/* Append one datagram to the outgoing queue */
+static int lb_queue(struct gb_nl_loopback* lb, const void* buf, size_t len) {
+    uint32_t len32 = (uint32_t)len;
+    int ret;
+
+    if (lb->out_head > 0 && lb->out_head == lb->out_len) {
+        lb->out_head = 0;
+        lb->out_len = 0;
+    }
+
+    ret = lb_reserve(&lb->out, &lb->out_cap, lb->out_len + sizeof(len32) + len);
+    if (ret < 0)
+        return ret;
+
+    memcpy(lb->out + lb->out_len, &len32, sizeof(len32));
+    memcpy(lb->out + lb->out_len + sizeof(len32), buf, len);
+    lb->out_len += sizeof(len32) + len;
+    return 0;
+}
+
+/* Push queued replies until the socket would block */
+static int lb_flush(struct gb_nl_loopback* lb) {
+    while (lb->out_head < lb->out_len) {
+        uint32_t len;
+        ssize_t ret;
+
+        memcpy(&len, lb->out + lb->out_head, sizeof(len));
+        ret = send(lb->fd, lb->out + lb->out_head + sizeof(len), len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EAGAIN)
+                return 0;
+            return -errno;
+        }
+
+        lb->out_head += sizeof(len) + len;
+    }
+
+    lb->out_head = 0;
+    lb->out_len = 0;
+    return 0;
+}
+
+static void lb_ack(struct gb_nl_loopback* lb, const struct nlmsghdr* req, int err, const char* extack) {
+    struct nlmsghdr* nlh;
+    struct nlmsgerr* e;
+    size_t need = NLMSG_HDRLEN + NLMSG_ALIGN(sizeof(*e)) + 256u;
+
+    if (lb_reserve(&lb->tx, &lb->tx_cap, need) < 0)
+        return;
+
+    nlh = mnl_nlmsg_put_header(lb->tx);
+    nlh->nlmsg_type = NLMSG_ERROR;
+    nlh->nlmsg_flags = NLM_F_CAPPED;
+    nlh->nlmsg_seq = req->nlmsg_seq;
+    nlh->nlmsg_pid = lb->portid;
+
+    e = mnl_nlmsg_put_extra_header(nlh, sizeof(*e));
+    e->error = err;
+    e->msg = *req;
+
+    if (err != 0 && extack) {
+        nlh->nlmsg_flags |= NLM_F_ACK_TLVS;
+        mnl_attr_put_strz(nlh, NLMSGERR_ATTR_MSG, extack);
+    }
+
+    (void)lb_queue(lb, lb->tx, nlh->nlmsg_len);
+}
+
+/* Upper bound on the encoded size of one action */
+static size_t lb_action_size(const struct lb_action* a) {
+    return 384u + (size_t)a->num_entries * 64u;
+}
+
+static uint64_t lb_ticks_since(uint64_t then_ns, uint64_t now_ns) {
+    if (then_ns == 0 || now_ns < then_ns)
+        return 0;
+
+    return (now_ns - then_ns) / (1000000000ull / LB_USER_HZ);
+}
+
+static void lb_put_action(struct nlmsghdr* nlh, const struct lb_action* a, uint16_t prio, bool terse, uint64_t now) {
+    struct nlattr* nest = mnl_attr_nest_start(nlh, prio);
+    struct nlattr* stats;
+    struct gnet_stats_basic basic;
+    struct gnet_stats_queue queue;
+
+    mnl_attr_put_strz(nlh, TCA_ACT_KIND, "gate");
+    mnl_attr_put_u32(nlh, TCA_ACT_INDEX, a->index);
+
+    memset(&basic, 0, sizeof(basic));
+    memset(&queue, 0, sizeof(queue));
+    stats = mnl_attr_nest_start(nlh, TCA_ACT_STATS);
+    mnl_attr_put(nlh, TCA_STATS_BASIC, sizeof(basic), &basic);
+    mnl_attr_put(nlh, TCA_STATS_QUEUE, sizeof(queue), &queue);
+    mnl_attr_nest_end(nlh, stats);
+
+    if (!terse) {
+        struct nlattr* opts = mnl_attr_nest_start(nlh, TCA_ACT_OPTIONS);
+        struct nlattr* list;
+        struct tc_gate parms;
+        struct tcf_t tm;
+
+        memset(&parms, 0, sizeof(parms));
+        parms.index = a->index;
+        parms.action = a->control;
+        parms.refcnt = 1;
+        mnl_attr_put(nlh, TCA_GATE_PARMS, sizeof(parms), &parms);
+        mnl_attr_put(nlh, TCA_GATE_PRIORITY, sizeof(a->priority), &a->priority);
+
+        list = mnl_attr_nest_start(nlh, TCA_GATE_ENTRY_LIST);
+        for (uint32_t i = 0; i < a->num_entries; i++) {
+            const struct gate_entry* e = &a->entries[i];
+            struct nlattr* one = mnl_attr_nest_start(nlh, TCA_GATE_ONE_ENTRY);
+
+            mnl_attr_put_u32(nlh, TCA_GATE_ENTRY_INDEX, i);
+            if (e->gate_state)
+                mnl_attr_put(nlh, TCA_GATE_ENTRY_GATE, 0, NULL);
+            mnl_attr_put_u32(nlh, TCA_GATE_ENTRY_INTERVAL, e->interval);
+            mnl_attr_put(nlh, TCA_GATE_ENTRY_IPV, sizeof(e->ipv), &e->ipv);
+            mnl_attr_put(nlh, TCA_GATE_ENTRY_MAX_OCTETS, sizeof(e->maxoctets), &e->maxoctets);
+            mnl_attr_nest_end(nlh, one);
+        }
+        mnl_attr_nest_end(nlh, list);
+
+        mnl_attr_put_u64(nlh, TCA_GATE_BASE_TIME, a->base_time);
+        mnl_attr_put_u64(nlh, TCA_GATE_CYCLE_TIME, a->cycle_time);
+        mnl_attr_put_u64(nlh, TCA_GATE_CYCLE_TIME_EXT, a->cycle_time_ext);
+        mnl_attr_put_u32(nlh, TCA_GATE_CLOCKID, a->clockid);
+        mnl_attr_put_u32(nlh, TCA_GATE_FLAGS, a->flags);
+
+        memset(&tm, 0, sizeof(tm));
+        tm.install = lb_ticks_since(a->install_ns, now);
+        tm.lastuse = lb_ticks_since(a->lastuse_ns, now);
+        mnl_attr_put(nlh, TCA_GATE_TM, sizeof(tm), &tm);
+
+        mnl_attr_nest_end(nlh, opts);
+    }
+
+    mnl_attr_nest_end(nlh, nest);
+}
+
+/* Build an RTM_*ACTION message carrying actions[0..count) into lb->tx; *out is its header */
+static int lb_fill_actions(struct gb_nl_loopback* lb,
+                           const struct nlmsghdr* req,
+                           uint16_t type,
+                           struct lb_action* const* actions,
+                           size_t count,
+                           struct nlmsghdr** out) {
+    struct nlmsghdr* nlh;
+    struct tcamsg* tca;
+    struct nlattr* tab;
+    size_t need = 256u;
+    uint64_t now = lb_now_ns();
+    int ret;
+
+    for (size_t i = 0; i < count; i++)
+        need += lb_action_size(actions[i]);
+
+    ret = lb_reserve(&lb->tx, &lb->tx_cap, need);
+    if (ret < 0)
+        return ret;
+
+    nlh = mnl_nlmsg_put_header(lb->tx);
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_seq = req->nlmsg_seq;
+    nlh->nlmsg_pid = lb->portid;
+
+    tca = mnl_nlmsg_put_extra_header(nlh, sizeof(*tca));
+    memset(tca, 0, sizeof(*tca));
+    tca->tca_family = AF_UNSPEC;
+
+    tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
+    for (size_t i = 0; i < count; i++)
+        lb_put_action(nlh, actions[i], (uint16_t)(i + 1u), false, now);
+    mnl_attr_nest_end(nlh, tab);
+
+    *out = nlh;
+    return 0;
+}
+
+static int lb_reply_actions(struct gb_nl_loopback* lb,
+                            const struct nlmsghdr* req,
+                            uint16_t type,
+                            struct lb_action* const* actions,
+                            size_t count) {
+    struct nlmsghdr* nlh;
+    int ret;
+
+    ret = lb_fill_actions(lb, req, type, actions, count, &nlh);
+    if (ret < 0)
+        return ret;
+
+    return lb_queue(lb, lb->tx, nlh->nlmsg_len);
+}
+
+/*
+ * Multicast a change notification to every RTNLGRP_TC listener in the
+ * namespace; caller holds lb_model.lock. Like a netlink broadcast it never
+ * blocks the requester: a listener whose receive queue is full loses the
+ * message.
+ */
+static void lb_notify(const struct lb_table* t, const struct nlmsghdr* nlh) {
+    for (size_t i = 0; i < lb_model.listener_count; i++) {
+        const struct gb_nl_loopback* l = lb_model.listeners[i];
+
+        if (l->table == t)
+            (void)send(l->fd, nlh, nlh->nlmsg_len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+}
+
+/* Notify listeners and, for NLM_F_ECHO, the requester about a change */
+static int lb_report_change(struct gb_nl_loopback* lb,
+                            const struct nlmsghdr* req,
+                            uint16_t type,
+                            struct lb_action* const* actions,
+                            size_t count) {
+    struct nlmsghdr* nlh;
+    int ret;
+
+    if (lb_model.listener_count == 0 && !(req->nlmsg_flags & NLM_F_ECHO))
+        return 0;
+
+    ret = lb_fill_actions(lb, req, type, actions, count, &nlh);
+    if (ret < 0)
+        return ret;
+
+    lb_notify(lb->table, nlh);
+
+    if (req->nlmsg_flags & NLM_F_ECHO)
+        return lb_queue(lb, lb->tx, nlh->nlmsg_len);
+    return 0;
+}
+
+/* Strict-policy helpers: fixed-size attributes must match exactly */
+static bool lb_attr_len_is(const struct nlattr* attr, size_t len) {
+    return mnl_attr_get_payload_len(attr) == len;
+}
+
+struct lb_attr_ctx {
+    const struct nlattr** tb;
+    uint16_t max_type;
+    bool over_max; /* An attribute type beyond max_type was seen */
+};
+
+static int lb_attr_cb(const struct nlattr* attr, void* data) {
+    struct lb_attr_ctx* ctx = data;
+    uint16_t type = mnl_attr_get_type(attr);
+
+    if (type > ctx->max_type) {
+        ctx->over_max = true;
+        return MNL_CB_OK;
+    }
+
+    ctx->tb[type] = attr;
+    return MNL_CB_OK;
+}
+
+static int lb_parse_nested(const struct nlattr* nest, const struct nlattr** tb, uint16_t max_type, bool* over_max) {
+    struct lb_attr_ctx ctx = {
+        .tb = tb,
+        .max_type = max_type,
+        .over_max = false,
+    };
+
+    if (mnl_attr_parse_nested(nest, lb_attr_cb, &ctx) < 0)
+        return -EINVAL;
+
+    if (over_max)
+        *over_max = ctx.over_max;
+    return 0;
+}
+
+/* TCA_ACT_TAB of a tc action request, or NULL */
+static const struct nlattr* lb_act_tab(const struct nlmsghdr* nlh, const struct nlattr** root, uint16_t root_max) {
+    struct lb_attr_ctx ctx = {
+        .tb = root,
+        .max_type = root_max,
+        .over_max = false,
+    };
+
+    if (nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct tcamsg)))
+        return NULL;
+
+    if (mnl_attr_parse(nlh, sizeof(struct tcamsg), lb_attr_cb, &ctx) < 0)
+        return NULL;
+
+    return root[TCA_ACT_TAB];
+}
+
+/* Step to the next attribute of a nest, tracking the bytes left in *rem */
+static const struct nlattr* lb_attr_next(const struct nlattr* attr, int* rem) {
+    const struct nlattr* next = mnl_attr_next(attr);
+
+    *rem -= (int)((const char*)next - (const char*)attr);
+    return next;
+}
+
+static bool lb_clockid_valid(int32_t clockid) {
+    return clockid == CLOCK_REALTIME || clockid == CLOCK_MONOTONIC || clockid == CLOCK_BOOTTIME ||
+           clockid == CLOCK_TAI;
+}
+
+static bool lb_control_valid(int32_t action) {
+    if (action >= TC_ACT_UNSPEC && action <= TC_ACT_TRAP)
+        return true;
+
+    return TC_ACT_EXT_CMP(action, TC_ACT_JUMP);
+}
+
+static int lb_parse_entries(const struct nlattr* list, struct gate_entry** out, uint32_t* count, const char** extack) {
+    const struct nlattr* attr;
+    int rem;
+    struct gate_entry* entries = NULL;
+    uint32_t n = 0;
+    uint32_t cap = 0;
+    int ret = 0;
+
+    for (attr = mnl_attr_get_payload(list), rem = (int)mnl_attr_get_payload_len(list); mnl_attr_ok(attr, rem);
+         attr = lb_attr_next(attr, &rem)) {
+        const struct nlattr* tb[TCA_GATE_ENTRY_MAX + 1] = {NULL};
+        struct gate_entry* e;
+        bool over_max = false;
+
+        /* Non-entry attributes in the list are skipped, as act_gate does */
+        if (mnl_attr_get_type(attr) != TCA_GATE_ONE_ENTRY)
+            continue;
+
+        if (lb_parse_nested(attr, tb, TCA_GATE_ENTRY_MAX, &over_max) < 0 || over_max || tb[TCA_GATE_ENTRY_UNSPEC]) {
+            *extack = "Unknown attribute type";
+            ret = -EINVAL;
+            goto out;
+        }
+
+        if ((tb[TCA_GATE_ENTRY_INDEX] && !lb_attr_len_is(tb[TCA_GATE_ENTRY_INDEX], sizeof(uint32_t))) ||
+            (tb[TCA_GATE_ENTRY_GATE] && !lb_attr_len_is(tb[TCA_GATE_ENTRY_GATE], 0)) ||
+            (tb[TCA_GATE_ENTRY_INTERVAL] && !lb_attr_len_is(tb[TCA_GATE_ENTRY_INTERVAL], sizeof(uint32_t))) ||
+            (tb[TCA_GATE_ENTRY_IPV] && !lb_attr_len_is(tb[TCA_GATE_ENTRY_IPV], sizeof(int32_t))) ||
+            (tb[TCA_GATE_ENTRY_MAX_OCTETS] && !lb_attr_len_is(tb[TCA_GATE_ENTRY_MAX_OCTETS], sizeof(int32_t)))) {
+            ret = -EINVAL;
+            goto out;
+        }
+
+        if (!tb[TCA_GATE_ENTRY_INTERVAL] || mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INTERVAL]) == 0) {
+            *extack = "Invalid interval for schedule entry";
+            ret = -EINVAL;
+            goto out;
+        }
+
+        if (n == cap) {
+            uint32_t new_cap = cap ? cap * 2u : 8u;
+            struct gate_entry* p = realloc(entries, (size_t)new_cap * sizeof(*p));
+
+            if (!p) {
+                ret = -ENOMEM;
+                goto out;
+            }
+            entries = p;
+            cap = new_cap;
+        }
+
+        e = &entries[n];
+        memset(e, 0, sizeof(*e));
+        e->index = n;
+        e->gate_state = tb[TCA_GATE_ENTRY_GATE] != NULL;
+        e->interval = mnl_attr_get_u32(tb[TCA_GATE_ENTRY_INTERVAL]);
+        e->ipv = tb[TCA_GATE_ENTRY_IPV] ? (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_IPV]) : -1;
+        e->maxoctets = tb[TCA_GATE_ENTRY_MAX_OCTETS] ? (int32_t)mnl_attr_get_u32(tb[TCA_GATE_ENTRY_MAX_OCTETS]) : -1;
+        n++;
+    }
+
+out:
+    if (ret < 0) {
+        free(entries);
+        return ret;
+    }
+
+    *out = entries;
+    *count = n;
+    return 0;
+}
+
+/*
+ * Validate one action of a NEWACTION request into a fresh lb_action
+ * (tcf_gate_init); staged[0..staged_count) are the request's earlier actions.
+ */
+static int lb_gate_init(const struct lb_table* t,
+                        const struct lb_staged* staged,
+                        size_t staged_count,
+                        const struct nlattr* act,
+                        uint16_t nlmsg_flags,
+                        struct lb_staged* out,
+                        const char** extack) {
+    const struct nlattr* atb[TCA_ACT_MAX + 1] = {NULL};
+    const struct nlattr* tb[TCA_GATE_MAX + 1] = {NULL};
+    const struct tc_gate* parms;
+    const struct lb_action* old;
+    struct lb_action* a;
+    bool over_max = false;
+    uint32_t index;
+    int ret;
+
+    if (lb_parse_nested(act, atb, TCA_ACT_MAX - 1, NULL) < 0)
+        return -EINVAL;
+
+    if (!atb[TCA_ACT_KIND]) {
+        *extack = "TC action kind must be specified";
+        return -EINVAL;
+    }
+    if (strcmp(mnl_attr_get_str(atb[TCA_ACT_KIND]), "gate") != 0) {
+        *extack = "Failed to load TC action module";
+        return -ENOENT;
+    }
+    if (!atb[TCA_ACT_OPTIONS])
+        return -EINVAL;
+
+    if (lb_parse_nested(atb[TCA_ACT_OPTIONS], tb, TCA_GATE_MAX, &over_max) < 0 || over_max || tb[TCA_GATE_UNSPEC]) {
+        *extack = "Unknown attribute type";
+        return -EINVAL;
+    }
+
+    /* Output-only attributes have no policy entry, so strict parsing rejects them */
+    if (tb[TCA_GATE_TM] || tb[TCA_GATE_PAD]) {
+        *extack = "Unsupported attribute";
+        return -EINVAL;
+    }
+
+    if ((tb[TCA_GATE_PARMS] && !lb_attr_len_is(tb[TCA_GATE_PARMS], sizeof(struct tc_gate))) ||
+        (tb[TCA_GATE_PRIORITY] && !lb_attr_len_is(tb[TCA_GATE_PRIORITY], sizeof(int32_t))) ||
+        (tb[TCA_GATE_BASE_TIME] && !lb_attr_len_is(tb[TCA_GATE_BASE_TIME], sizeof(uint64_t))) ||
+        (tb[TCA_GATE_CYCLE_TIME] && !lb_attr_len_is(tb[TCA_GATE_CYCLE_TIME], sizeof(uint64_t))) ||
+        (tb[TCA_GATE_CYCLE_TIME_EXT] && !lb_attr_len_is(tb[TCA_GATE_CYCLE_TIME_EXT], sizeof(uint64_t))) ||
+        (tb[TCA_GATE_FLAGS] && !lb_attr_len_is(tb[TCA_GATE_FLAGS], sizeof(uint32_t))) ||
+        (tb[TCA_GATE_CLOCKID] && !lb_attr_len_is(tb[TCA_GATE_CLOCKID], sizeof(int32_t))))
+        return -EINVAL;
+
+    if (!tb[TCA_GATE_PARMS])
+        return -EINVAL;
+
+    if (tb[TCA_GATE_CLOCKID] && !lb_clockid_valid((int32_t)mnl_attr_get_u32(tb[TCA_GATE_CLOCKID]))) {
+        *extack = "Invalid 'clockid'";
+        return -EINVAL;
+    }
+
+    parms = mnl_attr_get_payload(tb[TCA_GATE_PARMS]);
+    index = parms->index ? parms->index : lb_alloc_index(t, staged, staged_count);
+    old = lb_find(t, index);
+    if (old && !(nlmsg_flags & NLM_F_REPLACE))
+        return -EEXIST;
+
+    if (!lb_control_valid(parms->action)) {
+        *extack = "Invalid control action";
+        return -EINVAL;
+    }
+
+    a = calloc(1, sizeof(*a));
+    if (!a)
+        return -ENOMEM;
+
+    if (old) {
+        *a = *old;
+        a->entries = NULL;
+        a->num_entries = 0;
+    }
+    else {
+        a->clockid = CLOCK_TAI;
+        a->priority = -1;
+        a->install_ns = lb_now_ns();
+        a->lastuse_ns = a->install_ns;
+    }
+    a->index = index;
+    a->control = parms->action;
+
+    if (tb[TCA_GATE_CLOCKID])
+        a->clockid = mnl_attr_get_u32(tb[TCA_GATE_CLOCKID]);
+    if (tb[TCA_GATE_PRIORITY])
+        a->priority = (int32_t)mnl_attr_get_u32(tb[TCA_GATE_PRIORITY]);
+    if (tb[TCA_GATE_BASE_TIME])
+        a->base_time = mnl_attr_get_u64(tb[TCA_GATE_BASE_TIME]);
+    if (tb[TCA_GATE_CYCLE_TIME_EXT])
+        a->cycle_time_ext = mnl_attr_get_u64(tb[TCA_GATE_CYCLE_TIME_EXT]);
+    if (tb[TCA_GATE_FLAGS])
+        a->flags = mnl_attr_get_u32(tb[TCA_GATE_FLAGS]);
+
+    if (tb[TCA_GATE_ENTRY_LIST]) {
+        ret = lb_parse_entries(tb[TCA_GATE_ENTRY_LIST], &a->entries, &a->num_entries, extack);
+        if (ret < 0)
+            goto err;
+    }
+    else if (old && old->num_entries > 0) {
+        a->entries = malloc((size_t)old->num_entries * sizeof(*a->entries));
+        if (!a->entries) {
+            ret = -ENOMEM;
+            goto err;
+        }
+        memcpy(a->entries, old->entries, (size_t)old->num_entries * sizeof(*a->entries));
+        a->num_entries = old->num_entries;
+    }
+
+    if (a->num_entries == 0) {
+        *extack = "The entry list is empty";
+        ret = -EINVAL;
+        goto err;
+    }
+
+    /* An explicit cycle time wins; new entries re-derive it; otherwise keep */
+    if (tb[TCA_GATE_CYCLE_TIME])
+        a->cycle_time = mnl_attr_get_u64(tb[TCA_GATE_CYCLE_TIME]);
+    else if (!old || tb[TCA_GATE_ENTRY_LIST])
+        a->cycle_time = 0;
+
+    if (a->cycle_time == 0) {
+        for (uint32_t i = 0; i < a->num_entries; i++)
+            a->cycle_time += a->entries[i].interval;
+    }
+
+    out->action = a;
+    out->replaces = old != NULL;
+    return 0;
+
+err:
+    lb_action_free(a);
+    return ret;
+}
+
+static int lb_new_action(struct gb_nl_loopback* lb, const struct nlmsghdr* nlh, const char** extack) {
+    const struct nlattr* root[TCA_ROOT_MAX + 1] = {NULL};
+    const struct nlattr* tab = lb_act_tab(nlh, root, TCA_ROOT_MAX);
+    const struct nlattr* act;
+    int rem;
+    struct lb_staged staged[TCA_ACT_MAX_PRIO];
+    struct lb_action* echo[TCA_ACT_MAX_PRIO];
+    size_t n = 0;
+    int ret = 0;
+
+    if (!tab)
+        return -EINVAL;
+
+    for (act = mnl_attr_get_payload(tab), rem = (int)mnl_attr_get_payload_len(tab); mnl_attr_ok(act, rem);
+         act = lb_attr_next(act, &rem)) {
+        if (mnl_attr_get_type(act) == 0 || mnl_attr_get_type(act) > TCA_ACT_MAX_PRIO)
+            continue;
+        if (n == TCA_ACT_MAX_PRIO)
+            break;
+
+        ret = lb_gate_init(lb->table, staged, n, act, nlh->nlmsg_flags, &staged[n], extack);
+        if (ret < 0)
+            goto out;
+        n++;
+    }
+
+    if (n == 0)
+        return -EINVAL;
+
+    /* Every action validated: commit them together */
+    for (size_t i = 0; i < n; i++) {
+        ret = lb_insert(lb->table, staged[i].action);
+        if (ret < 0)
+            goto out;
+        echo[i] = staged[i].action;
+        staged[i].action = NULL;
+    }
+
+    ret = lb_report_change(lb, nlh, RTM_NEWACTION, echo, n);
+
+out:
+    for (size_t i = 0; i < n; i++)
+        lb_action_free(staged[i].action);
+    return ret;
+}
+
+/* Resolve the KIND/INDEX pairs of a GET or DEL request */
+static int lb_lookup_actions(const struct lb_table* t,
+                             const struct nlattr* tab, struct lb_action** found, size_t* count, const char** extack) {
+    const struct nlattr* act;
+    int rem;
+    size_t n = 0;
+
+    for (act = mnl_attr_get_payload(tab), rem = (int)mnl_attr_get_payload_len(tab); mnl_attr_ok(act, rem);
+         act = lb_attr_next(act, &rem)) {
+        const struct nlattr* atb[TCA_ACT_MAX + 1] = {NULL};
+        struct lb_action* a;
+
+        if (mnl_attr_get_type(act) == 0 || mnl_attr_get_type(act) > TCA_ACT_MAX_PRIO)
+            continue;
+        if (n == TCA_ACT_MAX_PRIO)
+            break;
+
+        if (lb_parse_nested(act, atb, TCA_ACT_MAX - 1, NULL) < 0)
+            return -EINVAL;
+
+        if (!atb[TCA_ACT_INDEX] || !lb_attr_len_is(atb[TCA_ACT_INDEX], sizeof(uint32_t)))
+            return -EINVAL;
+
+        if (!atb[TCA_ACT_KIND] || strcmp(mnl_attr_get_str(atb[TCA_ACT_KIND]), "gate") != 0) {
+            *extack = "Specified TC action kind not found";
+            return -EINVAL;
+        }
+
+        a = lb_find(t, mnl_attr_get_u32(atb[TCA_ACT_INDEX]));
+        if (!a) {
+            *extack = "Specified TC action not found";
+            return -ENOENT;
+        }
+
+        found[n++] = a;
+    }
+
+    if (n == 0)
+        return -EINVAL;
+
+    *count = n;
+    return 0;
+}
+
+static int lb_get_action(struct gb_nl_loopback* lb, const struct nlmsghdr* nlh, const char** extack) {
+    const struct nlattr* root[TCA_ROOT_MAX + 1] = {NULL};
+    const struct nlattr* tab = lb_act_tab(nlh, root, TCA_ROOT_MAX);
+    struct lb_action* found[TCA_ACT_MAX_PRIO];
+    size_t n = 0;
+    int ret;
+
+    if (!tab)
+        return -EINVAL;
+
+    ret = lb_lookup_actions(lb->table, tab, found, &n, extack);
+    if (ret < 0)
+        return ret;
+
+    return lb_reply_actions(lb, nlh, RTM_GETACTION, found, n);
+}
+
+/* RTM_DELACTION | NLM_F_ROOT: remove every gate action */
+static int lb_flush_actions(struct gb_nl_loopback* lb, const struct nlmsghdr* nlh) {
+    struct nlmsghdr* reply;
+    struct tcamsg* tca;
+    struct nlattr *tab, *nest;
+    struct lb_table* t = lb->table;
+    uint32_t flushed = (uint32_t)t->count;
+    int ret;
+
+    for (size_t i = 0; i < t->count; i++)
+        lb_action_free(t->actions[i]);
+    t->count = 0;
+
+    if (lb_model.listener_count == 0 && !(nlh->nlmsg_flags & NLM_F_ECHO))
+        return 0;
+
+    ret = lb_reserve(&lb->tx, &lb->tx_cap, 256u);
+    if (ret < 0)
+        return ret;
+
+    reply = mnl_nlmsg_put_header(lb->tx);
+    reply->nlmsg_type = RTM_DELACTION;
+    reply->nlmsg_seq = nlh->nlmsg_seq;
+    reply->nlmsg_pid = lb->portid;
+    tca = mnl_nlmsg_put_extra_header(reply, sizeof(*tca));
+    memset(tca, 0, sizeof(*tca));
+    tca->tca_family = AF_UNSPEC;
+
+    tab = mnl_attr_nest_start(reply, TCA_ACT_TAB);
+    nest = mnl_attr_nest_start(reply, 0);
+    mnl_attr_put_strz(reply, TCA_ACT_KIND, "gate");
+    mnl_attr_put_u32(reply, TCA_FCNT, flushed);
+    mnl_attr_nest_end(reply, nest);
+    mnl_attr_nest_end(reply, tab);
+
+    lb_notify(lb->table, reply);
+
+    if (!(nlh->nlmsg_flags & NLM_F_ECHO))
+        return 0;
+    return lb_queue(lb, lb->tx, reply->nlmsg_len);
+}
+
+static int lb_del_action(struct gb_nl_loopback* lb, const struct nlmsghdr* nlh, const char** extack) {
+    const struct nlattr* root[TCA_ROOT_MAX + 1] = {NULL};
+    const struct nlattr* tab = lb_act_tab(nlh, root, TCA_ROOT_MAX);
+    struct lb_action* found[TCA_ACT_MAX_PRIO];
+    uint32_t indexes[TCA_ACT_MAX_PRIO];
+    size_t n = 0;
+    int ret;
+
+    if (!tab)
+        return -EINVAL;
+
+    if (nlh->nlmsg_flags & NLM_F_ROOT)
+        return lb_flush_actions(lb, nlh);
+
+    ret = lb_lookup_actions(lb->table, tab, found, &n, extack);
+    if (ret < 0)
+        return ret;
+
+    /* The notification describes the actions, so it is built before they go */
+    ret = lb_report_change(lb, nlh, RTM_DELACTION, found, n);
+    if (ret < 0)
+        return ret;
+
+    for (size_t i = 0; i < n; i++)
+        indexes[i] = found[i]->index;
+    for (size_t i = 0; i < n; i++)
+        lb_remove(lb->table, indexes[i]);
+
+    return 0;
+}
+
+/* Start a dump page; returns its header plus the TCA_ACT_TAB nest and count slot */
+static struct nlmsghdr* lb_page_start(struct gb_nl_loopback* lb,
+                                      const struct nlmsghdr* req,
+                                      struct nlattr** tab,
+                                      uint32_t** count) {
+    struct nlmsghdr* nlh;
+    struct tcamsg* tca;
+    struct nlattr* attr;
+
+    nlh = mnl_nlmsg_put_header(lb->tx);
+    nlh->nlmsg_type = RTM_GETACTION;
+    nlh->nlmsg_flags = NLM_F_MULTI;
+    nlh->nlmsg_seq = req->nlmsg_seq;
+    nlh->nlmsg_pid = lb->portid;
+
+    tca = mnl_nlmsg_put_extra_header(nlh, sizeof(*tca));
+    memset(tca, 0, sizeof(*tca));
+    tca->tca_family = AF_UNSPEC;
+
+    attr = mnl_nlmsg_get_payload_tail(nlh);
+    mnl_attr_put_u32(nlh, TCA_ROOT_COUNT, 0);
+    *count = mnl_attr_get_payload(attr);
+
+    *tab = mnl_attr_nest_start(nlh, TCA_ACT_TAB);
+    return nlh;
+}
+
+/* RTM_GETACTION | NLM_F_DUMP: queue every page plus NLMSG_DONE */
+static int lb_dump_actions(struct gb_nl_loopback* lb, const struct nlmsghdr* req) {
+    const struct nlattr* root[TCA_ROOT_MAX + 1] = {NULL};
+    const struct nlattr* tab = lb_act_tab(req, root, TCA_ROOT_MAX);
+    const struct lb_table* t = lb->table;
+    struct nlmsghdr* nlh;
+    uint32_t root_flags = 0;
+    uint64_t since_ns = 0;
+    uint64_t now = lb_now_ns();
+    bool gate_kind = false;
+    size_t pos = 0;
+    int ret;
+
+    if (tab) {
+        const struct nlattr* first = mnl_attr_get_payload(tab);
+        const struct nlattr* atb[TCA_ACT_MAX + 1] = {NULL};
+
+        if (mnl_attr_ok(first, (int)mnl_attr_get_payload_len(tab)) &&
+            lb_parse_nested(first, atb, TCA_ACT_MAX - 1, NULL) == 0 && atb[TCA_ACT_KIND])
+            gate_kind = strcmp(mnl_attr_get_str(atb[TCA_ACT_KIND]), "gate") == 0;
+    }
+
+    if (root[TCA_ROOT_FLAGS] && lb_attr_len_is(root[TCA_ROOT_FLAGS], sizeof(struct nla_bitfield32))) {
+        const struct nla_bitfield32* bf = mnl_attr_get_payload(root[TCA_ROOT_FLAGS]);
+
+        root_flags = bf->value & bf->selector;
+    }
+
+    if (root[TCA_ROOT_TIME_DELTA] && lb_attr_len_is(root[TCA_ROOT_TIME_DELTA], sizeof(uint32_t))) {
+        uint64_t delta_ns = (uint64_t)mnl_attr_get_u32(root[TCA_ROOT_TIME_DELTA]) * 1000000ull;
+
+        since_ns = delta_ns < now ? now - delta_ns : 0;
+    }
+
+    while (gate_kind && pos < t->count) {
+        struct nlattr* page_tab;
+        uint32_t* count_slot;
+        uint32_t n = 0;
+
+        ret = lb_reserve(&lb->tx, &lb->tx_cap, LB_PAGE_SIZE + lb_action_size(t->actions[pos]));
+        if (ret < 0)
+            return ret;
+
+        nlh = lb_page_start(lb, req, &page_tab, &count_slot);
+
+        for (; pos < t->count; pos++) {
+            const struct lb_action* a = t->actions[pos];
+
+            if (since_ns && a->lastuse_ns < since_ns)
+                continue;
+            if (!(root_flags & TCA_ACT_FLAG_LARGE_DUMP_ON) && n == TCA_ACT_MAX_PRIO)
+                break;
+            if (n > 0 && nlh->nlmsg_len + lb_action_size(a) > LB_PAGE_SIZE)
+                break;
+
+            lb_put_action(nlh, a, (uint16_t)(n + 1u), (root_flags & TCA_ACT_FLAG_TERSE_DUMP) != 0, now);
+            n++;
+        }
+
+        if (n == 0)
+            break;
+
+        mnl_attr_nest_end(nlh, page_tab);
+        *count_slot = n;
+        ret = lb_queue(lb, lb->tx, nlh->nlmsg_len);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = lb_reserve(&lb->tx, &lb->tx_cap, 64u);
+    if (ret < 0)
+        return ret;
+
+    nlh = mnl_nlmsg_put_header(lb->tx);
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_flags = NLM_F_MULTI;
+    nlh->nlmsg_seq = req->nlmsg_seq;
+    nlh->nlmsg_pid = lb->portid;
+    memset(mnl_nlmsg_put_extra_header(nlh, sizeof(int)), 0, sizeof(int));
+
+    return lb_queue(lb, lb->tx, nlh->nlmsg_len);
+}
+
+/* Serve every request in one datagram, queueing replies in order */
+static void lb_handle(struct gb_nl_loopback* lb, const void* buf, size_t len) {
+    const struct nlmsghdr* nlh = buf;
+    int remaining = len > INT32_MAX ? INT32_MAX : (int)len;
+
+    while (mnl_nlmsg_ok(nlh, remaining)) {
+        const char* extack = NULL;
+        bool dump = false;
+        int err;
+
+        if (!(nlh->nlmsg_flags & NLM_F_REQUEST)) {
+            nlh = mnl_nlmsg_next(nlh, &remaining);
+            continue;
+        }
+
+        pthread_mutex_lock(&lb_model.lock);
+        lb_service_wait();
+
+        switch (nlh->nlmsg_type) {
+            case RTM_NEWACTION:
+                err = lb_new_action(lb, nlh, &extack);
+                break;
+            case RTM_DELACTION:
+                err = lb_del_action(lb, nlh, &extack);
+                break;
+            case RTM_GETACTION:
+                dump = (nlh->nlmsg_flags & NLM_F_DUMP) == NLM_F_DUMP;
+                err = dump ? lb_dump_actions(lb, nlh) : lb_get_action(lb, nlh, &extack);
+                break;
+            default:
+                err = -EOPNOTSUPP;
+                break;
+        }
+
+        pthread_mutex_unlock(&lb_model.lock);
+
+        /* Dumps end with NLMSG_DONE instead of an ack */
+        if (err != 0 || (!dump && (nlh->nlmsg_flags & NLM_F_ACK)))
+            lb_ack(lb, nlh, err, extack);
+
+        nlh = mnl_nlmsg_next(nlh, &remaining);
+    }
+}
+
+static void* lb_serve(void* arg) {
+    struct gb_nl_loopback* lb = arg;
+
+    for (;;) {
+        struct pollfd pfd = {
+            .fd = lb->fd,
+            .events = POLLIN,
+        };
+        ssize_t n;
+
+        if (lb->out_head < lb->out_len)
+            pfd.events |= POLLOUT;
+
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if ((pfd.revents & POLLOUT) && lb_flush(lb) < 0)
+            break;
+
+        if (!(pfd.revents & POLLIN)) {
+            if (pfd.revents & (POLLHUP | POLLERR))
+                break;
+            continue;
+        }
+
+        /* Size the pending request first so a large batch is never truncated */
+        n = recv(lb->fd, NULL, 0, MSG_PEEK | MSG_TRUNC | MSG_DONTWAIT);
+        if (n == 0)
+            break;
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            break;
+        }
+        if (lb_reserve(&lb->rx, &lb->rx_cap, (size_t)n) < 0)
+            break;
+
+        n = recv(lb->fd, lb->rx, lb->rx_cap, MSG_DONTWAIT);
+        if (n <= 0)
+            break;
+
+        lb_handle(lb, lb->rx, (size_t)n);
+        if (lb_flush(lb) < 0)
+            break;
+    }
+
+    return NULL;
+}
+
+/*
+ * Action table of the calling thread's network namespace, created on first
+ * use. Namespaces are told apart by inode; without /proc all share one.
+ */
+static struct lb_table* lb_table_get(void) {
+    struct lb_table* t;
+    struct stat st;
+    uint64_t netns = 0;
+
+    if (stat("/proc/thread-self/ns/net", &st) == 0)
+        netns = (uint64_t)st.st_ino;
+
+    pthread_mutex_lock(&lb_model.lock);
+    for (t = lb_model.tables; t; t = t->next) {
+        if (t->netns == netns)
+            break;
+    }
+
+    if (!t) {
+        t = calloc(1, sizeof(*t));
+        if (t) {
+            t->netns = netns;
+            t->next = lb_model.tables;
+            lb_model.tables = t;
+        }
+    }
+    pthread_mutex_unlock(&lb_model.lock);
+
+    return t;
+}
+
+int gb_nl_loopback_open(int* fd_out, uint32_t* portid_out, struct gb_nl_loopback** out) {
+    struct gb_nl_loopback* lb;
+    int sv[2];
+    int ret;
+
+    if (!fd_out || !portid_out || !out)
+        return -EINVAL;
+
+    lb = calloc(1, sizeof(*lb));
+    if (!lb)
+        return -ENOMEM;
+
+    lb->table = lb_table_get();
+    if (!lb->table) {
+        free(lb);
+        return -ENOMEM;
+    }
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0) {
+        ret = -errno;
+        free(lb);
+        return ret;
+    }
+
+    lb->fd = sv[1];
+    lb->portid = atomic_fetch_add(&lb_next_portid, 1u);
+
+    ret = lb_reserve(&lb->rx, &lb->rx_cap, LB_BUF_SIZE);
+    if (ret == 0)
+        ret = lb_reserve(&lb->tx, &lb->tx_cap, LB_BUF_SIZE);
+    if (ret == 0)
+        ret = -pthread_create(&lb->thread, NULL, lb_serve, lb);
+    if (ret < 0) {
+        close(sv[0]);
+        close(sv[1]);
+        free(lb->rx);
+        free(lb->tx);
+        free(lb);
+        return ret;
+    }
+
+    *fd_out = sv[0];
+    *portid_out = lb->portid;
+    *out = lb;
+    return 0;
+}
+
+int gb_nl_loopback_join(struct gb_nl_loopback* lb, unsigned int group) {
+    int ret = 0;
+
+    if (!lb)
+        return -EINVAL;
+
+    /* Only tc action events are modelled; other groups stay silent */
+    if (group != RTNLGRP_TC)
+        return 0;
+
+    pthread_mutex_lock(&lb_model.lock);
+    if (lb->tc_listener)
+        goto out;
+
+    if (lb_model.listener_count == lb_model.listener_cap) {
+        size_t cap = lb_model.listener_cap ? lb_model.listener_cap * 2u : 16u;
+        struct gb_nl_loopback** p = realloc(lb_model.listeners, cap * sizeof(*p));
+
+        if (!p) {
+            ret = -ENOMEM;
+            goto out;
+        }
+        lb_model.listeners = p;
+        lb_model.listener_cap = cap;
+    }
+
+    lb_model.listeners[lb_model.listener_count++] = lb;
+    lb->tc_listener = true;
+
+out:
+    pthread_mutex_unlock(&lb_model.lock);
+    return ret;
+}
+
+/* Leave RTNLGRP_TC so no notification is sent to a socket being torn down */
+static void lb_leave(struct gb_nl_loopback* lb) {
+    pthread_mutex_lock(&lb_model.lock);
+    for (size_t i = 0; lb->tc_listener && i < lb_model.listener_count; i++) {
+        if (lb_model.listeners[i] == lb) {
+            lb_model.listeners[i] = lb_model.listeners[--lb_model.listener_count];
+            lb->tc_listener = false;
+        }
+    }
+    pthread_mutex_unlock(&lb_model.lock);
+}
+
+void gb_nl_loopback_close(struct gb_nl_loopback* lb) {
+    if (!lb)
+        return;
+
+    lb_leave(lb);
+
+    /* The client end is already closed, so the responder sees EOF and exits */
+    pthread_join(lb->thread, NULL);
+    close(lb->fd);
+    free(lb->rx);
+    free(lb->tx);
+    free(lb->out);
+    free(lb);
+}
+
+void gb_nl_loopback_set_service(const struct gb_nl_service* service) {
+    pthread_mutex_lock(&lb_model.lock);
+    if (service)
+        lb_model.service = *service;
+    else
+        memset(&lb_model.service, 0, sizeof(lb_model.service));
+    pthread_mutex_unlock(&lb_model.lock);
+}
+
+static int parse_ns(const char* s, char** end, uint64_t* out) {
+    unsigned long long v;
+
+    if (!s || *s < '0' || *s > '9')
+        return -EINVAL;
+
+    errno = 0;
+    v = strtoull(s, end, 10);
+    if (errno != 0)
+        return -EINVAL;
+
+    *out = (uint64_t)v;
+    return 0;
+}
+
+int gb_nl_service_parse(const char* spec, struct gb_nl_service* out) {
+    struct gb_nl_service svc;
+    const char* arg;
+    char* end = NULL;
+
+    if (!spec || !out)
+        return -EINVAL;
+
+    memset(&svc, 0, sizeof(svc));
+
+    if (strcmp(spec, "none") == 0 || strcmp(spec, "0") == 0) {
+        *out = svc;
+        return 0;
+    }
+
+    if (strncmp(spec, "fixed:", 6) == 0) {
+        svc.dist = GB_NL_SERVICE_FIXED;
+        arg = spec + 6;
+        if (parse_ns(arg, &end, &svc.a_ns) < 0 || *end != '\0')
+            return -EINVAL;
+    }
+    else if (strncmp(spec, "uniform:", 8) == 0) {
+        svc.dist = GB_NL_SERVICE_UNIFORM;
+        arg = spec + 8;
+        if (parse_ns(arg, &end, &svc.a_ns) < 0 || *end != ':')
+            return -EINVAL;
+        if (parse_ns(end + 1, &end, &svc.b_ns) < 0 || *end != '\0' || svc.b_ns < svc.a_ns)
+            return -EINVAL;
+    }
+    else if (strncmp(spec, "exp:", 4) == 0) {
+        svc.dist = GB_NL_SERVICE_EXP;
+        arg = spec + 4;
+        if (parse_ns(arg, &end, &svc.a_ns) < 0 || *end != '\0')
+            return -EINVAL;
+    }
+    else {
+        return -EINVAL;
+    }
+
+    *out = svc;
+    return 0;
+}
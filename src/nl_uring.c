@@ -0,0 +1,431 @@
+/* src/nl_uring.c
+ * io_uring transport for netlink sockets (raw syscalls, no liburing).
+ */
+#include "nl_internal.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define GB_NL_URING_ENTRIES 16u
+#define GB_NL_URING_MAX_SENDS 8u
+#define GB_NL_URING_TX_SIZE (64u * 1024u)
+
+/* user_data layout: generation << 16 | kind << 8 | send slot */
+enum uring_kind {
+    URING_KIND_SEND = 1,
+    URING_KIND_RECV = 2,
+    URING_KIND_TIMEOUT = 3,
+};
+
+struct gb_nl_uring {
+    int ring_fd;
+    int sock_fd;
+    bool fixed_file; /* sock_fd registered as fixed file 0 */
+    bool fixed_buf;  /* tx registered as fixed buffer 0 */
+
+    void* sq_ring;
+    size_t sq_ring_len;
+    void* cq_ring;
+    size_t cq_ring_len;
+    struct io_uring_sqe* sqes;
+    size_t sqes_len;
+
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+
+    unsigned sq_tail_local;
+    unsigned queued;     /* SQEs prepared for the current round */
+    unsigned sends;      /* Sends among them */
+    uint16_t generation; /* Round counter; stale CQEs are ignored */
+    size_t send_len[GB_NL_URING_MAX_SENDS];
+
+    uint8_t* tx;
+    size_t tx_used;
+
+    struct __kernel_timespec ts;
+};
+
+struct uring_round {
+    int send_err;
+    int recv_res;
+    bool recv_done;
+};
+
+static void* ring_at(void* base, uint32_t off) {
+    return (char*)base + off;
+}
+
+static int uring_setup(unsigned entries, struct io_uring_params* p) {
+    long ret = syscall(__NR_io_uring_setup, entries, p);
+
+    return ret < 0 ? -errno : (int)ret;
+}
+
+static int uring_register(int ring_fd, unsigned opcode, const void* arg, unsigned nr) {
+    long ret = syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr);
+
+    return ret < 0 ? -errno : 0;
+}
+
+static int uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete) {
+    for (;;) {
+        long ret = syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, IORING_ENTER_GETEVENTS, NULL, 0);
+
+        if (ret >= 0)
+            return (int)ret;
+        if (errno != EINTR)
+            return -errno;
+    }
+}
+
+static uint64_t uring_tag(const struct gb_nl_uring* ur, enum uring_kind kind, unsigned slot) {
+    return ((uint64_t)ur->generation << 16) | ((uint64_t)kind << 8) | (uint64_t)slot;
+}
+
+static struct io_uring_sqe* uring_get_sqe(struct gb_nl_uring* ur) {
+    unsigned head = __atomic_load_n(ur->sq_head, __ATOMIC_ACQUIRE);
+    unsigned idx;
+    struct io_uring_sqe* sqe;
+
+    if (ur->sq_tail_local - head >= ur->sq_entries)
+        return NULL;
+
+    idx = ur->sq_tail_local & ur->sq_mask;
+    sqe = &ur->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    ur->sq_array[idx] = idx;
+    ur->sq_tail_local++;
+    ur->queued++;
+
+    if (ur->fixed_file) {
+        sqe->fd = 0;
+        sqe->flags |= IOSQE_FIXED_FILE;
+    }
+    else {
+        sqe->fd = ur->sock_fd;
+    }
+    return sqe;
+}
+
+/* Submit everything queued in this round and wait until all of it completed. */
+static int uring_run(struct gb_nl_uring* ur, struct uring_round* round) {
+    unsigned to_submit = ur->queued;
+    unsigned expected = ur->queued;
+    unsigned seen = 0;
+    int ret = 0;
+
+    round->send_err = 0;
+    round->recv_res = 0;
+    round->recv_done = false;
+
+    __atomic_store_n(ur->sq_tail, ur->sq_tail_local, __ATOMIC_RELEASE);
+
+    while (seen < expected) {
+        unsigned head, tail;
+
+        ret = uring_enter(ur->ring_fd, to_submit, 1);
+        if (ret < 0)
+            break;
+        to_submit -= (unsigned)ret;
+
+        head = *ur->cq_head;
+        tail = __atomic_load_n(ur->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const struct io_uring_cqe* cqe = &ur->cqes[head & ur->cq_mask];
+            unsigned kind = (unsigned)((cqe->user_data >> 8) & 0xffu);
+            unsigned slot = (unsigned)(cqe->user_data & 0xffu);
+
+            head++;
+            if ((uint16_t)(cqe->user_data >> 16) != ur->generation)
+                continue;
+            seen++;
+
+            if (kind == URING_KIND_SEND && slot < GB_NL_URING_MAX_SENDS) {
+                /* Keep the first real failure; later links only report -ECANCELED. */
+                if (round->send_err == 0 && cqe->res < 0)
+                    round->send_err = cqe->res;
+                else if (round->send_err == 0 && (size_t)cqe->res != ur->send_len[slot])
+                    round->send_err = -EIO;
+            }
+            else if (kind == URING_KIND_RECV) {
+                round->recv_res = cqe->res;
+                round->recv_done = true;
+            }
+        }
+        __atomic_store_n(ur->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    ur->queued = 0;
+    ur->sends = 0;
+    ur->tx_used = 0;
+    ur->generation++;
+    return ret < 0 ? ret : 0;
+}
+
+int gb_nl_uring_open(int fd, struct gb_nl_uring** out) {
+    struct gb_nl_uring* ur;
+    struct io_uring_params p;
+    struct iovec iov;
+    int ret;
+
+    if (fd < 0 || !out)
+        return -EINVAL;
+
+    ur = calloc(1, sizeof(*ur));
+    if (!ur)
+        return -ENOMEM;
+
+    ur->ring_fd = -1;
+    ur->sock_fd = fd;
+    ur->sq_ring = MAP_FAILED;
+    ur->cq_ring = MAP_FAILED;
+    ur->sqes = MAP_FAILED;
+    ur->tx = MAP_FAILED;
+
+    memset(&p, 0, sizeof(p));
+    ret = uring_setup(GB_NL_URING_ENTRIES, &p);
+    if (ret < 0)
+        goto fail;
+    ur->ring_fd = ret;
+
+    ur->sq_ring_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ur->cq_ring_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) && ur->cq_ring_len > ur->sq_ring_len)
+        ur->sq_ring_len = ur->cq_ring_len;
+
+    ur->sq_ring =
+        mmap(NULL, ur->sq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd, IORING_OFF_SQ_RING);
+    if (ur->sq_ring == MAP_FAILED) {
+        ret = -errno;
+        goto fail;
+    }
+
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        ur->cq_ring = ur->sq_ring;
+        ur->cq_ring_len = 0;
+    }
+    else {
+        ur->cq_ring = mmap(NULL, ur->cq_ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd,
+                           IORING_OFF_CQ_RING);
+        if (ur->cq_ring == MAP_FAILED) {
+            ret = -errno;
+            goto fail;
+        }
+    }
+
+    ur->sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+    ur->sqes =
+        mmap(NULL, ur->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ur->ring_fd, IORING_OFF_SQES);
+    if (ur->sqes == MAP_FAILED) {
+        ret = -errno;
+        goto fail;
+    }
+
+    ur->sq_head = ring_at(ur->sq_ring, p.sq_off.head);
+    ur->sq_tail = ring_at(ur->sq_ring, p.sq_off.tail);
+    ur->sq_array = ring_at(ur->sq_ring, p.sq_off.array);
+    ur->sq_mask = *(unsigned*)ring_at(ur->sq_ring, p.sq_off.ring_mask);
+    ur->sq_entries = p.sq_entries;
+    ur->sq_tail_local = *ur->sq_tail;
+    ur->cq_head = ring_at(ur->cq_ring, p.cq_off.head);
+    ur->cq_tail = ring_at(ur->cq_ring, p.cq_off.tail);
+    ur->cq_mask = *(unsigned*)ring_at(ur->cq_ring, p.cq_off.ring_mask);
+    ur->cqes = ring_at(ur->cq_ring, p.cq_off.cqes);
+
+    ur->tx = mmap(NULL, GB_NL_URING_TX_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (ur->tx == MAP_FAILED) {
+        ret = -errno;
+        goto fail;
+    }
+
+    /* Registration is an optimization; fall back to plain ops if refused (e.g. RLIMIT_MEMLOCK). */
+    ur->fixed_file = uring_register(ur->ring_fd, IORING_REGISTER_FILES, &fd, 1) == 0;
+
+    iov.iov_base = ur->tx;
+    iov.iov_len = GB_NL_URING_TX_SIZE;
+    ur->fixed_buf = uring_register(ur->ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+
+    *out = ur;
+    return 0;
+
+fail:
+    gb_nl_uring_close(ur);
+    return ret;
+}
+
+void gb_nl_uring_close(struct gb_nl_uring* ur) {
+    if (!ur)
+        return;
+
+    if (ur->tx != MAP_FAILED)
+        munmap(ur->tx, GB_NL_URING_TX_SIZE);
+    if (ur->sqes != MAP_FAILED)
+        munmap(ur->sqes, ur->sqes_len);
+    if (ur->cq_ring != MAP_FAILED && ur->cq_ring != ur->sq_ring)
+        munmap(ur->cq_ring, ur->cq_ring_len);
+    if (ur->sq_ring != MAP_FAILED)
+        munmap(ur->sq_ring, ur->sq_ring_len);
+    if (ur->ring_fd >= 0)
+        close(ur->ring_fd);
+
+    free(ur);
+}
+
+int gb_nl_uring_flush(struct gb_nl_uring* ur) {
+    struct uring_round round;
+    int ret;
+
+    if (!ur)
+        return -EINVAL;
+
+    if (ur->queued == 0)
+        return 0;
+
+    ret = uring_run(ur, &round);
+    if (ret < 0)
+        return ret;
+
+    return round.send_err;
+}
+
+int gb_nl_uring_send(struct gb_nl_uring* ur, const void* buf, size_t len) {
+    struct io_uring_sqe* sqe;
+    unsigned slot;
+    int ret;
+
+    if (!ur || !buf || len == 0)
+        return -EINVAL;
+
+    if (len > GB_NL_URING_TX_SIZE)
+        return -EMSGSIZE;
+
+    /* Leave room for the receive and its timeout behind the queued sends. */
+    if (ur->sends >= GB_NL_URING_MAX_SENDS || len > GB_NL_URING_TX_SIZE - ur->tx_used) {
+        ret = gb_nl_uring_flush(ur);
+        if (ret < 0)
+            return ret;
+    }
+
+    memcpy(ur->tx + ur->tx_used, buf, len);
+
+    sqe = uring_get_sqe(ur);
+    if (!sqe)
+        return -EBUSY;
+
+    slot = ur->sends++;
+    ur->send_len[slot] = len;
+
+    /* Netlink accepts write() to the kernel on an unconnected socket. */
+    sqe->opcode = ur->fixed_buf ? IORING_OP_WRITE_FIXED : IORING_OP_SEND;
+    sqe->addr = (uint64_t)(uintptr_t)(ur->tx + ur->tx_used);
+    sqe->len = (uint32_t)len;
+    sqe->buf_index = 0;
+    sqe->flags |= IOSQE_IO_LINK;
+    sqe->user_data = uring_tag(ur, URING_KIND_SEND, slot);
+
+    ur->tx_used += len;
+    return 0;
+}
+
+int gb_nl_uring_sendmsg(struct gb_nl_uring* ur, const struct msghdr* mh, size_t total) {
+    struct io_uring_sqe* sqe;
+    unsigned slot;
+    int ret;
+
+    if (!ur || !mh)
+        return -EINVAL;
+
+    if (ur->sends >= GB_NL_URING_MAX_SENDS) {
+        ret = gb_nl_uring_flush(ur);
+        if (ret < 0)
+            return ret;
+    }
+
+    sqe = uring_get_sqe(ur);
+    if (!sqe)
+        return -EBUSY;
+
+    slot = ur->sends++;
+    ur->send_len[slot] = total;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->addr = (uint64_t)(uintptr_t)mh;
+    sqe->len = 1;
+    sqe->user_data = uring_tag(ur, URING_KIND_SEND, slot);
+
+    /* mh references caller memory, so it has to complete before returning. */
+    return gb_nl_uring_flush(ur);
+}
+
+ssize_t gb_nl_uring_recv(struct gb_nl_uring* ur, void* buf, size_t cap, int flags, int timeout_ms) {
+    struct io_uring_sqe* sqe;
+    struct uring_round round;
+    int ret;
+
+    if (!ur || (!buf && cap > 0) || cap > INT32_MAX)
+        return -EINVAL;
+
+    sqe = uring_get_sqe(ur);
+    if (!sqe)
+        return -EBUSY;
+
+    /* MSG_TRUNC makes the result the full datagram length so truncation is visible. */
+    sqe->opcode = IORING_OP_RECV;
+    sqe->addr = (uint64_t)(uintptr_t)buf;
+    sqe->len = (uint32_t)cap;
+    sqe->msg_flags = (uint32_t)(flags | MSG_TRUNC);
+    sqe->user_data = uring_tag(ur, URING_KIND_RECV, 0);
+
+    if (timeout_ms >= 0) {
+        sqe->flags |= IOSQE_IO_LINK;
+
+        ur->ts.tv_sec = timeout_ms / 1000;
+        ur->ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000ll;
+
+        sqe = uring_get_sqe(ur);
+        if (!sqe)
+            return -EBUSY;
+        sqe->opcode = IORING_OP_LINK_TIMEOUT;
+        sqe->fd = -1;
+        sqe->flags = 0;
+        sqe->addr = (uint64_t)(uintptr_t)&ur->ts;
+        sqe->len = 1;
+        sqe->user_data = uring_tag(ur, URING_KIND_TIMEOUT, 0);
+    }
+
+    ret = uring_run(ur, &round);
+    if (ret < 0)
+        return ret;
+
+    if (round.send_err < 0)
+        return round.send_err;
+
+    if (!round.recv_done)
+        return -EIO;
+
+    if (round.recv_res == -ECANCELED)
+        return -ETIMEDOUT;
+
+    if (round.recv_res < 0)
+        return round.recv_res;
+
+    if (!(flags & MSG_PEEK) && (size_t)round.recv_res > cap)
+        return -ENOSPC;
+
+    return round.recv_res;
+}
@@ -0,0 +1,254 @@
+/* src/open_loop.c
+ * Open-loop load: replaces are issued on a fixed or Poisson schedule rather
+ * than when the previous one returns, and their latency is measured from
+ * when they were due, so kernel stalls show up in the tail instead of
+ * silently lowering the offered rate.
+ */
+#include "../include/gatebench_open_loop.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Sleep until this close to the deadline, then spin, so wakeup jitter stays out of response times */
+#define OPEN_LOOP_SPIN_NS 50000ull
+#define OPEN_LOOP_SEED 0x9e3779b97f4a7c15ull
+
+const char* gb_arrivals_name(enum gb_arrivals arrivals) {
+    switch (arrivals) {
+        case GB_ARRIVALS_CONSTANT:
+            return "constant";
+        case GB_ARRIVALS_POISSON:
+            return "poisson";
+        default:
+            return "unknown";
+    }
+}
+
+int gb_arrivals_parse(const char* name, enum gb_arrivals* out) {
+    if (!name || !out)
+        return -EINVAL;
+
+    if (strcmp(name, "constant") == 0)
+        *out = GB_ARRIVALS_CONSTANT;
+    else if (strcmp(name, "poisson") == 0)
+        *out = GB_ARRIVALS_POISSON;
+    else
+        return -EINVAL;
+
+    return 0;
+}
+
+static uint64_t open_loop_rng(uint64_t* state) {
+    uint64_t x = *state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+/* Gap to the next arrival in ns */
+static double open_loop_gap_ns(enum gb_arrivals arrivals, double rate, uint64_t* state) {
+    double u;
+
+    if (arrivals != GB_ARRIVALS_POISSON)
+        return 1e9 / rate;
+
+    /* Uniform in (0, 1] so the log stays finite */
+    u = ((double)(open_loop_rng(state) >> 11) + 1.0) / 9007199254740992.0;
+    return -log(u) * 1e9 / rate;
+}
+
+static void open_loop_wait_until(uint64_t deadline_ns) {
+    uint64_t now = 0;
+
+    if (gb_util_ns_now(&now, CLOCK_MONOTONIC) < 0 || now >= deadline_ns)
+        return;
+
+    if (deadline_ns - now > OPEN_LOOP_SPIN_NS) {
+        uint64_t wake = deadline_ns - OPEN_LOOP_SPIN_NS;
+        struct timespec ts = {
+            .tv_sec = (time_t)(wake / 1000000000ull),
+            .tv_nsec = (long)(wake % 1000000000ull),
+        };
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+    }
+
+    while (gb_util_ns_now(&now, CLOCK_MONOTONIC) == 0 && now < deadline_ns) {
+    }
+}
+
+int gb_open_loop_run(const struct gb_config* cfg, double rate, uint32_t ops, struct gb_open_loop_result* out) {
+    struct gb_nl_sock* sock = NULL;
+    struct gb_nl_msg* msg = NULL;
+    struct gb_nl_msg* del_msg = NULL;
+    struct gb_nl_msg* resp = NULL;
+    struct gate_shape shape;
+    struct gate_entry* entries = NULL;
+    struct gb_stats service, response;
+    enum gb_arrivals arrivals;
+    uint64_t state = OPEN_LOOP_SEED;
+    uint64_t start_ns, prev_done, last_done = 0;
+    double due;
+    uint32_t entry_count;
+    int ret;
+
+    if (!cfg || !out || !(rate > 0.0) || ops == 0)
+        return -EINVAL;
+
+    memset(out, 0, sizeof(*out));
+    memset(&service, 0, sizeof(service));
+    memset(&response, 0, sizeof(response));
+    arrivals = (enum gb_arrivals)cfg->arrivals;
+    out->arrivals = cfg->arrivals;
+    out->offered_rate = rate;
+    state ^= cfg->index;
+
+    entry_count = cfg->entries;
+    memset(&shape, 0, sizeof(shape));
+    shape.clockid = cfg->clockid;
+    shape.base_time = cfg->base_time;
+    shape.cycle_time = cfg->cycle_time;
+    shape.cycle_time_ext = cfg->cycle_time_ext;
+    shape.interval_ns = cfg->interval_ns;
+    shape.entries = entry_count;
+
+    ret = gb_stats_init(&service, ops);
+    if (ret == 0)
+        ret = gb_stats_init(&response, ops);
+    if (ret < 0)
+        goto out;
+
+    entries = calloc(entry_count > 0 ? entry_count : 1u, sizeof(*entries));
+    msg = gb_nl_msg_alloc(gate_msg_capacity(entry_count, 0));
+    del_msg = gb_nl_msg_alloc(1024);
+    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!entries || !msg || !del_msg || !resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(entries, entry_count, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_newaction(msg, cfg->index, &shape, entries, entry_count, NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    if (ret < 0)
+        goto out;
+
+    ret = build_gate_delaction(del_msg, cfg->index);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_nl_open(&sock);
+    if (ret < 0)
+        goto out;
+
+    /* The first replace creates the action; a failure here is fatal rather than an error count */
+    ret = gb_nl_send_recv(sock, msg, resp, cfg->timeout_ms);
+    if (ret < 0)
+        goto out;
+    for (uint32_t i = 0; i < cfg->warmup; i++)
+        (void)gb_nl_send_recv(sock, msg, resp, cfg->timeout_ms);
+
+    ret = gb_util_ns_now(&start_ns, CLOCK_MONOTONIC);
+    if (ret < 0)
+        goto out_del;
+
+    /* Give the first op a full gap so the sleep above is not charged to it */
+    due = (double)start_ns + open_loop_gap_ns(arrivals, rate, &state);
+    prev_done = start_ns;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        uint64_t intended = (uint64_t)due;
+        uint64_t t0 = 0, t1 = 0;
+
+        if (prev_done > intended)
+            out->queued++;
+        else
+            open_loop_wait_until(intended);
+
+        (void)gb_util_ns_now(&t0, CLOCK_MONOTONIC);
+        ret = gb_nl_send_recv(sock, msg, resp, cfg->timeout_ms);
+        (void)gb_util_ns_now(&t1, CLOCK_MONOTONIC);
+
+        prev_done = t1;
+        last_done = t1;
+        due += open_loop_gap_ns(arrivals, rate, &state);
+        if (t0 > intended && t0 - intended > out->max_lag_ns)
+            out->max_lag_ns = t0 - intended;
+
+        if (ret < 0) {
+            out->errors++;
+            continue;
+        }
+        out->ops++;
+
+        ret = gb_stats_add(&service, t1 - t0);
+        if (ret == 0)
+            ret = gb_stats_add(&response, t1 > intended ? t1 - intended : 0);
+        if (ret < 0)
+            goto out_del;
+    }
+
+    out->secs = (double)(last_done - start_ns) / 1e9;
+    if (out->secs > 0.0)
+        out->achieved_rate = (double)out->ops / out->secs;
+
+    ret = gb_stats_summarize(&service, &out->service);
+    if (ret == 0)
+        ret = gb_stats_summarize(&response, &out->response);
+
+out_del:
+    (void)gb_nl_send_recv(sock, del_msg, resp, cfg->timeout_ms);
+out:
+    gb_nl_close(sock);
+    gb_nl_msg_free(msg);
+    gb_nl_msg_free(del_msg);
+    gb_nl_msg_free(resp);
+    free(entries);
+    gb_stats_free(&service);
+    gb_stats_free(&response);
+    return ret;
+}
+
+void gb_open_loop_print_result(const struct gb_open_loop_result* result, const struct gb_config* cfg) {
+    if (!result || !cfg)
+        return;
+
+    const struct {
+        const char* name;
+        const struct gb_latency_summary* lat;
+    } rows[] = {
+        {"service", &result->service},
+        {"response", &result->response},
+    };
+
+    printf("Open loop: %.1f ops/sec offered (%s arrivals), %.1f ops/sec achieved over %.3f s\n", result->offered_rate,
+           gb_arrivals_name((enum gb_arrivals)result->arrivals), result->achieved_rate, result->secs);
+    printf("  %llu replaces, %llu errors, %llu queued behind the previous op, max send lag %.1f us\n",
+           (unsigned long long)result->ops, (unsigned long long)result->errors, (unsigned long long)result->queued,
+           (double)result->max_lag_ns / 1e3);
+    printf("  %-9s %10s %10s %10s %10s %10s\n", "latency", "p50", "p95", "p99", "p999", "max");
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        const struct gb_latency_summary* lat = rows[i].lat;
+
+        printf("  %-9s %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus\n", rows[i].name, (double)lat->p50_ns / 1e3,
+               (double)lat->p95_ns / 1e3, (double)lat->p99_ns / 1e3, (double)lat->p999_ns / 1e3,
+               (double)lat->max_ns / 1e3);
+    }
+    printf("  (service: send to ack, uncorrected; response: intended start to ack, corrected)\n");
+}
@@ -0,0 +1,116 @@
+/* src/populate.c
+ * Bulk creation of gate action populations, several actions per request.
+ */
+#include "../include/gatebench.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+int gb_populator_init(struct gb_populator* p, const struct gb_config* cfg) {
+    uint32_t idx[GB_MULTI_ACTIONS_MAX];
+    int ret;
+
+    if (!p || !cfg)
+        return -EINVAL;
+
+    memset(p, 0, sizeof(*p));
+    p->cfg = cfg;
+
+    p->shape.clockid = cfg->clockid;
+    p->shape.base_time = cfg->base_time;
+    p->shape.cycle_time = cfg->cycle_time;
+    p->shape.cycle_time_ext = cfg->cycle_time_ext;
+    p->shape.interval_ns = cfg->interval_ns;
+    p->shape.entries = cfg->entries;
+
+    p->entries = calloc(cfg->entries > 0 ? cfg->entries : 1u, sizeof(*p->entries));
+    p->msg = gb_nl_msg_alloc(gate_msg_size_multi(GB_MULTI_ACTIONS_MAX, cfg->entries));
+    if (!p->entries || !p->msg) {
+        ret = -ENOMEM;
+        goto err;
+    }
+
+    ret = gb_fill_entries(p->entries, cfg->entries, cfg->interval_ns);
+    if (ret < 0)
+        goto err;
+
+    /* Largest batch whose full-size schedules still fit one TCA_ACT_TAB nest */
+    for (uint32_t k = GB_MULTI_ACTIONS_MAX; k > 0; k /= 2u) {
+        for (uint32_t j = 0; j < k; j++)
+            idx[j] = cfg->index + j;
+
+        gb_nl_msg_reset(p->msg);
+        ret = build_gate_newaction_multi(p->msg, idx, k, &p->shape, p->entries, cfg->entries,
+                                         NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+        if (ret == 0) {
+            p->batch = k;
+            return 0;
+        }
+        if (ret != -EMSGSIZE)
+            goto err;
+    }
+    ret = -EMSGSIZE;
+
+err:
+    gb_populator_free(p);
+    return ret;
+}
+
+int gb_populate(struct gb_populator* p,
+                struct gb_nl_sock* sock,
+                struct gb_nl_msg* resp,
+                uint32_t off,
+                uint32_t n,
+                bool vary_entries,
+                uint64_t* errors) {
+    const struct gb_config* cfg;
+    uint32_t idx[GB_MULTI_ACTIONS_MAX];
+    uint32_t k;
+    int ret;
+
+    if (!p || !p->msg || !sock || !resp || !errors)
+        return -EINVAL;
+
+    cfg = p->cfg;
+    if (off > UINT32_MAX - n || cfg->index > UINT32_MAX - off - n)
+        return -ERANGE;
+
+    for (uint32_t done = 0, m = 0; done < n; done += k, m++) {
+        uint32_t entries = vary_entries ? 1u + m % cfg->entries : cfg->entries;
+
+        k = n - done < p->batch ? n - done : p->batch;
+        for (uint32_t j = 0; j < k; j++)
+            idx[j] = cfg->index + off + done + j;
+
+        p->shape.entries = entries;
+        gb_nl_msg_reset(p->msg);
+        ret = build_gate_newaction_multi(p->msg, idx, k, &p->shape, p->entries, entries, NLM_F_CREATE | NLM_F_EXCL, 0,
+                                         -1);
+        if (ret < 0)
+            return ret;
+
+        ret = gb_nl_send_recv(sock, p->msg, resp, cfg->timeout_ms);
+        if (ret < 0) {
+            /* Nothing at all could be created: report it instead of measuring an empty table */
+            if (done == 0)
+                return ret;
+            (*errors)++;
+        }
+    }
+
+    return 0;
+}
+
+void gb_populator_free(struct gb_populator* p) {
+    if (!p)
+        return;
+
+    gb_nl_msg_free(p->msg);
+    free(p->entries);
+    p->msg = NULL;
+    p->entries = NULL;
+}
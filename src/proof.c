@@ -103,6 +103,19 @@ static void gb_pcap_stop(struct gb_pcap_ctx* ctx) {
 }
 #endif
 
+/* Decode every action and entry in place, as a consumer of the dump would */
+static int proof_visit_entry(const struct gate_entry* entry, void* arg) {
+    struct gb_dump_summary* summary = arg;
+
+    (void)entry;
+    summary->entries++;
+    return 0;
+}
+
+static int proof_visit_action(const struct gate_view* view, void* arg) {
+    return gb_gate_view_entries(view, proof_visit_entry, arg);
+}
+
 int gb_proof_run(const struct gb_config* cfg, struct gb_dump_summary* summary) {
     struct gb_nl_sock* sock = NULL;
     struct gb_nl_msg* create_msg = NULL;
@@ -127,8 +140,6 @@ int gb_proof_run(const struct gb_config* cfg, struct gb_dump_summary* summary) {
         return ret;
 
     entry_count = cfg->entries;
-    if (entry_count > GB_MAX_ENTRIES)
-        entry_count = GB_MAX_ENTRIES;
 
     if (entry_count > 0) {
         entries = malloc((size_t)entry_count * sizeof(*entries));
@@ -193,12 +204,21 @@ int gb_proof_run(const struct gb_config* cfg, struct gb_dump_summary* summary) {
     }
 
     memset(&dump_stats, 0, sizeof(dump_stats));
-    ret = gb_nl_dump_action(sock, dump_msg, &dump_stats, cfg->timeout_ms);
+    summary->pipelined = cfg->dump_pipeline;
+    ret = gb_nl_dump_visit(sock, dump_msg, proof_visit_action, summary, cfg->dump_pipeline, &dump_stats,
+                           cfg->timeout_ms);
     summary->reply_msgs = dump_stats.reply_msgs;
     summary->payload_bytes = dump_stats.payload_bytes;
     summary->saw_done = dump_stats.saw_done;
     summary->saw_error = dump_stats.saw_error;
     summary->error_code = dump_stats.error_code;
+    summary->actions = dump_stats.visited_actions;
+    summary->parse_ns = dump_stats.parse_ns;
+    summary->wall_ns = dump_stats.wall_ns;
+    if (dump_stats.parse_ns > 0) {
+        summary->parse_bytes_per_sec = (double)dump_stats.payload_bytes * 1e9 / (double)dump_stats.parse_ns;
+        summary->parse_actions_per_sec = (double)dump_stats.visited_actions * 1e9 / (double)dump_stats.parse_ns;
+    }
 
     if (summary->saw_error)
         ret = summary->error_code;
@@ -240,6 +260,12 @@ void gb_proof_print_summary(const struct gb_dump_summary* summary, const struct
         printf("  NLMSG_ERROR:              no\n");
     }
     printf("  Reply payload bytes:      %llu\n", (unsigned long long)summary->payload_bytes);
+    printf("  Actions / entries parsed: %llu / %llu%s\n", (unsigned long long)summary->actions,
+           (unsigned long long)summary->entries, summary->pipelined ? " (pipelined)" : "");
+    printf("  Parse time / dump time:   %llu ns / %llu ns\n", (unsigned long long)summary->parse_ns,
+           (unsigned long long)summary->wall_ns);
+    printf("  Parse throughput:         %.1f MB/s, %.0f actions/s\n", summary->parse_bytes_per_sec / 1e6,
+           summary->parse_actions_per_sec);
     if (cfg->pcap_path) {
         if (summary->pcap_error < 0)
             printf("  pcap capture:             failed (%d)\n", summary->pcap_error);
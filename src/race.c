@@ -56,6 +56,7 @@
 #define RACE_EXTACK_SLOTS 6u
 #define RACE_INVALID_CASES 8u
 #define RACE_BASETIME_JITTER_NS 10000000u
+#define RACE_GET_RESP_SIZE (128u * 1024u) /* One 64 KiB action nest plus headers */
 #define RACE_THREAD_COUNT GB_RACE_THREAD_COUNT
 #define RACE_PAIR_COUNT (RACE_THREAD_COUNT / 2u)
 #define RACE_PAIR_SWAP_SLICE_NS 1000000000ull
@@ -431,38 +432,6 @@ static void race_print_extack(const char* label, const struct gb_race_extack_sta
         printf("    (other): %llu\n", (unsigned long long)stats->other);
 }
 
-static int race_collect_cpus(int* cpus, int max) {
-    cpu_set_t set;
-    long nproc;
-    int count = 0;
-    int nproc_i;
-
-    if (!cpus || max <= 0)
-        return 0;
-
-    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
-        for (size_t cpu = 0; cpu < (size_t)CPU_SETSIZE && count < max; cpu++) {
-            if (CPU_ISSET(cpu, &set))
-                cpus[count++] = (int)cpu;
-        }
-        if (count > 0)
-            return count;
-    }
-
-    nproc = sysconf(_SC_NPROCESSORS_ONLN);
-    if (nproc <= 0)
-        return 0;
-
-    if (nproc > max)
-        nproc = max;
-
-    nproc_i = (int)nproc;
-    for (int i = 0; i < nproc_i; i++)
-        cpus[i] = i;
-
-    return nproc_i;
-}
-
 static void race_pin_thread(const char* label, int cpu) {
     cpu_set_t set;
     int ret;
@@ -503,7 +472,7 @@ static void race_shape_init(struct gate_shape* shape, const struct gb_config* cf
     shape->cycle_time = cfg->cycle_time;
     shape->cycle_time_ext = cfg->cycle_time_ext;
     shape->interval_ns = cfg->interval_ns;
-    shape->entries = cfg->entries > GB_MAX_ENTRIES ? GB_MAX_ENTRIES : cfg->entries;
+    shape->entries = cfg->entries;
 }
 
 static struct nlmsghdr* race_gate_nlmsg_start(struct gb_nl_msg* msg,
@@ -744,6 +713,23 @@ static int race_send_bad_interval(struct gb_nl_sock* sock,
     return gb_nl_send_recv(sock, msg, resp, timeout_ms);
 }
 
+/* Prefer configured cycle_time; otherwise derive from current entry list. */
+static uint64_t race_basetime_cycle_time(const struct gb_config* cfg,
+                                         const struct gate_entry* entries,
+                                         uint32_t num_entries) {
+    uint64_t cycle_time = cfg ? cfg->cycle_time : 0;
+
+    if (cycle_time == 0 && entries && num_entries > 0) {
+        for (uint32_t i = 0; i < num_entries; i++)
+            cycle_time += (uint64_t)entries[i].interval;
+    }
+    if (cycle_time == 0) {
+        uint64_t interval_ns = cfg ? cfg->interval_ns : 0;
+        cycle_time = interval_ns ? interval_ns : 1000000ull;
+    }
+    return cycle_time;
+}
+
 static int race_send_basetime_update(struct gb_nl_sock* sock,
                                      struct gb_nl_msg* msg,
                                      struct gb_nl_msg* resp,
@@ -760,19 +746,7 @@ static int race_send_basetime_update(struct gb_nl_sock* sock,
     memset(&shape, 0, sizeof(shape));
     shape.clockid = clockid;
     shape.base_time = basetime;
-
-    /* Prefer configured cycle_time; otherwise derive from current entry list. */
-    shape.cycle_time = cfg ? cfg->cycle_time : 0;
-    if (shape.cycle_time == 0 && entries && num_entries > 0) {
-        uint64_t sum = 0;
-        for (uint32_t i = 0; i < num_entries; i++)
-            sum += (uint64_t)entries[i].interval;
-        shape.cycle_time = sum;
-    }
-    if (shape.cycle_time == 0) {
-        uint64_t interval_ns = cfg ? cfg->interval_ns : 0;
-        shape.cycle_time = interval_ns ? interval_ns : 1000000ull;
-    }
+    shape.cycle_time = race_basetime_cycle_time(cfg, entries, num_entries);
     shape.cycle_time_ext = cfg ? cfg->cycle_time_ext : 0;
     if (timeout_ms < 0)
         timeout_ms = 0;
@@ -893,11 +867,10 @@ static void race_sync_pair_init(struct tst_fzsync_pair* pair, float alpha, int m
 static void* race_replace_thread(void* arg) {
     struct gb_race_nl_ctx* ctx = arg;
     struct gb_nl_sock* sock = NULL;
-    struct gb_nl_msg* req = NULL;
+    struct gate_tmpl* tmpl = NULL;
     struct gb_nl_msg* resp = NULL;
     struct gate_entry* entries = NULL;
     struct gate_shape shape;
-    size_t cap;
     int ret;
 
     race_pin_thread("replace", ctx->cpu);
@@ -914,25 +887,29 @@ static void* race_replace_thread(void* arg) {
         goto out;
     }
 
-    cap = gate_msg_capacity(ctx->max_entries, 0);
-    req = gb_nl_msg_alloc(cap);
     resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
-    if (!req || !resp) {
+    if (!resp) {
         race_record_err(&ctx->errors, ctx->err_counts, -ENOMEM);
         goto out;
     }
 
     race_shape_init(&shape, ctx->cfg);
+    ret = build_gate_newaction_tmpl(&tmpl, ctx->max_entries, ctx->index, &shape, NULL, 0,
+                                    NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    if (ret < 0) {
+        race_record_err(&ctx->errors, ctx->err_counts, ret);
+        goto out;
+    }
 
     while (!atomic_load_explicit(ctx->stop, memory_order_relaxed) && !race_sync_exit_requested(ctx->sync_pair)) {
         uint32_t count = race_fill_entries(entries, ctx->max_entries, ctx->interval_max, &ctx->seed);
 
-        ret = build_gate_newaction(req, ctx->index, &shape, entries, count, NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+        ret = gate_tmpl_set_entries(tmpl, entries, count);
         race_sync_start(ctx->sync_pair, ctx->sync_is_a);
         if (ret < 0)
             race_record_err(&ctx->errors, ctx->err_counts, ret);
         else {
-            ret = gb_nl_send_recv(sock, req, resp, ctx->timeout_ms);
+            ret = gb_nl_send_recv(sock, gate_tmpl_msg(tmpl), resp, ctx->timeout_ms);
             if (ret < 0 && ret != -EEXIST && ret != -ENOENT)
                 race_record_nl_error(&ctx->errors, ctx->err_counts, &ctx->extack, ret, resp);
         }
@@ -946,14 +923,25 @@ static void* race_replace_thread(void* arg) {
 out:
     race_sync_signal_exit(ctx->sync_pair);
     free(entries);
-    if (req)
-        gb_nl_msg_free(req);
+    gate_tmpl_free(tmpl);
     if (resp)
         gb_nl_msg_free(resp);
     gb_nl_close(sock);
     return NULL;
 }
 
+/* Entries are decoded in place from the reply and dropped; nothing is copied */
+static int race_visit_entry(const struct gate_entry* entry, void* arg) {
+    (void)entry;
+    (void)arg;
+    return 0;
+}
+
+static int race_visit_action(const struct gate_view* view, void* arg) {
+    (void)arg;
+    return gb_gate_view_entries(view, race_visit_entry, NULL);
+}
+
 static void* race_dump_thread(void* arg) {
     struct gb_race_dump_ctx* ctx = arg;
     struct gb_nl_sock* sock = NULL;
@@ -983,7 +971,7 @@ static void* race_dump_thread(void* arg) {
 
     while (!atomic_load_explicit(ctx->stop, memory_order_relaxed) && !race_sync_exit_requested(ctx->sync_pair)) {
         race_sync_start(ctx->sync_pair, ctx->sync_is_a);
-        ret = gb_nl_dump_action(sock, req, &stats, ctx->timeout_ms);
+        ret = gb_nl_dump_visit(sock, req, race_visit_action, NULL, false, &stats, ctx->timeout_ms);
         if (ret < 0)
             race_record_err(&ctx->errors, ctx->err_counts, ret);
         else if (stats.saw_error)
@@ -1008,7 +996,6 @@ static void* race_get_thread(void* arg) {
     struct gb_nl_sock* sock = NULL;
     struct gb_nl_msg* req = NULL;
     struct gb_nl_msg* resp = NULL;
-    struct gate_dump dump;
     int ret;
 
     race_pin_thread("get", ctx->cpu);
@@ -1020,7 +1007,7 @@ static void* race_get_thread(void* arg) {
     }
 
     req = gb_nl_msg_alloc(1024u);
-    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    resp = gb_nl_msg_alloc(RACE_GET_RESP_SIZE);
     if (!req || !resp) {
         race_record_err(&ctx->errors, ctx->err_counts, -ENOMEM);
         goto out;
@@ -1040,14 +1027,9 @@ static void* race_get_thread(void* arg) {
                 race_record_nl_error(&ctx->errors, ctx->err_counts, &ctx->extack, ret, resp);
         }
         else {
-            ret = gb_nl_gate_parse((struct nlmsghdr*)resp->buf, &dump);
-            if (ret < 0) {
+            ret = gb_nl_gate_visit((struct nlmsghdr*)resp->buf, race_visit_action, NULL);
+            if (ret < 0)
                 race_record_err(&ctx->errors, ctx->err_counts, ret);
-                gb_gate_dump_free(&dump);
-            }
-            else {
-                gb_gate_dump_free(&dump);
-            }
         }
         race_sync_end(ctx->sync_pair, ctx->sync_is_a);
 
@@ -1070,11 +1052,10 @@ static void* race_delete_thread(void* arg) {
     struct gb_race_nl_ctx* ctx = arg;
     struct gb_nl_sock* sock = NULL;
     struct gb_nl_msg* del_msg = NULL;
-    struct gb_nl_msg* create_msg = NULL;
+    struct gate_tmpl* create = NULL;
     struct gb_nl_msg* resp = NULL;
     struct gate_entry* entries = NULL;
     struct gate_shape shape;
-    size_t create_cap;
     int ret;
 
     race_pin_thread("delete", ctx->cpu);
@@ -1092,10 +1073,8 @@ static void* race_delete_thread(void* arg) {
     }
 
     del_msg = gb_nl_msg_alloc(1024u);
-    create_cap = gate_msg_capacity(ctx->max_entries, 0);
-    create_msg = gb_nl_msg_alloc(create_cap);
     resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
-    if (!del_msg || !create_msg || !resp) {
+    if (!del_msg || !resp) {
         race_record_err(&ctx->errors, ctx->err_counts, -ENOMEM);
         goto out;
     }
@@ -1106,6 +1085,12 @@ static void* race_delete_thread(void* arg) {
         goto out;
     }
     race_shape_init(&shape, ctx->cfg);
+    ret = build_gate_newaction_tmpl(&create, ctx->max_entries, ctx->index, &shape, NULL, 0,
+                                    NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+    if (ret < 0) {
+        race_record_err(&ctx->errors, ctx->err_counts, ret);
+        goto out;
+    }
 
     while (!atomic_load_explicit(ctx->stop, memory_order_relaxed) && !race_sync_exit_requested(ctx->sync_pair)) {
         race_sync_start(ctx->sync_pair, ctx->sync_is_a);
@@ -1116,14 +1101,13 @@ static void* race_delete_thread(void* arg) {
 
         {
             uint32_t count = race_fill_entries(entries, ctx->max_entries, ctx->interval_max, &ctx->seed);
-            ret =
-                build_gate_newaction(create_msg, ctx->index, &shape, entries, count, NLM_F_CREATE | NLM_F_EXCL, 0, -1);
+            ret = gate_tmpl_set_entries(create, entries, count);
         }
         if (ret < 0) {
             race_record_err(&ctx->errors, ctx->err_counts, ret);
             continue;
         }
-        ret = gb_nl_send_recv(sock, create_msg, resp, ctx->timeout_ms);
+        ret = gb_nl_send_recv(sock, gate_tmpl_msg(create), resp, ctx->timeout_ms);
         if (ret < 0 && ret != -EEXIST)
             race_record_nl_error(&ctx->errors, ctx->err_counts, &ctx->extack, ret, resp);
 
@@ -1136,8 +1120,7 @@ out:
     free(entries);
     if (del_msg)
         gb_nl_msg_free(del_msg);
-    if (create_msg)
-        gb_nl_msg_free(create_msg);
+    gate_tmpl_free(create);
     if (resp)
         gb_nl_msg_free(resp);
     gb_nl_close(sock);
@@ -1320,10 +1303,10 @@ out:
 static void* race_basetime_thread(void* arg) {
     struct gb_race_update_ctx* ctx = arg;
     struct gb_nl_sock* sock = NULL;
-    struct gb_nl_msg* msg = NULL;
+    struct gate_tmpl* tmpl = NULL;
     struct gb_nl_msg* resp = NULL;
     struct gate_dump dump;
-    size_t cap;
+    struct gate_shape shape;
     int ret;
 
     race_pin_thread("basetime", ctx->cpu);
@@ -1334,14 +1317,25 @@ static void* race_basetime_thread(void* arg) {
         goto out;
     }
 
-    cap = gate_msg_capacity(GB_MAX_ENTRIES, 0);
-    msg = gb_nl_msg_alloc(cap);
     resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
-    if (!msg || !resp) {
+    if (!resp) {
         race_record_err(&ctx->errors, ctx->err_counts, -ENOMEM);
         goto out;
     }
 
+    /*
+     * The schedule read back each round usually matches the last one sent,
+     * so the template only has base_time and the entry scalars rewritten.
+     */
+    memset(&shape, 0, sizeof(shape));
+    shape.clockid = ctx->cfg->clockid;
+    shape.cycle_time_ext = ctx->cfg->cycle_time_ext;
+    ret = build_gate_newaction_tmpl(&tmpl, GB_MAX_ENTRIES, ctx->index, &shape, NULL, 0, NLM_F_REPLACE, 0, -1);
+    if (ret < 0) {
+        race_record_err(&ctx->errors, ctx->err_counts, ret);
+        goto out;
+    }
+
     while (!atomic_load_explicit(ctx->stop, memory_order_relaxed) && !race_sync_exit_requested(ctx->sync_pair)) {
         race_sync_start(ctx->sync_pair, ctx->sync_is_a);
         uint64_t now = race_clock_now_ns((clockid_t)ctx->cfg->clockid);
@@ -1361,8 +1355,12 @@ static void* race_basetime_thread(void* arg) {
                 race_record_err(&ctx->errors, ctx->err_counts, ret);
         }
         else {
-            ret = race_send_basetime_update(sock, msg, resp, ctx->cfg, ctx->index, basetime, ctx->cfg->clockid,
-                                            dump.entries, dump.num_entries, ctx->timeout_ms);
+            ret = gate_tmpl_set_entries(tmpl, dump.entries, dump.num_entries);
+            if (ret >= 0) {
+                gate_tmpl_set_cycle_time(tmpl, race_basetime_cycle_time(ctx->cfg, dump.entries, dump.num_entries));
+                gate_tmpl_set_base_time(tmpl, basetime);
+                ret = gb_nl_send_recv(sock, gate_tmpl_msg(tmpl), resp, ctx->timeout_ms);
+            }
             gb_gate_dump_free(&dump);
 
             if (ret < 0) {
@@ -1379,8 +1377,7 @@ static void* race_basetime_thread(void* arg) {
 
 out:
     race_sync_signal_exit(ctx->sync_pair);
-    if (msg)
-        gb_nl_msg_free(msg);
+    gate_tmpl_free(tmpl);
     if (resp)
         gb_nl_msg_free(resp);
     gb_nl_close(sock);
@@ -1422,8 +1419,6 @@ int gb_race_run_with_summary(const struct gb_config* cfg, struct gb_race_summary
         return -EINVAL;
 
     max_entries = cfg->entries == 0 ? 1u : cfg->entries;
-    if (max_entries > GB_MAX_ENTRIES)
-        max_entries = GB_MAX_ENTRIES;
     if (cfg->interval_ns == 0 || cfg->interval_ns > UINT32_MAX)
         base_interval = 1000000u;
     else
@@ -1441,7 +1436,7 @@ int gb_race_run_with_summary(const struct gb_config* cfg, struct gb_race_summary
     gb_fzsync_seed(RACE_SEED_BASE ^ cfg->index ^ cfg->race_seconds);
     gb_fzsync_set_info(cfg->verbose && !cfg->json);
 
-    cpu_count = race_collect_cpus(cpus, (int)RACE_THREAD_COUNT);
+    cpu_count = gb_util_collect_cpus(cpus, (int)RACE_THREAD_COUNT);
     if (cpu_count <= 0) {
         for (unsigned int i = 0; i < RACE_THREAD_COUNT; i++)
             cpus[i] = -1;
@@ -0,0 +1,351 @@
+/* src/replay.c
+ * Trace replay: re-issue a captured request stream with its original thread
+ * layout, either at the recorded inter-arrival times or as fast as possible.
+ */
+#include "../include/gatebench_trace.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Lead time so every worker has its socket ready before the first request */
+#define REPLAY_START_DELAY_NS 50000000ull
+#define REPLAY_RESP_SIZE (64u * 1024u)
+
+struct replay_worker {
+    const struct gb_config* cfg;
+    enum gb_replay_pace pace;
+    uint64_t start_ns; /* CLOCK_MONOTONIC instant that maps to trace time 0 */
+    uint32_t tid;
+
+    const struct gb_trace_record** recs;
+    size_t count;
+
+    struct gb_nl_sock* sock;
+    struct gb_nl_msg* msg;
+    struct gb_nl_msg* resp;
+    struct gb_stats lat;
+
+    uint64_t ops;
+    uint64_t errors;
+    uint64_t mismatches;
+    uint64_t late_ns;
+    int ret;
+};
+
+const char* gb_replay_pace_name(enum gb_replay_pace pace) {
+    switch (pace) {
+        case GB_REPLAY_PACE_ORIGINAL:
+            return "original";
+        case GB_REPLAY_PACE_MAX:
+            return "max";
+        default:
+            return "unknown";
+    }
+}
+
+int gb_replay_pace_parse(const char* name, enum gb_replay_pace* out) {
+    if (!name || !out)
+        return -EINVAL;
+
+    if (strcmp(name, "original") == 0)
+        *out = GB_REPLAY_PACE_ORIGINAL;
+    else if (strcmp(name, "max") == 0)
+        *out = GB_REPLAY_PACE_MAX;
+    else
+        return -EINVAL;
+
+    return 0;
+}
+
+static void replay_wait_until(uint64_t deadline_ns) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ull),
+        .tv_nsec = (long)(deadline_ns % 1000000000ull),
+    };
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* Issue one recorded request; returns 0 or the request's -errno */
+static int replay_issue(struct replay_worker* w, const struct gb_trace_record* rec) {
+    const struct nlmsghdr* nlh = gb_trace_payload(rec);
+    struct gb_dump_stats stats;
+    int ret;
+
+    memcpy(w->msg->buf, nlh, rec->len);
+    w->msg->len = rec->len;
+
+    if ((nlh->nlmsg_flags & NLM_F_DUMP) == NLM_F_DUMP && nlh->nlmsg_type != NLMSG_ERROR) {
+        ret = gb_nl_dump_action(w->sock, w->msg, &stats, w->cfg->timeout_ms);
+        if (ret == 0 && stats.saw_error)
+            ret = stats.error_code;
+        return ret;
+    }
+
+    return gb_nl_send_recv(w->sock, w->msg, w->resp, w->cfg->timeout_ms);
+}
+
+static void* replay_worker_main(void* arg) {
+    struct replay_worker* w = arg;
+
+    replay_wait_until(w->start_ns);
+
+    for (size_t i = 0; i < w->count; i++) {
+        const struct gb_trace_record* rec = w->recs[i];
+        uint64_t t0 = 0, t1 = 0;
+        int err;
+
+        if (w->pace == GB_REPLAY_PACE_ORIGINAL) {
+            uint64_t target = w->start_ns + rec->ts_ns;
+            uint64_t now = 0;
+
+            replay_wait_until(target);
+            (void)gb_util_ns_now(&now, CLOCK_MONOTONIC);
+            if (now > target && now - target > w->late_ns)
+                w->late_ns = now - target;
+        }
+
+        (void)gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+        err = replay_issue(w, rec);
+        (void)gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW);
+
+        w->ops++;
+        if (err != 0)
+            w->errors++;
+        if (rec->err != GB_TRACE_ERR_PENDING && rec->err != err)
+            w->mismatches++;
+
+        if (gb_stats_add(&w->lat, t1 - t0) < 0) {
+            w->ret = -ENOMEM;
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+int gb_replay_run(const struct gb_config* cfg, struct gb_replay_summary* summary) {
+    struct gb_trace_file file;
+    struct replay_worker* workers = NULL;
+    const struct gb_trace_record** recs = NULL;
+    pthread_t* threads = NULL;
+    size_t* fill = NULL;
+    struct gb_stats all;
+    const struct gb_trace_record* rec;
+    uint32_t nthreads = 0;
+    uint32_t started = 0;
+    uint64_t records = 0;
+    uint64_t last_ts = 0;
+    uint64_t end_ns = 0;
+    size_t max_len = 0;
+    size_t used = 0;
+    int ret;
+
+    if (!cfg || !cfg->replay_path || !summary)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&all, 0, sizeof(all));
+
+    ret = gb_trace_map(cfg->replay_path, &file);
+    if (ret < 0)
+        return ret;
+
+    /* Size per-thread schedules; the header count is not trusted for a cut-short capture */
+    for (rec = gb_trace_first(&file); rec; rec = gb_trace_next(&file, rec)) {
+        if (rec->len < NLMSG_HDRLEN)
+            continue;
+        if (rec->tid >= nthreads)
+            nthreads = rec->tid + 1u;
+        if (rec->len > max_len)
+            max_len = rec->len;
+        if (rec->ts_ns > last_ts)
+            last_ts = rec->ts_ns;
+        records++;
+    }
+
+    if (records == 0) {
+        ret = -ENODATA;
+        goto out;
+    }
+
+    workers = calloc(nthreads, sizeof(*workers));
+    threads = calloc(nthreads, sizeof(*threads));
+    fill = calloc(nthreads, sizeof(*fill));
+    recs = calloc((size_t)records, sizeof(*recs));
+    summary->per_thread = calloc(nthreads, sizeof(*summary->per_thread));
+    if (!workers || !threads || !fill || !recs || !summary->per_thread) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    for (rec = gb_trace_first(&file); rec; rec = gb_trace_next(&file, rec)) {
+        if (rec->len >= NLMSG_HDRLEN)
+            workers[rec->tid].count++;
+    }
+
+    for (uint32_t t = 0; t < nthreads; t++) {
+        workers[t].recs = recs + used;
+        used += workers[t].count;
+    }
+
+    for (rec = gb_trace_first(&file); rec; rec = gb_trace_next(&file, rec)) {
+        if (rec->len >= NLMSG_HDRLEN)
+            workers[rec->tid].recs[fill[rec->tid]++] = rec;
+    }
+
+    ret = gb_stats_init(&all, (size_t)records);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t t = 0; t < nthreads; t++) {
+        struct replay_worker* w = &workers[t];
+
+        w->cfg = cfg;
+        w->pace = (enum gb_replay_pace)cfg->replay_pace;
+        w->tid = t;
+
+        ret = gb_stats_init(&w->lat, w->count > 0 ? w->count : 1u);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_open(&w->sock);
+        if (ret < 0)
+            goto out;
+
+        w->msg = gb_nl_msg_alloc(max_len);
+        w->resp = gb_nl_msg_alloc(REPLAY_RESP_SIZE);
+        if (!w->msg || !w->resp) {
+            ret = -ENOMEM;
+            goto out;
+        }
+    }
+
+    ret = gb_util_ns_now(&workers[0].start_ns, CLOCK_MONOTONIC);
+    if (ret < 0)
+        goto out;
+    workers[0].start_ns += REPLAY_START_DELAY_NS;
+
+    for (uint32_t t = 0; t < nthreads; t++) {
+        workers[t].start_ns = workers[0].start_ns;
+
+        ret = -pthread_create(&threads[t], NULL, replay_worker_main, &workers[t]);
+        if (ret < 0)
+            goto join;
+        started++;
+    }
+
+join:
+    for (uint32_t t = 0; t < started; t++)
+        pthread_join(threads[t], NULL);
+    if (ret < 0)
+        goto out;
+
+    ret = gb_util_ns_now(&end_ns, CLOCK_MONOTONIC);
+    if (ret < 0)
+        goto out;
+
+    summary->threads = nthreads;
+    summary->records = records;
+    summary->pace = cfg->replay_pace;
+    summary->trace_secs = (double)last_ts / 1e9;
+    summary->secs = (double)(end_ns - workers[0].start_ns) / 1e9;
+
+    for (uint32_t t = 0; t < nthreads; t++) {
+        struct replay_worker* w = &workers[t];
+        struct gb_replay_thread_summary* ts = &summary->per_thread[t];
+
+        if (w->ret < 0) {
+            ret = w->ret;
+            goto out;
+        }
+
+        ts->tid = t;
+        ts->ops = w->ops;
+        ts->errors = w->errors;
+        ts->mismatches = w->mismatches;
+        ts->late_ns = w->late_ns;
+        summary->total_ops += w->ops;
+        summary->total_errors += w->errors;
+        summary->total_mismatches += w->mismatches;
+
+        for (size_t k = 0; k < w->lat.count; k++) {
+            ret = gb_stats_add(&all, w->lat.values[k]);
+            if (ret < 0)
+                goto out;
+        }
+
+        ret = gb_stats_summarize(&w->lat, &ts->latency);
+        if (ret < 0)
+            goto out;
+    }
+
+    if (summary->secs > 0.0)
+        summary->ops_per_sec = (double)summary->total_ops / summary->secs;
+
+    ret = gb_stats_summarize(&all, &summary->latency);
+
+out:
+    if (workers) {
+        for (uint32_t t = 0; t < nthreads; t++) {
+            gb_nl_close(workers[t].sock);
+            gb_nl_msg_free(workers[t].msg);
+            gb_nl_msg_free(workers[t].resp);
+            gb_stats_free(&workers[t].lat);
+        }
+        free(workers);
+    }
+    if (ret < 0)
+        gb_replay_summary_free(summary);
+    free(threads);
+    free(fill);
+    free(recs);
+    gb_stats_free(&all);
+    gb_trace_unmap(&file);
+    return ret;
+}
+
+void gb_replay_print_summary(const struct gb_replay_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg)
+        return;
+
+    printf("Replay: %u threads, %llu ops in %.3f s (%.1f ops/sec, pace %s, trace span %.3f s)\n", summary->threads,
+           (unsigned long long)summary->total_ops, summary->secs, summary->ops_per_sec,
+           gb_replay_pace_name((enum gb_replay_pace)summary->pace), summary->trace_secs);
+    printf("  Errors: %llu, errno mismatches vs. capture: %llu\n", (unsigned long long)summary->total_errors,
+           (unsigned long long)summary->total_mismatches);
+    printf("  Latency (all threads): p50 %llu ns, p95 %llu ns, p99 %llu ns, p999 %llu ns, max %llu ns\n",
+           (unsigned long long)summary->latency.p50_ns, (unsigned long long)summary->latency.p95_ns,
+           (unsigned long long)summary->latency.p99_ns, (unsigned long long)summary->latency.p999_ns,
+           (unsigned long long)summary->latency.max_ns);
+
+    if (!cfg->verbose || !summary->per_thread)
+        return;
+
+    for (uint32_t i = 0; i < summary->threads; i++) {
+        const struct gb_replay_thread_summary* ts = &summary->per_thread[i];
+
+        printf("  thread %3u: %llu ops, %llu errors, %llu mismatches, p50 %llu ns, p99 %llu ns, max late %llu ns\n",
+               ts->tid, (unsigned long long)ts->ops, (unsigned long long)ts->errors,
+               (unsigned long long)ts->mismatches, (unsigned long long)ts->latency.p50_ns,
+               (unsigned long long)ts->latency.p99_ns, (unsigned long long)ts->late_ns);
+    }
+}
+
+void gb_replay_summary_free(struct gb_replay_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_thread);
+    summary->per_thread = NULL;
+    summary->threads = 0;
+}
@@ -0,0 +1,509 @@
+/* src/rw.c
+ * Reader/writer contention: M threads replacing and R threads getting the
+ * same gate actions, to show how much a replace storm inflates the GET
+ * latency a monitoring agent sees, and what readers cost the writers.
+ */
+#include "../include/gatebench_rw.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RW_STATS_INITIAL 4096u
+
+struct rw_ctx {
+    const struct gb_config* cfg;
+    struct gate_shape shape;
+    struct gate_entry* entries;
+    uint32_t entry_count;
+    const int* cpus;
+    uint32_t cpu_count;
+
+    /* Start gate: every thread is set up before the cell starts */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t ready;
+    bool go;
+    atomic_bool stop;
+};
+
+struct rw_worker {
+    struct rw_ctx* ctx;
+    bool writer;
+    uint32_t id; /* Offset into the shared indices */
+    int cpu;
+
+    struct gb_stats lat;
+    uint64_t ops;
+    uint64_t errors;
+    int ret;
+};
+
+/* Report this thread set up (or failed) and wait for the common start */
+static void rw_ready_wait(struct rw_ctx* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    ctx->ready++;
+    pthread_cond_broadcast(&ctx->cond);
+    while (!ctx->go)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static int rw_writer_loop(struct rw_worker* w, struct gb_nl_sock* sock, struct gb_nl_msg* resp) {
+    struct rw_ctx* ctx = w->ctx;
+    const struct gb_config* cfg = ctx->cfg;
+    struct gate_tmpl* tmpl = NULL;
+    uint32_t j = w->id;
+    uint64_t a, b;
+    int ret;
+
+    ret = build_gate_newaction_tmpl(&tmpl, ctx->entry_count, cfg->index, &ctx->shape, ctx->entries, ctx->entry_count,
+                                    NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+    rw_ready_wait(ctx);
+    if (ret < 0)
+        return ret;
+
+    while (!atomic_load_explicit(&ctx->stop, memory_order_relaxed)) {
+        gate_tmpl_set_index(tmpl, cfg->index + j++ % cfg->rw_indices);
+
+        (void)gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+        ret = gb_nl_send_recv(sock, gate_tmpl_msg(tmpl), resp, cfg->timeout_ms);
+        (void)gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+
+        if (ret < 0) {
+            w->errors++;
+            continue;
+        }
+
+        ret = gb_stats_add(&w->lat, b - a);
+        if (ret < 0)
+            break;
+        w->ops++;
+    }
+
+    gate_tmpl_free(tmpl);
+    return ret < 0 && ret != -ENOMEM ? 0 : ret;
+}
+
+static int rw_reader_loop(struct rw_worker* w, struct gb_nl_sock* sock) {
+    struct rw_ctx* ctx = w->ctx;
+    const struct gb_config* cfg = ctx->cfg;
+    struct gate_dump dump;
+    uint32_t j = w->id;
+    uint64_t a, b;
+    int ret = 0;
+
+    memset(&dump, 0, sizeof(dump));
+    rw_ready_wait(ctx);
+
+    while (!atomic_load_explicit(&ctx->stop, memory_order_relaxed)) {
+        (void)gb_util_ns_now(&a, CLOCK_MONOTONIC_RAW);
+        ret = gb_nl_get_action(sock, cfg->index + j++ % cfg->rw_indices, &dump, cfg->timeout_ms);
+        (void)gb_util_ns_now(&b, CLOCK_MONOTONIC_RAW);
+
+        if (ret < 0) {
+            w->errors++;
+            continue;
+        }
+
+        ret = gb_stats_add(&w->lat, b - a);
+        if (ret < 0)
+            break;
+        w->ops++;
+    }
+
+    gb_gate_dump_free(&dump);
+    return ret < 0 && ret != -ENOMEM ? 0 : ret;
+}
+
+static void* rw_worker_main(void* arg) {
+    struct rw_worker* w = arg;
+    struct gb_nl_sock* sock = NULL;
+    struct gb_nl_msg* resp = NULL;
+
+    /* Running unpinned only blurs the grid; keep going */
+    if (w->cpu >= 0)
+        (void)gb_util_pin_cpu(w->cpu);
+
+    w->ret = gb_nl_open(&sock);
+    if (w->ret == 0) {
+        resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+        if (!resp)
+            w->ret = -ENOMEM;
+    }
+    if (w->ret < 0) {
+        rw_ready_wait(w->ctx);
+        goto out;
+    }
+
+    if (w->writer)
+        w->ret = rw_writer_loop(w, sock, resp);
+    else
+        w->ret = rw_reader_loop(w, sock);
+
+out:
+    gb_nl_msg_free(resp);
+    gb_nl_close(sock);
+    return NULL;
+}
+
+/* Merge the samples of one side into summary */
+static int rw_merge(struct rw_worker* workers,
+                    uint32_t first,
+                    uint32_t n,
+                    uint64_t* ops,
+                    uint64_t* errors,
+                    struct gb_latency_summary* out) {
+    struct gb_stats all;
+    int ret;
+
+    ret = gb_stats_init(&all, RW_STATS_INITIAL);
+    if (ret < 0)
+        return ret;
+
+    for (uint32_t i = first; i < first + n; i++) {
+        *ops += workers[i].ops;
+        *errors += workers[i].errors;
+        for (size_t k = 0; k < workers[i].lat.count; k++) {
+            ret = gb_stats_add(&all, workers[i].lat.values[k]);
+            if (ret < 0)
+                goto out;
+        }
+    }
+
+    ret = gb_stats_summarize(&all, out);
+
+out:
+    gb_stats_free(&all);
+    return ret;
+}
+
+static int rw_cell(struct rw_ctx* ctx, uint32_t writers, uint32_t readers, struct gb_rw_cell* out) {
+    const struct gb_config* cfg = ctx->cfg;
+    uint32_t n = writers + readers;
+    struct rw_worker* workers = NULL;
+    pthread_t* threads = NULL;
+    uint64_t start_ns = 0, end_ns = 0;
+    uint32_t started = 0;
+    int ret = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->writers = writers;
+    out->readers = readers;
+
+    workers = calloc(n, sizeof(*workers));
+    threads = calloc(n, sizeof(*threads));
+    if (!workers || !threads) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    /*
+     * Writers first, then readers; CPUs are handed out in that order, one
+     * thread each. Threads past the CPU count run unpinned rather than
+     * stacking on a CPU that already has a pinned thread.
+     */
+    for (uint32_t i = 0; i < n; i++) {
+        struct rw_worker* w = &workers[i];
+
+        w->ctx = ctx;
+        w->writer = i < writers;
+        w->id = w->writer ? i : i - writers;
+        w->cpu = i < ctx->cpu_count ? ctx->cpus[i] : -1;
+
+        ret = gb_stats_init(&w->lat, RW_STATS_INITIAL);
+        if (ret < 0)
+            goto out;
+    }
+
+    ctx->ready = 0;
+    ctx->go = false;
+    atomic_store(&ctx->stop, false);
+
+    for (uint32_t i = 0; i < n; i++) {
+        ret = -pthread_create(&threads[i], NULL, rw_worker_main, &workers[i]);
+        if (ret < 0)
+            break;
+        started++;
+    }
+
+    /* Release whoever started, even after a failed pthread_create */
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->ready < started)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    ctx->go = true;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    (void)gb_util_ns_now(&start_ns, CLOCK_MONOTONIC_RAW);
+    if (ret == 0)
+        (void)gb_util_sleep_ns((uint64_t)cfg->rw_ms * 1000000ull);
+    atomic_store(&ctx->stop, true);
+
+    for (uint32_t i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    (void)gb_util_ns_now(&end_ns, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (workers[i].ret < 0) {
+            ret = workers[i].ret;
+            goto out;
+        }
+    }
+
+    out->secs = (double)(end_ns - start_ns) / 1e9;
+
+    ret = rw_merge(workers, 0, writers, &out->writes, &out->write_errors, &out->write);
+    if (ret == 0)
+        ret = rw_merge(workers, writers, readers, &out->reads, &out->read_errors, &out->read);
+    if (ret < 0)
+        goto out;
+
+    if (out->secs > 0.0) {
+        out->writes_per_sec = (double)out->writes / out->secs;
+        out->reads_per_sec = (double)out->reads / out->secs;
+    }
+
+out:
+    if (workers) {
+        for (uint32_t i = 0; i < n; i++)
+            gb_stats_free(&workers[i].lat);
+    }
+    free(workers);
+    free(threads);
+    return ret;
+}
+
+/* Create (or, with del, delete) the shared actions */
+static int rw_setup(struct rw_ctx* ctx, bool del) {
+    const struct gb_config* cfg = ctx->cfg;
+    struct gb_nl_sock* sock = NULL;
+    struct gb_nl_msg* msg = NULL;
+    struct gb_nl_msg* resp = NULL;
+    int ret;
+
+    msg = gb_nl_msg_alloc(gate_msg_capacity(ctx->entry_count, 0));
+    resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!msg || !resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_nl_open(&sock);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < cfg->rw_indices; i++) {
+        gb_nl_msg_reset(msg);
+        if (del)
+            ret = build_gate_delaction(msg, cfg->index + i);
+        else
+            ret = build_gate_newaction(msg, cfg->index + i, &ctx->shape, ctx->entries, ctx->entry_count,
+                                       NLM_F_CREATE | NLM_F_REPLACE, 0, -1);
+        if (ret < 0)
+            goto out;
+
+        ret = gb_nl_send_recv(sock, msg, resp, cfg->timeout_ms);
+        if (del)
+            ret = 0;
+        if (ret < 0)
+            goto out;
+    }
+
+out:
+    gb_nl_close(sock);
+    gb_nl_msg_free(msg);
+    gb_nl_msg_free(resp);
+    return ret;
+}
+
+/* 0, 1, 2, 4, ... max (x2, ending at max); returns how many */
+static uint32_t rw_levels(uint32_t max, uint32_t* levels) {
+    uint32_t n = 0;
+
+    levels[n++] = 0;
+    for (uint32_t v = 1; v < max; v *= 2u)
+        levels[n++] = v;
+    if (max > 0)
+        levels[n++] = max;
+    return n;
+}
+
+int gb_rw_run(const struct gb_config* cfg, struct gb_rw_summary* summary) {
+    struct rw_ctx ctx;
+    uint32_t wl[16], rl[16];
+    uint32_t wn, rn;
+    int* cpus = NULL;
+    int cpu_count;
+    bool created = false;
+    int ret;
+
+    if (!cfg || !summary || cfg->rw_writers > GB_RW_MAX || cfg->rw_readers > GB_RW_MAX || cfg->rw_indices == 0 ||
+        cfg->rw_ms == 0)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
+    atomic_init(&ctx.stop, false);
+    ctx.entry_count = cfg->entries;
+    ctx.shape.clockid = cfg->clockid;
+    ctx.shape.base_time = cfg->base_time;
+    ctx.shape.cycle_time = cfg->cycle_time;
+    ctx.shape.cycle_time_ext = cfg->cycle_time_ext;
+    ctx.shape.interval_ns = cfg->interval_ns;
+    ctx.shape.entries = ctx.entry_count;
+
+    summary->writers = cfg->rw_writers;
+    summary->readers = cfg->rw_readers;
+    summary->indices = cfg->rw_indices;
+    summary->ms = cfg->rw_ms;
+
+    wn = rw_levels(cfg->rw_writers, wl);
+    rn = rw_levels(cfg->rw_readers, rl);
+
+    ctx.entries = calloc(ctx.entry_count > 0 ? ctx.entry_count : 1u, sizeof(*ctx.entries));
+    cpus = calloc(2u * GB_RW_MAX, sizeof(*cpus));
+    summary->per_cell = calloc((size_t)wn * rn, sizeof(*summary->per_cell));
+    if (!ctx.entries || !cpus || !summary->per_cell) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_fill_entries(ctx.entries, ctx.entry_count, cfg->interval_ns);
+    if (ret < 0)
+        goto out;
+
+    cpu_count = gb_util_collect_cpus(cpus, (int)(2u * GB_RW_MAX));
+    summary->cpus = cpu_count > 0 ? (uint32_t)cpu_count : 0;
+    ctx.cpus = cpus;
+    ctx.cpu_count = summary->cpus;
+
+    ret = rw_setup(&ctx, false);
+    if (ret < 0)
+        goto out;
+    created = true;
+
+    for (uint32_t i = 0; i < wn; i++) {
+        for (uint32_t k = 0; k < rn; k++) {
+            struct gb_rw_cell* c;
+
+            if (wl[i] == 0 && rl[k] == 0)
+                continue;
+
+            c = &summary->per_cell[summary->cells];
+            if (!cfg->json)
+                printf("  %3u writers, %3u readers... ", wl[i], rl[k]);
+            fflush(stdout);
+
+            ret = rw_cell(&ctx, wl[i], rl[k], c);
+            if (ret < 0) {
+                if (!cfg->json)
+                    printf("failed: %s\n", strerror(-ret));
+                goto out;
+            }
+            summary->cells++;
+
+            if (!cfg->json)
+                printf("done (%.1f reads/sec, %.1f writes/sec)\n", c->reads_per_sec, c->writes_per_sec);
+        }
+    }
+
+out:
+    if (created)
+        (void)rw_setup(&ctx, true);
+    if (ret < 0)
+        gb_rw_summary_free(summary);
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    free(cpus);
+    free(ctx.entries);
+    return ret;
+}
+
+/* Cell with exactly these counts (NULL = not run) */
+static const struct gb_rw_cell* rw_find(const struct gb_rw_summary* summary, uint32_t writers, uint32_t readers) {
+    for (uint32_t i = 0; i < summary->cells; i++) {
+        const struct gb_rw_cell* c = &summary->per_cell[i];
+
+        if (c->writers == writers && c->readers == readers)
+            return c;
+    }
+    return NULL;
+}
+
+void gb_rw_print_summary(const struct gb_rw_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || summary->cells == 0)
+        return;
+
+    printf("Reader/writer contention: %u shared actions, %u ms per cell, %u CPUs available\n", summary->indices,
+           summary->ms, summary->cpus);
+    printf("  %3s %3s %11s %9s %9s %9s %7s %11s %9s %9s %7s\n", "M", "R", "reads/s", "rd p50", "rd p99", "rd p999",
+           "rd p99x", "writes/s", "wr p50", "wr p99", "wr p99x");
+
+    for (uint32_t i = 0; i < summary->cells; i++) {
+        const struct gb_rw_cell* c = &summary->per_cell[i];
+        const struct gb_rw_cell* quiet;
+
+        printf("  %3u %3u", c->writers, c->readers);
+        if (c->readers > 0) {
+            printf(" %11.1f %7.1fus %7.1fus %7.1fus", c->reads_per_sec, (double)c->read.p50_ns / 1e3,
+                   (double)c->read.p99_ns / 1e3, (double)c->read.p999_ns / 1e3);
+            /* Reader p99 against the same readers with no writers */
+            quiet = rw_find(summary, 0, c->readers);
+            if (quiet && quiet->read.p99_ns > 0)
+                printf(" %6.2fx", (double)c->read.p99_ns / (double)quiet->read.p99_ns);
+            else
+                printf(" %7s", "-");
+        } else {
+            printf(" %11s %9s %9s %9s %7s", "-", "-", "-", "-", "-");
+        }
+
+        if (c->writers > 0) {
+            printf(" %11.1f %7.1fus %7.1fus", c->writes_per_sec, (double)c->write.p50_ns / 1e3,
+                   (double)c->write.p99_ns / 1e3);
+            /* Writer p99 against the same writers with no readers */
+            quiet = rw_find(summary, c->writers, 0);
+            if (quiet && quiet->write.p99_ns > 0)
+                printf(" %6.2fx\n", (double)c->write.p99_ns / (double)quiet->write.p99_ns);
+            else
+                printf(" %7s\n", "-");
+        } else {
+            printf(" %11s %9s %9s %7s\n", "-", "-", "-", "-");
+        }
+    }
+
+    for (uint32_t i = 0; i < summary->cells; i++) {
+        const struct gb_rw_cell* c = &summary->per_cell[i];
+
+        if (c->read_errors == 0 && c->write_errors == 0 && !cfg->verbose)
+            continue;
+
+        printf("  M=%u R=%u: %llu read errors, %llu write errors\n", c->writers, c->readers,
+               (unsigned long long)c->read_errors, (unsigned long long)c->write_errors);
+    }
+}
+
+void gb_rw_summary_free(struct gb_rw_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_cell);
+    summary->per_cell = NULL;
+    summary->cells = 0;
+}
@@ -9,6 +9,9 @@
 #include <stdbool.h>
 #include <string.h>
 
+/* Needs clsact and a real packet path; soft-fails on the loopback backend */
+#define DATAPATH_GATE_TIMER_START "gate timer start logic"
+
 static const struct gb_selftest_case internal_tests[] = {
     {"schedule pattern", gb_selftest_internal_schedule_pattern, 0},
 };
@@ -26,7 +29,7 @@ static const struct gb_selftest_case stable_tests[] = {
     {"duplicate create", gb_selftest_duplicate_create, -EEXIST},
     {"replace preserve schedule", gb_selftest_replace_preserve_schedule, 0},
     {"replace RCU snapshot", gb_selftest_replace_rcu_snapshot, 0},
-    {"gate timer start logic", gb_selftest_gate_timer_start_logic, 0},
+    {DATAPATH_GATE_TIMER_START, gb_selftest_gate_timer_start_logic, 0},
     {"base time update", gb_selftest_base_time_update, 0},
     {"replace persistence", gb_selftest_replace_persistence, 0},
     {"replace preserve attrs", gb_selftest_replace_preserve_attrs, 0},
@@ -227,6 +230,8 @@ int gb_selftest_run(struct gb_config* cfg) {
     static const char* const historical_fail_tests[] = {HISTORICAL_CREATE_MISSING_ENTRY_LIST,
                                                         HISTORICAL_CREATE_EMPTY_ENTRY_LIST, HISTORICAL_REPLACE_APPEND};
     static const char* const unpatched_fail_tests[] = {UNPATCHED_LARGE_DUMP};
+    static const char* const loopback_fail_tests[] = {DATAPATH_GATE_TIMER_START};
+    bool loopback = gb_nl_get_backend() == GB_NL_BACKEND_LOOPBACK;
 
     base_index = cfg->index;
     verbose = cfg->verbose && !cfg->json;
@@ -242,7 +247,10 @@ int gb_selftest_run(struct gb_config* cfg) {
     }
 
     ret_stable = run_test_suite("stable regression", "stable", stable_tests, NUM_STABLE_TESTS, sock, base_index,
-                                &stable_passed, &stable_failed, &stable_soft_failed, NULL, 0, NULL, verbose, cfg->json);
+                                &stable_passed, &stable_failed, &stable_soft_failed,
+                                loopback ? loopback_fail_tests : NULL,
+                                loopback ? sizeof(loopback_fail_tests) / sizeof(loopback_fail_tests[0]) : 0, NULL,
+                                verbose, cfg->json);
 
     ret_historical =
         run_test_suite("historical behavior", "historical", historical_tests, NUM_HISTORICAL_TESTS, sock,
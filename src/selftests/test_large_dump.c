@@ -4,35 +4,148 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Second, much larger schedule. Replies carry 40 bytes per entry, so this is
+ * about the largest GET reply that still fits its 64 KiB action nest.
+ */
+#define GB_LARGE_DUMP_MAX_ENTRIES 1536u
+
+static void large_dump_fill(struct gate_entry* entries, uint32_t num_entries, uint64_t* cycle_time) {
+    *cycle_time = 0;
+    for (uint32_t i = 0; i < num_entries; i++) {
+        gb_selftest_entry_default(&entries[i]);
+        entries[i].index = i;
+        entries[i].interval = 100000 + i;
+        entries[i].gate_state = (i % 2) == 0;
+        *cycle_time += entries[i].interval;
+    }
+}
+
+/* GET the action back and compare every entry; a clean error is not a mismatch */
+static int large_dump_verify(struct gb_nl_sock* sock,
+                             uint32_t index,
+                             const struct gate_entry* entries,
+                             uint32_t num_entries,
+                             bool allow_get_error) {
+    struct gate_dump dump;
+    int ret;
+
+    memset(&dump, 0, sizeof(dump));
+    ret = gb_nl_get_action(sock, index, &dump, GB_SELFTEST_TIMEOUT_MS);
+    if (ret < 0) {
+        gb_selftest_log("Large dump get_action of %u entries failed: %d (%s)\n", num_entries, ret,
+                        gb_nl_strerror(ret));
+        return allow_get_error ? 0 : ret;
+    }
+
+    ret = 0;
+    if (dump.num_entries != num_entries) {
+        gb_selftest_log("Large dump failed: got %u entries, expected %u\n", dump.num_entries, num_entries);
+        ret = -EINVAL;
+    }
+    else {
+        for (uint32_t i = 0; i < num_entries; i++) {
+            if (dump.entries[i].index != i || dump.entries[i].interval != entries[i].interval ||
+                dump.entries[i].gate_state != entries[i].gate_state) {
+                gb_selftest_log("Large dump data mismatch at entry %u of %u\n", i, num_entries);
+                ret = -EINVAL;
+                break;
+            }
+        }
+    }
+
+    gb_gate_dump_free(&dump);
+    return ret;
+}
+
+/* What a dump visit found for the action under test */
+struct large_dump_visit {
+    uint32_t index;
+    const struct gate_entry* entries;
+    uint32_t next; /* Entries of the action under test checked so far */
+    bool seen;
+    bool mismatch;
+};
+
+static int large_dump_visit_entry(const struct gate_entry* entry, void* arg) {
+    struct large_dump_visit* v = arg;
+    const struct gate_entry* want = &v->entries[v->next];
+
+    if (entry->index != v->next || entry->interval != want->interval || entry->gate_state != want->gate_state)
+        v->mismatch = true;
+    v->next++;
+    return 0;
+}
+
+static int large_dump_visit_action(const struct gate_view* view, void* arg) {
+    struct large_dump_visit* v = arg;
+
+    if (view->action.index != v->index)
+        return 0;
+
+    v->seen = true;
+    v->next = 0;
+    return gb_gate_view_entries(view, large_dump_visit_entry, v);
+}
+
+/* Dump through the zero-copy visitor, serially or pipelined, and check the action in place */
+static int large_dump_visit_check(struct gb_nl_sock* sock,
+                                  struct gb_nl_msg* msg,
+                                  uint32_t index,
+                                  const struct gate_entry* entries,
+                                  uint32_t num_entries,
+                                  bool pipelined) {
+    struct large_dump_visit v;
+    struct gb_dump_stats stats;
+    int ret;
+
+    memset(&v, 0, sizeof(v));
+    v.index = index;
+    v.entries = entries;
+
+    gb_nl_msg_reset(msg);
+    ret = build_gate_getaction_ex(msg, index, NLM_F_DUMP);
+    if (ret < 0)
+        return ret;
+
+    ret = gb_nl_dump_visit(sock, msg, large_dump_visit_action, &v, pipelined, &stats, GB_SELFTEST_TIMEOUT_MS);
+    if (ret < 0) {
+        gb_selftest_log("Large dump visit (%s) failed: %d (%s)\n", pipelined ? "pipelined" : "serial", ret,
+                        gb_nl_strerror(ret));
+        return ret;
+    }
+
+    if (stats.saw_error || !stats.saw_done || !v.seen || v.mismatch || v.next != num_entries) {
+        gb_selftest_log("Large dump visit (%s) mismatch: done=%d seen=%d entries=%u/%u\n",
+                        pipelined ? "pipelined" : "serial", stats.saw_done ? 1 : 0, v.seen ? 1 : 0, v.next,
+                        num_entries);
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
 /* Test dumping a large number of entries to check for truncation or buffer issues */
 int gb_selftest_large_dump(struct gb_nl_sock* sock, uint32_t base_index) {
     struct gb_nl_msg* msg = NULL;
     struct gb_nl_msg* resp = NULL;
     struct gate_shape shape;
     struct gate_entry* entries;
-    struct gate_dump dump;
     struct gb_dump_stats dump_stats;
-    const uint32_t num_entries = 93; /* Significant but should fit in typical netlink msg */
+    const uint32_t num_entries = 93; /* Fits a single default-sized reply page */
     uint64_t cycle_time = 0;
     int ret;
     int test_ret = 0;
-    bool dump_valid = false;
 
-    entries = calloc(num_entries, sizeof(*entries));
+    entries = calloc(GB_LARGE_DUMP_MAX_ENTRIES, sizeof(*entries));
     if (!entries)
         return -ENOMEM;
 
     gb_selftest_shape_default(&shape, num_entries);
-    for (uint32_t i = 0; i < num_entries; i++) {
-        gb_selftest_entry_default(&entries[i]);
-        entries[i].index = i;
-        entries[i].interval = 100000 + i;
-        entries[i].gate_state = (i % 2) == 0;
-        cycle_time += entries[i].interval;
-    }
+    large_dump_fill(entries, num_entries, &cycle_time);
     shape.cycle_time = cycle_time;
 
-    ret = gb_selftest_alloc_msgs(&msg, &resp, gate_msg_capacity(num_entries, 0));
+    ret = gb_selftest_alloc_msgs(&msg, &resp, gate_msg_capacity(GB_LARGE_DUMP_MAX_ENTRIES, 0));
     if (ret < 0) {
         free(entries);
         return ret;
@@ -57,35 +170,43 @@ int gb_selftest_large_dump(struct gb_nl_sock* sock, uint32_t base_index) {
         goto cleanup;
     }
 
-    /* Verify dump */
-    ret = gb_nl_get_action(sock, base_index, &dump, GB_SELFTEST_TIMEOUT_MS);
+    test_ret = large_dump_verify(sock, base_index, entries, num_entries, false);
+    if (test_ret < 0)
+        goto cleanup;
+
+    test_ret = large_dump_visit_check(sock, msg, base_index, entries, num_entries, false);
+    if (test_ret < 0)
+        goto cleanup;
+
+    test_ret = large_dump_visit_check(sock, msg, base_index, entries, num_entries, true);
+    if (test_ret < 0)
+        goto cleanup;
+
+    /*
+     * Replace with a schedule far past one reply page. The kernel may refuse
+     * it or fail the GET outright, but it must never hand back a short list.
+     */
+    gb_selftest_shape_default(&shape, GB_LARGE_DUMP_MAX_ENTRIES);
+    large_dump_fill(entries, GB_LARGE_DUMP_MAX_ENTRIES, &cycle_time);
+    shape.cycle_time = cycle_time;
+
+    gb_nl_msg_reset(msg);
+    ret = build_gate_newaction(msg, base_index, &shape, entries, GB_LARGE_DUMP_MAX_ENTRIES, NLM_F_REPLACE, 0, -1);
     if (ret < 0) {
-        gb_selftest_log("Large dump get_action failed: %d (%s)\n", ret, gb_nl_strerror(ret));
         test_ret = ret;
         goto cleanup;
     }
-    dump_valid = true;
 
-    if (dump.num_entries != num_entries) {
-        gb_selftest_log("Large dump failed: got %u entries, expected %u\n", dump.num_entries, num_entries);
-        test_ret = -EINVAL;
-    }
-    else {
-        /* Check a few entries */
-        for (uint32_t i = 0; i < num_entries; i++) {
-            if (dump.entries[i].index != i || dump.entries[i].interval != entries[i].interval ||
-                dump.entries[i].gate_state != entries[i].gate_state) {
-                gb_selftest_log("Large dump data mismatch at entry %u\n", i);
-                test_ret = -EINVAL;
-                break;
-            }
-        }
+    ret = gb_nl_send_recv(sock, msg, resp, GB_SELFTEST_TIMEOUT_MS);
+    if (ret < 0) {
+        gb_selftest_log("DEBUG: kernel refused %u-entry replace: %d (%s)\n", GB_LARGE_DUMP_MAX_ENTRIES, ret,
+                        gb_nl_strerror(ret));
+        goto cleanup;
     }
 
-cleanup:
-    if (dump_valid)
-        gb_gate_dump_free(&dump);
+    test_ret = large_dump_verify(sock, base_index, entries, GB_LARGE_DUMP_MAX_ENTRIES, true);
 
+cleanup:
     gb_selftest_cleanup_gate(sock, msg, resp, base_index);
     gb_nl_msg_reset(msg);
     ret = build_gate_flushaction(msg);
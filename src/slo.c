@@ -0,0 +1,202 @@
+/* src/slo.c
+ * Capacity at SLO: search the open-loop offered rate for the knee where
+ * the chosen response latency percentile crosses the bound.
+ */
+#include "../include/gatebench_slo.h"
+#include "../include/gatebench_open_loop.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stop bisecting once the bracket is this narrow, relative to its low end */
+#define SLO_PRECISION 0.02
+
+uint64_t gb_slo_pct_ns(const struct gb_latency_summary* lat, uint32_t pct_permille) {
+    if (!lat)
+        return 0;
+
+    switch (pct_permille) {
+        case 500:
+            return lat->p50_ns;
+        case 950:
+            return lat->p95_ns;
+        case 999:
+            return lat->p999_ns;
+        default:
+            return lat->p99_ns;
+    }
+}
+
+/* The last probe failed on service latency, which does not drop with the rate */
+static bool slo_hopeless(const struct gb_slo_summary* summary) {
+    const struct gb_slo_probe* p = &summary->probe[summary->probes - 1u];
+
+    return !p->pass && gb_slo_pct_ns(&p->result.service, summary->pct_permille) > summary->bound_ns;
+}
+
+/* Replaces in a probe at rate: what GB_SLO_PROBE_SECS allows, kept between min_ops and iters */
+static uint32_t slo_probe_ops(const struct gb_config* cfg, const struct gb_slo_summary* summary, double rate) {
+    double budget = ceil(rate * (double)GB_SLO_PROBE_SECS);
+    uint32_t ops = budget < (double)cfg->iters ? (uint32_t)budget : cfg->iters;
+
+    if (ops < summary->min_ops)
+        ops = summary->min_ops < cfg->iters ? summary->min_ops : cfg->iters;
+    return ops;
+}
+
+static int slo_probe(const struct gb_config* cfg, struct gb_slo_summary* summary, double rate, bool* pass) {
+    struct gb_slo_probe* p;
+    int ret;
+
+    if (summary->probes >= GB_SLO_PROBES_MAX)
+        return -E2BIG;
+
+    p = &summary->probe[summary->probes];
+    memset(p, 0, sizeof(*p));
+    p->rate = rate;
+    p->ops = slo_probe_ops(cfg, summary, rate);
+
+    if (!cfg->json)
+        printf("  %12.1f ops/sec x %u... ", rate, p->ops);
+    fflush(stdout);
+
+    ret = gb_open_loop_run(cfg, rate, p->ops, &p->result);
+    if (ret < 0) {
+        if (!cfg->json)
+            printf("failed: %s\n", strerror(-ret));
+        return ret;
+    }
+
+    p->pct_ns = gb_slo_pct_ns(&p->result.response, summary->pct_permille);
+    p->pass = p->result.errors == 0 && p->pct_ns <= summary->bound_ns;
+    *pass = p->pass;
+
+    if (p->pass && rate > summary->knee_rate) {
+        summary->knee_rate = rate;
+        summary->knee = (int)summary->probes;
+    }
+    summary->probes++;
+
+    if (!cfg->json)
+        printf("%s (p%.1f %.1f us, achieved %.1f ops/sec)\n", p->pass ? "pass" : "FAIL",
+               (double)summary->pct_permille / 10.0, (double)p->pct_ns / 1e3, p->result.achieved_rate);
+    return 0;
+}
+
+int gb_slo_run(const struct gb_config* cfg, struct gb_slo_summary* summary) {
+    double lo = 0.0, hi = 0.0, rate;
+    bool pass;
+    int ret;
+
+    if (!cfg || !summary || cfg->slo_ns == 0)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    summary->bound_ns = cfg->slo_ns;
+    summary->pct_permille = cfg->slo_pct;
+    summary->knee = -1;
+    /* Ten samples beyond the percentile, so p99 rests on 1000 replaces */
+    summary->min_ops = 10u * 1000u / (1000u - (cfg->slo_pct < 999u ? cfg->slo_pct : 999u));
+    summary->min_rate = (double)summary->min_ops / (double)GB_SLO_PROBE_SECS;
+
+    rate = cfg->rate > 0 ? (double)cfg->rate : (double)GB_SLO_START_RATE;
+
+    ret = slo_probe(cfg, summary, rate, &pass);
+    if (ret < 0)
+        return ret;
+
+    /* Bracket the knee: lo passes, hi fails */
+    if (pass) {
+        lo = rate;
+        while (hi == 0.0 && rate < (double)GB_OPEN_LOOP_RATE_MAX) {
+            rate *= 2.0;
+            if (rate > (double)GB_OPEN_LOOP_RATE_MAX)
+                rate = (double)GB_OPEN_LOOP_RATE_MAX;
+            ret = slo_probe(cfg, summary, rate, &pass);
+            if (ret < 0)
+                return ret;
+            if (pass)
+                lo = rate;
+            else
+                hi = rate;
+        }
+    } else {
+        hi = rate;
+        /*
+         * Response time is at least service time: once service alone breaks
+         * the bound, slower probes cannot pass and would only take longer.
+         */
+        while (lo == 0.0 && rate / 2.0 >= summary->min_rate && !slo_hopeless(summary)) {
+            rate /= 2.0;
+            ret = slo_probe(cfg, summary, rate, &pass);
+            if (ret < 0)
+                return ret;
+            if (pass)
+                lo = rate;
+            else
+                hi = rate;
+        }
+    }
+
+    /* Never failed up to the cap, or never passed down to min_rate */
+    if (lo == 0.0 || hi == 0.0)
+        return 0;
+
+    while (hi - lo > lo * SLO_PRECISION && summary->probes < GB_SLO_PROBES_MAX) {
+        rate = (lo + hi) / 2.0;
+        ret = slo_probe(cfg, summary, rate, &pass);
+        if (ret < 0)
+            return ret;
+        if (pass)
+            lo = rate;
+        else
+            hi = rate;
+    }
+
+    return 0;
+}
+
+static int slo_cmp_rate(const void* a, const void* b) {
+    double x = ((const struct gb_slo_probe*)a)->rate;
+    double y = ((const struct gb_slo_probe*)b)->rate;
+
+    return (x > y) - (x < y);
+}
+
+void gb_slo_print_summary(const struct gb_slo_summary* summary, const struct gb_config* cfg) {
+    struct gb_slo_probe curve[GB_SLO_PROBES_MAX];
+    double pct;
+
+    if (!summary || !cfg || summary->probes == 0)
+        return;
+
+    pct = (double)summary->pct_permille / 10.0;
+    printf("Capacity at SLO: p%.1f response latency <= %.1f us, %s arrivals\n", pct, (double)summary->bound_ns / 1e3,
+           gb_arrivals_name((enum gb_arrivals)cfg->arrivals));
+    printf("  Probes: up to %u replaces or %u s each, at least %u replaces (no probes below %.1f ops/sec)\n",
+           cfg->iters, GB_SLO_PROBE_SECS, summary->min_ops < cfg->iters ? summary->min_ops : cfg->iters,
+           summary->min_rate);
+    if (summary->knee >= 0)
+        printf("  Knee: %.1f ops/sec (p%.1f %.1f us)\n", summary->knee_rate, pct,
+               (double)summary->probe[summary->knee].pct_ns / 1e3);
+    else
+        printf("  Knee: none, no probe met the SLO\n");
+
+    /* The curve reads better by rate than in search order */
+    memcpy(curve, summary->probe, (size_t)summary->probes * sizeof(curve[0]));
+    qsort(curve, summary->probes, sizeof(curve[0]), slo_cmp_rate);
+
+    printf("  %12s %12s %8s %10s %10s %10s %10s %10s %5s\n", "offered/s", "achieved/s", "ops", "svc p99", "resp p50",
+           "resp p99", "resp p999", "resp max", "SLO");
+    for (uint32_t i = 0; i < summary->probes; i++) {
+        const struct gb_slo_probe* p = &curve[i];
+        const struct gb_open_loop_result* r = &p->result;
+
+        printf("  %12.1f %12.1f %8u %8.1fus %8.1fus %8.1fus %8.1fus %8.1fus %5s\n", p->rate, r->achieved_rate, p->ops,
+               (double)r->service.p99_ns / 1e3, (double)r->response.p50_ns / 1e3, (double)r->response.p99_ns / 1e3,
+               (double)r->response.p999_ns / 1e3, (double)r->response.max_ns / 1e3, p->pass ? "ok" : "FAIL");
+    }
+}
@@ -238,6 +238,19 @@ int gb_stats_calculate(struct gb_stats* stats,
     return 0;
 }
 
+int gb_stats_summarize(struct gb_stats* stats, struct gb_latency_summary* out) {
+    if (!stats || !out)
+        return -EINVAL;
+
+    memset(out, 0, sizeof(*out));
+    if (stats->count == 0)
+        return 0;
+
+    out->count = stats->count;
+    return gb_stats_calculate(stats, &out->min_ns, &out->max_ns, &out->mean_ns, &out->stddev_ns, &out->p50_ns,
+                              &out->p95_ns, &out->p99_ns, &out->p999_ns);
+}
+
 int gb_stats_median_double(const double* values, size_t count, double* out) {
     double* copy;
 
@@ -0,0 +1,365 @@
+/* src/teardown.c
+ * Bulk teardown: how long deleting a large gate population takes one action
+ * at a time, in multi-index batches and with a single flush.
+ */
+#include "../include/gatebench_teardown.h"
+#include "../include/gatebench_gate.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <libmnl/libmnl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Smallest population of the sweep; sizes grow x4 from here */
+#define TEARDOWN_MIN_ACTIONS 256u
+
+struct teardown_ctx {
+    const struct gb_config* cfg;
+    struct gb_nl_sock* sock;
+    struct gb_populator pop;
+    struct gb_nl_msg* del_msg;
+    struct gb_nl_msg* flush_msg;
+    struct gb_nl_msg* dump_msg;
+    struct gb_nl_msg* resp;
+};
+
+/* Fill idx with the indices of actions off.. (at most max of them, stopping at n) */
+static uint32_t teardown_indices(const struct teardown_ctx* ctx, uint32_t off, uint32_t n, uint32_t max, uint32_t* idx) {
+    uint32_t k = n - off < max ? n - off : max;
+
+    for (uint32_t j = 0; j < k; j++)
+        idx[j] = ctx->cfg->index + off + j;
+
+    return k;
+}
+
+/*
+ * A kernel flush walks and frees the whole table under rtnl before it acks,
+ * so give it the normal timeout plus one more per 10k actions.
+ */
+static int teardown_flush_timeout(const struct gb_config* cfg, uint32_t n) {
+    uint64_t t = (uint64_t)cfg->timeout_ms * (1u + n / 10000u);
+
+    return t > INT32_MAX ? INT32_MAX : (int)t;
+}
+
+static int teardown_populate(struct teardown_ctx* ctx, uint32_t n, struct gb_teardown_step* step, double* secs) {
+    uint64_t t0, t1;
+    int ret;
+
+    ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+
+    ret = gb_populate(&ctx->pop, ctx->sock, ctx->resp, 0, n, false, &step->populate_errors);
+    if (ret < 0)
+        return ret;
+
+    if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+        return -EIO;
+
+    *secs += (double)(t1 - t0) / 1e9;
+    return 0;
+}
+
+/* Gate actions the kernel still reports */
+static uint32_t teardown_left(struct teardown_ctx* ctx) {
+    struct gb_dump_stats stats;
+
+    if (gb_nl_dump_action(ctx->sock, ctx->dump_msg, &stats, ctx->cfg->timeout_ms) < 0 || stats.saw_error)
+        return UINT32_MAX;
+
+    return stats.action_count;
+}
+
+static int teardown_single(struct teardown_ctx* ctx, uint32_t n, struct gb_teardown_method* m) {
+    for (uint32_t i = 0; i < n; i++) {
+        int ret;
+
+        gb_nl_msg_reset(ctx->del_msg);
+        ret = build_gate_delaction(ctx->del_msg, ctx->cfg->index + i);
+        if (ret < 0)
+            return ret;
+
+        m->msgs++;
+        if (gb_nl_send_recv(ctx->sock, ctx->del_msg, ctx->resp, ctx->cfg->timeout_ms) < 0)
+            m->errors++;
+    }
+
+    return 0;
+}
+
+static int teardown_batch(struct teardown_ctx* ctx, uint32_t n, struct gb_teardown_method* m) {
+    uint32_t idx[GB_MULTI_ACTIONS_MAX];
+    uint32_t k;
+
+    for (uint32_t off = 0; off < n; off += k) {
+        int ret;
+
+        k = teardown_indices(ctx, off, n, GB_MULTI_ACTIONS_MAX, idx);
+
+        gb_nl_msg_reset(ctx->del_msg);
+        ret = build_gate_delaction_multi(ctx->del_msg, idx, k);
+        if (ret < 0)
+            return ret;
+
+        m->msgs++;
+        if (gb_nl_send_recv(ctx->sock, ctx->del_msg, ctx->resp, ctx->cfg->timeout_ms) < 0)
+            m->errors++;
+    }
+
+    return 0;
+}
+
+static int teardown_flush(struct teardown_ctx* ctx, uint32_t n, struct gb_teardown_method* m, uint32_t* fcnt) {
+    m->msgs++;
+    if (gb_nl_send_recv_flush(ctx->sock, ctx->flush_msg, ctx->resp, teardown_flush_timeout(ctx->cfg, n), fcnt) < 0)
+        m->errors++;
+
+    return 0;
+}
+
+enum teardown_kind {
+    TEARDOWN_SINGLE,
+    TEARDOWN_BATCH,
+    TEARDOWN_FLUSH,
+};
+
+/* Populate n actions, then time one teardown method and count what is left */
+static int teardown_measure(struct teardown_ctx* ctx,
+                            uint32_t n,
+                            enum teardown_kind kind,
+                            struct gb_teardown_step* step,
+                            double* populate_secs) {
+    struct gb_teardown_method* m;
+    uint64_t t0, t1;
+    int ret;
+
+    ret = teardown_populate(ctx, n, step, populate_secs);
+    if (ret < 0)
+        return ret;
+
+    ret = gb_util_ns_now(&t0, CLOCK_MONOTONIC_RAW);
+    if (ret < 0)
+        return ret;
+
+    switch (kind) {
+        case TEARDOWN_SINGLE:
+            m = &step->single;
+            ret = teardown_single(ctx, n, m);
+            break;
+        case TEARDOWN_BATCH:
+            m = &step->batch;
+            ret = teardown_batch(ctx, n, m);
+            break;
+        case TEARDOWN_FLUSH:
+        default:
+            m = &step->flush;
+            ret = teardown_flush(ctx, n, m, &step->flush_count);
+            break;
+    }
+    if (ret < 0)
+        return ret;
+
+    if (gb_util_ns_now(&t1, CLOCK_MONOTONIC_RAW) < 0)
+        return -EIO;
+
+    m->secs = (double)(t1 - t0) / 1e9;
+    m->actions_per_sec = m->secs > 0.0 ? (double)n / m->secs : 0.0;
+    m->left = teardown_left(ctx);
+
+    /* Whatever a method left behind must not collide with the next population */
+    if (m->left != 0)
+        (void)gb_nl_send_recv_flush(ctx->sock, ctx->flush_msg, ctx->resp, teardown_flush_timeout(ctx->cfg, n),
+                                    NULL);
+
+    return 0;
+}
+
+static int teardown_step(struct teardown_ctx* ctx, uint32_t n, struct gb_teardown_step* step) {
+    double populate_secs = 0.0;
+    int ret;
+
+    memset(step, 0, sizeof(*step));
+    step->actions = n;
+    step->flush_count = UINT32_MAX;
+
+    ret = teardown_measure(ctx, n, TEARDOWN_SINGLE, step, &populate_secs);
+    if (ret == 0)
+        ret = teardown_measure(ctx, n, TEARDOWN_BATCH, step, &populate_secs);
+    if (ret == 0)
+        ret = teardown_measure(ctx, n, TEARDOWN_FLUSH, step, &populate_secs);
+
+    if (ret < 0) {
+        /* A refused population is a result; clean up and let the sweep stop */
+        (void)gb_nl_send_recv_flush(ctx->sock, ctx->flush_msg, ctx->resp, teardown_flush_timeout(ctx->cfg, n), NULL);
+        step->error = -ret;
+        return 0;
+    }
+
+    if (populate_secs > 0.0)
+        step->populate_actions_per_sec = 3.0 * (double)n / populate_secs;
+
+    return 0;
+}
+
+static uint32_t teardown_points(uint32_t max, uint32_t* out) {
+    uint32_t n = 0;
+
+    for (uint32_t a = TEARDOWN_MIN_ACTIONS; a < max; a *= 4u)
+        out[n++] = a;
+    out[n++] = max;
+
+    return n;
+}
+
+int gb_teardown_run(const struct gb_config* cfg, struct gb_teardown_summary* summary) {
+    struct teardown_ctx ctx;
+    struct nlmsghdr* nlh;
+    uint32_t sweep[16];
+    uint32_t steps;
+    int ret;
+
+    if (!cfg || !summary || cfg->teardown == 0 || cfg->teardown > GB_TEARDOWN_MAX)
+        return -EINVAL;
+
+    if (cfg->index > UINT32_MAX - cfg->teardown)
+        return -ERANGE;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.cfg = cfg;
+
+    steps = teardown_points(cfg->teardown, sweep);
+    summary->per_step = calloc(steps, sizeof(*summary->per_step));
+    ctx.del_msg = gb_nl_msg_alloc(4096);
+    ctx.flush_msg = gb_nl_msg_alloc(1024);
+    ctx.dump_msg = gb_nl_msg_alloc(1024);
+    ctx.resp = gb_nl_msg_alloc((size_t)MNL_SOCKET_BUFFER_SIZE);
+    if (!summary->per_step || !ctx.del_msg || !ctx.flush_msg || !ctx.dump_msg || !ctx.resp) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    ret = gb_populator_init(&ctx.pop, cfg);
+    if (ret < 0)
+        goto out;
+    summary->populate_batch = ctx.pop.batch;
+
+    ret = build_gate_dumpaction(ctx.dump_msg);
+    if (ret < 0)
+        goto out;
+
+    /* The kernel only unicasts the TCA_FCNT notification back when asked to echo */
+    ret = build_gate_flushaction(ctx.flush_msg);
+    if (ret < 0)
+        goto out;
+    nlh = (struct nlmsghdr*)ctx.flush_msg->buf;
+    nlh->nlmsg_flags |= NLM_F_ECHO;
+
+    ret = gb_nl_open(&ctx.sock);
+    if (ret < 0)
+        goto out;
+
+    /* Start from an empty table so create never hits a leftover index */
+    (void)gb_nl_send_recv_flush(ctx.sock, ctx.flush_msg, ctx.resp, teardown_flush_timeout(cfg, cfg->teardown), NULL);
+
+    for (uint32_t s = 0; s < steps; s++) {
+        struct gb_teardown_step* st = &summary->per_step[s];
+
+        if (!cfg->json)
+            printf("  %7u actions... ", sweep[s]);
+        fflush(stdout);
+
+        ret = teardown_step(&ctx, sweep[s], st);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->steps = s + 1u;
+
+        if (st->error != 0) {
+            if (!cfg->json)
+                printf("populate failed: %s\n", strerror(st->error));
+            break;
+        }
+
+        if (!cfg->json)
+            printf("done (flush %.3f ms)\n", st->flush.secs * 1e3);
+    }
+
+out:
+    gb_nl_close(ctx.sock);
+    gb_populator_free(&ctx.pop);
+    gb_nl_msg_free(ctx.del_msg);
+    gb_nl_msg_free(ctx.flush_msg);
+    gb_nl_msg_free(ctx.dump_msg);
+    gb_nl_msg_free(ctx.resp);
+    if (ret < 0)
+        gb_teardown_summary_free(summary);
+    return ret;
+}
+
+void gb_teardown_print_summary(const struct gb_teardown_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || summary->steps == 0)
+        return;
+
+    printf("Teardown: deleting N gate actions (populated %u per message)\n", summary->populate_batch);
+    printf("  %7s %12s %12s %12s %12s %12s %12s %9s %6s\n", "N", "populate/s", "single/s", "batch/s", "flush ms",
+           "flush/s", "flush ns/act", "fcnt", "left");
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_teardown_step* st = &summary->per_step[s];
+        uint32_t left = st->single.left;
+
+        if (st->error != 0) {
+            printf("  %7u populate failed: %s\n", st->actions, strerror(st->error));
+            continue;
+        }
+
+        if (st->batch.left > left)
+            left = st->batch.left;
+        if (st->flush.left > left)
+            left = st->flush.left;
+
+        printf("  %7u %12.0f %12.0f %12.0f %12.3f %12.0f %12.1f", st->actions, st->populate_actions_per_sec,
+               st->single.actions_per_sec, st->batch.actions_per_sec, st->flush.secs * 1e3,
+               st->flush.actions_per_sec, st->flush.secs * 1e9 / (double)st->actions);
+        if (st->flush_count == UINT32_MAX)
+            printf(" %9s", "-");
+        else
+            printf(" %9u", st->flush_count);
+        printf(" %6u\n", left);
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_teardown_step* st = &summary->per_step[s];
+
+        if (st->error != 0)
+            continue;
+
+        printf("  N=%u: populate %llu errors; single %llu msgs %llu errors %.3f s; batch %llu msgs %llu errors "
+               "%.3f s; flush %llu errors\n",
+               st->actions, (unsigned long long)st->populate_errors, (unsigned long long)st->single.msgs,
+               (unsigned long long)st->single.errors, st->single.secs, (unsigned long long)st->batch.msgs,
+               (unsigned long long)st->batch.errors, st->batch.secs, (unsigned long long)st->flush.errors);
+    }
+}
+
+void gb_teardown_summary_free(struct gb_teardown_summary* summary) {
+    if (!summary)
+        return;
+
+    free(summary->per_step);
+    summary->per_step = NULL;
+    summary->steps = 0;
+}
@@ -0,0 +1,304 @@
+/* src/threads.c
+ * Write scaling: N pinned threads, each with its own socket and index, run
+ * the benchmark loop together to show where create/replace throughput stops
+ * growing with threads (rtnl, idr or per-netns serialization).
+ */
+#include "../include/gatebench_threads.h"
+#include "../include/gatebench_bench.h"
+#include "../include/gatebench_nl.h"
+#include "../include/gatebench_stats.h"
+#include "../include/gatebench_util.h"
+#include "bench_internal.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct threads_ctx {
+    /* Start gate: the runs begin together once every thread is set up */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t ready;
+    bool go;
+};
+
+struct threads_worker {
+    struct threads_ctx* ctx;
+    struct gb_config cfg; /* Copy with this thread's index; samples kept */
+    int cpu;
+    bool pinned;
+    struct gb_run_result result;
+    int ret;
+};
+
+/* Report this thread set up (or failed) and wait for the common start */
+static void threads_ready_wait(struct threads_ctx* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    ctx->ready++;
+    pthread_cond_broadcast(&ctx->cond);
+    while (!ctx->go)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static void* threads_worker_main(void* arg) {
+    struct threads_worker* w = arg;
+    struct gb_nl_sock* sock = NULL;
+
+    /* Running unpinned only blurs the curve; keep going */
+    w->pinned = w->cpu >= 0 && gb_util_pin_cpu(w->cpu) == 0;
+
+    w->ret = gb_nl_open(&sock);
+    threads_ready_wait(w->ctx);
+    if (w->ret < 0)
+        return NULL;
+
+    w->ret = gb_bench_single_run(sock, &w->cfg, &w->result);
+    gb_nl_close(sock);
+    return NULL;
+}
+
+static int threads_step(struct threads_ctx* ctx,
+                        const struct gb_config* cfg,
+                        const int* cpus,
+                        uint32_t cpu_count,
+                        uint32_t n,
+                        struct gb_threads_step* out) {
+    struct threads_worker* workers = NULL;
+    pthread_t* threads = NULL;
+    struct gb_stats all;
+    uint64_t first_start = UINT64_MAX, last_end = 0;
+    uint32_t started = 0;
+    int ret;
+
+    memset(out, 0, sizeof(*out));
+    out->threads = n;
+
+    ret = gb_stats_init(&all, (size_t)n * cfg->iters * 2u);
+    if (ret < 0)
+        return ret;
+
+    workers = calloc(n, sizeof(*workers));
+    threads = calloc(n, sizeof(*threads));
+    out->per_worker = calloc(n, sizeof(*out->per_worker));
+    if (!workers || !threads || !out->per_worker) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        struct threads_worker* w = &workers[i];
+
+        w->ctx = ctx;
+        w->cfg = *cfg;
+        w->cfg.index = cfg->index + i;
+        /* Keep every latency (or every sample_every-th) to merge across threads */
+        w->cfg.sample_mode = true;
+        w->cfg.sample_every = cfg->sample_mode ? cfg->sample_every : 1u;
+        /* The sweep never exceeds cpu_count, so no two workers share a CPU */
+        w->cpu = i < cpu_count ? cpus[i] : -1;
+    }
+
+    ctx->ready = 0;
+    ctx->go = false;
+
+    for (uint32_t i = 0; i < n; i++) {
+        ret = -pthread_create(&threads[i], NULL, threads_worker_main, &workers[i]);
+        if (ret < 0)
+            break;
+        started++;
+    }
+
+    /* Release whoever started, even after a failed pthread_create */
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->ready < started)
+        pthread_cond_wait(&ctx->cond, &ctx->lock);
+    ctx->go = true;
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (uint32_t i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    if (ret < 0)
+        goto out;
+
+    for (uint32_t i = 0; i < n; i++) {
+        struct threads_worker* w = &workers[i];
+        struct gb_threads_worker* ws = &out->per_worker[i];
+        struct gb_run_result* r = &w->result;
+
+        if (w->ret < 0) {
+            ret = w->ret;
+            goto out;
+        }
+
+        ws->index = w->cfg.index;
+        ws->cpu = w->pinned ? w->cpu : -1;
+        ws->ops = (uint64_t)llround(r->ops_per_sec * r->secs);
+        ws->ops_per_sec = r->ops_per_sec;
+        ws->latency.count = r->sample_count;
+        ws->latency.min_ns = r->min_ns;
+        ws->latency.max_ns = r->max_ns;
+        ws->latency.mean_ns = r->mean_ns;
+        ws->latency.stddev_ns = r->stddev_ns;
+        ws->latency.p50_ns = r->p50_ns;
+        ws->latency.p95_ns = r->p95_ns;
+        ws->latency.p99_ns = r->p99_ns;
+        ws->latency.p999_ns = r->p999_ns;
+
+        out->total_ops += ws->ops;
+        if (r->start_ns < first_start)
+            first_start = r->start_ns;
+        if (r->end_ns > last_end)
+            last_end = r->end_ns;
+
+        for (uint32_t k = 0; k < r->sample_count; k++) {
+            ret = gb_stats_add(&all, r->samples[k]);
+            if (ret < 0)
+                goto out;
+        }
+    }
+
+    if (last_end > first_start)
+        out->secs = (double)(last_end - first_start) / 1e9;
+    if (out->secs > 0.0)
+        out->ops_per_sec = (double)out->total_ops / out->secs;
+
+    ret = gb_stats_summarize(&all, &out->latency);
+
+out:
+    if (workers) {
+        for (uint32_t i = 0; i < n; i++)
+            gb_run_result_free(&workers[i].result);
+    }
+    if (ret < 0) {
+        free(out->per_worker);
+        out->per_worker = NULL;
+    }
+    free(workers);
+    free(threads);
+    gb_stats_free(&all);
+    return ret;
+}
+
+int gb_threads_run(const struct gb_config* cfg, struct gb_threads_summary* summary) {
+    struct threads_ctx ctx;
+    uint32_t sweep[32];
+    uint32_t steps = 0;
+    int* cpus = NULL;
+    int cpu_count;
+    int ret = 0;
+
+    if (!cfg || !summary || cfg->threads == 0 || cfg->threads > GB_THREADS_MAX)
+        return -EINVAL;
+
+    memset(summary, 0, sizeof(*summary));
+    memset(&ctx, 0, sizeof(ctx));
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.cond, NULL);
+
+    for (uint32_t n = 1; n < cfg->threads; n *= 2u)
+        sweep[steps++] = n;
+    sweep[steps++] = cfg->threads;
+
+    cpus = calloc(GB_THREADS_MAX, sizeof(*cpus));
+    summary->per_step = calloc(steps, sizeof(*summary->per_step));
+    if (!cpus || !summary->per_step) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    cpu_count = gb_util_collect_cpus(cpus, (int)GB_THREADS_MAX);
+    summary->cpus = cpu_count > 0 ? (uint32_t)cpu_count : 0;
+
+    /* Past the CPU count the curve would measure time slicing, not the kernel */
+    if (summary->cpus > 0 && cfg->threads > summary->cpus) {
+        ret = -ERANGE;
+        goto out;
+    }
+
+    for (uint32_t s = 0; s < steps; s++) {
+        struct gb_threads_step* st = &summary->per_step[s];
+
+        if (!cfg->json)
+            printf("  %4u threads... ", sweep[s]);
+        fflush(stdout);
+
+        ret = threads_step(&ctx, cfg, cpus, summary->cpus, sweep[s], st);
+        if (ret < 0) {
+            if (!cfg->json)
+                printf("failed: %s\n", strerror(-ret));
+            goto out;
+        }
+        summary->steps = s + 1u;
+
+        if (summary->per_step[0].ops_per_sec > 0.0)
+            st->efficiency = st->ops_per_sec / ((double)sweep[s] * summary->per_step[0].ops_per_sec);
+
+        if (!cfg->json)
+            printf("done (%.1f ops/sec, %.0f%% efficiency)\n", st->ops_per_sec, st->efficiency * 100.0);
+    }
+
+out:
+    if (ret < 0)
+        gb_threads_summary_free(summary);
+    pthread_cond_destroy(&ctx.cond);
+    pthread_mutex_destroy(&ctx.lock);
+    free(cpus);
+    return ret;
+}
+
+void gb_threads_print_summary(const struct gb_threads_summary* summary, const struct gb_config* cfg) {
+    if (!summary || !cfg || summary->steps == 0)
+        return;
+
+    printf("Write scaling: %u CPUs available, %u iterations per thread\n", summary->cpus, cfg->iters);
+    printf("  %7s %14s %14s %10s %10s %10s %14s\n", "threads", "ops/sec", "per thread", "effic.", "p50", "p99",
+           "thread p99 max");
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_threads_step* st = &summary->per_step[s];
+        uint64_t worst = 0;
+
+        for (uint32_t i = 0; i < st->threads; i++) {
+            if (st->per_worker[i].latency.p99_ns > worst)
+                worst = st->per_worker[i].latency.p99_ns;
+        }
+
+        printf("  %7u %14.1f %14.1f %9.1f%% %8.1fus %8.1fus %12.1fus\n", st->threads, st->ops_per_sec,
+               st->ops_per_sec / (double)st->threads, st->efficiency * 100.0, (double)st->latency.p50_ns / 1e3,
+               (double)st->latency.p99_ns / 1e3, (double)worst / 1e3);
+    }
+
+    if (!cfg->verbose)
+        return;
+
+    for (uint32_t s = 0; s < summary->steps; s++) {
+        const struct gb_threads_step* st = &summary->per_step[s];
+
+        for (uint32_t i = 0; i < st->threads; i++) {
+            const struct gb_threads_worker* w = &st->per_worker[i];
+
+            printf("  N=%u thread %3u (index %u, cpu %d): %.1f ops/sec, p50 %llu ns, p99 %llu ns\n", st->threads, i,
+                   w->index, w->cpu, w->ops_per_sec, (unsigned long long)w->latency.p50_ns,
+                   (unsigned long long)w->latency.p99_ns);
+        }
+    }
+}
+
+void gb_threads_summary_free(struct gb_threads_summary* summary) {
+    if (!summary)
+        return;
+
+    if (summary->per_step) {
+        for (uint32_t s = 0; s < summary->steps; s++)
+            free(summary->per_step[s].per_worker);
+    }
+    free(summary->per_step);
+    summary->per_step = NULL;
+    summary->steps = 0;
+}
@@ -0,0 +1,335 @@
+/* src/trace.c
+ * Request capture: every netlink request sent by gatebench is appended to a
+ * compact trace file together with the errno its ack carried.
+ */
+#include "../include/gatebench_trace.h"
+#include "../include/gatebench_util.h"
+#include "nl_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Records are staged here and written out in large chunks */
+#define TRACE_BUF_SIZE (1024u * 1024u)
+#define TRACE_ALIGN(len) (((len) + 7u) & ~(size_t)7u)
+
+static struct {
+    pthread_mutex_t lock;
+    int fd;
+    uint8_t* buf;
+    size_t len;       /* Staged bytes */
+    uint64_t flushed; /* File offset of buf[0] */
+    uint64_t records;
+    uint64_t start_ns;
+    uint32_t threads;
+} trace = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1,
+};
+
+static atomic_bool trace_on;
+
+/* Thread number + 1 within the current capture; 0 = not seen yet */
+static _Thread_local uint32_t trace_tid;
+static _Thread_local uint64_t trace_tid_gen;
+static uint64_t trace_gen;
+
+/* Write the staged bytes; caller holds trace.lock */
+static int trace_flush_locked(void) {
+    size_t off = 0;
+
+    while (off < trace.len) {
+        ssize_t ret = pwrite(trace.fd, trace.buf + off, trace.len - off, (off_t)(trace.flushed + off));
+
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return -errno;
+        }
+        off += (size_t)ret;
+    }
+
+    trace.flushed += trace.len;
+    trace.len = 0;
+    return 0;
+}
+
+static int trace_write_header_locked(void) {
+    struct gb_trace_header hdr;
+    ssize_t ret;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, GB_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = GB_TRACE_VERSION;
+    hdr.header_size = (uint32_t)sizeof(hdr);
+    hdr.record_count = trace.records;
+    hdr.threads = trace.threads;
+
+    ret = pwrite(trace.fd, &hdr, sizeof(hdr), 0);
+    if (ret < 0)
+        return -errno;
+    if ((size_t)ret != sizeof(hdr))
+        return -EIO;
+
+    return 0;
+}
+
+int gb_trace_open(const char* path) {
+    int ret;
+
+    if (!path)
+        return -EINVAL;
+
+    pthread_mutex_lock(&trace.lock);
+    if (trace.fd >= 0) {
+        ret = -EBUSY;
+        goto out;
+    }
+
+    trace.buf = malloc(TRACE_BUF_SIZE);
+    if (!trace.buf) {
+        ret = -ENOMEM;
+        goto out;
+    }
+
+    trace.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (trace.fd < 0) {
+        ret = -errno;
+        free(trace.buf);
+        trace.buf = NULL;
+        goto out;
+    }
+
+    trace.len = 0;
+    trace.flushed = sizeof(struct gb_trace_header);
+    trace.records = 0;
+    trace.threads = 0;
+    trace_gen++;
+
+    ret = trace_write_header_locked();
+    if (ret == 0)
+        ret = gb_util_ns_now(&trace.start_ns, CLOCK_MONOTONIC);
+    if (ret < 0) {
+        close(trace.fd);
+        trace.fd = -1;
+        free(trace.buf);
+        trace.buf = NULL;
+        goto out;
+    }
+
+    atomic_store(&trace_on, true);
+
+out:
+    pthread_mutex_unlock(&trace.lock);
+    return ret;
+}
+
+int gb_trace_close(void) {
+    int ret;
+
+    pthread_mutex_lock(&trace.lock);
+    if (trace.fd < 0) {
+        pthread_mutex_unlock(&trace.lock);
+        return 0;
+    }
+
+    atomic_store(&trace_on, false);
+
+    ret = trace_flush_locked();
+    if (ret == 0)
+        ret = trace_write_header_locked();
+
+    if (close(trace.fd) < 0 && ret == 0)
+        ret = -errno;
+    trace.fd = -1;
+    free(trace.buf);
+    trace.buf = NULL;
+
+    pthread_mutex_unlock(&trace.lock);
+    return ret;
+}
+
+bool gb_trace_capturing(void) {
+    return atomic_load_explicit(&trace_on, memory_order_relaxed);
+}
+
+int64_t gb_trace_record_request(const void* buf, size_t len, uint32_t seq) {
+    struct gb_trace_record rec;
+    size_t need = sizeof(rec) + TRACE_ALIGN(len);
+    uint64_t now = 0;
+    int64_t off;
+
+    if (!buf || len > UINT32_MAX)
+        return -EINVAL;
+
+    (void)gb_util_ns_now(&now, CLOCK_MONOTONIC);
+
+    pthread_mutex_lock(&trace.lock);
+    if (trace.fd < 0) {
+        pthread_mutex_unlock(&trace.lock);
+        return -ENODEV;
+    }
+
+    if (trace_tid == 0 || trace_tid_gen != trace_gen) {
+        trace_tid = ++trace.threads;
+        trace_tid_gen = trace_gen;
+    }
+
+    if (trace.len + need > TRACE_BUF_SIZE) {
+        int ret = trace_flush_locked();
+
+        if (ret < 0) {
+            pthread_mutex_unlock(&trace.lock);
+            return ret;
+        }
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    rec.ts_ns = now > trace.start_ns ? now - trace.start_ns : 0;
+    rec.tid = trace_tid - 1u;
+    rec.seq = seq;
+    rec.err = GB_TRACE_ERR_PENDING;
+    rec.len = (uint32_t)len;
+
+    off = (int64_t)(trace.flushed + trace.len);
+    if (need > TRACE_BUF_SIZE) {
+        /* Oversized request: the stage is empty, write it straight through */
+        if (pwrite(trace.fd, &rec, sizeof(rec), (off_t)trace.flushed) != (ssize_t)sizeof(rec) ||
+            pwrite(trace.fd, buf, len, (off_t)(trace.flushed + sizeof(rec))) != (ssize_t)len) {
+            pthread_mutex_unlock(&trace.lock);
+            return -EIO;
+        }
+        trace.flushed += need;
+    }
+    else {
+        memcpy(trace.buf + trace.len, &rec, sizeof(rec));
+        memcpy(trace.buf + trace.len + sizeof(rec), buf, len);
+        memset(trace.buf + trace.len + sizeof(rec) + len, 0, need - sizeof(rec) - len);
+        trace.len += need;
+    }
+    trace.records++;
+
+    pthread_mutex_unlock(&trace.lock);
+    return off;
+}
+
+void gb_trace_record_result(int64_t off, int err) {
+    int32_t err32 = (int32_t)err;
+    uint64_t at;
+
+    if (off < 0)
+        return;
+
+    at = (uint64_t)off + offsetof(struct gb_trace_record, err);
+
+    pthread_mutex_lock(&trace.lock);
+    if (trace.fd >= 0) {
+        if (at >= trace.flushed)
+            memcpy(trace.buf + (at - trace.flushed), &err32, sizeof(err32));
+        else
+            (void)pwrite(trace.fd, &err32, sizeof(err32), (off_t)at);
+    }
+    pthread_mutex_unlock(&trace.lock);
+}
+
+int gb_trace_map(const char* path, struct gb_trace_file* out) {
+    const struct gb_trace_header* hdr;
+    struct stat st;
+    void* map;
+    int fd;
+    int ret = 0;
+
+    if (!path || !out)
+        return -EINVAL;
+
+    memset(out, 0, sizeof(*out));
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -errno;
+
+    if (fstat(fd, &st) < 0) {
+        ret = -errno;
+        goto out;
+    }
+
+    if ((size_t)st.st_size < sizeof(*hdr)) {
+        ret = -EINVAL;
+        goto out;
+    }
+
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        ret = -errno;
+        goto out;
+    }
+
+    hdr = map;
+    if (memcmp(hdr->magic, GB_TRACE_MAGIC, sizeof(hdr->magic)) != 0 || hdr->version != GB_TRACE_VERSION ||
+        hdr->header_size < sizeof(*hdr) || hdr->header_size % 8u != 0 || hdr->header_size > (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        ret = -EINVAL;
+        goto out;
+    }
+
+    out->map = map;
+    out->size = (size_t)st.st_size;
+    out->hdr = hdr;
+
+out:
+    close(fd);
+    return ret;
+}
+
+void gb_trace_unmap(struct gb_trace_file* file) {
+    if (!file || !file->map)
+        return;
+
+    munmap(file->map, file->size);
+    memset(file, 0, sizeof(*file));
+}
+
+/* Record at byte offset off, or NULL if it does not fit in the file */
+static const struct gb_trace_record* trace_record_at(const struct gb_trace_file* file, size_t off) {
+    const struct gb_trace_record* rec;
+
+    if (off > file->size || file->size - off < sizeof(*rec))
+        return NULL;
+
+    rec = (const void*)((const uint8_t*)file->map + off);
+    if (file->size - off - sizeof(*rec) < rec->len)
+        return NULL;
+
+    return rec;
+}
+
+const struct gb_trace_record* gb_trace_first(const struct gb_trace_file* file) {
+    if (!file || !file->map)
+        return NULL;
+
+    return trace_record_at(file, file->hdr->header_size);
+}
+
+const struct gb_trace_record* gb_trace_next(const struct gb_trace_file* file, const struct gb_trace_record* rec) {
+    size_t off;
+
+    if (!file || !rec)
+        return NULL;
+
+    off = (size_t)((const uint8_t*)rec - (const uint8_t*)file->map);
+    return trace_record_at(file, off + sizeof(*rec) + TRACE_ALIGN((size_t)rec->len));
+}
+
+const void* gb_trace_payload(const struct gb_trace_record* rec) {
+    return rec + 1;
+}
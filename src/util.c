@@ -9,6 +9,7 @@
 #include <limits.h>
 #include <sched.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -32,6 +33,52 @@ int gb_util_pin_cpu(int cpu) {
     return 0;
 }
 
+int gb_util_count_cpus(void) {
+    cpu_set_t set;
+    long nproc;
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 0)
+        return CPU_COUNT(&set);
+
+    nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nproc <= 0)
+        return 0;
+
+    return nproc > INT_MAX ? INT_MAX : (int)nproc;
+}
+
+int gb_util_collect_cpus(int* cpus, int max) {
+    cpu_set_t set;
+    long nproc;
+    int count = 0;
+    int nproc_i;
+
+    if (!cpus || max <= 0)
+        return 0;
+
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (size_t cpu = 0; cpu < (size_t)CPU_SETSIZE && count < max; cpu++) {
+            if (CPU_ISSET(cpu, &set))
+                cpus[count++] = (int)cpu;
+        }
+        if (count > 0)
+            return count;
+    }
+
+    nproc = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nproc <= 0)
+        return 0;
+
+    if (nproc > max)
+        nproc = max;
+
+    nproc_i = (int)nproc;
+    for (int i = 0; i < nproc_i; i++)
+        cpus[i] = i;
+
+    return nproc_i;
+}
+
 int gb_util_ns_now(uint64_t* out_ns, int clockid) {
     struct timespec ts;
     clockid_t clk = (clockid_t)clockid;
@@ -127,6 +174,39 @@ int gb_util_sleep_ns(uint64_t ns) {
     return 0;
 }
 
+int gb_util_meminfo_kb(const char* key, uint64_t* out_kb) {
+    char line[256];
+    size_t key_len;
+    FILE* f;
+    int ret = -ENOENT;
+
+    if (!key || !out_kb)
+        return -EINVAL;
+
+    f = fopen("/proc/meminfo", "re");
+    if (!f)
+        return -errno;
+
+    key_len = strlen(key);
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long long kb;
+
+        if (strncmp(line, key, key_len) != 0 || line[key_len] != ':')
+            continue;
+
+        if (sscanf(line + key_len + 1, "%llu", &kb) == 1) {
+            *out_kb = (uint64_t)kb;
+            ret = 0;
+        } else {
+            ret = -EINVAL;
+        }
+        break;
+    }
+
+    fclose(f);
+    return ret;
+}
+
 int gb_util_parse_uint64(const char* str, uint64_t* val) {
     char* endptr = NULL;
     uintmax_t tmp;